@@ -122,8 +122,9 @@ static int hmi_create(void)
     hmi->serial = rt_device_find(HMI_DEVICE_SERIAL_NAME);
     if (hmi->serial != RT_NULL)
     {
-        /* 以读写及中断接收方式打开串口设备 */
-        rt_device_open(hmi->serial, RT_DEVICE_OFLAG_RDWR | RT_DEVICE_FLAG_INT_RX);
+        /* 以读写及中断接收方式打开串口设备, 支持时使用DMA发送队列 */
+        rt_device_open(hmi->serial, RT_DEVICE_OFLAG_RDWR | RT_DEVICE_FLAG_INT_RX |
+                       (hmi->serial->flag & RT_DEVICE_FLAG_DMA_TX));
         /* 设置钩子函数 */
         rt_device_set_rx_indicate(hmi->serial, hmi_serial_input);
     }
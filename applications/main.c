@@ -7,6 +7,8 @@
  * Date           Author       Notes
  * 2018-11-06     SummerGift   first version
  * 2018-11-19     flybreak     add stm32f429-fire-challenger bsp
+ * 2026-10-19     Hehesheng    mount the flash through block cache
+ * 2026-10-19     Hehesheng    mount the flash through FTL
  */
 
 /*
@@ -134,28 +136,52 @@ int main(void)
 #ifdef BSP_USING_SPI3
     if (rt_device_find("W25Q64") != RT_NULL)
     {
+        const char *flash = "W25Q64";
+        const char *path = "/";
+        rt_bool_t format = RT_FALSE;
+        int result;
+
+#ifdef BSP_USING_SPI_FLASH_FTL
+        rt_nor_ftl_t ftl;
+
+        /* the sectors are remapped by FTL instead of erased in place */
+        ftl = rt_nor_ftl_create("ftl0", "nor0");
+        if (ftl != RT_NULL)
+        {
+            flash = "ftl0";
+            /* only the blank FTL has no file system */
+            format = ftl->blank;
+        }
+#endif
+
+#ifdef RT_USING_BLK_CACHE
+        /* the FAT and directory sectors are rewritten frequently */
+        if (rt_blk_cache_create("flash0", flash, RT_BLK_CACHE_SECTORS) != RT_NULL)
+        {
+            flash = "flash0";
+        }
+#endif
+
         if (rt_device_find("sd0") != RT_NULL)
         {
             rt_thread_mdelay(RT_TICK_PER_SECOND);
-            if (dfs_mount("W25Q64", "/flash", "elm", 0, 0) == RT_EOK)
-            {
-                LOG_I("flash mount to '/flash'");
-            }
-            else
-            {
-                LOG_W("flash mount to '/flash' failed!");
-            }
+            path = "/flash";
+        }
+
+        result = dfs_mount(flash, path, "elm", 0, 0);
+        if (result != RT_EOK && format && dfs_mkfs("elm", flash) == 0)
+        {
+            LOG_I("flash is formatted");
+            result = dfs_mount(flash, path, "elm", 0, 0);
+        }
+
+        if (result == RT_EOK)
+        {
+            LOG_I("flash mount to '%s'", path);
         }
         else
         {
-            if (dfs_mount("W25Q64", "/", "elm", 0, 0) == RT_EOK)
-            {
-                LOG_I("flash mount to '/'");
-            }
-            else
-            {
-                LOG_W("flash mount to '/' failed!");
-            }
+            LOG_W("flash mount to '%s' failed!", path);
         }
     }
 #endif
@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2019-05-17     Hehesheng    first version
+ * 2026-10-19     Hehesheng    parse the serial fifo in place
  */
 
 /*
@@ -43,13 +44,13 @@ BIG PACK:
 #define TGAM_THREAD_PRIORITY (15)
 
 #ifdef TGAM_USING_DMA
-#define RX_BUFF_SIZE (RT_SERIAL_RB_BUFSZ)
+#define RX_FIFO_SIZE (1024)
+#define DATA_BUFF_SIZE (64)
 #define RAW_DATA_MAX_SIZE (2048)
 #define GET_RAW_SIZE (5)
 #define GET_PACK_SIZE (33)
 
-static char rx_buff[RX_BUFF_SIZE + 1]   = {0};
-static char data_buff[RX_BUFF_SIZE + 1] = {0};
+static char data_buff[DATA_BUFF_SIZE + 1] = {0};
 
 enum
 {
@@ -237,12 +238,8 @@ static void tgam_free(void *data)
  */
 static rt_err_t serial_dma_input(rt_device_t dev, rt_size_t size)
 {
-    if (rt_mb_send(tgam_mb, size) != RT_EOK)
-    {
-        /* 丢包 */
-        rt_device_read(dev, 0, RT_NULL, size);
-        log_w("TGAM mailbox send fail!!!");
-    }
+    /* 数据留在串口FIFO中, 信箱满时线程仍会读取, 不会丢包 */
+    rt_mb_send(tgam_mb, size);
 
     return RT_EOK;
 }
@@ -256,6 +253,7 @@ void tgam_dma_thread(void *parameter)
 {
     int len           = 0;
     int index         = 0;
+    uint8_t *rx_buff  = RT_NULL;
     uint32_t status   = 0;
     rt_event_t events = RT_NULL;
 
@@ -266,7 +264,8 @@ void tgam_dma_thread(void *parameter)
     } while (events == RT_NULL);
     rt_event_recv(events, EVENT_NET_OK, RT_EVENT_FLAG_OR, RT_WAITING_FOREVER, RT_NULL);
 
-    /* 以读写及中断接收方式打开串口设备 */
+    /* 设置串口FIFO大小, 以读写及DMA接收方式打开串口设备 */
+    rt_device_control(serial, RT_SERIAL_CTRL_SET_RX_BUFSZ, (void *)RX_FIFO_SIZE);
     rt_device_open(serial, RT_DEVICE_OFLAG_RDWR | RT_DEVICE_FLAG_DMA_RX);
 #ifdef TGAM_USING_DMA
     rt_device_set_rx_indicate(serial, serial_dma_input);
@@ -298,89 +297,99 @@ void tgam_dma_thread(void *parameter)
             }
         }
 
-        rt_device_read(serial, 0, rx_buff, len);
-        /* analysis */
-        for (int i = 0; i < len; i++)
+        /* 在FIFO中直接解析 */
+        while ((len = rt_serial_rx_peek((struct rt_serial_device *)serial, &rx_buff)) > 0)
         {
-            switch (status)
+            for (int i = 0; i < len; i++)
             {
-                /* 识别数据头 */
-                case STATUS_NONE:
-                case STATUS_AA_FIRST:
-                    if (rx_buff[i] == 0xAA)
-                    {
-                        status++;
-                    }
-                    else
-                    {
-                        status = STATUS_NONE;
-                    }
+                switch (status)
+                {
+                    /* 识别数据头 */
+                    case STATUS_NONE:
+                    case STATUS_AA_FIRST:
+                        if (rx_buff[i] == 0xAA)
+                        {
+                            status++;
+                        }
+                        else
+                        {
+                            status = STATUS_NONE;
+                        }
 
-                    break;
-                case STATUS_AA_SECOND:
-                    if (rx_buff[i] == 0x04)
-                    {
-                        status = STATUS_RAW_HEAD1;
-                    }
-                    else if (rx_buff[i] == 0x20)
-                    {
-                        status = STATUS_PACK_HEAD1;
-                    }
-                    else
-                    {
-                        status = STATUS_NONE;
                         break;
-                    }
-                    rt_memset(data_buff, 0, RX_BUFF_SIZE);
+                    case STATUS_AA_SECOND:
+                        if (rx_buff[i] == 0x04)
+                        {
+                            status = STATUS_RAW_HEAD1;
+                        }
+                        else if (rx_buff[i] == 0x20)
+                        {
+                            status = STATUS_PACK_HEAD1;
+                        }
+                        else
+                        {
+                            status = STATUS_NONE;
+                            break;
+                        }
+                        rt_memset(data_buff, 0, DATA_BUFF_SIZE);
+
+                        break;
+                    case STATUS_RAW_HEAD1:
+                        data_buff[index++] = rx_buff[i];
+                        /* raw 接收完成 */
+                        if (index == GET_RAW_SIZE)
+                        {
+                            status = STATUS_RAW_OK;
+                        }
+
+                        break;
+                    case STATUS_PACK_HEAD1:
+                        data_buff[index++] = rx_buff[i];
+                        /* pack 接收完成 */
+                        if (index == GET_PACK_SIZE)
+                        {
+                            status = STATUS_PACK_OK;
+                        }
 
-                    break;
-                case STATUS_RAW_HEAD1:
-                    data_buff[index++] = rx_buff[i];
-                    /* raw 接收完成 */
-                    if (index == GET_RAW_SIZE)
+                        break;
+
+                    default:
+                        break;
+                }
+
+                if (status == STATUS_RAW_OK || status == STATUS_PACK_OK)
+                {
+                    index  = 0;
+                    status = STATUS_NONE;
+
+                    if (rt_event_recv(events, EVENT_UPLOAD_OK, RT_EVENT_FLAG_OR, 0, RT_NULL) != RT_EOK)
                     {
-                        status = STATUS_RAW_OK;
+                        continue;
                     }
-
-                    break;
-                case STATUS_PACK_HEAD1:
-                    data_buff[index++] = rx_buff[i];
-                    /* pack 接收完成 */
-                    if (index == GET_PACK_SIZE)
+                    if (tgam_msg_dump(data_buff, raw, pack) == 1)
                     {
-                        status = STATUS_PACK_OK;
+                        upload->parent.stream_name    = TGAM_ONENET_STREAM_NAME;
+                        upload->parent.create_monitor = tgam_create_monitor;
+                        upload->parent.free           = tgam_free;
+                        upload->parent.tick           = rt_tick_get();
+                        if (rt_mb_send(upload_mb, (rt_base_t)upload) != RT_EOK)
+                        {
+                            /* 上传失败释放内存 */
+                            tgam_free(upload);
+                            log_w("UPLOAD mailbox send fail!!!");
+                        }
+                        /* 重新申请上传资源 */
+                        tgam_mem_alloc(&upload, &raw, &pack, &raw_data);
                     }
-
-                    break;
-
-                default:
-                    break;
+                }
             }
 
-            if (status == STATUS_RAW_OK || status == STATUS_PACK_OK)
+            /* 解析期间FIFO溢出, 丢弃未完成的包 */
+            if (rt_serial_rx_consume((struct rt_serial_device *)serial, len) == 0)
             {
                 index  = 0;
                 status = STATUS_NONE;
-
-                if (rt_event_recv(events, EVENT_UPLOAD_OK, RT_EVENT_FLAG_OR, 0, RT_NULL) != RT_EOK)
-                {
-                    continue;
-                }
-                if (tgam_msg_dump(data_buff, raw, pack) == 1)
-                {
-                    upload->parent.stream_name    = TGAM_ONENET_STREAM_NAME;
-                    upload->parent.create_monitor = tgam_create_monitor;
-                    upload->parent.free           = tgam_free;
-                    upload->parent.tick           = rt_tick_get();
-                    if (rt_mb_send(upload_mb, (rt_base_t)upload) != RT_EOK)
-                    {
-                        /* 上传失败释放内存 */
-                        tgam_free(upload);
-                        log_w("UPLOAD mailbox send fail!!!");
-                    }
-                    /* 重新申请上传资源 */
-                    tgam_mem_alloc(&upload, &raw, &pack, &raw_data);
-                }
+                log_w("TGAM serial fifo overflow!!!");
             }
         }
     }
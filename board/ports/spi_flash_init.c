@@ -6,14 +6,70 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-11-27     SummerGift   add spi flash port file
+ * 2026-10-19     Hehesheng    register the flash as MTD Nor Flash
  */
 
 #include <rtthread.h>
+#include <rtdevice.h>
 #include "spi_flash.h"
 #include "spi_flash_sfud.h"
 #include "drv_spi.h"
 
 #if defined(BSP_USING_SPI_FLASH)
+#ifdef RT_USING_MTD_NOR
+static struct rt_mtd_nor_device spi_flash_nor;
+
+static rt_err_t spi_flash_nor_read_id(struct rt_mtd_nor_device *device)
+{
+    return RT_EOK;
+}
+
+static rt_size_t spi_flash_nor_read(struct rt_mtd_nor_device *device, rt_off_t offset, rt_uint8_t *data, rt_uint32_t length)
+{
+    sfud_flash_t flash = (sfud_flash_t)device->parent.user_data;
+
+    if (sfud_read(flash, offset, length, data) != SFUD_SUCCESS)
+    {
+        return 0;
+    }
+
+    return length;
+}
+
+static rt_size_t spi_flash_nor_write(struct rt_mtd_nor_device *device, rt_off_t offset, const rt_uint8_t *data, rt_uint32_t length)
+{
+    sfud_flash_t flash = (sfud_flash_t)device->parent.user_data;
+
+    /* program only, the erase is done by the user */
+    if (sfud_write(flash, offset, length, data) != SFUD_SUCCESS)
+    {
+        return 0;
+    }
+
+    return length;
+}
+
+static rt_err_t spi_flash_nor_erase_block(struct rt_mtd_nor_device *device, rt_off_t offset, rt_uint32_t length)
+{
+    sfud_flash_t flash = (sfud_flash_t)device->parent.user_data;
+
+    if (sfud_erase(flash, offset, length) != SFUD_SUCCESS)
+    {
+        return -RT_EIO;
+    }
+
+    return RT_EOK;
+}
+
+static const struct rt_mtd_nor_driver_ops spi_flash_nor_ops =
+{
+    spi_flash_nor_read_id,
+    spi_flash_nor_read,
+    spi_flash_nor_write,
+    spi_flash_nor_erase_block,
+};
+#endif /* RT_USING_MTD_NOR */
+
 static int rt_hw_spi_flash_init(void)
 {
     __HAL_RCC_GPIOG_CLK_ENABLE();
@@ -24,6 +80,20 @@ static int rt_hw_spi_flash_init(void)
         return -RT_ERROR;
     }
 
+#ifdef RT_USING_MTD_NOR
+    /* the flash in erase blocks for the flash translation layer */
+    {
+        sfud_flash_t flash = rt_sfud_flash_find_by_dev_name("W25Q64");
+
+        spi_flash_nor.block_size = flash->chip.erase_gran;
+        spi_flash_nor.block_start = 0;
+        spi_flash_nor.block_end = flash->chip.capacity / flash->chip.erase_gran;
+        spi_flash_nor.ops = &spi_flash_nor_ops;
+        spi_flash_nor.parent.user_data = flash;
+        rt_mtd_nor_register_device("nor0", &spi_flash_nor);
+    }
+#endif
+
     return RT_EOK;
 }
 INIT_COMPONENT_EXPORT(rt_hw_spi_flash_init);
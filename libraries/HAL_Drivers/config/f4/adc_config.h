@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-12-06     zylx         first version
+ * 2026-10-19     Hehesheng    add ADC1 stream mode config
  */
 
 #ifndef __ADC_CONFIG_H__
@@ -38,6 +39,24 @@ extern "C" {
 #endif /* ADC1_CONFIG */
 #endif /* BSP_USING_ADC1 */
 
+#ifdef BSP_ADC1_USING_STREAM
+#ifndef ADC1_DMA_CONFIG
+#define ADC1_DMA_CONFIG                                             \
+    {                                                               \
+        .Instance = ADC1_DMA_INSTANCE,                              \
+        .channel = ADC1_DMA_CHANNEL,                                \
+        .dma_rcc = ADC1_DMA_RCC,                                    \
+        .dma_irq = ADC1_DMA_IRQ,                                    \
+    }
+#endif /* ADC1_DMA_CONFIG */
+
+/* the timer to trigger the scans, TIM2, TIM3 or TIM8 by TRGO */
+#ifndef ADC1_TRIGGER_TIM
+#define ADC1_TRIGGER_TIM            TIM2
+#define ADC1_TRIGGER_CONV           ADC_EXTERNALTRIGCONV_T2_TRGO
+#endif /* ADC1_TRIGGER_TIM */
+#endif /* BSP_ADC1_USING_STREAM */
+
 #ifdef BSP_USING_ADC2
 #ifndef ADC2_CONFIG
 #define ADC2_CONFIG                                                 \
@@ -7,6 +7,7 @@
  * Date           Author       Notes
  * 2019-01-02     zylx         first version
  * 2019-01-08     SummerGift   clean up the code
+ * 2026-10-19     Hehesheng    add ADC1 DMA config
  */
 
 #ifndef __DMA_CONFIG_H__
@@ -139,6 +140,12 @@ extern "C" {
 #define SPI4_TX_DMA_INSTANCE             DMA2_Stream0
 #define SPI4_TX_DMA_CHANNEL              DMA_CHANNEL_4
 #define SPI4_TX_DMA_IRQ                  DMA2_Stream0_IRQn
+#elif defined(BSP_ADC1_USING_STREAM) && !defined(ADC1_DMA_INSTANCE)
+#define ADC1_DMA_IRQHandler              DMA2_Stream0_IRQHandler
+#define ADC1_DMA_RCC                     RCC_AHB1ENR_DMA2EN
+#define ADC1_DMA_INSTANCE                DMA2_Stream0
+#define ADC1_DMA_CHANNEL                 DMA_CHANNEL_0
+#define ADC1_DMA_IRQ                     DMA2_Stream0_IRQn
 #endif
 
 /* DMA2 stream1 */
@@ -205,6 +212,12 @@ extern "C" {
 #define SPI4_TX_DMA_INSTANCE             DMA2_Stream4
 #define SPI4_TX_DMA_CHANNEL              DMA_CHANNEL_5
 #define SPI4_TX_DMA_IRQ                  DMA2_Stream4_IRQn
+#elif defined(BSP_ADC1_USING_STREAM) && !defined(ADC1_DMA_INSTANCE)
+#define ADC1_DMA_IRQHandler              DMA2_Stream4_IRQHandler
+#define ADC1_DMA_RCC                     RCC_AHB1ENR_DMA2EN
+#define ADC1_DMA_INSTANCE                DMA2_Stream4
+#define ADC1_DMA_CHANNEL                 DMA_CHANNEL_0
+#define ADC1_DMA_IRQ                     DMA2_Stream4_IRQn
 #endif
 
 /* DMA2 stream5 */
@@ -8,6 +8,7 @@
  * 2018-12-05     zylx         first version
  * 2018-12-12     greedyhao    Porting for stm32f7xx
  * 2019-02-01     yuneizhilin   fix the stm32_adc_init function initialization issue
+ * 2026-10-19     Hehesheng    add stream mode by timer trigger and circular DMA
  */
 
 #include <board.h>
@@ -19,6 +20,11 @@
 #define LOG_TAG             "drv.adc"
 #include <drv_log.h>
 
+#if defined(RT_USING_ADC_STREAM) && (defined(SOC_SERIES_STM32F2) || defined(SOC_SERIES_STM32F4))
+#include "drv_dma.h"
+#define ADC_USING_STREAM
+#endif
+
 static ADC_HandleTypeDef adc_config[] =
 {
 #ifdef BSP_USING_ADC1
@@ -38,6 +44,16 @@ struct stm32_adc
 {
     ADC_HandleTypeDef ADC_Handler;
     struct rt_adc_device stm32_adc_device;
+#ifdef ADC_USING_STREAM
+    struct dma_config *dma_config;                      /* RT_NULL if stream isn't supported */
+    TIM_TypeDef *trigger_tim;
+    rt_uint32_t trigger_conv;
+    DMA_HandleTypeDef dma_handle;
+    TIM_HandleTypeDef tim_handle;
+    ADC_InitTypeDef single_init;                        /* the init of single conversion */
+    rt_uint16_t *dma_buffer;                            /* two blocks, RT_NULL if stream is stopped */
+    rt_uint32_t block_samples;
+#endif
 };
 
 static struct stm32_adc stm32_adc_obj[sizeof(adc_config) / sizeof(adc_config[0])];
@@ -146,6 +162,13 @@ static rt_err_t stm32_get_adc_value(struct rt_adc_device *device, rt_uint32_t ch
     RT_ASSERT(device != RT_NULL);
     RT_ASSERT(value != RT_NULL);
 
+#ifdef ADC_USING_STREAM
+    if (((struct stm32_adc *)stm32_adc_handler)->dma_buffer != RT_NULL)
+    {
+        return -RT_EBUSY;
+    }
+#endif
+
     rt_memset(&ADC_ChanConf, 0, sizeof(ADC_ChanConf));
 
 #if defined(SOC_SERIES_STM32F1)
@@ -199,10 +222,304 @@ static rt_err_t stm32_get_adc_value(struct rt_adc_device *device, rt_uint32_t ch
     return RT_EOK;
 }
 
+#ifdef ADC_USING_STREAM
+/* the conversion cycles of one channel in stream mode, sampling and 12 bits */
+#define ADC_STREAM_SAMPLETIME       ADC_SAMPLETIME_56CYCLES
+#define ADC_STREAM_CONV_CYCLES      (56 + 12)
+
+static rt_uint32_t stm32_adc_trigger_clock(TIM_TypeDef *tim)
+{
+    rt_uint32_t clock = 0;
+
+    /* the timer clock is twice of APB clock if APB prescaler isn't 1 */
+    if (tim == TIM2 || tim == TIM3)
+    {
+        if (tim == TIM2)
+            __HAL_RCC_TIM2_CLK_ENABLE();
+        else
+            __HAL_RCC_TIM3_CLK_ENABLE();
+
+        clock = HAL_RCC_GetPCLK1Freq();
+        if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_HCLK_DIV1)
+            clock *= 2;
+    }
+#if defined(TIM8)
+    else if (tim == TIM8)
+    {
+        __HAL_RCC_TIM8_CLK_ENABLE();
+
+        clock = HAL_RCC_GetPCLK2Freq();
+        if ((RCC->CFGR & RCC_CFGR_PPRE2) != (RCC_HCLK_DIV1 << 3))
+            clock *= 2;
+    }
+#endif
+
+    return clock;
+}
+
+static rt_err_t stm32_adc_trigger_init(struct stm32_adc *adc, rt_uint32_t sample_rate)
+{
+    TIM_MasterConfigTypeDef master_config;
+    rt_uint32_t clock, ticks, prescaler;
+
+    clock = stm32_adc_trigger_clock(adc->trigger_tim);
+    ticks = clock / sample_rate;
+    if (ticks < 2)
+    {
+        return -RT_EINVAL;
+    }
+
+    /* all the trigger timers have 16 bits prescaler and counter at least */
+    prescaler = (ticks - 1) / 0x10000;
+    if (prescaler > 0xFFFF)
+    {
+        return -RT_EINVAL;
+    }
+
+    adc->tim_handle.Instance               = adc->trigger_tim;
+    adc->tim_handle.Init.Prescaler         = prescaler;
+    adc->tim_handle.Init.CounterMode       = TIM_COUNTERMODE_UP;
+    adc->tim_handle.Init.Period            = ticks / (prescaler + 1) - 1;
+    adc->tim_handle.Init.ClockDivision     = TIM_CLOCKDIVISION_DIV1;
+    adc->tim_handle.Init.RepetitionCounter = 0;
+    if (HAL_TIM_Base_Init(&adc->tim_handle) != HAL_OK)
+    {
+        return -RT_ERROR;
+    }
+
+    /* trigger ADC by the update event */
+    master_config.MasterOutputTrigger = TIM_TRGO_UPDATE;
+    master_config.MasterSlaveMode     = TIM_MASTERSLAVEMODE_DISABLE;
+    if (HAL_TIMEx_MasterConfigSynchronization(&adc->tim_handle, &master_config) != HAL_OK)
+    {
+        return -RT_ERROR;
+    }
+
+    return RT_EOK;
+}
+
+static rt_err_t stm32_adc_dma_init(struct stm32_adc *adc)
+{
+    DMA_HandleTypeDef *DMA_Handle = &adc->dma_handle;
+    rt_uint32_t tmpreg = 0x00U;
+
+    /* enable DMA clock && Delay after an RCC peripheral clock enabling*/
+    SET_BIT(RCC->AHB1ENR, adc->dma_config->dma_rcc);
+    tmpreg = READ_BIT(RCC->AHB1ENR, adc->dma_config->dma_rcc);
+    UNUSED(tmpreg);   /* To avoid compiler warnings */
+
+    DMA_Handle->Init.Channel             = adc->dma_config->channel;
+    DMA_Handle->Init.Direction           = DMA_PERIPH_TO_MEMORY;
+    DMA_Handle->Init.PeriphInc           = DMA_PINC_DISABLE;
+    DMA_Handle->Init.MemInc              = DMA_MINC_ENABLE;
+    DMA_Handle->Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    DMA_Handle->Init.MemDataAlignment    = DMA_MDATAALIGN_HALFWORD;
+    DMA_Handle->Init.Mode                = DMA_CIRCULAR;
+    DMA_Handle->Init.Priority            = DMA_PRIORITY_HIGH;
+    DMA_Handle->Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+    if (HAL_DMA_Init(DMA_Handle) != HAL_OK)
+    {
+        return -RT_ERROR;
+    }
+
+    HAL_NVIC_SetPriority(adc->dma_config->dma_irq, 0, 0);
+    HAL_NVIC_EnableIRQ(adc->dma_config->dma_irq);
+    /* for the overrun */
+    HAL_NVIC_SetPriority(ADC_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(ADC_IRQn);
+
+    return RT_EOK;
+}
+
+static void stm32_adc_stream_stop(struct stm32_adc *adc)
+{
+    ADC_HandleTypeDef *stm32_adc_handler = &adc->ADC_Handler;
+    rt_uint16_t *dma_buffer;
+    rt_base_t level;
+
+    HAL_TIM_Base_Stop(&adc->tim_handle);
+    HAL_ADC_Stop_DMA(stm32_adc_handler);
+    HAL_NVIC_DisableIRQ(adc->dma_config->dma_irq);
+    HAL_DMA_DeInit(&adc->dma_handle);
+    HAL_TIM_Base_DeInit(&adc->tim_handle);
+
+    /* back to single conversion by software start */
+    stm32_adc_handler->Init = adc->single_init;
+    HAL_ADC_Init(stm32_adc_handler);
+
+    level = rt_hw_interrupt_disable();
+    dma_buffer = adc->dma_buffer;
+    adc->dma_buffer = RT_NULL;
+    rt_hw_interrupt_enable(level);
+
+    if (dma_buffer != RT_NULL)
+    {
+        rt_free(dma_buffer);
+    }
+}
+
+static rt_err_t stm32_adc_stream_start(struct stm32_adc *adc, const struct rt_adc_stream_config *config)
+{
+    ADC_HandleTypeDef *stm32_adc_handler = &adc->ADC_Handler;
+    ADC_ChannelConfTypeDef ADC_ChanConf;
+    rt_uint32_t adc_clock, index;
+    rt_err_t result;
+
+    for (index = 0; index < config->channel_count; index ++)
+    {
+        if (config->channels[index] > 18)
+        {
+            LOG_E("ADC channel must be between 0 and 18.");
+            return -RT_EINVAL;
+        }
+    }
+
+    /* the scans must be finished in the trigger period */
+    adc_clock = HAL_RCC_GetPCLK2Freq() / (((stm32_adc_handler->Init.ClockPrescaler >> 16) + 1) * 2);
+    if ((rt_uint64_t)config->sample_rate * config->channel_count * ADC_STREAM_CONV_CYCLES > adc_clock)
+    {
+        LOG_E("sample rate %d is too high for %d channels", config->sample_rate, config->channel_count);
+        return -RT_EINVAL;
+    }
+
+    adc->block_samples = config->block_size * config->channel_count;
+    adc->dma_buffer = rt_malloc(adc->block_samples * 2 * sizeof(rt_uint16_t));
+    if (adc->dma_buffer == RT_NULL)
+    {
+        return -RT_ENOMEM;
+    }
+
+    /* scan the channels at each trigger, and request DMA after each one */
+    adc->single_init = stm32_adc_handler->Init;
+    stm32_adc_handler->Init.ScanConvMode          = ENABLE;
+    stm32_adc_handler->Init.ContinuousConvMode    = DISABLE;
+    stm32_adc_handler->Init.NbrOfConversion       = config->channel_count;
+    stm32_adc_handler->Init.ExternalTrigConv      = adc->trigger_conv;
+    stm32_adc_handler->Init.ExternalTrigConvEdge  = ADC_EXTERNALTRIGCONVEDGE_RISING;
+    stm32_adc_handler->Init.DMAContinuousRequests = ENABLE;
+    stm32_adc_handler->Init.EOCSelection          = ADC_EOC_SEQ_CONV;
+    if (HAL_ADC_Init(stm32_adc_handler) != HAL_OK)
+    {
+        result = -RT_ERROR;
+        goto _exit;
+    }
+
+    rt_memset(&ADC_ChanConf, 0, sizeof(ADC_ChanConf));
+    ADC_ChanConf.SamplingTime = ADC_STREAM_SAMPLETIME;
+    for (index = 0; index < config->channel_count; index ++)
+    {
+        ADC_ChanConf.Channel = stm32_adc_get_channel(config->channels[index]);
+        ADC_ChanConf.Rank = index + 1;
+        if (HAL_ADC_ConfigChannel(stm32_adc_handler, &ADC_ChanConf) != HAL_OK)
+        {
+            result = -RT_ERROR;
+            goto _exit;
+        }
+    }
+
+    result = stm32_adc_dma_init(adc);
+    if (result != RT_EOK)
+    {
+        goto _exit;
+    }
+    result = stm32_adc_trigger_init(adc, config->sample_rate);
+    if (result != RT_EOK)
+    {
+        goto _exit;
+    }
+
+    /* the half and complete transfer callbacks give the two blocks by turns */
+    if (HAL_ADC_Start_DMA(stm32_adc_handler, (uint32_t *)adc->dma_buffer, adc->block_samples * 2) != HAL_OK ||
+        HAL_TIM_Base_Start(&adc->tim_handle) != HAL_OK)
+    {
+        result = -RT_ERROR;
+        goto _exit;
+    }
+
+    LOG_D("stream %d Hz, %d channels, %d scans in block", config->sample_rate,
+          config->channel_count, config->block_size);
+
+    return RT_EOK;
+
+_exit:
+    LOG_E("stream start failed %d", result);
+    stm32_adc_stream_stop(adc);
+
+    return result;
+}
+
+static rt_err_t stm32_adc_stream(struct rt_adc_device *device, const struct rt_adc_stream_config *config, rt_bool_t start)
+{
+    struct stm32_adc *adc;
+
+    RT_ASSERT(device != RT_NULL);
+    adc = rt_container_of(device, struct stm32_adc, stm32_adc_device);
+
+    if (adc->dma_config == RT_NULL)
+    {
+        return -RT_ENOSYS;
+    }
+
+    if (start)
+    {
+        if (adc->dma_buffer != RT_NULL)
+        {
+            return -RT_EBUSY;
+        }
+        return stm32_adc_stream_start(adc, config);
+    }
+
+    if (adc->dma_buffer != RT_NULL)
+    {
+        stm32_adc_stream_stop(adc);
+    }
+
+    return RT_EOK;
+}
+
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    struct stm32_adc *adc = rt_container_of(hadc, struct stm32_adc, ADC_Handler);
+
+    if (adc->dma_buffer != RT_NULL)
+    {
+        rt_hw_adc_stream_done(&adc->stm32_adc_device, adc->dma_buffer);
+    }
+}
+
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    struct stm32_adc *adc = rt_container_of(hadc, struct stm32_adc, ADC_Handler);
+
+    if (adc->dma_buffer != RT_NULL)
+    {
+        rt_hw_adc_stream_done(&adc->stm32_adc_device, adc->dma_buffer + adc->block_samples);
+    }
+}
+
+void HAL_ADC_ErrorCallback(ADC_HandleTypeDef *hadc)
+{
+    struct stm32_adc *adc = rt_container_of(hadc, struct stm32_adc, ADC_Handler);
+
+    if (adc->dma_buffer == RT_NULL)
+    {
+        return;
+    }
+
+    /* the overrun stops DMA requests, restart it from the first block */
+    HAL_ADC_Stop_DMA(hadc);
+    rt_hw_adc_stream_done(&adc->stm32_adc_device, RT_NULL);
+    HAL_ADC_Start_DMA(hadc, (uint32_t *)adc->dma_buffer, adc->block_samples * 2);
+}
+#endif /* ADC_USING_STREAM */
+
 static const struct rt_adc_ops stm_adc_ops =
 {
     .enabled = stm32_adc_enabled,
     .convert = stm32_get_adc_value,
+#ifdef ADC_USING_STREAM
+    .stream  = stm32_adc_stream,
+#endif
 };
 
 static int stm32_adc_init(void)
@@ -221,6 +538,12 @@ static int stm32_adc_init(void)
         if (stm32_adc_obj[i].ADC_Handler.Instance == ADC1)
         {
             name_buf[3] = '1';
+#ifdef BSP_ADC1_USING_STREAM
+            static struct dma_config adc1_dma = ADC1_DMA_CONFIG;
+            stm32_adc_obj[i].dma_config = &adc1_dma;
+            stm32_adc_obj[i].trigger_tim = ADC1_TRIGGER_TIM;
+            stm32_adc_obj[i].trigger_conv = ADC1_TRIGGER_CONV;
+#endif
         }
 #endif
 #if defined(ADC2)
@@ -234,6 +557,15 @@ static int stm32_adc_init(void)
         {
             name_buf[3] = '3';
         }
+#endif
+#ifdef ADC_USING_STREAM
+        if (stm32_adc_obj[i].dma_config != RT_NULL)
+        {
+            /* the handles are ready to be stopped before stream starts */
+            stm32_adc_obj[i].dma_handle.Instance = stm32_adc_obj[i].dma_config->Instance;
+            stm32_adc_obj[i].tim_handle.Instance = stm32_adc_obj[i].trigger_tim;
+            __HAL_LINKDMA(&stm32_adc_obj[i].ADC_Handler, DMA_Handle, stm32_adc_obj[i].dma_handle);
+        }
 #endif
         if (HAL_ADC_Init(&stm32_adc_obj[i].ADC_Handler) != HAL_OK)
         {
@@ -259,4 +591,40 @@ static int stm32_adc_init(void)
 }
 INIT_BOARD_EXPORT(stm32_adc_init);
 
+#ifdef ADC_USING_STREAM
+void ADC_IRQHandler(void)
+{
+    int i;
+
+    /* enter interrupt */
+    rt_interrupt_enter();
+
+    /* the ADCs share the interrupt, it's for overrun in stream mode */
+    for (i = 0; i < sizeof(stm32_adc_obj) / sizeof(stm32_adc_obj[0]); i++)
+    {
+        if (stm32_adc_obj[i].dma_buffer != RT_NULL)
+        {
+            HAL_ADC_IRQHandler(&stm32_adc_obj[i].ADC_Handler);
+        }
+    }
+
+    /* leave interrupt */
+    rt_interrupt_leave();
+}
+
+#if defined(BSP_ADC1_USING_STREAM)
+void ADC1_DMA_IRQHandler(void)
+{
+    /* enter interrupt */
+    rt_interrupt_enter();
+
+    /* ADC1 is always the first one */
+    HAL_DMA_IRQHandler(&stm32_adc_obj[0].dma_handle);
+
+    /* leave interrupt */
+    rt_interrupt_leave();
+}
+#endif /* BSP_ADC1_USING_STREAM */
+#endif /* ADC_USING_STREAM */
+
 #endif /* BSP_USING_ADC */
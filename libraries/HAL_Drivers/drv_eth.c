@@ -8,6 +8,9 @@
  * 2018-11-19     SummerGift   first version
  * 2018-12-25     zylx         fix some bugs
  * 2019-06-10     SummerGift   optimize PHY state detection process 
+ * 2026-10-19     Hehesheng    notify rx in softirq
+ * 2026-10-19     Hehesheng    add zero-copy rx
+ * 2026-10-19     Hehesheng    lock HAL by mutex, tx in tcpip thread directly
  */
 
 #include "board.h"
@@ -41,6 +44,12 @@ struct rt_stm32_eth
     uint32_t    ETH_Speed;
     /* ETH_Duplex_Mode */
     uint32_t    ETH_Mode;
+#ifdef RT_USING_SOFTIRQ
+    /* the bottom half of rx interrupt */
+    struct rt_softirq rx_softirq;
+#endif
+    /* the lock of HAL between rx and tx */
+    struct rt_mutex hal_lock;
 };
 
 static ETH_DMADescTypeDef *DMARxDscrTab, *DMATxDscrTab;
@@ -48,6 +57,80 @@ static rt_uint8_t *Rx_Buff, *Tx_Buff;
 static  ETH_HandleTypeDef EthHandle;
 static struct rt_stm32_eth stm32_eth_device;
 
+#ifdef BSP_ETH_RX_ZERO_COPY
+#if !LWIP_SUPPORT_CUSTOM_PBUF
+#error "zero-copy rx needs the custom pbuf of lwIP"
+#endif
+
+/*
+ * The rx buffer is passed up to lwIP in place by a custom pbuf. The descriptor
+ * gets a spare buffer from the pool at once, so the ring never runs short of
+ * buffers, and the received buffer goes back to the pool when lwIP frees it.
+ */
+struct eth_rx_pbuf
+{
+    struct pbuf_custom pc;
+    rt_uint8_t buffer[ETH_RX_BUF_SIZE];
+};
+
+/* the number of blocks in rx pool, the ring takes ETH_RXBUFNB of them */
+#define ETH_RX_POOL_NUM     (ETH_RXBUFNB + BSP_ETH_RX_POOL_NUM)
+#define ETH_RX_POOL_SIZE    (ETH_RX_POOL_NUM * (RT_ALIGN(sizeof(struct eth_rx_pbuf), RT_ALIGN_SIZE) + sizeof(rt_uint8_t *)))
+
+static struct rt_mempool eth_rx_pool;
+
+static void eth_rx_pbuf_free(struct pbuf *p)
+{
+    /* the pbuf is the first member of rx buffer */
+    rt_mp_free(p);
+}
+
+/* pass the received frame up in place, RT_NULL if it shall be copied */
+static struct pbuf *eth_rx_pbuf_alloc(uint16_t len)
+{
+    struct eth_rx_pbuf *rx_pbuf, *spare;
+    struct pbuf *p;
+    __IO ETH_DMADescTypeDef *dmarxdesc = EthHandle.RxFrameInfos.FSRxDesc;
+
+    /* the frame over several descriptors is copied */
+    if (EthHandle.RxFrameInfos.SegCount != 1)
+        return RT_NULL;
+
+    spare = (struct eth_rx_pbuf *)rt_mp_alloc(&eth_rx_pool, RT_WAITING_NO);
+    if (spare == RT_NULL)
+    {
+        LOG_D("rx pool is empty");
+        return RT_NULL;
+    }
+
+    rx_pbuf = rt_container_of((rt_uint8_t *)dmarxdesc->Buffer1Addr, struct eth_rx_pbuf, buffer[0]);
+    dmarxdesc->Buffer1Addr = (uint32_t)spare->buffer;
+
+    rx_pbuf->pc.custom_free_function = eth_rx_pbuf_free;
+    p = pbuf_alloced_custom(PBUF_RAW, len, PBUF_REF, &rx_pbuf->pc, rx_pbuf->buffer, ETH_RX_BUF_SIZE);
+    if (p == RT_NULL)
+    {
+        /* the data is kept in the freed block, it's copied out later */
+        rt_mp_free(rx_pbuf);
+    }
+
+    return p;
+}
+
+static void eth_rx_ring_fill(void)
+{
+    struct eth_rx_pbuf *rx_pbuf;
+    rt_uint32_t i;
+
+    for (i = 0; i < ETH_RXBUFNB; i++)
+    {
+        rx_pbuf = (struct eth_rx_pbuf *)rt_mp_alloc(&eth_rx_pool, RT_WAITING_NO);
+        RT_ASSERT(rx_pbuf != RT_NULL);
+        DMARxDscrTab[i].Buffer1Addr = (uint32_t)rx_pbuf->buffer;
+    }
+}
+#endif /* BSP_ETH_RX_ZERO_COPY */
+
 #if defined(ETH_RX_DUMP) || defined(ETH_TX_DUMP)
 #define __is_print(ch) ((unsigned int)((ch) - ' ') < 127u - ' ')
 static void dump_hex(const rt_uint8_t *ptr, rt_size_t buflen)
@@ -114,6 +197,10 @@ static rt_err_t rt_stm32_eth_init(rt_device_t dev)
 
     /* Initialize Rx Descriptors list: Chain Mode  */
     HAL_ETH_DMARxDescListInit(&EthHandle, DMARxDscrTab, Rx_Buff, ETH_RXBUFNB);
+#ifdef BSP_ETH_RX_ZERO_COPY
+    /* the buffers of ring are taken from rx pool */
+    eth_rx_ring_fill();
+#endif
 
     /* ETH interrupt Init */
     HAL_NVIC_SetPriority(ETH_IRQn, 0x07, 0);
@@ -247,10 +334,10 @@ rt_err_t rt_stm32_eth_tx(rt_device_t dev, struct pbuf *p)
     /* TODO Optimize data send speed*/
     LOG_D("transmit frame lenth :%d", framelength);
 
-    /* wait for unlocked */
-    while (EthHandle.Lock == HAL_LOCKED);
-
+    /* the mutex instead of waiting for unlocked, the tx may run at higher priority than rx */
+    rt_mutex_take(&stm32_eth_device.hal_lock, RT_WAITING_FOREVER);
     state = HAL_ETH_TransmitFrame(&EthHandle, framelength);
+    rt_mutex_release(&stm32_eth_device.hal_lock);
     if (state != HAL_OK)
     {
         LOG_E("eth transmit frame faild: %d", state);
@@ -287,9 +374,12 @@ struct pbuf *rt_stm32_eth_rx(rt_device_t dev)
     uint32_t payloadoffset = 0;
     uint32_t byteslefttocopy = 0;
     uint32_t i = 0;
+    rt_bool_t in_place = RT_FALSE;
 
     /* Get received frame */
+    rt_mutex_take(&stm32_eth_device.hal_lock, RT_WAITING_FOREVER);
     state = HAL_ETH_GetReceivedFrame_IT(&EthHandle);
+    rt_mutex_release(&stm32_eth_device.hal_lock);
     if (state != HAL_OK)
     {
         LOG_D("receive frame faild");
@@ -302,17 +392,25 @@ struct pbuf *rt_stm32_eth_rx(rt_device_t dev)
 
     LOG_D("receive frame len : %d", len);
 
+#ifdef ETH_RX_DUMP
+    dump_hex(buffer, len);
+#endif
+
+#ifdef BSP_ETH_RX_ZERO_COPY
     if (len > 0)
+    {
+        p = eth_rx_pbuf_alloc(len);
+        in_place = (p != NULL);
+    }
+#endif
+
+    if (len > 0 && !in_place)
     {
         /* We allocate a pbuf chain of pbufs from the Lwip buffer pool */
         p = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
     }
 
-#ifdef ETH_RX_DUMP
-    dump_hex(buffer, p->tot_len);
-#endif
-
-    if (p != NULL)
+    if (p != NULL && !in_place)
     {
         dmarxdesc = EthHandle.RxFrameInfos.FSRxDesc;
         bufferoffset = 0;
@@ -378,6 +476,21 @@ void ETH_IRQHandler(void)
     rt_interrupt_leave();
 }
 
+#ifdef RT_USING_SOFTIRQ
+static void eth_rx_softirq(void *parameter)
+{
+    rt_err_t result;
+    result = eth_device_ready(&(stm32_eth_device.parent));
+    if (result != RT_EOK)
+        LOG_I("RxCpltCallback err = %d", result);
+}
+
+void HAL_ETH_RxCpltCallback(ETH_HandleTypeDef *heth)
+{
+    /* the rx thread reads all received frames, so the notifications can be merged */
+    rt_softirq_raise(&stm32_eth_device.rx_softirq);
+}
+#else
 void HAL_ETH_RxCpltCallback(ETH_HandleTypeDef *heth)
 {
     rt_err_t result;
@@ -385,6 +498,7 @@ void HAL_ETH_RxCpltCallback(ETH_HandleTypeDef *heth)
     if (result != RT_EOK)
         LOG_I("RxCpltCallback err = %d", result);
 }
+#endif /* RT_USING_SOFTIRQ */
 
 void HAL_ETH_ErrorCallback(ETH_HandleTypeDef *heth)
 {
@@ -575,15 +689,23 @@ static void phy_monitor_thread_entry(void *parameter)
 static int rt_hw_stm32_eth_init(void)
 {
     rt_err_t state = RT_EOK;
+    rt_uint16_t flags;
 
     /* Prepare receive and send buffers */
+#ifdef BSP_ETH_RX_ZERO_COPY
+    Rx_Buff = (rt_uint8_t *)rt_malloc(ETH_RX_POOL_SIZE);
+#else
     Rx_Buff = (rt_uint8_t *)rt_calloc(ETH_RXBUFNB, ETH_MAX_PACKET_SIZE);
+#endif
     if (Rx_Buff == RT_NULL)
     {
         LOG_E("No memory");
         state = -RT_ENOMEM;
         goto __exit;
     }
+#ifdef BSP_ETH_RX_ZERO_COPY
+    rt_mp_init(&eth_rx_pool, "erx", Rx_Buff, ETH_RX_POOL_SIZE, sizeof(struct eth_rx_pbuf));
+#endif
 
     Tx_Buff = (rt_uint8_t *)rt_calloc(ETH_TXBUFNB, ETH_MAX_PACKET_SIZE);
     if (Rx_Buff == RT_NULL)
@@ -632,8 +754,22 @@ static int rt_hw_stm32_eth_init(void)
     stm32_eth_device.parent.eth_rx     = rt_stm32_eth_rx;
     stm32_eth_device.parent.eth_tx     = rt_stm32_eth_tx;
 
+#ifdef RT_USING_SOFTIRQ
+    rt_softirq_init(&stm32_eth_device.rx_softirq, "e0", eth_rx_softirq, RT_NULL, RT_SOFTIRQ_PRIORITIES - 1);
+#endif
+
+    rt_mutex_init(&stm32_eth_device.hal_lock, "e0", RT_IPC_FLAG_FIFO);
+
     /* register eth device */
-    state = eth_device_init(&(stm32_eth_device.parent), "e0");
+    flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP;
+#if LWIP_IGMP
+    flags |= NETIF_FLAG_IGMP;
+#endif
+#ifdef ETHIF_TX_DIRECT
+    /* the tx copies the frame and waits only for the HAL lock, it's called in tcpip thread */
+    flags |= ETHIF_TX_DIRECT;
+#endif
+    state = eth_device_init_with_flag(&(stm32_eth_device.parent), "e0", flags);
     if (RT_EOK == state)
     {
         LOG_D("emac device init success");
@@ -666,6 +802,9 @@ __exit:
     {
         if (Rx_Buff)
         {
+#ifdef BSP_ETH_RX_ZERO_COPY
+            rt_mp_detach(&eth_rx_pool);
+#endif
             rt_free(Rx_Buff);
         }
 
@@ -8,6 +8,7 @@
  * 2018-11-5      SummerGift   first version
  * 2018-12-11     greedyhao    Porting for stm32f7xx
  * 2019-01-03     zylx         modify DMA initialization and spixfer function
+ * 2026-10-19     Hehesheng    add asynchronous DMA transfer
  */
 
 #include "board.h"
@@ -246,6 +247,23 @@ static rt_err_t stm32_spi_init(struct stm32_spi *spi_drv, struct rt_spi_configur
     return RT_EOK;
 }
 
+/* the DMA can't access the CCM data RAM, the heap may be extended there */
+static rt_bool_t spi_dma_reachable(struct rt_spi_message *message)
+{
+#if defined(CCMDATARAM_BASE) && defined(CCMDATARAM_END)
+    rt_ubase_t send_addr = (rt_ubase_t)message->send_buf;
+    rt_ubase_t recv_addr = (rt_ubase_t)message->recv_buf;
+
+    if ((send_addr >= CCMDATARAM_BASE && send_addr <= CCMDATARAM_END) ||
+        (recv_addr >= CCMDATARAM_BASE && recv_addr <= CCMDATARAM_END))
+    {
+        return RT_FALSE;
+    }
+#endif
+
+    return RT_TRUE;
+}
+
 static rt_uint32_t spixfer(struct rt_spi_device *device, struct rt_spi_message *message)
 {
     HAL_StatusTypeDef state;
@@ -253,6 +271,7 @@ static rt_uint32_t spixfer(struct rt_spi_device *device, struct rt_spi_message *
     rt_uint16_t send_length;
     rt_uint8_t *recv_buf;
     const rt_uint8_t *send_buf;
+    rt_uint8_t dma_flag;
 
     RT_ASSERT(device != RT_NULL);
     RT_ASSERT(device->bus != RT_NULL);
@@ -268,6 +287,9 @@ static rt_uint32_t spixfer(struct rt_spi_device *device, struct rt_spi_message *
         HAL_GPIO_WritePin(cs->GPIOx, cs->GPIO_Pin, GPIO_PIN_RESET);
     }
 
+    /* the buffers out of DMA reach are transferred by polling */
+    dma_flag = spi_dma_reachable(message) ? spi_drv->spi_dma_flag : 0;
+
     LOG_D("%s transfer prepare and start", spi_drv->config->bus_name);
     LOG_D("%s sendbuf: %X, recvbuf: %X, length: %d",
           spi_drv->config->bus_name,
@@ -299,7 +321,7 @@ static rt_uint32_t spixfer(struct rt_spi_device *device, struct rt_spi_message *
         /* start once data exchange in DMA mode */
         if (message->send_buf && message->recv_buf)
         {
-            if ((spi_drv->spi_dma_flag & SPI_USING_TX_DMA_FLAG) && (spi_drv->spi_dma_flag & SPI_USING_RX_DMA_FLAG))
+            if ((dma_flag & SPI_USING_TX_DMA_FLAG) && (dma_flag & SPI_USING_RX_DMA_FLAG))
             {
                 state = HAL_SPI_TransmitReceive_DMA(spi_handle, (uint8_t *)send_buf, (uint8_t *)recv_buf, send_length);
             }
@@ -310,7 +332,7 @@ static rt_uint32_t spixfer(struct rt_spi_device *device, struct rt_spi_message *
         }
         else if (message->send_buf)
         {
-            if (spi_drv->spi_dma_flag & SPI_USING_TX_DMA_FLAG)
+            if (dma_flag & SPI_USING_TX_DMA_FLAG)
             {
                 state = HAL_SPI_Transmit_DMA(spi_handle, (uint8_t *)send_buf, send_length);
             }
@@ -322,7 +344,7 @@ static rt_uint32_t spixfer(struct rt_spi_device *device, struct rt_spi_message *
         else
         {
             memset((uint8_t *)recv_buf, 0xff, send_length);
-            if (spi_drv->spi_dma_flag & SPI_USING_RX_DMA_FLAG)
+            if (dma_flag & SPI_USING_RX_DMA_FLAG)
             {
                 state = HAL_SPI_Receive_DMA(spi_handle, (uint8_t *)recv_buf, send_length);
             }
@@ -375,6 +397,143 @@ static const struct rt_spi_ops stm_spi_ops =
     .xfer = spixfer,
 };
 
+#ifdef RT_SPI_USING_ASYNC
+/* start the DMA transfer of next piece of the message */
+static HAL_StatusTypeDef spixfer_dma_next(struct stm32_spi *spi_drv)
+{
+    struct rt_spi_message *message = spi_drv->xfer_message;
+    SPI_HandleTypeDef *spi_handle = &spi_drv->handle;
+    rt_size_t length;
+    rt_uint8_t *recv_buf;
+    const rt_uint8_t *send_buf;
+
+    /* the HAL library use uint16 to save the data length */
+    length = message->length - spi_drv->xfer_offset;
+    if (length > 65535)
+    {
+        length = 65535;
+    }
+    spi_drv->xfer_length = length;
+
+    send_buf = (const rt_uint8_t *)message->send_buf + spi_drv->xfer_offset;
+    recv_buf = (rt_uint8_t *)message->recv_buf + spi_drv->xfer_offset;
+
+    if (message->send_buf && message->recv_buf)
+    {
+        return HAL_SPI_TransmitReceive_DMA(spi_handle, (uint8_t *)send_buf, (uint8_t *)recv_buf, length);
+    }
+    else if (message->send_buf)
+    {
+        return HAL_SPI_Transmit_DMA(spi_handle, (uint8_t *)send_buf, length);
+    }
+    else
+    {
+        memset((uint8_t *)recv_buf, 0xff, length);
+        return HAL_SPI_Receive_DMA(spi_handle, (uint8_t *)recv_buf, length);
+    }
+}
+
+static rt_err_t spixfer_start(struct rt_spi_device *device, struct rt_spi_message *message)
+{
+    RT_ASSERT(device != RT_NULL);
+    RT_ASSERT(device->bus != RT_NULL);
+    RT_ASSERT(message != RT_NULL);
+
+    struct stm32_spi *spi_drv =  rt_container_of(device->bus, struct stm32_spi, spi_bus);
+    struct stm32_hw_spi_cs *cs = device->parent.user_data;
+
+    /* let the bus transfer it by spixfer */
+    if (!spi_dma_reachable(message))
+    {
+        return -RT_ENOSYS;
+    }
+
+    if (message->cs_take)
+    {
+        HAL_GPIO_WritePin(cs->GPIOx, cs->GPIO_Pin, GPIO_PIN_RESET);
+    }
+
+    spi_drv->xfer_device = device;
+    spi_drv->xfer_message = message;
+    spi_drv->xfer_offset = 0;
+
+    if (spixfer_dma_next(spi_drv) != HAL_OK)
+    {
+        LOG_I("spi transfer error");
+        spi_drv->xfer_message = RT_NULL;
+        spi_drv->handle.State = HAL_SPI_STATE_READY;
+        HAL_GPIO_WritePin(cs->GPIOx, cs->GPIO_Pin, GPIO_PIN_SET);
+        return -RT_EIO;
+    }
+
+    return RT_EOK;
+}
+
+/* the DMA transfer is done, continue the message or report it to the bus */
+static void spixfer_dma_done(SPI_HandleTypeDef *hspi, rt_err_t result)
+{
+    struct stm32_spi *spi_drv =  rt_container_of(hspi, struct stm32_spi, handle);
+    struct rt_spi_message *message = spi_drv->xfer_message;
+    struct stm32_hw_spi_cs *cs;
+
+    /* the synchronous transfer in DMA mode */
+    if (message == RT_NULL)
+    {
+        return;
+    }
+
+    if (result == RT_EOK)
+    {
+        spi_drv->xfer_offset += spi_drv->xfer_length;
+        if (spi_drv->xfer_offset < message->length)
+        {
+            if (spixfer_dma_next(spi_drv) == HAL_OK)
+            {
+                return;
+            }
+            result = -RT_EIO;
+        }
+    }
+
+    cs = spi_drv->xfer_device->parent.user_data;
+    if (message->cs_release || result != RT_EOK)
+    {
+        HAL_GPIO_WritePin(cs->GPIOx, cs->GPIO_Pin, GPIO_PIN_SET);
+    }
+    spi_drv->xfer_message = RT_NULL;
+
+    rt_spi_bus_xfer_done(&spi_drv->spi_bus, result);
+}
+
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    spixfer_dma_done(hspi, RT_EOK);
+}
+
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    spixfer_dma_done(hspi, RT_EOK);
+}
+
+void HAL_SPI_RxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    spixfer_dma_done(hspi, RT_EOK);
+}
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi)
+{
+    spixfer_dma_done(hspi, -RT_EIO);
+}
+
+/* the bus with both of TX and RX DMA transfers the queued requests asynchronously */
+static const struct rt_spi_ops stm_spi_dma_ops =
+{
+    .configure = spi_configure,
+    .xfer = spixfer,
+    .xfer_start = spixfer_start,
+};
+#endif /* RT_SPI_USING_ASYNC */
+
 static int rt_hw_spi_bus_init(void)
 {
     rt_err_t result;
@@ -460,7 +619,16 @@ static int rt_hw_spi_bus_init(void)
             }
         }
 
-        result = rt_spi_bus_register(&spi_bus_obj[i].spi_bus, spi_config[i].bus_name, &stm_spi_ops);
+#ifdef RT_SPI_USING_ASYNC
+        if ((spi_bus_obj[i].spi_dma_flag & SPI_USING_TX_DMA_FLAG) && (spi_bus_obj[i].spi_dma_flag & SPI_USING_RX_DMA_FLAG))
+        {
+            result = rt_spi_bus_register(&spi_bus_obj[i].spi_bus, spi_config[i].bus_name, &stm_spi_dma_ops);
+        }
+        else
+#endif
+        {
+            result = rt_spi_bus_register(&spi_bus_obj[i].spi_bus, spi_config[i].bus_name, &stm_spi_ops);
+        }
         RT_ASSERT(result == RT_EOK);
 
         LOG_D("%s bus init done", spi_config[i].bus_name);
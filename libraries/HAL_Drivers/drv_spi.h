@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-11-5      SummerGift   first version
+ * 2026-10-19     Hehesheng    add asynchronous DMA transfer
  */
 
 #ifndef __DRV_SPI_H_
@@ -57,6 +58,14 @@ struct stm32_spi
     
     rt_uint8_t spi_dma_flag;
     struct rt_spi_bus spi_bus;
+
+#ifdef RT_SPI_USING_ASYNC
+    /* the message in asynchronous transfer */
+    struct rt_spi_device *xfer_device;
+    struct rt_spi_message *xfer_message;
+    rt_size_t xfer_offset;
+    rt_uint16_t xfer_length;
+#endif
 };
 
 #endif /*__DRV_SPI_H_ */
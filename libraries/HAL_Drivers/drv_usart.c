@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-10-30     SummerGift   first version
+ * 2026-10-19     Hehesheng    reset dma rx index when the fifo is configured
  */
 
 #include "board.h"
@@ -156,6 +157,14 @@ static rt_err_t stm32_control(struct rt_serial_device *serial, int cmd, void *ar
     {
     /* disable interrupt */
     case RT_DEVICE_CTRL_CLR_INT:
+#ifdef RT_SERIAL_USING_DMA
+        /* stop the tx DMA, the rx is kept */
+        if (ctrl_arg == RT_DEVICE_FLAG_DMA_TX)
+        {
+            HAL_UART_AbortTransmit(&(uart->handle));
+            break;
+        }
+#endif
         /* disable rx irq */
         NVIC_DisableIRQ(uart->config->irq_type);
         /* disable interrupt */
@@ -722,6 +731,8 @@ static void stm32_dma_config(struct rt_serial_device *serial, rt_ubase_t flag)
     if (flag == RT_DEVICE_FLAG_DMA_RX)
     {
         rx_fifo = (struct rt_serial_rx_fifo *)serial->serial_rx;
+        /* the fifo size may be changed before open */
+        uart->dma_rx.last_index = 0;
         /* Start DMA transfer */
         if (HAL_UART_Receive_DMA(&(uart->handle), rx_fifo->buffer, serial->config.bufsz) != HAL_OK)
         {
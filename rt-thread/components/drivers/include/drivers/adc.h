@@ -7,23 +7,59 @@
  * Date           Author       Notes
  * 2018-05-07     aozima       the first version
  * 2018-11-16     Ernest Chen  add finsh command and update adc function
+ * 2026-10-19     Hehesheng    add continuous acquisition (stream) mode
  */
 
 #ifndef __ADC_H__
 #define __ADC_H__
 #include <rtthread.h>
 
+#define RT_ADC_STREAM_CHANNELS_MAX      16
+
+struct rt_adc_stream_config
+{
+    rt_uint32_t sample_rate;                            /* the scans per second */
+    rt_uint16_t block_size;                             /* the scans in one block */
+    rt_uint8_t  channel_count;
+    rt_uint8_t  channels[RT_ADC_STREAM_CHANNELS_MAX];   /* the scan sequence */
+};
+
+struct rt_adc_stream_stats
+{
+    rt_uint32_t blocks;                                 /* the blocks delivered by driver */
+    rt_uint32_t overruns;                               /* the blocks dropped or lost by hardware */
+    rt_uint32_t samples_read;                           /* the samples read by application */
+};
+
+struct rt_adc_stream
+{
+    struct rt_adc_stream_config config;
+    rt_uint32_t block_samples;                          /* the samples in one block */
+    rt_uint16_t *ring;                                  /* RT_ADC_STREAM_BLOCKS blocks */
+    rt_uint32_t head;                                   /* the blocks put by driver */
+    rt_uint32_t tail;                                   /* the blocks taken by reader */
+    rt_uint32_t offset;                                 /* the samples read in tail block */
+    rt_uint8_t running;
+
+    struct rt_adc_stream_stats stats;
+};
+
 struct rt_adc_device;
 struct rt_adc_ops
 {
     rt_err_t (*enabled)(struct rt_adc_device *device, rt_uint32_t channel, rt_bool_t enabled);
     rt_err_t (*convert)(struct rt_adc_device *device, rt_uint32_t channel, rt_uint32_t *value);
+    /* start or stop the stream, it's optional */
+    rt_err_t (*stream)(struct rt_adc_device *device, const struct rt_adc_stream_config *config, rt_bool_t start);
 };
 
 struct rt_adc_device
 {
     struct rt_device parent;
     const struct rt_adc_ops *ops;
+#ifdef RT_USING_ADC_STREAM
+    struct rt_adc_stream stream;
+#endif
 };
 typedef struct rt_adc_device *rt_adc_device_t;
 
@@ -31,6 +67,10 @@ typedef enum
 {
     RT_ADC_CMD_ENABLE,
     RT_ADC_CMD_DISABLE,
+    RT_ADC_CMD_STREAM_CONFIG,                           /* args is struct rt_adc_stream_config * */
+    RT_ADC_CMD_STREAM_START,
+    RT_ADC_CMD_STREAM_STOP,
+    RT_ADC_CMD_STREAM_GET_STATS,                        /* args is struct rt_adc_stream_stats * */
 } rt_adc_cmd_t;
 
 rt_err_t rt_hw_adc_register(rt_adc_device_t adc,const char *name, const struct rt_adc_ops *ops, const void *user_data);
@@ -39,4 +79,8 @@ rt_uint32_t rt_adc_read(rt_adc_device_t dev, rt_uint32_t channel);
 rt_err_t rt_adc_enable(rt_adc_device_t dev, rt_uint32_t channel);
 rt_err_t rt_adc_disable(rt_adc_device_t dev, rt_uint32_t channel);
 
+#ifdef RT_USING_ADC_STREAM
+void rt_hw_adc_stream_done(rt_adc_device_t dev, const rt_uint16_t *samples);
+#endif
+
 #endif /* __ADC_H__ */
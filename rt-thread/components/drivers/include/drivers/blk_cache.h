@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#ifndef __BLK_CACHE_H__
+#define __BLK_CACHE_H__
+
+#include <rtthread.h>
+#include <ipc/workqueue.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RT_BLK_CACHE_CTRL_GET_STATS     0x20            /**< get the statistics of cache */
+#define RT_BLK_CACHE_CTRL_RESET_STATS   0x21            /**< reset the statistics of cache */
+
+struct rt_blk_cache_stats
+{
+    rt_uint32_t hits;                                   /* the sectors read from cache */
+    rt_uint32_t misses;                                 /* the sectors read from device */
+    rt_uint32_t read_ahead;                             /* the sectors read ahead */
+    rt_uint32_t writes;                                 /* the sectors written to cache */
+    rt_uint32_t write_backs;                            /* the sectors written back to device */
+    rt_uint32_t bypass;                                 /* the sectors of large transfer */
+    rt_uint32_t dirty;                                  /* the dirty sectors now */
+};
+
+struct rt_blk_cache_entry
+{
+    rt_list_t list;                                     /* the node in LRU list */
+    rt_uint32_t sector;
+    rt_uint8_t valid;
+    rt_uint8_t dirty;
+    rt_uint8_t *data;
+};
+
+struct rt_blk_cache
+{
+    struct rt_device parent;
+
+    rt_device_t device;                                 /* the cached block device */
+    struct rt_device_blk_geometry geometry;
+
+    struct rt_mutex lock;
+    rt_list_t lru;                                      /* the most recently used is the first */
+    struct rt_blk_cache_entry *entries;
+    rt_uint32_t capacity;                               /* the number of cached sectors */
+    rt_uint32_t next_sector;                            /* the sector after the last read */
+
+    struct rt_timer flush_timer;
+    struct rt_work flush_work;
+    struct rt_work ahead_work;
+
+    struct rt_blk_cache_stats stats;
+    rt_list_t node;                                     /* the node in cache list */
+};
+typedef struct rt_blk_cache *rt_blk_cache_t;
+
+rt_blk_cache_t rt_blk_cache_create(const char *name, const char *device_name, rt_uint32_t capacity);
+rt_err_t rt_blk_cache_delete(rt_blk_cache_t cache);
+rt_err_t rt_blk_cache_sync(rt_blk_cache_t cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BLK_CACHE_H__ */
@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author		Notes
  * 2011-07-25     weety		first version
+ * 2026-10-19     Hehesheng	add block request queue
  */
 
 #ifndef __CORE_H__
@@ -15,6 +16,9 @@
 #include <drivers/mmcsd_host.h>
 #include <drivers/mmcsd_card.h>
 #include <drivers/mmcsd_cmd.h>
+#ifdef RT_MMCSD_USING_BLK_QUEUE
+#include <ipc/completion.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -238,6 +242,53 @@ int rt_mmcsd_blk_init(void);
 rt_int32_t rt_mmcsd_blk_probe(struct rt_mmcsd_card *card);
 void rt_mmcsd_blk_remove(struct rt_mmcsd_card *card);
 
+#ifdef RT_MMCSD_USING_BLK_QUEUE
+#define RT_MMCSD_BLK_CTRL_GET_STATS     0x20            /**< get the statistics of request queue */
+
+struct rt_mmcsd_blk_request
+{
+    rt_list_t list;
+    rt_uint32_t sector;                 /* the sector in card */
+    rt_uint32_t count;                  /* the number of sectors */
+    void *buffer;
+    rt_uint8_t dir;                     /* 0 is read, 1 is write */
+    rt_uint32_t order;                  /* the order of submission */
+    rt_tick_t stamp;                    /* the tick of submission */
+    struct mmcsd_blk_queue *queue;      /* the queue submitted to */
+
+    /* invoked in queue thread, or the request is waited by rt_mmcsd_blk_request_wait */
+    void (*done)(struct rt_mmcsd_blk_request *request);
+    void *user_data;
+
+    struct rt_completion completion;
+    rt_err_t result;
+};
+
+struct rt_mmcsd_blk_stats
+{
+    rt_uint32_t requests;               /* the requests submitted */
+    rt_uint32_t merged;                 /* the requests merged to the previous one */
+    rt_uint32_t transfers;              /* the multiple block transfers */
+    rt_uint32_t sectors;                /* the sectors transferred */
+    rt_uint32_t pre_erases;             /* the pre-erase hints of write */
+    rt_uint32_t errors;
+    rt_uint16_t depth;                  /* the requests in queue now */
+    rt_uint16_t depth_max;
+    rt_uint32_t latency_sum;            /* the ticks from submission to completion */
+    rt_uint32_t latency_max;
+};
+
+void rt_mmcsd_blk_request_init(struct rt_mmcsd_blk_request *request,
+                               rt_off_t    pos,
+                               void       *buffer,
+                               rt_size_t   count,
+                               rt_uint8_t  dir,
+                               void (*done)(struct rt_mmcsd_blk_request *request),
+                               void       *user_data);
+rt_err_t rt_mmcsd_blk_submit(rt_device_t dev, struct rt_mmcsd_blk_request *request);
+rt_err_t rt_mmcsd_blk_request_wait(struct rt_mmcsd_blk_request *request, rt_int32_t timeout);
+#endif /* RT_MMCSD_USING_BLK_QUEUE */
+
 
 #ifdef __cplusplus
 }
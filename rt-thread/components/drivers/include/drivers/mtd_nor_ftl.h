@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#ifndef __MTD_NOR_FTL_H__
+#define __MTD_NOR_FTL_H__
+
+#include <rtthread.h>
+#include <ipc/workqueue.h>
+#include <drivers/mtd_nor.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RT_NOR_FTL_CTRL_GET_STATS       0x20            /**< get the statistics of FTL */
+
+struct rt_nor_ftl_stats
+{
+    rt_uint32_t host_reads;                             /* the sectors read by host */
+    rt_uint32_t host_writes;                            /* the sectors written by host */
+    rt_uint32_t page_writes;                            /* the pages programmed, including GC */
+    rt_uint32_t gc_copies;                              /* the pages moved by GC */
+    rt_uint32_t erases;                                 /* the segments erased */
+    rt_uint32_t wear_moves;                             /* the segments moved by wear levelling */
+    rt_uint32_t erase_min;                              /* the minimal erase count of segments */
+    rt_uint32_t erase_max;                              /* the maximal erase count of segments */
+    rt_uint32_t free_segments;                          /* the erased segments now */
+};
+
+struct rt_nor_ftl_segment
+{
+    rt_uint32_t seq;                                    /* the order it's opened, 0 if it isn't used */
+    rt_uint32_t erase_count;
+    rt_uint16_t valid;                                  /* the pages mapped to sector */
+    rt_uint8_t state;
+    rt_uint8_t reserved;
+};
+
+struct rt_nor_ftl
+{
+    struct rt_device parent;
+
+    struct rt_mtd_nor_device *mtd;
+    rt_uint32_t base;                                   /* the offset of first segment in MTD */
+    rt_uint32_t segment_size;
+    rt_uint16_t segment_count;
+    rt_uint16_t pages;                                  /* the pages in segment, the first one is header */
+    rt_uint32_t sector_count;                           /* the sectors exported */
+
+    struct rt_mutex lock;
+    rt_uint16_t *map;                                   /* the page of sector, 0 if it isn't written */
+    struct rt_nor_ftl_segment *segments;
+    rt_uint16_t free_count;                             /* the segments not used */
+    rt_uint16_t active;                                 /* the segment for writing */
+    rt_uint16_t active_page;                            /* the next page in active segment */
+    rt_uint8_t gc_running;
+    rt_uint8_t blank;                                   /* no segment was formatted on mount */
+    rt_uint32_t seq;
+    rt_uint8_t *buffer;                                 /* one page for GC */
+    rt_uint32_t *tags;                                  /* the tags of one segment */
+
+    struct rt_work gc_work;
+
+    struct rt_nor_ftl_stats stats;
+    rt_list_t node;                                     /* the node in FTL list */
+};
+typedef struct rt_nor_ftl *rt_nor_ftl_t;
+
+rt_nor_ftl_t rt_nor_ftl_create(const char *name, const char *mtd_name);
+rt_err_t rt_nor_ftl_delete(rt_nor_ftl_t ftl);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MTD_NOR_FTL_H__ */
@@ -9,6 +9,9 @@
  * 2012-05-28     bernard      change interfaces
  * 2013-02-20     bernard      use RT_SERIAL_RB_BUFSZ to define
  *                             the size of ring buffer.
+ * 2026-10-19     Hehesheng    add rx softirq
+ * 2026-10-19     Hehesheng    add rx statistics and peek span
+ * 2026-10-19     Hehesheng    queue DMA tx data in a byte ring
  */
 
 #ifndef __SERIAL_H__
@@ -58,6 +61,14 @@
 #define RT_SERIAL_RB_BUFSZ              64
 #endif
 
+#ifndef RT_SERIAL_TX_DMA_BUFSZ
+#define RT_SERIAL_TX_DMA_BUFSZ          256
+#endif
+
+#ifndef RT_SERIAL_SOFTIRQ_PRIORITY
+#define RT_SERIAL_SOFTIRQ_PRIORITY      0       /* the priority of rx softirq */
+#endif
+
 #define RT_SERIAL_EVENT_RX_IND          0x01    /* Rx indication */
 #define RT_SERIAL_EVENT_TX_DONE         0x02    /* Tx complete   */
 #define RT_SERIAL_EVENT_RX_DMADONE      0x03    /* Rx DMA transfer done */
@@ -70,6 +81,10 @@
 #define RT_SERIAL_RX_INT                0x01
 #define RT_SERIAL_TX_INT                0x02
 
+#define RT_SERIAL_CTRL_SET_RX_BUFSZ     0x20    /* set rx fifo size before open */
+#define RT_SERIAL_CTRL_GET_RX_STATS     0x21    /* get rx fifo statistics */
+#define RT_SERIAL_CTRL_GET_TX_STATS     0x22    /* get DMA tx statistics */
+
 #define RT_SERIAL_ERR_OVERRUN           0x01
 #define RT_SERIAL_ERR_FRAMING           0x02
 #define RT_SERIAL_ERR_PARITY            0x03
@@ -106,6 +121,15 @@ struct serial_configure
 /*
  * Serial FIFO mode 
  */
+struct rt_serial_rx_stats
+{
+    rt_uint32_t received;               /* the received bytes */
+    rt_uint32_t overflows;              /* the times of fifo overflow */
+    rt_uint32_t lost;                   /* the bytes overwritten before read */
+    rt_uint16_t peak;                   /* the peak bytes in fifo */
+    rt_uint16_t bufsz;                  /* the size of fifo */
+};
+
 struct rt_serial_rx_fifo
 {
     /* software fifo */
@@ -114,6 +138,11 @@ struct rt_serial_rx_fifo
     rt_uint16_t put_index, get_index;
 
     rt_bool_t is_full;
+
+    /* the overflows when the span is peeked */
+    rt_uint32_t peek_overflows;
+
+    struct rt_serial_rx_stats stats;
 };
 
 struct rt_serial_tx_fifo
@@ -129,10 +158,30 @@ struct rt_serial_rx_dma
     rt_bool_t activated;
 };
 
+struct rt_serial_tx_stats
+{
+    rt_uint32_t written;                /* the written bytes */
+    rt_uint32_t bursts;                 /* the DMA transfers */
+    rt_uint32_t full;                   /* the times of writer finding the ring full */
+    rt_uint32_t dropped;                /* the bytes dropped by failed DMA transfer */
+};
+
 struct rt_serial_tx_dma
 {
     rt_bool_t activated;
-    struct rt_data_queue data_queue;
+
+    /* the bytes in [get_index, get_index + count) are pending, the first
+     * burst bytes of them are in DMA transfer */
+    rt_uint8_t *buffer;
+    rt_uint16_t bufsz;
+    rt_uint16_t get_index;
+    rt_uint16_t count;
+    rt_uint16_t burst;
+
+    /* the writers waiting for free space */
+    rt_wqueue_t wait_queue;
+
+    struct rt_serial_tx_stats stats;
 };
 
 struct rt_serial_device
@@ -144,6 +193,10 @@ struct rt_serial_device
 
     void *serial_rx;
     void *serial_tx;
+
+#ifdef RT_USING_SOFTIRQ
+    struct rt_softirq rx_softirq;       /* the bottom half of rx interrupt */
+#endif
 };
 typedef struct rt_serial_device rt_serial_t;
 
@@ -163,6 +216,9 @@ struct rt_uart_ops
 
 void rt_hw_serial_isr(struct rt_serial_device *serial, int event);
 
+rt_size_t rt_serial_rx_peek(struct rt_serial_device *serial, rt_uint8_t **span);
+rt_size_t rt_serial_rx_consume(struct rt_serial_device *serial, rt_size_t length);
+
 rt_err_t rt_hw_serial_register(struct rt_serial_device *serial,
                                const char              *name,
                                rt_uint32_t              flag,
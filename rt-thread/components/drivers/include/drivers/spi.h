@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2012-11-23     Bernard      Add extern "C"
+ * 2026-10-19     Hehesheng    add asynchronous transfer queue
  */
 
 #ifndef __SPI_H__
@@ -14,6 +15,11 @@
 #include <stdlib.h>
 #include <rtthread.h>
 
+#ifdef RT_SPI_USING_ASYNC
+#include <ipc/completion.h>
+#include <ipc/workqueue.h>
+#endif
+
 #ifdef __cplusplus
 extern "C"{
 #endif
@@ -80,6 +86,7 @@ struct rt_spi_configuration
 };
 
 struct rt_spi_ops;
+struct rt_spi_request;
 struct rt_spi_bus
 {
     struct rt_device parent;
@@ -88,6 +95,15 @@ struct rt_spi_bus
 
     struct rt_mutex lock;
     struct rt_spi_device *owner;
+
+#ifdef RT_SPI_USING_ASYNC
+    rt_list_t async_devices;                /* the devices with queued requests */
+    struct rt_spi_request *async_current;   /* the request in transfer */
+    rt_uint16_t async_hold;                 /* the bus is taken by thread */
+    rt_uint16_t async_defer;                /* the current request waits for async_work */
+    struct rt_completion async_idle;
+    struct rt_work async_work;              /* configure the bus out of ISR */
+#endif
 };
 
 /**
@@ -97,6 +113,10 @@ struct rt_spi_ops
 {
     rt_err_t (*configure)(struct rt_spi_device *device, struct rt_spi_configuration *configuration);
     rt_uint32_t (*xfer)(struct rt_spi_device *device, struct rt_spi_message *message);
+    /* start the transfer of message and return, the driver shall invoke
+     * rt_spi_bus_xfer_done when it's done, or return -RT_ENOSYS to transfer
+     * the message by xfer. It's optional. */
+    rt_err_t (*xfer_start)(struct rt_spi_device *device, struct rt_spi_message *message);
 };
 
 /**
@@ -109,7 +129,32 @@ struct rt_spi_device
 
     struct rt_spi_configuration config;
     void   *user_data;
+
+#ifdef RT_SPI_USING_ASYNC
+    rt_list_t async_queue;                  /* the queued requests */
+    rt_list_t async_node;                   /* the node in async_devices of bus */
+#endif
+};
+
+#ifdef RT_SPI_USING_ASYNC
+/**
+ * SPI asynchronous request, a message list queued on SPI bus
+ */
+struct rt_spi_request
+{
+    rt_list_t list;
+    struct rt_spi_device *device;
+    struct rt_spi_message *message;         /* the message list */
+    struct rt_spi_message *current;         /* the message in transfer, or the failed one */
+
+    /* invoked when the request is done, it may be in ISR */
+    void (*done)(struct rt_spi_request *request);
+    void *user_data;
+
+    struct rt_completion completion;
+    rt_err_t result;
 };
+#endif
 
 struct rt_qspi_message
 {
@@ -252,6 +297,56 @@ rt_size_t rt_spi_transfer(struct rt_spi_device *device,
 struct rt_spi_message *rt_spi_transfer_message(struct rt_spi_device  *device,
                                                struct rt_spi_message *message);
 
+#ifdef RT_SPI_USING_ASYNC
+/**
+ * This function initializes an asynchronous SPI request.
+ *
+ * @param request the request to be initialized
+ * @param device the SPI device attached to SPI bus
+ * @param message the message list to be transmitted to SPI device
+ * @param done the callback when the request is done, RT_NULL to wait for it
+ *        by rt_spi_request_wait
+ * @param user_data the user data of request
+ */
+void rt_spi_request_init(struct rt_spi_request *request,
+                         struct rt_spi_device  *device,
+                         struct rt_spi_message *message,
+                         void (*done)(struct rt_spi_request *request),
+                         void                  *user_data);
+
+/**
+ * This function queues a request on SPI bus and returns immediately. The
+ * requests of the devices on same bus are transferred in turn, and the
+ * messages of one request are chained without releasing the bus.
+ *
+ * @param request the initialized request
+ *
+ * @return RT_EOK on queued, -RT_ENOSYS if the bus doesn't support it.
+ */
+rt_err_t rt_spi_transfer_async(struct rt_spi_request *request);
+
+/**
+ * This function waits for the request without done callback. On timeout, the
+ * request not started yet is removed from the queue, and the request in
+ * transfer is waited until it's done.
+ *
+ * @param request the queued request
+ * @param timeout the waiting time
+ *
+ * @return the result of request, -RT_ETIMEOUT if it's removed on timeout.
+ */
+rt_err_t rt_spi_request_wait(struct rt_spi_request *request, rt_int32_t timeout);
+
+/**
+ * This function is invoked by SPI bus driver when the transfer started by
+ * xfer_start is done.
+ *
+ * @param bus the SPI bus
+ * @param result RT_EOK on successful, others on failed
+ */
+void rt_spi_bus_xfer_done(struct rt_spi_bus *bus, rt_err_t result);
+#endif
+
 rt_inline rt_size_t rt_spi_recv(struct rt_spi_device *device,
                                 void                 *recv_buf,
                                 rt_size_t             length)
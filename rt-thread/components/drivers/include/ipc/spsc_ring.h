@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#ifndef SPSC_RING_H__
+#define SPSC_RING_H__
+
+/*
+ * Introduction:
+ * The spsc ring is a lock-free byte ring buffer for exactly one producer and
+ * one consumer, e.g. an ISR (or DMA engine) and a thread. It never disables
+ * interrupt: the producer only writes the head counter and the consumer only
+ * writes the tail counter, both with release ordering, and each side reads
+ * the other counter with acquire ordering.
+ *
+ * The counters are free-running 32 bit values and the buffer size must be a
+ * power of two, so the used length is (head - tail) and the position is
+ * (counter & mask).
+ *
+ * Besides the copy based put/get, the contiguous spans of the buffer can be
+ * claimed and committed, then a DMA engine or a parser can work on the buffer
+ * in place:
+ *
+ *     len = rt_spsc_ring_write_claim(ring, &ptr);   fill ptr[0 .. len)
+ *     rt_spsc_ring_write_commit(ring, filled);
+ *
+ *     len = rt_spsc_ring_read_claim(ring, &ptr);    parse ptr[0 .. len)
+ *     rt_spsc_ring_read_commit(ring, parsed);
+ */
+
+#include <rtthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct rt_spsc_ring
+{
+    rt_uint8_t *buffer_ptr;
+    rt_uint32_t buffer_size;                            /**< power of two */
+    rt_uint32_t mask;                                   /**< buffer_size - 1 */
+
+    volatile rt_uint32_t head;                          /**< written by producer only */
+    volatile rt_uint32_t tail;                          /**< written by consumer only */
+};
+typedef struct rt_spsc_ring *rt_spsc_ring_t;
+
+rt_err_t rt_spsc_ring_init(struct rt_spsc_ring *ring, rt_uint8_t *pool, rt_uint32_t size);
+void rt_spsc_ring_reset(struct rt_spsc_ring *ring);
+
+#ifdef RT_USING_HEAP
+struct rt_spsc_ring *rt_spsc_ring_create(rt_uint32_t size);
+void rt_spsc_ring_destroy(struct rt_spsc_ring *ring);
+#endif
+
+/* producer side */
+rt_uint32_t rt_spsc_ring_space_len(struct rt_spsc_ring *ring);
+rt_uint32_t rt_spsc_ring_put(struct rt_spsc_ring *ring, const rt_uint8_t *ptr, rt_uint32_t length);
+rt_uint32_t rt_spsc_ring_write_claim(struct rt_spsc_ring *ring, rt_uint8_t **ptr);
+void rt_spsc_ring_write_commit(struct rt_spsc_ring *ring, rt_uint32_t length);
+
+/* consumer side */
+rt_uint32_t rt_spsc_ring_data_len(struct rt_spsc_ring *ring);
+rt_uint32_t rt_spsc_ring_get(struct rt_spsc_ring *ring, rt_uint8_t *ptr, rt_uint32_t length);
+rt_uint32_t rt_spsc_ring_read_claim(struct rt_spsc_ring *ring, rt_uint8_t **ptr);
+void rt_spsc_ring_read_commit(struct rt_spsc_ring *ring, rt_uint32_t length);
+
+rt_inline rt_uint32_t rt_spsc_ring_get_size(struct rt_spsc_ring *ring)
+{
+    RT_ASSERT(ring != RT_NULL);
+    return ring->buffer_size;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -5,6 +5,7 @@
  *
  * Change Logs:
  * Date           Author       Notes
+ * 2026-10-19     Hehesheng    add worker pool, priority lanes, keys and stats
  */
 #ifndef WORKQUEUE_H__
 #define WORKQUEUE_H__
@@ -25,14 +26,53 @@ enum
     RT_WORK_TYPE_DELAYED     = 0x0001,
 };
 
+/**
+ * work priority lanes, the works in higher lane are always run first
+ */
+enum
+{
+    RT_WORK_PRIO_HIGH        = 0,
+    RT_WORK_PRIO_NORMAL,
+    RT_WORK_PRIO_LOW,
+    RT_WORK_PRIO_NUM,
+};
+
+struct rt_work;
+
+struct rt_workqueue_stats
+{
+    rt_uint32_t submitted;        /* number of submitted works */
+    rt_uint32_t completed;        /* number of completed works */
+    rt_uint32_t overrun;          /* number of works run longer than budget */
+    rt_uint16_t depth;            /* number of pending works */
+    rt_uint16_t depth_max;        /* maximum number of pending works */
+    rt_tick_t   latency_max;      /* maximum ticks from submitting to running */
+    rt_tick_t   latency_total;    /* total ticks from submitting to running */
+    rt_tick_t   longest;          /* the longest run time of work */
+    void (*longest_func)(struct rt_work *work, void *work_data);
+};
+
+struct rt_workqueue_worker
+{
+    rt_thread_t    thread;
+    struct rt_work *current;      /* current work */
+    struct rt_workqueue *queue;
+};
+
 /* workqueue implementation */
 struct rt_workqueue
 {
-    rt_list_t      work_list;
-    struct rt_work *work_current; /* current work */
+    rt_list_t      work_list[RT_WORK_PRIO_NUM];
 
-    struct rt_semaphore sem;
-    rt_thread_t    work_thread;
+    struct rt_semaphore sem;      /* work completion */
+    struct rt_semaphore wake;     /* wake up the idle workers */
+    rt_thread_t    work_thread;   /* the first worker thread */
+
+    rt_uint8_t     worker_num;
+    rt_uint8_t     worker_idle;
+    struct rt_workqueue_worker *workers;
+
+    struct rt_workqueue_stats stats;
 };
 
 struct rt_work
@@ -43,6 +83,11 @@ struct rt_work
     void *work_data;
     rt_uint16_t flags;
     rt_uint16_t type;
+
+    rt_uint8_t  priority;         /* the priority lane */
+    rt_ubase_t  key;              /* the works with same non-zero key never run concurrently */
+    rt_tick_t   budget;           /* the expected run time in ticks, 0 for no budget */
+    rt_tick_t   submit_tick;
 };
 
 struct rt_delayed_work
@@ -57,11 +102,15 @@ struct rt_delayed_work
  * WorkQueue for DeviceDriver
  */
 struct rt_workqueue *rt_workqueue_create(const char *name, rt_uint16_t stack_size, rt_uint8_t priority);
+struct rt_workqueue *rt_workqueue_create_pool(const char *name, rt_uint16_t stack_size, rt_uint8_t priority,
+        rt_uint8_t workers);
 rt_err_t rt_workqueue_destroy(struct rt_workqueue *queue);
 rt_err_t rt_workqueue_dowork(struct rt_workqueue *queue, struct rt_work *work);
 rt_err_t rt_workqueue_submit_work(struct rt_workqueue *queue, struct rt_work *work, rt_tick_t time);
 rt_err_t rt_workqueue_cancel_work(struct rt_workqueue *queue, struct rt_work *work);
 rt_err_t rt_workqueue_cancel_work_sync(struct rt_workqueue *queue, struct rt_work *work);
+rt_err_t rt_workqueue_get_stats(struct rt_workqueue *queue, struct rt_workqueue_stats *stats);
+void rt_workqueue_reset_stats(struct rt_workqueue *queue);
 
 #ifdef RT_USING_SYSTEM_WORKQUEUE
 rt_err_t rt_work_submit(struct rt_work *work, rt_tick_t time);
@@ -76,6 +125,29 @@ rt_inline void rt_work_init(struct rt_work *work, void (*work_func)(struct rt_wo
     work->work_data = work_data;
     work->flags = 0;
     work->type = 0;
+    work->priority = RT_WORK_PRIO_NORMAL;
+    work->key = 0;
+    work->budget = 0;
+    work->submit_tick = 0;
+}
+
+/* set the priority lane, it takes effect on next submitting */
+rt_inline void rt_work_set_priority(struct rt_work *work, rt_uint8_t priority)
+{
+    RT_ASSERT(priority < RT_WORK_PRIO_NUM);
+    work->priority = priority;
+}
+
+/* the works sharing a non-zero key are serialised among the workers */
+rt_inline void rt_work_set_key(struct rt_work *work, rt_ubase_t key)
+{
+    work->key = key;
+}
+
+/* the work run longer than budget is counted as overrun in stats */
+rt_inline void rt_work_set_budget(struct rt_work *work, rt_tick_t budget)
+{
+    work->budget = budget;
 }
 
 void rt_delayed_work_init(struct rt_delayed_work *work, void (*work_func)(struct rt_work *work,
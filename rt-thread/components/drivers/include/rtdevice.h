@@ -7,6 +7,8 @@
  * Date           Author       Notes
  * 2012-01-08     bernard      first version.
  * 2014-07-12     bernard      Add workqueue implementation.
+ * 2026-10-19     Hehesheng    add block device cache
+ * 2026-10-19     Hehesheng    add flash translation layer on MTD Nor Flash
  */
 
 #ifndef __RT_DEVICE_H__
@@ -22,6 +24,7 @@
 #include "ipc/pipe.h"
 #include "ipc/poll.h"
 #include "ipc/ringblk_buf.h"
+#include "ipc/spsc_ring.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -42,12 +45,19 @@ extern "C" {
 
 #ifdef RT_USING_MTD_NOR
 #include "drivers/mtd_nor.h"
+#ifdef RT_USING_MTD_NOR_FTL
+#include "drivers/mtd_nor_ftl.h"
+#endif
 #endif /* RT_USING_MTD_NOR */
 
 #ifdef RT_USING_MTD_NAND
 #include "drivers/mtd_nand.h"
 #endif /* RT_USING_MTD_NAND */
 
+#ifdef RT_USING_BLK_CACHE
+#include "drivers/blk_cache.h"
+#endif /* RT_USING_BLK_CACHE */
+
 #ifdef RT_USING_USB_DEVICE
 #include "drivers/usb_device.h"
 #endif /* RT_USING_USB_DEVICE */
@@ -7,8 +7,10 @@
  * Date           Author       Notes
  * 2018-05-07     aozima       the first version
  * 2018-11-16     Ernest Chen  add finsh command and update adc function
+ * 2026-10-19     Hehesheng    add continuous acquisition (stream) mode
  */
 
+#include <rthw.h>
 #include <rtthread.h>
 #include <rtdevice.h>
 
@@ -19,6 +21,179 @@
 #define DBG_LVL DBG_INFO
 #include <rtdbg.h>
 
+#ifdef RT_USING_ADC_STREAM
+/*
+ * The stream mode: the driver scans the channels by a hardware trigger into a
+ * circular DMA buffer, and gives each half of it as a block to the ring by
+ * rt_hw_adc_stream_done in ISR. The ring has one producer (the ISR) and one
+ * consumer (the reader), the counters are free running, so only the ISR
+ * updates head and only the reader updates tail. When the ring is full the
+ * new block is dropped, the reader always gets the whole blocks in order.
+ */
+
+static rt_uint16_t *_adc_stream_block(struct rt_adc_stream *stream, rt_uint32_t index)
+{
+    return stream->ring + (index % RT_ADC_STREAM_BLOCKS) * stream->block_samples;
+}
+
+static rt_size_t _adc_stream_read(struct rt_adc_stream *stream, rt_uint16_t *buffer, rt_size_t count)
+{
+    rt_size_t total = 0, length;
+
+    while (total < count && stream->tail != stream->head)
+    {
+        length = stream->block_samples - stream->offset;
+        if (length > count - total)
+        {
+            length = count - total;
+        }
+        rt_memcpy(buffer + total, _adc_stream_block(stream, stream->tail) + stream->offset,
+                  length * sizeof(rt_uint16_t));
+        total += length;
+        stream->offset += length;
+
+        if (stream->offset == stream->block_samples)
+        {
+            /* give the block back to ISR */
+            stream->offset = 0;
+            stream->tail ++;
+        }
+    }
+    stream->stats.samples_read += total;
+
+    return total;
+}
+
+static rt_err_t _adc_stream_config(struct rt_adc_device *adc, struct rt_adc_stream_config *config)
+{
+    struct rt_adc_stream *stream = &adc->stream;
+    rt_uint16_t *ring = RT_NULL, *old;
+    rt_uint32_t block_samples = 0;
+    rt_base_t level;
+
+    if (adc->ops->stream == RT_NULL)
+    {
+        return -RT_ENOSYS;
+    }
+    if (stream->running)
+    {
+        return -RT_EBUSY;
+    }
+
+    /* the null config leaves the stream mode */
+    if (config != RT_NULL)
+    {
+        if (config->sample_rate == 0 || config->block_size == 0 ||
+            config->channel_count == 0 || config->channel_count > RT_ADC_STREAM_CHANNELS_MAX)
+        {
+            return -RT_EINVAL;
+        }
+
+        block_samples = config->block_size * config->channel_count;
+        ring = rt_malloc(RT_ADC_STREAM_BLOCKS * block_samples * sizeof(rt_uint16_t));
+        if (ring == RT_NULL)
+        {
+            return -RT_ENOMEM;
+        }
+    }
+
+    level = rt_hw_interrupt_disable();
+    old = stream->ring;
+    if (config != RT_NULL)
+    {
+        stream->config = *config;
+    }
+    stream->ring = ring;
+    stream->block_samples = block_samples;
+    stream->head = stream->tail = stream->offset = 0;
+    rt_memset(&stream->stats, 0, sizeof(stream->stats));
+    rt_hw_interrupt_enable(level);
+
+    if (old != RT_NULL)
+    {
+        rt_free(old);
+    }
+
+    return RT_EOK;
+}
+
+static rt_err_t _adc_stream_start(struct rt_adc_device *adc, rt_bool_t start)
+{
+    struct rt_adc_stream *stream = &adc->stream;
+    rt_err_t result;
+
+    if (stream->ring == RT_NULL)
+    {
+        return -RT_ERROR;
+    }
+    if ((rt_bool_t)stream->running == start)
+    {
+        return RT_EOK;
+    }
+
+    if (start)
+    {
+        /* the blocks and statistics of last run are dropped */
+        stream->head = stream->tail = stream->offset = 0;
+        rt_memset(&stream->stats, 0, sizeof(stream->stats));
+        stream->running = RT_TRUE;
+        result = adc->ops->stream(adc, &stream->config, RT_TRUE);
+        if (result != RT_EOK)
+        {
+            stream->running = RT_FALSE;
+        }
+    }
+    else
+    {
+        /* the blocks in ring can be still read after stop */
+        result = adc->ops->stream(adc, &stream->config, RT_FALSE);
+        stream->running = RT_FALSE;
+    }
+
+    return result;
+}
+
+/**
+ * This function will put a block of samples to the stream ring, it's invoked
+ * by the driver in ISR when a half of the DMA buffer is filled.
+ *
+ * @param dev the ADC device
+ * @param samples the block, the scans of configured channels one by one,
+ *        RT_NULL if the block is lost by hardware
+ */
+void rt_hw_adc_stream_done(rt_adc_device_t dev, const rt_uint16_t *samples)
+{
+    struct rt_adc_stream *stream;
+    rt_uint32_t head;
+
+    RT_ASSERT(dev != RT_NULL);
+    stream = &dev->stream;
+
+    if (!stream->running)
+    {
+        return;
+    }
+
+    stream->stats.blocks ++;
+    head = stream->head;
+    if (samples == RT_NULL || head - stream->tail >= RT_ADC_STREAM_BLOCKS)
+    {
+        stream->stats.overruns ++;
+        return;
+    }
+
+    rt_memcpy(_adc_stream_block(stream, head), samples, stream->block_samples * sizeof(rt_uint16_t));
+    /* publish the block after it's copied */
+    stream->head = head + 1;
+
+    if (dev->parent.rx_indicate != RT_NULL)
+    {
+        dev->parent.rx_indicate(&dev->parent,
+                                ((head + 1 - stream->tail) * stream->block_samples - stream->offset) * sizeof(rt_uint16_t));
+    }
+}
+#endif /* RT_USING_ADC_STREAM */
+
 static rt_size_t _adc_read(rt_device_t dev, rt_off_t pos, void *buffer, rt_size_t size)
 {
     rt_err_t result = RT_EOK;
@@ -26,6 +201,14 @@ static rt_size_t _adc_read(rt_device_t dev, rt_off_t pos, void *buffer, rt_size_
     struct rt_adc_device *adc = (struct rt_adc_device *)dev;
     rt_uint32_t *value = (rt_uint32_t *)buffer;
 
+#ifdef RT_USING_ADC_STREAM
+    /* read the samples in stream mode, pos is ignored and it never blocks */
+    if (adc->stream.ring != RT_NULL)
+    {
+        return _adc_stream_read(&adc->stream, (rt_uint16_t *)buffer, size / sizeof(rt_uint16_t)) * sizeof(rt_uint16_t);
+    }
+#endif
+
     for (i = 0; i < size; i += sizeof(int))
     {
         result = adc->ops->convert(adc, pos + i, value);
@@ -44,6 +227,33 @@ static rt_err_t _adc_control(rt_device_t dev, int cmd, void *args)
     rt_err_t result = RT_EOK;
     rt_adc_device_t adc = (struct rt_adc_device *)dev;
 
+#ifdef RT_USING_ADC_STREAM
+    switch (cmd)
+    {
+    case RT_ADC_CMD_STREAM_CONFIG:
+        return _adc_stream_config(adc, (struct rt_adc_stream_config *)args);
+    case RT_ADC_CMD_STREAM_START:
+        return _adc_stream_start(adc, RT_TRUE);
+    case RT_ADC_CMD_STREAM_STOP:
+        return _adc_stream_start(adc, RT_FALSE);
+    case RT_ADC_CMD_STREAM_GET_STATS:
+    {
+        rt_base_t level;
+
+        if (args == RT_NULL)
+        {
+            return -RT_EINVAL;
+        }
+        level = rt_hw_interrupt_disable();
+        rt_memcpy(args, &adc->stream.stats, sizeof(struct rt_adc_stream_stats));
+        rt_hw_interrupt_enable(level);
+        return RT_EOK;
+    }
+    default:
+        break;
+    }
+#endif
+
     if (adc->ops->enabled == RT_NULL)
     {
         return -RT_ENOSYS;
@@ -93,6 +303,9 @@ rt_err_t rt_hw_adc_register(rt_adc_device_t device, const char *name, const stru
 #endif
     device->ops = ops;
     device->parent.user_data = (void *)user_data;
+#ifdef RT_USING_ADC_STREAM
+    rt_memset(&device->stream, 0, sizeof(device->stream));
+#endif
 
     result = rt_device_register(&device->parent, name, RT_DEVICE_FLAG_RDWR);
 
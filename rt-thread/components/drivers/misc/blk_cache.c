@@ -0,0 +1,596 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#define DBG_TAG                        "blk.cache"
+#define DBG_LVL                        DBG_WARNING
+#include <rtdbg.h>
+
+/*
+ * The block cache device wraps a block device with a sector cache. The
+ * sectors are replaced by LRU, the sequential read starts the read ahead in
+ * system workqueue, and the written sectors are kept dirty until the flush
+ * timer, the eviction or RT_DEVICE_CTRL_BLK_SYNC writes them back. So the
+ * repeated writes of the same sector, such as the FAT and the tail of an
+ * appended file, reach the device once.
+ *
+ * The transfer larger than a half of cache bypasses the cache, so it can't
+ * wipe the cache out.
+ */
+
+#ifndef RT_BLK_CACHE_READ_AHEAD
+#define RT_BLK_CACHE_READ_AHEAD        2
+#endif
+
+#ifndef RT_BLK_CACHE_FLUSH_MS
+#define RT_BLK_CACHE_FLUSH_MS          1000
+#endif
+
+#define BLK_CACHE_LARGE(cache, count)  ((count) > (cache)->capacity / 2)
+
+static rt_list_t _blk_cache_list = RT_LIST_OBJECT_INIT(_blk_cache_list);
+
+static struct rt_blk_cache_entry *_blk_cache_find(rt_blk_cache_t cache, rt_uint32_t sector)
+{
+    struct rt_blk_cache_entry *entry;
+
+    rt_list_for_each_entry(entry, &(cache->lru), list)
+    {
+        if (entry->valid && entry->sector == sector)
+            return entry;
+    }
+
+    return RT_NULL;
+}
+
+/* move the entry to the head of LRU list */
+rt_inline void _blk_cache_touch(rt_blk_cache_t cache, struct rt_blk_cache_entry *entry)
+{
+    rt_list_remove(&(entry->list));
+    rt_list_insert_after(&(cache->lru), &(entry->list));
+}
+
+static rt_err_t _blk_cache_write_back(rt_blk_cache_t cache, struct rt_blk_cache_entry *entry)
+{
+    if (rt_device_write(cache->device, entry->sector, entry->data, 1) != 1)
+    {
+        LOG_E("%.*s write back sector %d failed", RT_NAME_MAX, cache->parent.parent.name, entry->sector);
+        return -RT_EIO;
+    }
+
+    entry->dirty = RT_FALSE;
+    cache->stats.dirty --;
+    cache->stats.write_backs ++;
+
+    return RT_EOK;
+}
+
+/* drop the entry, the dirty data is discarded */
+static void _blk_cache_drop(rt_blk_cache_t cache, struct rt_blk_cache_entry *entry)
+{
+    if (entry->dirty)
+    {
+        entry->dirty = RT_FALSE;
+        cache->stats.dirty --;
+    }
+    entry->valid = RT_FALSE;
+
+    /* reuse it first */
+    rt_list_remove(&(entry->list));
+    rt_list_insert_before(&(cache->lru), &(entry->list));
+}
+
+/* take the least recently used entry for the sector */
+static struct rt_blk_cache_entry *_blk_cache_alloc(rt_blk_cache_t cache, rt_uint32_t sector)
+{
+    struct rt_blk_cache_entry *entry;
+
+    entry = rt_list_entry(cache->lru.prev, struct rt_blk_cache_entry, list);
+    if (entry->dirty && _blk_cache_write_back(cache, entry) != RT_EOK)
+        return RT_NULL;
+
+    entry->sector = sector;
+    entry->valid = RT_FALSE;
+    _blk_cache_touch(cache, entry);
+
+    return entry;
+}
+
+/* write back the dirty sectors in order of sector */
+static rt_err_t _blk_cache_flush(rt_blk_cache_t cache)
+{
+    struct rt_blk_cache_entry *entry, *next;
+    rt_err_t result = RT_EOK;
+
+    while (cache->stats.dirty != 0)
+    {
+        next = RT_NULL;
+        rt_list_for_each_entry(entry, &(cache->lru), list)
+        {
+            if (entry->dirty && (next == RT_NULL || entry->sector < next->sector))
+                next = entry;
+        }
+        RT_ASSERT(next != RT_NULL);
+
+        if (_blk_cache_write_back(cache, next) != RT_EOK)
+        {
+            /* keep the sector and give up this time */
+            result = -RT_EIO;
+            break;
+        }
+    }
+
+    return result;
+}
+
+/* start the flush timer if there are dirty sectors and it's not running */
+static void _blk_cache_arm_flush(rt_blk_cache_t cache)
+{
+    if (cache->stats.dirty != 0 && RT_BLK_CACHE_FLUSH_MS > 0 &&
+        !(cache->flush_timer.parent.flag & RT_TIMER_FLAG_ACTIVATED))
+        rt_timer_start(&(cache->flush_timer));
+}
+
+static void _blk_cache_flush_timeout(void *parameter)
+{
+    rt_blk_cache_t cache = (rt_blk_cache_t)parameter;
+
+    rt_work_submit(&(cache->flush_work), 0);
+}
+
+static void _blk_cache_flush_work(struct rt_work *work, void *work_data)
+{
+    rt_blk_cache_t cache = (rt_blk_cache_t)work_data;
+
+    rt_mutex_take(&(cache->lock), RT_WAITING_FOREVER);
+    _blk_cache_flush(cache);
+    /* retry the sectors failed to write back in next period */
+    _blk_cache_arm_flush(cache);
+    rt_mutex_release(&(cache->lock));
+}
+
+static void _blk_cache_read_ahead(rt_blk_cache_t cache, rt_uint32_t sector)
+{
+    struct rt_blk_cache_entry *entry;
+    rt_uint32_t count;
+
+    count = RT_BLK_CACHE_READ_AHEAD;
+    if (count > cache->capacity / 2)
+        count = cache->capacity / 2;
+
+    for (; count > 0 && sector < cache->geometry.sector_count; count --, sector ++)
+    {
+        if (_blk_cache_find(cache, sector) != RT_NULL)
+            continue;
+
+        entry = _blk_cache_alloc(cache, sector);
+        if (entry == RT_NULL)
+            break;
+        if (rt_device_read(cache->device, sector, entry->data, 1) != 1)
+            break;
+
+        entry->valid = RT_TRUE;
+        cache->stats.read_ahead ++;
+    }
+}
+
+static rt_err_t _blk_cache_control(rt_device_t dev, int cmd, void *args);
+
+static rt_err_t _blk_cache_close(rt_device_t dev)
+{
+    return _blk_cache_control(dev, RT_DEVICE_CTRL_BLK_SYNC, RT_NULL);
+}
+
+static rt_size_t _blk_cache_read(rt_device_t dev, rt_off_t pos, void *buffer, rt_size_t size)
+{
+    rt_blk_cache_t cache = (rt_blk_cache_t)dev;
+    struct rt_blk_cache_entry *entry;
+    rt_uint32_t bytes = cache->geometry.bytes_per_sector;
+    rt_uint8_t *data = (rt_uint8_t *)buffer;
+    rt_size_t index, count, offset;
+    rt_bool_t sequential;
+
+    rt_mutex_take(&(cache->lock), RT_WAITING_FOREVER);
+
+    for (index = 0; index < size; )
+    {
+        entry = _blk_cache_find(cache, pos + index);
+        if (entry != RT_NULL)
+        {
+            rt_memcpy(data + index * bytes, entry->data, bytes);
+            _blk_cache_touch(cache, entry);
+            cache->stats.hits ++;
+            index ++;
+            continue;
+        }
+
+        /* read the continuous missed sectors at once */
+        for (count = 1; index + count < size && _blk_cache_find(cache, pos + index + count) == RT_NULL; count ++);
+        if (rt_device_read(cache->device, pos + index, data + index * bytes, count) != count)
+            break;
+        cache->stats.misses += count;
+
+        if (BLK_CACHE_LARGE(cache, count))
+        {
+            cache->stats.bypass += count;
+        }
+        else
+        {
+            for (offset = 0; offset < count; offset ++)
+            {
+                entry = _blk_cache_alloc(cache, pos + index + offset);
+                if (entry == RT_NULL)
+                    break;
+                rt_memcpy(entry->data, data + (index + offset) * bytes, bytes);
+                entry->valid = RT_TRUE;
+            }
+        }
+        index += count;
+    }
+
+    sequential = (pos == cache->next_sector);
+    cache->next_sector = pos + index;
+
+    rt_mutex_release(&(cache->lock));
+
+    /* read the next sectors in background */
+    if (sequential && index == size && RT_BLK_CACHE_READ_AHEAD > 0)
+        rt_work_submit(&(cache->ahead_work), 0);
+
+    return index;
+}
+
+static rt_size_t _blk_cache_write(rt_device_t dev, rt_off_t pos, const void *buffer, rt_size_t size)
+{
+    rt_blk_cache_t cache = (rt_blk_cache_t)dev;
+    struct rt_blk_cache_entry *entry;
+    rt_uint32_t bytes = cache->geometry.bytes_per_sector;
+    const rt_uint8_t *data = (const rt_uint8_t *)buffer;
+    rt_size_t index;
+
+    rt_mutex_take(&(cache->lock), RT_WAITING_FOREVER);
+
+    if (BLK_CACHE_LARGE(cache, size))
+    {
+        rt_size_t count;
+
+        /* write through, and drop the sectors overwritten */
+        count = rt_device_write(cache->device, pos, data, size);
+        for (index = 0; index < count; index ++)
+        {
+            entry = _blk_cache_find(cache, pos + index);
+            if (entry != RT_NULL)
+                _blk_cache_drop(cache, entry);
+        }
+        cache->stats.bypass += count;
+
+        rt_mutex_release(&(cache->lock));
+        return count;
+    }
+
+    for (index = 0; index < size; index ++)
+    {
+        entry = _blk_cache_find(cache, pos + index);
+        if (entry == RT_NULL)
+        {
+            entry = _blk_cache_alloc(cache, pos + index);
+            if (entry == RT_NULL)
+                break;
+        }
+        else
+        {
+            _blk_cache_touch(cache, entry);
+        }
+
+        rt_memcpy(entry->data, data + index * bytes, bytes);
+        entry->valid = RT_TRUE;
+        if (!entry->dirty)
+        {
+            entry->dirty = RT_TRUE;
+            cache->stats.dirty ++;
+        }
+        cache->stats.writes ++;
+    }
+
+    _blk_cache_arm_flush(cache);
+
+    rt_mutex_release(&(cache->lock));
+
+    return index;
+}
+
+static rt_err_t _blk_cache_control(rt_device_t dev, int cmd, void *args)
+{
+    rt_blk_cache_t cache = (rt_blk_cache_t)dev;
+    struct rt_blk_cache_entry *entry;
+    rt_err_t result = RT_EOK;
+
+    switch (cmd)
+    {
+    case RT_DEVICE_CTRL_BLK_GETGEOME:
+        if (args == RT_NULL)
+            return -RT_EINVAL;
+        rt_memcpy(args, &(cache->geometry), sizeof(struct rt_device_blk_geometry));
+        break;
+
+    case RT_DEVICE_CTRL_BLK_SYNC:
+        rt_mutex_take(&(cache->lock), RT_WAITING_FOREVER);
+        result = _blk_cache_flush(cache);
+        rt_mutex_release(&(cache->lock));
+
+        if (result == RT_EOK)
+            result = rt_device_control(cache->device, RT_DEVICE_CTRL_BLK_SYNC, RT_NULL);
+        break;
+
+    case RT_DEVICE_CTRL_BLK_ERASE:
+        {
+            rt_uint32_t *addrs = (rt_uint32_t *)args;
+            rt_uint32_t index;
+
+            if (addrs == RT_NULL)
+                return -RT_EINVAL;
+
+            /* the erased sectors are dropped, the range is [start, end] */
+            rt_mutex_take(&(cache->lock), RT_WAITING_FOREVER);
+            for (index = 0; index < cache->capacity; index ++)
+            {
+                entry = &(cache->entries[index]);
+                if (entry->valid && entry->sector >= addrs[0] && entry->sector <= addrs[1])
+                    _blk_cache_drop(cache, entry);
+            }
+            result = rt_device_control(cache->device, cmd, args);
+            rt_mutex_release(&(cache->lock));
+        }
+        break;
+
+    case RT_BLK_CACHE_CTRL_GET_STATS:
+        if (args == RT_NULL)
+            return -RT_EINVAL;
+        rt_mutex_take(&(cache->lock), RT_WAITING_FOREVER);
+        rt_memcpy(args, &(cache->stats), sizeof(struct rt_blk_cache_stats));
+        rt_mutex_release(&(cache->lock));
+        break;
+
+    case RT_BLK_CACHE_CTRL_RESET_STATS:
+        rt_mutex_take(&(cache->lock), RT_WAITING_FOREVER);
+        cache->stats.hits = 0;
+        cache->stats.misses = 0;
+        cache->stats.read_ahead = 0;
+        cache->stats.writes = 0;
+        cache->stats.write_backs = 0;
+        cache->stats.bypass = 0;
+        rt_mutex_release(&(cache->lock));
+        break;
+
+    default:
+        result = rt_device_control(cache->device, cmd, args);
+        break;
+    }
+
+    return result;
+}
+
+static void _blk_cache_ahead_work(struct rt_work *work, void *work_data)
+{
+    rt_blk_cache_t cache = (rt_blk_cache_t)work_data;
+
+    rt_mutex_take(&(cache->lock), RT_WAITING_FOREVER);
+    _blk_cache_read_ahead(cache, cache->next_sector);
+    rt_mutex_release(&(cache->lock));
+}
+
+#ifdef RT_USING_DEVICE_OPS
+const static struct rt_device_ops blk_cache_ops =
+{
+    RT_NULL,
+    RT_NULL,
+    _blk_cache_close,
+    _blk_cache_read,
+    _blk_cache_write,
+    _blk_cache_control
+};
+#endif
+
+/**
+ * This function will create a block cache device on a block device. The
+ * block device is opened by the cache device, and it shall be accessed by
+ * the cache device only.
+ *
+ * @param name the name of cache device
+ * @param device_name the name of block device
+ * @param capacity the number of cached sectors
+ *
+ * @return the created cache device, RT_NULL on error
+ */
+rt_blk_cache_t rt_blk_cache_create(const char *name, const char *device_name, rt_uint32_t capacity)
+{
+    rt_blk_cache_t cache;
+    rt_device_t device;
+    rt_uint8_t *data;
+    rt_uint32_t index;
+
+    RT_ASSERT(name != RT_NULL);
+    RT_ASSERT(device_name != RT_NULL);
+    RT_ASSERT(capacity > 0);
+
+    device = rt_device_find(device_name);
+    if (device == RT_NULL || device->type != RT_Device_Class_Block)
+    {
+        LOG_E("block device %s is not found", device_name);
+        return RT_NULL;
+    }
+
+    cache = (rt_blk_cache_t)rt_calloc(1, sizeof(struct rt_blk_cache));
+    if (cache == RT_NULL)
+        return RT_NULL;
+
+    if (rt_device_control(device, RT_DEVICE_CTRL_BLK_GETGEOME, &(cache->geometry)) != RT_EOK ||
+        cache->geometry.bytes_per_sector == 0)
+    {
+        LOG_E("get geometry of %s failed", device_name);
+        goto __error;
+    }
+
+    cache->entries = (struct rt_blk_cache_entry *)rt_malloc(capacity *
+                     (sizeof(struct rt_blk_cache_entry) + cache->geometry.bytes_per_sector));
+    if (cache->entries == RT_NULL)
+    {
+        LOG_E("no memory for %d sectors", capacity);
+        goto __error;
+    }
+
+    if (rt_device_open(device, RT_DEVICE_OFLAG_RDWR) != RT_EOK)
+    {
+        LOG_E("open %s failed", device_name);
+        goto __error;
+    }
+
+    cache->device = device;
+    cache->capacity = capacity;
+    cache->next_sector = (rt_uint32_t)-1;
+    rt_list_init(&(cache->lru));
+
+    data = (rt_uint8_t *)&cache->entries[capacity];
+    for (index = 0; index < capacity; index ++)
+    {
+        cache->entries[index].valid = RT_FALSE;
+        cache->entries[index].dirty = RT_FALSE;
+        cache->entries[index].data = data + index * cache->geometry.bytes_per_sector;
+        rt_list_insert_before(&(cache->lru), &(cache->entries[index].list));
+    }
+
+    rt_mutex_init(&(cache->lock), name, RT_IPC_FLAG_FIFO);
+    rt_timer_init(&(cache->flush_timer), name, _blk_cache_flush_timeout, cache,
+                  rt_tick_from_millisecond(RT_BLK_CACHE_FLUSH_MS),
+                  RT_TIMER_FLAG_ONE_SHOT | RT_TIMER_FLAG_SOFT_TIMER);
+    rt_work_init(&(cache->flush_work), _blk_cache_flush_work, cache);
+    rt_work_init(&(cache->ahead_work), _blk_cache_ahead_work, cache);
+
+    cache->parent.type = RT_Device_Class_Block;
+#ifdef RT_USING_DEVICE_OPS
+    cache->parent.ops = &blk_cache_ops;
+#else
+    cache->parent.init = RT_NULL;
+    cache->parent.open = RT_NULL;
+    cache->parent.close = _blk_cache_close;
+    cache->parent.read = _blk_cache_read;
+    cache->parent.write = _blk_cache_write;
+    cache->parent.control = _blk_cache_control;
+#endif
+    if (rt_device_register(&(cache->parent), name, RT_DEVICE_FLAG_RDWR) != RT_EOK)
+    {
+        rt_device_close(device);
+        rt_timer_detach(&(cache->flush_timer));
+        rt_mutex_detach(&(cache->lock));
+        goto __error;
+    }
+
+    rt_enter_critical();
+    rt_list_insert_before(&_blk_cache_list, &(cache->node));
+    rt_exit_critical();
+
+    return cache;
+
+__error:
+    rt_free(cache->entries);
+    rt_free(cache);
+    return RT_NULL;
+}
+RTM_EXPORT(rt_blk_cache_create);
+
+/**
+ * This function will write back the dirty sectors and delete the cache
+ * device. The cache device shall not be in use.
+ *
+ * @param cache the cache device
+ *
+ * @return RT_EOK on successful, -RT_EIO if the dirty sectors can't be written
+ */
+rt_err_t rt_blk_cache_delete(rt_blk_cache_t cache)
+{
+    RT_ASSERT(cache != RT_NULL);
+
+    if (rt_blk_cache_sync(cache) != RT_EOK)
+        return -RT_EIO;
+
+    rt_timer_detach(&(cache->flush_timer));
+    /* wait for the running works */
+    while (rt_work_cancel(&(cache->flush_work)) == -RT_EBUSY)
+    {
+        rt_thread_mdelay(1);
+    }
+    while (rt_work_cancel(&(cache->ahead_work)) == -RT_EBUSY)
+    {
+        rt_thread_mdelay(1);
+    }
+
+    rt_enter_critical();
+    rt_list_remove(&(cache->node));
+    rt_exit_critical();
+
+    rt_device_unregister(&(cache->parent));
+    rt_device_close(cache->device);
+    rt_mutex_detach(&(cache->lock));
+    rt_free(cache->entries);
+    rt_free(cache);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_blk_cache_delete);
+
+/**
+ * This function will write back the dirty sectors of cache.
+ *
+ * @param cache the cache device
+ *
+ * @return RT_EOK on successful, -RT_EIO on failed
+ */
+rt_err_t rt_blk_cache_sync(rt_blk_cache_t cache)
+{
+    RT_ASSERT(cache != RT_NULL);
+
+    return _blk_cache_control(&(cache->parent), RT_DEVICE_CTRL_BLK_SYNC, RT_NULL);
+}
+RTM_EXPORT(rt_blk_cache_sync);
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+static void list_blk_cache(void)
+{
+    rt_blk_cache_t cache;
+    struct rt_blk_cache_stats stats;
+    rt_uint32_t total;
+
+    rt_kprintf("%-*.*s size     hits   misses    ahead   writes    backs   bypass dirty\n",
+               RT_NAME_MAX, RT_NAME_MAX, "cache");
+    rt_kprintf("%-*.*s ---- -------- -------- -------- -------- -------- -------- -----\n",
+               RT_NAME_MAX, RT_NAME_MAX, "------------------------------");
+
+    rt_enter_critical();
+    rt_list_for_each_entry(cache, &_blk_cache_list, node)
+    {
+        /* the counters are read without the lock of cache */
+        stats = cache->stats;
+        total = cache->capacity;
+
+        rt_kprintf("%-*.*s %4d %8d %8d %8d %8d %8d %8d %5d\n",
+                   RT_NAME_MAX, RT_NAME_MAX, cache->parent.parent.name, total,
+                   stats.hits, stats.misses, stats.read_ahead, stats.writes,
+                   stats.write_backs, stats.bypass, stats.dirty);
+    }
+    rt_exit_critical();
+}
+FINSH_FUNCTION_EXPORT(list_blk_cache, list block cache in system)
+MSH_CMD_EXPORT(list_blk_cache, list block cache in system);
+#endif /* RT_USING_FINSH */
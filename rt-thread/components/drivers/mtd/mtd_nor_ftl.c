@@ -0,0 +1,803 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+
+#define DBG_TAG                        "nor.ftl"
+#define DBG_LVL                        DBG_WARNING
+#include <rtdbg.h>
+
+/*
+ * The flash translation layer exports a block device on MTD Nor Flash. The
+ * sectors are never written in place, they are appended to the active
+ * segment, and the map from sector to page is kept in RAM.
+ *
+ * The segment is RT_NOR_FTL_SEGMENT_BLOCKS erase blocks, its first page is the
+ * header and the tags of other pages:
+ *
+ * +--------+-----+-----+-----+-----+--------+--------+-----+
+ * | header | tag | tag | ... | tag | page 1 | page 2 | ... |
+ * +--------+-----+-----+-----+-----+--------+--------+-----+
+ *
+ * The header is written after erase with the erase count, and the sequence
+ * number is written when the segment is opened for writing. The tag is the
+ * sector of page and is written after the data of page, so a write is
+ * committed by its tag. On mount, the tags are replayed in order of sequence
+ * number to rebuild the map, the torn tag and header are detected by their
+ * check code, and the last active segment is not appended any more.
+ *
+ * The garbage collection moves the valid pages of segment with least valid
+ * pages to the active segment and erases it. It runs in system workqueue
+ * when the free segments are less than a half of reserved segments, and the
+ * write runs it when only one free segment is left. The segment with least
+ * erase count is moved when the erase counts differ more than
+ * RT_NOR_FTL_WEAR_DELTA, and the free segment with least erase count is opened
+ * first.
+ */
+
+#ifndef RT_NOR_FTL_SECTOR_SIZE
+#define RT_NOR_FTL_SECTOR_SIZE         512
+#endif
+
+#ifndef RT_NOR_FTL_SEGMENT_BLOCKS
+#define RT_NOR_FTL_SEGMENT_BLOCKS      8
+#endif
+
+#ifndef RT_NOR_FTL_RESERVED
+#define RT_NOR_FTL_RESERVED            8
+#endif
+
+#ifndef RT_NOR_FTL_WEAR_DELTA
+#define RT_NOR_FTL_WEAR_DELTA          64
+#endif
+
+#if RT_NOR_FTL_RESERVED < 2
+#error "RT_NOR_FTL_RESERVED must be 2 at least"
+#endif
+
+#define NOR_FTL_MAGIC                  0x304C5446      /* "FTL0" */
+#define NOR_FTL_HEADER_SIZE            32
+#define NOR_FTL_NONE                   0xFFFF
+#define NOR_FTL_PROGRAM_MAX            16
+
+#define NOR_FTL_GC_WATERMARK           (RT_NOR_FTL_RESERVED / 2 > 2 ? RT_NOR_FTL_RESERVED / 2 : 2)
+
+#define NOR_FTL_TAG(sector)            ((rt_uint32_t)(sector) | ((~(rt_uint32_t)(sector) & 0xFFFF) << 16))
+#define NOR_FTL_TAG_VALID(tag)         ((((tag) >> 16) ^ ((tag) & 0xFFFF)) == 0xFFFF)
+#define NOR_FTL_TAG_SECTOR(tag)        ((tag) & 0xFFFF)
+
+enum
+{
+    NOR_FTL_FREE = 0,                                   /* erased with header */
+    NOR_FTL_USED,                                       /* opened for writing */
+    NOR_FTL_DIRTY,                                      /* shall be erased before use */
+    NOR_FTL_BAD,                                        /* failed to erase */
+};
+
+struct nor_ftl_header
+{
+    rt_uint32_t magic;
+    rt_uint32_t geometry;                               /* the sector size and pages of segment */
+    rt_uint32_t erase_count;
+    rt_uint32_t erase_check;                            /* ~erase_count */
+
+    /* written when it's opened */
+    rt_uint32_t seq;
+    rt_uint32_t seq_check;                              /* ~seq */
+
+    rt_uint32_t reserved[2];
+};
+
+static rt_list_t _nor_ftl_list = RT_LIST_OBJECT_INIT(_nor_ftl_list);
+
+rt_inline rt_uint32_t _ftl_addr(rt_nor_ftl_t ftl, rt_uint16_t segment, rt_uint16_t page)
+{
+    return ftl->base + segment * ftl->segment_size + page * RT_NOR_FTL_SECTOR_SIZE;
+}
+
+rt_inline rt_uint32_t _ftl_tag_addr(rt_nor_ftl_t ftl, rt_uint16_t segment, rt_uint16_t page)
+{
+    return ftl->base + segment * ftl->segment_size + NOR_FTL_HEADER_SIZE + (page - 1) * sizeof(rt_uint32_t);
+}
+
+rt_inline rt_uint32_t _ftl_geometry(rt_nor_ftl_t ftl)
+{
+    return (RT_NOR_FTL_SECTOR_SIZE << 16) | ftl->pages;
+}
+
+/* erase the dirty segment and write its header */
+static rt_err_t _ftl_erase(rt_nor_ftl_t ftl, rt_uint16_t index)
+{
+    struct rt_nor_ftl_segment *segment = &(ftl->segments[index]);
+    struct nor_ftl_header header;
+
+    RT_ASSERT(segment->state == NOR_FTL_DIRTY);
+
+    if (rt_mtd_nor_erase_block(ftl->mtd, _ftl_addr(ftl, index, 0), ftl->segment_size) != RT_EOK)
+        goto __error;
+    segment->erase_count ++;
+    ftl->stats.erases ++;
+
+    header.magic = NOR_FTL_MAGIC;
+    header.geometry = _ftl_geometry(ftl);
+    header.erase_count = segment->erase_count;
+    header.erase_check = ~segment->erase_count;
+    if (rt_mtd_nor_write(ftl->mtd, _ftl_addr(ftl, index, 0), (const rt_uint8_t *)&header,
+                         4 * sizeof(rt_uint32_t)) != 4 * sizeof(rt_uint32_t))
+        goto __error;
+
+    segment->state = NOR_FTL_FREE;
+    segment->seq = 0;
+    segment->valid = 0;
+    return RT_EOK;
+
+__error:
+    LOG_E("%.*s erase segment %d failed", RT_NAME_MAX, ftl->parent.parent.name, index);
+    segment->state = NOR_FTL_BAD;
+    ftl->free_count --;
+    return -RT_EIO;
+}
+
+/* the difference between the most worn segment and the coldest segment in use */
+static rt_uint32_t _ftl_wear_delta(rt_nor_ftl_t ftl, rt_uint16_t *coldest)
+{
+    struct rt_nor_ftl_segment *segment;
+    rt_uint32_t max = 0, min = 0;
+    rt_uint16_t index;
+
+    *coldest = NOR_FTL_NONE;
+    for (index = 0; index < ftl->segment_count; index ++)
+    {
+        segment = &(ftl->segments[index]);
+        if (segment->state == NOR_FTL_BAD)
+            continue;
+
+        if (segment->erase_count > max)
+            max = segment->erase_count;
+        if (segment->state == NOR_FTL_USED && index != ftl->active &&
+            (*coldest == NOR_FTL_NONE || segment->erase_count < min))
+        {
+            min = segment->erase_count;
+            *coldest = index;
+        }
+    }
+
+    return *coldest == NOR_FTL_NONE ? 0 : max - min;
+}
+
+static rt_err_t _ftl_gc(rt_nor_ftl_t ftl, rt_uint16_t victim);
+
+/* open a free segment for writing */
+static rt_err_t _ftl_open(rt_nor_ftl_t ftl)
+{
+    struct rt_nor_ftl_segment *segment;
+    rt_uint16_t index, best;
+    rt_uint32_t seq[2];
+
+    /* keep one free segment for garbage collection */
+    while (!ftl->gc_running && ftl->free_count <= 1)
+    {
+        best = NOR_FTL_NONE;
+        for (index = 0; index < ftl->segment_count; index ++)
+        {
+            segment = &(ftl->segments[index]);
+            if (segment->state == NOR_FTL_USED && index != ftl->active && segment->valid < ftl->pages - 1 &&
+                (best == NOR_FTL_NONE || segment->valid < ftl->segments[best].valid))
+                best = index;
+        }
+
+        if (best == NOR_FTL_NONE || _ftl_gc(ftl, best) != RT_EOK)
+            break;
+    }
+
+    /* the garbage collection has opened one */
+    if (ftl->active != NOR_FTL_NONE && ftl->active_page < ftl->pages)
+        return RT_EOK;
+
+    while (ftl->free_count > 0)
+    {
+        /* the least worn segment first */
+        best = NOR_FTL_NONE;
+        for (index = 0; index < ftl->segment_count; index ++)
+        {
+            segment = &(ftl->segments[index]);
+            if ((segment->state == NOR_FTL_FREE || segment->state == NOR_FTL_DIRTY) &&
+                (best == NOR_FTL_NONE || segment->erase_count < ftl->segments[best].erase_count))
+                best = index;
+        }
+        RT_ASSERT(best != NOR_FTL_NONE);
+
+        segment = &(ftl->segments[best]);
+        if (segment->state == NOR_FTL_DIRTY && _ftl_erase(ftl, best) != RT_EOK)
+            continue;
+
+        seq[0] = ftl->seq + 1;
+        seq[1] = ~seq[0];
+        if (rt_mtd_nor_write(ftl->mtd, _ftl_addr(ftl, best, 0) + 4 * sizeof(rt_uint32_t),
+                             (const rt_uint8_t *)seq, sizeof(seq)) != sizeof(seq))
+        {
+            LOG_E("%.*s open segment %d failed", RT_NAME_MAX, ftl->parent.parent.name, best);
+            segment->state = NOR_FTL_BAD;
+            ftl->free_count --;
+            continue;
+        }
+
+        ftl->seq = seq[0];
+        segment->seq = seq[0];
+        segment->valid = 0;
+        segment->state = NOR_FTL_USED;
+        ftl->free_count --;
+        ftl->active = best;
+        ftl->active_page = 1;
+
+        /* move the cold data in background */
+        if (!ftl->gc_running && _ftl_wear_delta(ftl, &index) > RT_NOR_FTL_WEAR_DELTA)
+            rt_work_submit(&(ftl->gc_work), 0);
+
+        return RT_EOK;
+    }
+
+    LOG_E("%.*s no free segment", RT_NAME_MAX, ftl->parent.parent.name);
+    return -RT_EFULL;
+}
+
+/* program the sectors to the continuous pages of active segment */
+static rt_size_t _ftl_program(rt_nor_ftl_t ftl, rt_uint32_t sector, const rt_uint8_t *data, rt_size_t count)
+{
+    rt_uint32_t tags[NOR_FTL_PROGRAM_MAX];
+    rt_uint16_t page, index, old;
+
+    if (ftl->active == NOR_FTL_NONE || ftl->active_page >= ftl->pages)
+    {
+        if (_ftl_open(ftl) != RT_EOK)
+            return 0;
+    }
+
+    if (count > NOR_FTL_PROGRAM_MAX)
+        count = NOR_FTL_PROGRAM_MAX;
+    if (count > (rt_size_t)(ftl->pages - ftl->active_page))
+        count = ftl->pages - ftl->active_page;
+
+    /* the pages can't be programmed again even if they are failed */
+    page = ftl->active_page;
+    ftl->active_page += count;
+
+    if (rt_mtd_nor_write(ftl->mtd, _ftl_addr(ftl, ftl->active, page), data,
+                         count * RT_NOR_FTL_SECTOR_SIZE) != count * RT_NOR_FTL_SECTOR_SIZE)
+        return 0;
+
+    /* commit them by tags */
+    for (index = 0; index < count; index ++)
+        tags[index] = NOR_FTL_TAG(sector + index);
+    if (rt_mtd_nor_write(ftl->mtd, _ftl_tag_addr(ftl, ftl->active, page), (const rt_uint8_t *)tags,
+                         count * sizeof(rt_uint32_t)) != count * sizeof(rt_uint32_t))
+        return 0;
+
+    for (index = 0; index < count; index ++)
+    {
+        old = ftl->map[sector + index];
+        if (old != 0)
+            ftl->segments[old / ftl->pages].valid --;
+        ftl->map[sector + index] = ftl->active * ftl->pages + page + index;
+    }
+    ftl->segments[ftl->active].valid += count;
+    ftl->stats.page_writes += count;
+
+    return count;
+}
+
+/* move the valid pages of victim to active segment, and erase it */
+static rt_err_t _ftl_gc(rt_nor_ftl_t ftl, rt_uint16_t victim)
+{
+    struct rt_nor_ftl_segment *segment = &(ftl->segments[victim]);
+    rt_uint32_t sector, size;
+    rt_uint16_t page;
+    rt_err_t result = RT_EOK;
+
+    RT_ASSERT(segment->state == NOR_FTL_USED);
+    RT_ASSERT(victim != ftl->active);
+
+    size = (ftl->pages - 1) * sizeof(rt_uint32_t);
+    if (segment->valid != 0 &&
+        rt_mtd_nor_read(ftl->mtd, _ftl_tag_addr(ftl, victim, 1), (rt_uint8_t *)ftl->tags, size) != size)
+        return -RT_EIO;
+
+    ftl->gc_running = RT_TRUE;
+    for (page = 1; page < ftl->pages && segment->valid != 0; page ++)
+    {
+        if (!NOR_FTL_TAG_VALID(ftl->tags[page - 1]))
+            continue;
+        sector = NOR_FTL_TAG_SECTOR(ftl->tags[page - 1]);
+        if (sector >= ftl->sector_count || ftl->map[sector] != victim * ftl->pages + page)
+            continue;
+
+        if (rt_mtd_nor_read(ftl->mtd, _ftl_addr(ftl, victim, page), ftl->buffer,
+                            RT_NOR_FTL_SECTOR_SIZE) != RT_NOR_FTL_SECTOR_SIZE ||
+            _ftl_program(ftl, sector, ftl->buffer, 1) != 1)
+        {
+            result = -RT_EIO;
+            break;
+        }
+        ftl->stats.gc_copies ++;
+    }
+    ftl->gc_running = RT_FALSE;
+
+    if (result != RT_EOK)
+        return result;
+
+    segment->state = NOR_FTL_DIRTY;
+    ftl->free_count ++;
+
+    return _ftl_erase(ftl, victim);
+}
+
+static void _ftl_gc_work(struct rt_work *work, void *work_data)
+{
+    rt_nor_ftl_t ftl = (rt_nor_ftl_t)work_data;
+    struct rt_nor_ftl_segment *segment;
+    rt_uint16_t step, index, victim;
+    rt_err_t result;
+
+    for (step = 0; step < ftl->segment_count; step ++)
+    {
+        rt_mutex_take(&(ftl->lock), RT_WAITING_FOREVER);
+
+        victim = NOR_FTL_NONE;
+        if (ftl->free_count >= 2 && _ftl_wear_delta(ftl, &index) > RT_NOR_FTL_WEAR_DELTA)
+        {
+            victim = index;
+            ftl->stats.wear_moves ++;
+        }
+        else if (ftl->free_count < NOR_FTL_GC_WATERMARK)
+        {
+            for (index = 0; index < ftl->segment_count; index ++)
+            {
+                segment = &(ftl->segments[index]);
+                if (segment->state == NOR_FTL_USED && index != ftl->active && segment->valid < ftl->pages - 1 &&
+                    (victim == NOR_FTL_NONE || segment->valid < ftl->segments[victim].valid))
+                    victim = index;
+            }
+        }
+
+        result = victim == NOR_FTL_NONE ? -RT_EEMPTY : _ftl_gc(ftl, victim);
+
+        rt_mutex_release(&(ftl->lock));
+
+        if (result != RT_EOK)
+            break;
+    }
+}
+
+/* rebuild the map from the tags of segments */
+static rt_err_t _ftl_mount(rt_nor_ftl_t ftl)
+{
+    struct rt_nor_ftl_segment *segment;
+    struct nor_ftl_header header;
+    rt_uint32_t sum = 0, known = 0, sector, size;
+    rt_uint16_t index, page, old;
+
+    ftl->free_count = 0;
+    for (index = 0; index < ftl->segment_count; index ++)
+    {
+        segment = &(ftl->segments[index]);
+        segment->seq = 0;
+        segment->valid = 0;
+
+        if (rt_mtd_nor_read(ftl->mtd, _ftl_addr(ftl, index, 0), (rt_uint8_t *)&header,
+                            sizeof(header)) != sizeof(header))
+            return -RT_EIO;
+
+        if (header.magic != NOR_FTL_MAGIC || header.geometry != _ftl_geometry(ftl) ||
+            header.erase_check != ~header.erase_count)
+        {
+            /* not formatted, or the erase is torn */
+            segment->state = NOR_FTL_DIRTY;
+            segment->erase_count = (rt_uint32_t)-1;
+            ftl->free_count ++;
+            continue;
+        }
+
+        segment->erase_count = header.erase_count;
+        sum += header.erase_count;
+        known ++;
+
+        if (header.seq == (rt_uint32_t)-1 && header.seq_check == (rt_uint32_t)-1)
+        {
+            segment->state = NOR_FTL_FREE;
+            ftl->free_count ++;
+        }
+        else if (header.seq_check != ~header.seq || header.seq == 0)
+        {
+            segment->state = NOR_FTL_DIRTY;
+            ftl->free_count ++;
+        }
+        else
+        {
+            segment->state = NOR_FTL_USED;
+            segment->seq = header.seq;
+            if (header.seq > ftl->seq)
+                ftl->seq = header.seq;
+        }
+    }
+
+    /* no segment is formatted, it's a blank flash or it's used by others */
+    ftl->blank = (known == 0);
+
+    /* the erase count of unformatted segment is unknown, take the average */
+    for (index = 0; index < ftl->segment_count; index ++)
+    {
+        if (ftl->segments[index].erase_count == (rt_uint32_t)-1)
+            ftl->segments[index].erase_count = known ? sum / known : 0;
+    }
+
+    /* the newer sequence or the later page wins */
+    size = (ftl->pages - 1) * sizeof(rt_uint32_t);
+    for (index = 0; index < ftl->segment_count; index ++)
+    {
+        segment = &(ftl->segments[index]);
+        if (segment->state != NOR_FTL_USED)
+            continue;
+
+        if (rt_mtd_nor_read(ftl->mtd, _ftl_tag_addr(ftl, index, 1), (rt_uint8_t *)ftl->tags, size) != size)
+            return -RT_EIO;
+
+        for (page = 1; page < ftl->pages; page ++)
+        {
+            if (!NOR_FTL_TAG_VALID(ftl->tags[page - 1]))
+                continue;
+            sector = NOR_FTL_TAG_SECTOR(ftl->tags[page - 1]);
+            if (sector >= ftl->sector_count)
+                continue;
+
+            old = ftl->map[sector];
+            if (old == 0 || ftl->segments[old / ftl->pages].seq <= segment->seq)
+                ftl->map[sector] = index * ftl->pages + page;
+        }
+    }
+
+    for (sector = 0; sector < ftl->sector_count; sector ++)
+    {
+        if (ftl->map[sector] != 0)
+            ftl->segments[ftl->map[sector] / ftl->pages].valid ++;
+    }
+
+    /* the tail of last active segment may be torn, never append it */
+    ftl->active = NOR_FTL_NONE;
+    ftl->active_page = 0;
+
+    return RT_EOK;
+}
+
+static rt_size_t _ftl_read(rt_device_t dev, rt_off_t pos, void *buffer, rt_size_t size)
+{
+    rt_nor_ftl_t ftl = (rt_nor_ftl_t)dev;
+    rt_uint8_t *data = (rt_uint8_t *)buffer;
+    rt_size_t index, count, length;
+    rt_uint16_t page;
+
+    if (pos >= ftl->sector_count)
+        return 0;
+    if (size > ftl->sector_count - pos)
+        size = ftl->sector_count - pos;
+
+    rt_mutex_take(&(ftl->lock), RT_WAITING_FOREVER);
+
+    for (index = 0; index < size; index += count)
+    {
+        page = ftl->map[pos + index];
+        if (page == 0)
+        {
+            /* never written */
+            rt_memset(data + index * RT_NOR_FTL_SECTOR_SIZE, 0xFF, RT_NOR_FTL_SECTOR_SIZE);
+            count = 1;
+            continue;
+        }
+
+        /* the sectors written together are read at once */
+        for (count = 1; index + count < size && ftl->map[pos + index + count] == page + count; count ++);
+
+        length = count * RT_NOR_FTL_SECTOR_SIZE;
+        if (rt_mtd_nor_read(ftl->mtd, _ftl_addr(ftl, page / ftl->pages, page % ftl->pages),
+                            data + index * RT_NOR_FTL_SECTOR_SIZE, length) != length)
+            break;
+    }
+    ftl->stats.host_reads += index;
+
+    rt_mutex_release(&(ftl->lock));
+
+    return index;
+}
+
+static rt_size_t _ftl_write(rt_device_t dev, rt_off_t pos, const void *buffer, rt_size_t size)
+{
+    rt_nor_ftl_t ftl = (rt_nor_ftl_t)dev;
+    const rt_uint8_t *data = (const rt_uint8_t *)buffer;
+    rt_size_t index, count;
+    rt_bool_t gc;
+
+    if (pos >= ftl->sector_count)
+        return 0;
+    if (size > ftl->sector_count - pos)
+        size = ftl->sector_count - pos;
+
+    rt_mutex_take(&(ftl->lock), RT_WAITING_FOREVER);
+
+    for (index = 0; index < size; index += count)
+    {
+        count = _ftl_program(ftl, pos + index, data + index * RT_NOR_FTL_SECTOR_SIZE, size - index);
+        if (count == 0)
+            break;
+    }
+    ftl->stats.host_writes += index;
+    gc = (ftl->free_count < NOR_FTL_GC_WATERMARK);
+
+    rt_mutex_release(&(ftl->lock));
+
+    if (gc)
+        rt_work_submit(&(ftl->gc_work), 0);
+
+    return index;
+}
+
+static rt_err_t _ftl_control(rt_device_t dev, int cmd, void *args)
+{
+    rt_nor_ftl_t ftl = (rt_nor_ftl_t)dev;
+    struct rt_nor_ftl_segment *segment;
+    rt_uint32_t index;
+
+    switch (cmd)
+    {
+    case RT_DEVICE_CTRL_BLK_GETGEOME:
+        {
+            struct rt_device_blk_geometry *geometry = (struct rt_device_blk_geometry *)args;
+
+            if (geometry == RT_NULL)
+                return -RT_EINVAL;
+            geometry->sector_count = ftl->sector_count;
+            geometry->bytes_per_sector = RT_NOR_FTL_SECTOR_SIZE;
+            geometry->block_size = RT_NOR_FTL_SECTOR_SIZE;
+        }
+        break;
+
+    case RT_DEVICE_CTRL_BLK_SYNC:
+        /* the sectors are written through */
+        break;
+
+    case RT_DEVICE_CTRL_BLK_ERASE:
+        /*
+         * The unmapped sectors would come back from their stale pages after
+         * power off, so the trim is ignored and the sectors keep their data.
+         */
+        break;
+
+    case RT_NOR_FTL_CTRL_GET_STATS:
+        {
+            struct rt_nor_ftl_stats *stats = (struct rt_nor_ftl_stats *)args;
+
+            if (stats == RT_NULL)
+                return -RT_EINVAL;
+
+            rt_mutex_take(&(ftl->lock), RT_WAITING_FOREVER);
+            rt_memcpy(stats, &(ftl->stats), sizeof(struct rt_nor_ftl_stats));
+            stats->erase_min = (rt_uint32_t)-1;
+            stats->erase_max = 0;
+            for (index = 0; index < ftl->segment_count; index ++)
+            {
+                segment = &(ftl->segments[index]);
+                if (segment->state == NOR_FTL_BAD)
+                    continue;
+                if (segment->erase_count < stats->erase_min)
+                    stats->erase_min = segment->erase_count;
+                if (segment->erase_count > stats->erase_max)
+                    stats->erase_max = segment->erase_count;
+            }
+            stats->free_segments = ftl->free_count;
+            rt_mutex_release(&(ftl->lock));
+        }
+        break;
+
+    default:
+        return -RT_ENOSYS;
+    }
+
+    return RT_EOK;
+}
+
+#ifdef RT_USING_DEVICE_OPS
+const static struct rt_device_ops nor_ftl_ops =
+{
+    RT_NULL,
+    RT_NULL,
+    RT_NULL,
+    _ftl_read,
+    _ftl_write,
+    _ftl_control
+};
+#endif
+
+/**
+ * This function will create a FTL block device on MTD Nor Flash. The segments
+ * written by FTL are mounted, and the other segments are erased when they are
+ * used, so the flash is formatted on its first use. The blank member of FTL
+ * device is set if no segment is written by FTL, the file system shall be
+ * made on it only in this case.
+ *
+ * @param name the name of FTL device
+ * @param mtd_name the name of MTD Nor Flash device
+ *
+ * @return the created FTL device, RT_NULL on error
+ */
+rt_nor_ftl_t rt_nor_ftl_create(const char *name, const char *mtd_name)
+{
+    struct rt_mtd_nor_device *mtd;
+    rt_nor_ftl_t ftl;
+    rt_uint32_t segment_size, segment_count, pages;
+
+    RT_ASSERT(name != RT_NULL);
+    RT_ASSERT(mtd_name != RT_NULL);
+
+    mtd = (struct rt_mtd_nor_device *)rt_device_find(mtd_name);
+    if (mtd == RT_NULL || mtd->parent.type != RT_Device_Class_MTD)
+    {
+        LOG_E("MTD device %s is not found", mtd_name);
+        return RT_NULL;
+    }
+
+    segment_size = mtd->block_size * RT_NOR_FTL_SEGMENT_BLOCKS;
+    segment_count = (mtd->block_end - mtd->block_start) / RT_NOR_FTL_SEGMENT_BLOCKS;
+    pages = segment_size / RT_NOR_FTL_SECTOR_SIZE;
+    if (pages < 2 || NOR_FTL_HEADER_SIZE + (pages - 1) * sizeof(rt_uint32_t) > RT_NOR_FTL_SECTOR_SIZE ||
+        segment_count <= RT_NOR_FTL_RESERVED || segment_count * pages > 0x10000)
+    {
+        LOG_E("%d segments of %d pages are not supported", segment_count, pages);
+        return RT_NULL;
+    }
+
+    ftl = (rt_nor_ftl_t)rt_calloc(1, sizeof(struct rt_nor_ftl));
+    if (ftl == RT_NULL)
+        return RT_NULL;
+
+    ftl->mtd = mtd;
+    ftl->base = mtd->block_start * mtd->block_size;
+    ftl->segment_size = segment_size;
+    ftl->segment_count = segment_count;
+    ftl->pages = pages;
+    ftl->sector_count = (segment_count - RT_NOR_FTL_RESERVED) * (pages - 1);
+    ftl->active = NOR_FTL_NONE;
+
+    ftl->map = (rt_uint16_t *)rt_calloc(ftl->sector_count, sizeof(rt_uint16_t));
+    ftl->segments = (struct rt_nor_ftl_segment *)rt_calloc(segment_count, sizeof(struct rt_nor_ftl_segment));
+    ftl->buffer = (rt_uint8_t *)rt_malloc(RT_NOR_FTL_SECTOR_SIZE);
+    ftl->tags = (rt_uint32_t *)rt_malloc((pages - 1) * sizeof(rt_uint32_t));
+    if (ftl->map == RT_NULL || ftl->segments == RT_NULL || ftl->buffer == RT_NULL || ftl->tags == RT_NULL)
+    {
+        LOG_E("no memory for %d sectors", ftl->sector_count);
+        goto __error;
+    }
+
+    if (rt_device_open(&(mtd->parent), RT_DEVICE_OFLAG_RDWR) != RT_EOK)
+    {
+        LOG_E("open %s failed", mtd_name);
+        goto __error;
+    }
+
+    if (_ftl_mount(ftl) != RT_EOK)
+    {
+        LOG_E("mount %s failed", mtd_name);
+        rt_device_close(&(mtd->parent));
+        goto __error;
+    }
+
+    rt_mutex_init(&(ftl->lock), name, RT_IPC_FLAG_FIFO);
+    rt_work_init(&(ftl->gc_work), _ftl_gc_work, ftl);
+
+    ftl->parent.type = RT_Device_Class_Block;
+#ifdef RT_USING_DEVICE_OPS
+    ftl->parent.ops = &nor_ftl_ops;
+#else
+    ftl->parent.init = RT_NULL;
+    ftl->parent.open = RT_NULL;
+    ftl->parent.close = RT_NULL;
+    ftl->parent.read = _ftl_read;
+    ftl->parent.write = _ftl_write;
+    ftl->parent.control = _ftl_control;
+#endif
+    if (rt_device_register(&(ftl->parent), name, RT_DEVICE_FLAG_RDWR) != RT_EOK)
+    {
+        rt_device_close(&(mtd->parent));
+        rt_mutex_detach(&(ftl->lock));
+        goto __error;
+    }
+
+    rt_enter_critical();
+    rt_list_insert_before(&_nor_ftl_list, &(ftl->node));
+    rt_exit_critical();
+
+    return ftl;
+
+__error:
+    rt_free(ftl->tags);
+    rt_free(ftl->buffer);
+    rt_free(ftl->segments);
+    rt_free(ftl->map);
+    rt_free(ftl);
+    return RT_NULL;
+}
+RTM_EXPORT(rt_nor_ftl_create);
+
+/**
+ * This function will delete the FTL device. The FTL device shall not be in
+ * use.
+ *
+ * @param ftl the FTL device
+ *
+ * @return RT_EOK
+ */
+rt_err_t rt_nor_ftl_delete(rt_nor_ftl_t ftl)
+{
+    RT_ASSERT(ftl != RT_NULL);
+
+    /* wait for the running garbage collection */
+    while (rt_work_cancel(&(ftl->gc_work)) == -RT_EBUSY)
+    {
+        rt_thread_mdelay(1);
+    }
+
+    rt_enter_critical();
+    rt_list_remove(&(ftl->node));
+    rt_exit_critical();
+
+    rt_device_unregister(&(ftl->parent));
+    rt_device_close(&(ftl->mtd->parent));
+    rt_mutex_detach(&(ftl->lock));
+    rt_free(ftl->tags);
+    rt_free(ftl->buffer);
+    rt_free(ftl->segments);
+    rt_free(ftl->map);
+    rt_free(ftl);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_nor_ftl_delete);
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+static void list_nor_ftl(void)
+{
+    struct rt_nor_ftl_stats stats;
+    rt_list_t *node;
+    rt_nor_ftl_t ftl;
+    rt_uint32_t amplification;
+
+    rt_kprintf("%-*.*s   writes    pages gc copies   erases wear free erase min/max  WA\n",
+               RT_NAME_MAX, RT_NAME_MAX, "ftl");
+    rt_kprintf("%-*.*s -------- -------- --------- -------- ---- ---- ------------- ----\n",
+               RT_NAME_MAX, RT_NAME_MAX, "------------------------------");
+
+    /* the FTL devices are only deleted by their owner, the list is stable */
+    for (node = _nor_ftl_list.next; node != &_nor_ftl_list; node = node->next)
+    {
+        ftl = rt_list_entry(node, struct rt_nor_ftl, node);
+        _ftl_control(&(ftl->parent), RT_NOR_FTL_CTRL_GET_STATS, &stats);
+
+        /* the write amplification in 1/100 */
+        amplification = stats.host_writes ? (rt_uint32_t)((rt_uint64_t)stats.page_writes * 100 / stats.host_writes) : 0;
+        rt_kprintf("%-*.*s %8d %8d %9d %8d %4d %4d %6d/%-6d %d.%02d\n",
+                   RT_NAME_MAX, RT_NAME_MAX, ftl->parent.parent.name, stats.host_writes,
+                   stats.page_writes, stats.gc_copies, stats.erases, stats.wear_moves,
+                   stats.free_segments, stats.erase_min, stats.erase_max,
+                   amplification / 100, amplification % 100);
+    }
+}
+FINSH_FUNCTION_EXPORT(list_nor_ftl, list flash translation layer in system)
+MSH_CMD_EXPORT(list_nor_ftl, list flash translation layer in system);
+#endif /* RT_USING_FINSH */
@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author        Notes
  * 2011-07-25     weety     first version
+ * 2026-10-19     Hehesheng add block request queue
  */
 
 #include <rtthread.h>
@@ -25,6 +26,32 @@ static rt_list_t blk_devices = RT_LIST_OBJECT_INIT(blk_devices);
 
 #define BLK_MIN(a, b) ((a) < (b) ? (a) : (b))
 
+#ifdef RT_MMCSD_USING_BLK_QUEUE
+#ifndef RT_MMCSD_BLK_MERGE_SECTORS
+#define RT_MMCSD_BLK_MERGE_SECTORS 16
+#endif
+
+#ifndef RT_MMCSD_BLK_QUEUE_STACK_SIZE
+#define RT_MMCSD_BLK_QUEUE_STACK_SIZE 1024
+#endif
+
+/* the request queue of card, shared by its partitions */
+struct mmcsd_blk_queue
+{
+    struct rt_mmcsd_card *card;
+    struct rt_mutex lock;
+    rt_list_t pending;
+    struct rt_semaphore sem;
+    rt_uint32_t order;
+    rt_uint32_t head;                   /* the sector after the last transfer */
+    rt_size_t max_req_size;
+    rt_size_t max_merge;                /* the sectors of bounce buffer */
+    rt_uint8_t *bounce;
+    rt_bool_t removed;
+    struct rt_mmcsd_blk_stats stats;
+};
+#endif /* RT_MMCSD_USING_BLK_QUEUE */
+
 struct mmcsd_blk_device
 {
     struct rt_mmcsd_card *card;
@@ -33,6 +60,9 @@ struct mmcsd_blk_device
     struct dfs_partition part;
     struct rt_device_blk_geometry geometry;
     rt_size_t max_req_size;
+#ifdef RT_MMCSD_USING_BLK_QUEUE
+    struct mmcsd_blk_queue *queue;
+#endif
 };
 
 #ifndef RT_MMCSD_MAX_PARTITION
@@ -202,6 +232,473 @@ static rt_err_t rt_mmcsd_req_blk(struct rt_mmcsd_card *card,
     return RT_EOK;
 }
 
+#ifdef RT_MMCSD_USING_BLK_QUEUE
+/*
+ * The requests of card are queued and done by its queue thread. The thread
+ * takes the requests in order of sector from the last transfer (C-SCAN), and
+ * merges the requests with continuous sectors into one multiple block
+ * transfer through the bounce buffer. A request is never taken before the
+ * requests submitted earlier and overlapped with it, if one of them writes.
+ *
+ * The multiple block write of SD card is hinted by ACMD23, so the card can
+ * pre-erase the blocks.
+ */
+
+static rt_int32_t mmcsd_set_wr_blk_erase_count(struct rt_mmcsd_card *card, rt_uint32_t blocks)
+{
+    struct rt_mmcsd_cmd cmd;
+    rt_int32_t err;
+
+    rt_memset(&cmd, 0, sizeof(struct rt_mmcsd_cmd));
+
+    cmd.cmd_code = APP_CMD;
+    cmd.arg = card->rca << 16;
+    cmd.flags = RESP_R1 | CMD_AC;
+
+    err = mmcsd_send_cmd(card->host, &cmd, 0);
+    if (err)
+        return -RT_ERROR;
+    if (!(cmd.resp[0] & R1_APP_CMD))
+        return -RT_ERROR;
+
+    rt_memset(&cmd, 0, sizeof(struct rt_mmcsd_cmd));
+
+    cmd.cmd_code = SD_APP_SET_WR_BLK_ERASE_COUNT;
+    cmd.arg = blocks & 0x7FFFFF;
+    cmd.flags = RESP_R1 | CMD_AC;
+
+    err = mmcsd_send_cmd(card->host, &cmd, 0);
+    if (err)
+        return -RT_ERROR;
+
+    return RT_EOK;
+}
+
+rt_inline rt_bool_t mmcsd_blk_overlap(struct rt_mmcsd_blk_request *a, struct rt_mmcsd_blk_request *b)
+{
+    return (a->dir || b->dir) &&
+           a->sector < b->sector + b->count && b->sector < a->sector + a->count;
+}
+
+/* the request can be taken if no earlier request overlaps with it */
+static rt_bool_t mmcsd_blk_ready(struct mmcsd_blk_queue *queue, struct rt_mmcsd_blk_request *request)
+{
+    struct rt_mmcsd_blk_request *other;
+
+    rt_list_for_each_entry(other, &queue->pending, list)
+    {
+        if ((rt_int32_t)(other->order - request->order) < 0 && mmcsd_blk_overlap(other, request))
+            return RT_FALSE;
+    }
+
+    return RT_TRUE;
+}
+
+/* take the next request and the requests merged to it */
+static rt_size_t mmcsd_blk_take(struct mmcsd_blk_queue *queue, rt_list_t *batch)
+{
+    struct rt_mmcsd_blk_request *request, *next, *wrap;
+    rt_uint32_t end;
+    rt_size_t count;
+    rt_uint8_t dir;
+
+    next = RT_NULL;
+    wrap = RT_NULL;
+    rt_list_for_each_entry(request, &queue->pending, list)
+    {
+        if (!mmcsd_blk_ready(queue, request))
+            continue;
+
+        if (request->sector >= queue->head)
+        {
+            if (next == RT_NULL || request->sector < next->sector)
+                next = request;
+        }
+        else if (wrap == RT_NULL || request->sector < wrap->sector)
+        {
+            wrap = request;
+        }
+    }
+
+    if (next == RT_NULL)
+        next = wrap;
+    if (next == RT_NULL)
+        return 0;
+
+    rt_list_remove(&next->list);
+    rt_list_insert_before(batch, &next->list);
+    count = next->count;
+    end = next->sector + next->count;
+    dir = next->dir;
+
+    /* merge the following requests */
+    while (count < queue->max_merge)
+    {
+        next = RT_NULL;
+        rt_list_for_each_entry(request, &queue->pending, list)
+        {
+            if (request->sector == end && request->dir == dir &&
+                count + request->count <= queue->max_merge && mmcsd_blk_ready(queue, request))
+            {
+                next = request;
+                break;
+            }
+        }
+        if (next == RT_NULL)
+            break;
+
+        rt_list_remove(&next->list);
+        rt_list_insert_before(batch, &next->list);
+        count += next->count;
+        end += next->count;
+        queue->stats.merged ++;
+    }
+
+    return count;
+}
+
+static rt_err_t mmcsd_blk_transfer(struct mmcsd_blk_queue *queue, rt_list_t *batch, rt_size_t count)
+{
+    struct rt_mmcsd_card *card = queue->card;
+    struct rt_mmcsd_blk_request *first, *request;
+    rt_uint8_t *buffer, *ptr;
+    rt_uint32_t sector;
+    rt_size_t offset, req_size;
+    rt_err_t err = RT_EOK;
+
+    first = rt_list_entry(batch->next, struct rt_mmcsd_blk_request, list);
+
+    /* the buffers of requests merged are not continuous */
+    buffer = (rt_uint8_t *)first->buffer;
+    ptr = buffer;
+    rt_list_for_each_entry(request, batch, list)
+    {
+        if ((rt_uint8_t *)request->buffer != ptr)
+        {
+            buffer = queue->bounce;
+            break;
+        }
+        ptr += request->count << 9;
+    }
+
+    if (buffer == queue->bounce && first->dir)
+    {
+        ptr = buffer;
+        rt_list_for_each_entry(request, batch, list)
+        {
+            rt_memcpy(ptr, request->buffer, request->count << 9);
+            ptr += request->count << 9;
+        }
+    }
+
+    mmcsd_host_lock(card->host);
+    for (offset = 0, sector = first->sector; offset < count; offset += req_size)
+    {
+        req_size = BLK_MIN(count - offset, queue->max_req_size);
+
+        if (first->dir && req_size > 1 && card->card_type == CARD_TYPE_SD &&
+            !controller_is_spi(card->host) &&
+            mmcsd_set_wr_blk_erase_count(card, req_size) == RT_EOK)
+        {
+            queue->stats.pre_erases ++;
+        }
+
+        err = rt_mmcsd_req_blk(card, sector + offset, buffer + (offset << 9), req_size, first->dir);
+        if (err)
+            break;
+        queue->stats.transfers ++;
+        queue->stats.sectors += req_size;
+    }
+    mmcsd_host_unlock(card->host);
+
+    if (err == RT_EOK && buffer == queue->bounce && !first->dir)
+    {
+        ptr = buffer;
+        rt_list_for_each_entry(request, batch, list)
+        {
+            rt_memcpy(request->buffer, ptr, request->count << 9);
+            ptr += request->count << 9;
+        }
+    }
+
+    queue->head = first->sector + count;
+
+    return err;
+}
+
+static void mmcsd_blk_complete(struct mmcsd_blk_queue *queue, struct rt_mmcsd_blk_request *request, rt_err_t result)
+{
+    rt_tick_t latency;
+
+    rt_list_remove(&request->list);
+    request->result = result;
+
+    rt_mutex_take(&queue->lock, RT_WAITING_FOREVER);
+    latency = rt_tick_get() - request->stamp;
+    queue->stats.depth --;
+    queue->stats.latency_sum += latency;
+    if (latency > queue->stats.latency_max)
+        queue->stats.latency_max = latency;
+    if (result != RT_EOK)
+        queue->stats.errors ++;
+    rt_mutex_release(&queue->lock);
+
+    if (request->done != RT_NULL)
+        request->done(request);
+    else
+        rt_completion_done(&request->completion);
+}
+
+static void mmcsd_blk_queue_entry(void *parameter)
+{
+    struct mmcsd_blk_queue *queue = (struct mmcsd_blk_queue *)parameter;
+    rt_list_t batch;
+    rt_size_t count;
+    rt_err_t err;
+
+    while (1)
+    {
+        rt_sem_take(&queue->sem, RT_WAITING_FOREVER);
+
+        while (1)
+        {
+            rt_list_init(&batch);
+
+            rt_mutex_take(&queue->lock, RT_WAITING_FOREVER);
+            count = queue->removed ? 0 : mmcsd_blk_take(queue, &batch);
+            rt_mutex_release(&queue->lock);
+
+            if (count == 0)
+                break;
+
+            err = mmcsd_blk_transfer(queue, &batch, count);
+
+            while (!rt_list_isempty(&batch))
+            {
+                mmcsd_blk_complete(queue, rt_list_entry(batch.next, struct rt_mmcsd_blk_request, list),
+                                   err == RT_EOK ? RT_EOK : -RT_EIO);
+            }
+        }
+
+        if (queue->removed)
+            break;
+    }
+
+    /* the card is removed, fail the requests left */
+    rt_mutex_take(&queue->lock, RT_WAITING_FOREVER);
+    while (!rt_list_isempty(&queue->pending))
+    {
+        rt_list_t *node = queue->pending.next;
+
+        rt_list_remove(node);
+        rt_list_insert_before(&batch, node);
+    }
+    rt_mutex_release(&queue->lock);
+
+    while (!rt_list_isempty(&batch))
+    {
+        mmcsd_blk_complete(queue, rt_list_entry(batch.next, struct rt_mmcsd_blk_request, list), -RT_EIO);
+    }
+
+    rt_sem_detach(&queue->sem);
+    rt_mutex_detach(&queue->lock);
+    rt_free(queue->bounce);
+    rt_free(queue);
+}
+
+static struct mmcsd_blk_queue *mmcsd_blk_queue_create(struct rt_mmcsd_card *card, rt_size_t max_req_size)
+{
+    struct mmcsd_blk_queue *queue;
+    rt_thread_t thread;
+
+    queue = rt_calloc(1, sizeof(struct mmcsd_blk_queue));
+    if (queue == RT_NULL)
+        return RT_NULL;
+
+    queue->card = card;
+    queue->max_req_size = max_req_size;
+    queue->max_merge = RT_MMCSD_BLK_MERGE_SECTORS;
+    queue->bounce = rt_malloc(RT_MMCSD_BLK_MERGE_SECTORS << 9);
+    if (queue->bounce == RT_NULL)
+    {
+        rt_free(queue);
+        return RT_NULL;
+    }
+    rt_list_init(&queue->pending);
+    rt_mutex_init(&queue->lock, "blkq", RT_IPC_FLAG_FIFO);
+    rt_sem_init(&queue->sem, "blkq", 0, RT_IPC_FLAG_FIFO);
+
+    thread = rt_thread_create("blkq", mmcsd_blk_queue_entry, queue,
+                              RT_MMCSD_BLK_QUEUE_STACK_SIZE, RT_MMCSD_THREAD_PREORITY, 20);
+    if (thread == RT_NULL)
+    {
+        rt_sem_detach(&queue->sem);
+        rt_mutex_detach(&queue->lock);
+        rt_free(queue->bounce);
+        rt_free(queue);
+        return RT_NULL;
+    }
+    rt_thread_startup(thread);
+
+    return queue;
+}
+
+static void mmcsd_blk_queue_delete(struct mmcsd_blk_queue *queue)
+{
+    /* the thread releases the queue */
+    rt_mutex_take(&queue->lock, RT_WAITING_FOREVER);
+    queue->removed = RT_TRUE;
+    rt_mutex_release(&queue->lock);
+    rt_sem_release(&queue->sem);
+}
+
+/**
+ * This function will initialize a block request.
+ *
+ * @param request the request to be initialized
+ * @param pos the first sector in partition
+ * @param buffer the data buffer
+ * @param count the number of sectors
+ * @param dir 0 to read, 1 to write
+ * @param done the callback invoked in queue thread, RT_NULL if the request is
+ *        waited by rt_mmcsd_blk_request_wait
+ * @param user_data the user data of request
+ */
+void rt_mmcsd_blk_request_init(struct rt_mmcsd_blk_request *request,
+                               rt_off_t    pos,
+                               void       *buffer,
+                               rt_size_t   count,
+                               rt_uint8_t  dir,
+                               void (*done)(struct rt_mmcsd_blk_request *request),
+                               void       *user_data)
+{
+    RT_ASSERT(request != RT_NULL);
+
+    rt_list_init(&request->list);
+    request->sector    = pos;
+    request->count     = count;
+    request->buffer    = buffer;
+    request->dir       = dir;
+    request->done      = done;
+    request->user_data = user_data;
+    request->queue     = RT_NULL;
+    request->result    = RT_EOK;
+    rt_completion_init(&request->completion);
+}
+
+/**
+ * This function will submit a block request to the queue of card. It shall
+ * be invoked in thread.
+ *
+ * @param dev the mmcsd block device
+ * @param request the request initialized by rt_mmcsd_blk_request_init
+ *
+ * @return RT_EOK on submitted, -RT_ENOSYS if the device has no queue
+ */
+rt_err_t rt_mmcsd_blk_submit(rt_device_t dev, struct rt_mmcsd_blk_request *request)
+{
+    struct mmcsd_blk_device *blk_dev;
+    struct mmcsd_blk_queue *queue;
+
+    RT_ASSERT(dev != RT_NULL);
+    RT_ASSERT(request != RT_NULL);
+    RT_ASSERT(request->count > 0);
+
+    blk_dev = (struct mmcsd_blk_device *)dev->user_data;
+    queue = blk_dev->queue;
+    if (queue == RT_NULL)
+        return -RT_ENOSYS;
+
+    rt_mutex_take(&queue->lock, RT_WAITING_FOREVER);
+    if (queue->removed)
+    {
+        rt_mutex_release(&queue->lock);
+        return -RT_EIO;
+    }
+
+    request->sector += blk_dev->part.offset;
+    request->order = queue->order ++;
+    request->stamp = rt_tick_get();
+    request->queue = queue;
+    rt_list_insert_before(&queue->pending, &request->list);
+
+    queue->stats.requests ++;
+    queue->stats.depth ++;
+    if (queue->stats.depth > queue->stats.depth_max)
+        queue->stats.depth_max = queue->stats.depth;
+    rt_mutex_release(&queue->lock);
+
+    rt_sem_release(&queue->sem);
+
+    return RT_EOK;
+}
+
+/**
+ * This function will wait for the request without done callback.
+ *
+ * On timeout, the request not taken by the queue thread yet is removed from
+ * the queue, and it's owned by the caller again. The request already in
+ * transfer is used by the queue thread until it's done, so it's waited
+ * further and its result is returned.
+ *
+ * @param request the submitted request
+ * @param timeout the timeout in tick
+ *
+ * @return the result of request, -RT_ETIMEOUT if it's removed on timeout
+ */
+rt_err_t rt_mmcsd_blk_request_wait(struct rt_mmcsd_blk_request *request, rt_int32_t timeout)
+{
+    struct mmcsd_blk_queue *queue;
+    struct rt_mmcsd_blk_request *pending;
+
+    RT_ASSERT(request != RT_NULL);
+    RT_ASSERT(request->done == RT_NULL);
+    RT_ASSERT(request->queue != RT_NULL);
+
+    if (rt_completion_wait(&request->completion, timeout) == RT_EOK)
+        return request->result;
+
+    /* remove the request not taken yet */
+    queue = request->queue;
+    rt_mutex_take(&queue->lock, RT_WAITING_FOREVER);
+    rt_list_for_each_entry(pending, &queue->pending, list)
+    {
+        if (pending == request)
+        {
+            rt_list_remove(&request->list);
+            queue->stats.depth --;
+            rt_mutex_release(&queue->lock);
+            return -RT_ETIMEOUT;
+        }
+    }
+    rt_mutex_release(&queue->lock);
+
+    /* the request is in transfer, the queue thread is using it until it's done */
+    rt_completion_wait(&request->completion, RT_WAITING_FOREVER);
+
+    return request->result;
+}
+
+static rt_size_t mmcsd_blk_queue_xfer(struct mmcsd_blk_device *blk_dev,
+                                      rt_off_t    pos,
+                                      void       *buffer,
+                                      rt_size_t   size,
+                                      rt_uint8_t  dir)
+{
+    struct rt_mmcsd_blk_request request;
+
+    rt_mmcsd_blk_request_init(&request, pos, buffer, size, dir, RT_NULL, RT_NULL);
+    if (rt_mmcsd_blk_submit(&blk_dev->dev, &request) != RT_EOK ||
+        rt_mmcsd_blk_request_wait(&request, RT_WAITING_FOREVER) != RT_EOK)
+    {
+        rt_set_errno(-EIO);
+        return 0;
+    }
+
+    return size;
+}
+#endif /* RT_MMCSD_USING_BLK_QUEUE */
+
 static rt_err_t rt_mmcsd_init(rt_device_t dev)
 {
     return RT_EOK;
@@ -225,6 +722,15 @@ static rt_err_t rt_mmcsd_control(rt_device_t dev, int cmd, void *args)
     case RT_DEVICE_CTRL_BLK_GETGEOME:
         rt_memcpy(args, &blk_dev->geometry, sizeof(struct rt_device_blk_geometry));
         break;
+#ifdef RT_MMCSD_USING_BLK_QUEUE
+    case RT_MMCSD_BLK_CTRL_GET_STATS:
+        if (blk_dev->queue == RT_NULL)
+            return -RT_ENOSYS;
+        rt_mutex_take(&blk_dev->queue->lock, RT_WAITING_FOREVER);
+        rt_memcpy(args, &blk_dev->queue->stats, sizeof(struct rt_mmcsd_blk_stats));
+        rt_mutex_release(&blk_dev->queue->lock);
+        break;
+#endif
     default:
         break;
     }
@@ -250,6 +756,11 @@ static rt_size_t rt_mmcsd_read(rt_device_t dev,
         return 0;
     }
 
+#ifdef RT_MMCSD_USING_BLK_QUEUE
+    if (blk_dev->queue != RT_NULL)
+        return mmcsd_blk_queue_xfer(blk_dev, pos, rd_ptr, size, 0);
+#endif
+
     rt_sem_take(part->lock, RT_WAITING_FOREVER);
     while (remain_size)
     {
@@ -291,6 +802,11 @@ static rt_size_t rt_mmcsd_write(rt_device_t dev,
         return 0;
     }
 
+#ifdef RT_MMCSD_USING_BLK_QUEUE
+    if (blk_dev->queue != RT_NULL)
+        return mmcsd_blk_queue_xfer(blk_dev, pos, wr_ptr, size, 1);
+#endif
+
     rt_sem_take(part->lock, RT_WAITING_FOREVER);
     while (remain_size)
     {
@@ -360,6 +876,9 @@ rt_int32_t rt_mmcsd_blk_probe(struct rt_mmcsd_card *card)
     char dname[4];
     char sname[8];
     struct mmcsd_blk_device *blk_dev = RT_NULL;
+#ifdef RT_MMCSD_USING_BLK_QUEUE
+    struct mmcsd_blk_queue *queue = RT_NULL;
+#endif
 
     err = mmcsd_set_blksize(card);
     if(err) 
@@ -381,6 +900,18 @@ rt_int32_t rt_mmcsd_blk_probe(struct rt_mmcsd_card *card)
     status = rt_mmcsd_req_blk(card, 0, sector, 1, 0);
     if (status == RT_EOK)
     {
+#ifdef RT_MMCSD_USING_BLK_QUEUE
+        /* the partitions share the queue of card */
+        queue = mmcsd_blk_queue_create(card, BLK_MIN((card->host->max_dma_segs *
+                                                      card->host->max_seg_size) >> 9,
+                                                     (card->host->max_blk_count *
+                                                      card->host->max_blk_size) >> 9));
+        if (queue == RT_NULL)
+        {
+            LOG_W("mmcsd:create request queue failed!");
+        }
+#endif
+
         for (i = 0; i < RT_MMCSD_MAX_PARTITION; i++)
         {
             blk_dev = rt_calloc(1, sizeof(struct mmcsd_blk_device));
@@ -394,6 +925,9 @@ rt_int32_t rt_mmcsd_blk_probe(struct rt_mmcsd_card *card)
                                              card->host->max_seg_size) >> 9, 
                                             (card->host->max_blk_count * 
                                              card->host->max_blk_size) >> 9);
+#ifdef RT_MMCSD_USING_BLK_QUEUE
+            blk_dev->queue = queue;
+#endif
 
             /* get the first partition */
             status = dfs_filesystem_get_partition(&blk_dev->part, sector, i);
@@ -486,6 +1020,24 @@ rt_int32_t rt_mmcsd_blk_probe(struct rt_mmcsd_card *card)
         LOG_E("read mmcsd first sector failed");
         err = -RT_ERROR;
     }
+
+#ifdef RT_MMCSD_USING_BLK_QUEUE
+    if (queue != RT_NULL)
+    {
+        rt_bool_t used = RT_FALSE;
+        rt_list_t *l;
+
+        for (l = blk_devices.next; l != &blk_devices; l = l->next)
+        {
+            if (rt_list_entry(l, struct mmcsd_blk_device, list)->queue == queue)
+                used = RT_TRUE;
+        }
+
+        /* no partition is registered */
+        if (!used)
+            mmcsd_blk_queue_delete(queue);
+    }
+#endif
     
     /* release sector buffer */
     rt_free(sector);
@@ -497,6 +1049,9 @@ void rt_mmcsd_blk_remove(struct rt_mmcsd_card *card)
 {
     rt_list_t *l, *n;
     struct mmcsd_blk_device *blk_dev;
+#ifdef RT_MMCSD_USING_BLK_QUEUE
+    struct mmcsd_blk_queue *queue = RT_NULL;
+#endif
 
     for (l = (&blk_devices)->next, n = l->next; l != &blk_devices; l = n)
     {
@@ -510,12 +1065,53 @@ void rt_mmcsd_blk_remove(struct rt_mmcsd_card *card)
         		dfs_unmount(mounted_path);
         	}
 
+#ifdef RT_MMCSD_USING_BLK_QUEUE
+            if (blk_dev->queue != RT_NULL)
+                queue = blk_dev->queue;
+#endif
             rt_device_unregister(&blk_dev->dev);
             rt_list_remove(&blk_dev->list);
             rt_free(blk_dev);
         }
     }
+
+#ifdef RT_MMCSD_USING_BLK_QUEUE
+    if (queue != RT_NULL)
+        mmcsd_blk_queue_delete(queue);
+#endif
+}
+
+#if defined(RT_MMCSD_USING_BLK_QUEUE) && defined(RT_USING_FINSH)
+#include <finsh.h>
+
+static void list_sd_queue(void)
+{
+    struct mmcsd_blk_device *blk_dev;
+    struct rt_mmcsd_blk_stats stats;
+    rt_list_t *l;
+
+    rt_kprintf("%-*.*s requests   merged transfers  sectors pre-erase errors depth/max lat avg/max(ms)\n",
+               RT_NAME_MAX, RT_NAME_MAX, "device");
+    rt_kprintf("%-*.*s -------- -------- --------- -------- --------- ------ --------- --------------\n",
+               RT_NAME_MAX, RT_NAME_MAX, "------------------------------");
+
+    for (l = blk_devices.next; l != &blk_devices; l = l->next)
+    {
+        blk_dev = rt_list_entry(l, struct mmcsd_blk_device, list);
+        if (rt_mmcsd_control(&blk_dev->dev, RT_MMCSD_BLK_CTRL_GET_STATS, &stats) != RT_EOK)
+            continue;
+
+        rt_kprintf("%-*.*s %8d %8d %9d %8d %9d %6d %4d/%-4d %6d/%-7d\n",
+                   RT_NAME_MAX, RT_NAME_MAX, blk_dev->dev.parent.name, stats.requests, stats.merged,
+                   stats.transfers, stats.sectors, stats.pre_erases, stats.errors, stats.depth,
+                   stats.depth_max,
+                   stats.requests ? (rt_uint32_t)((rt_uint64_t)stats.latency_sum * 1000 / RT_TICK_PER_SECOND / stats.requests) : 0,
+                   stats.latency_max * 1000 / RT_TICK_PER_SECOND);
+    }
 }
+FINSH_FUNCTION_EXPORT(list_sd_queue, list request queue of sd card)
+MSH_CMD_EXPORT(list_sd_queue, list request queue of sd card);
+#endif
 
 /*
  * This function will initialize block device on the mmc/sd.
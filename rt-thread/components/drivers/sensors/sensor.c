@@ -6,8 +6,10 @@
  * Change Logs:
  * Date           Author       Notes
  * 2019-01-31     flybreak     first version
+ * 2026-10-19     Hehesheng    add fifo mode batching by ring buffer
  */
 
+#include <rthw.h>
 #include "sensor.h"
 
 #define DBG_TAG  "sensor"
@@ -34,12 +36,233 @@ static char *const sensor_name_str[] =
     "forc_"      /* Force sensor      */
 };
 
+#ifdef RT_SENSOR_USING_FIFO_RING
+/*
+ * The fifo mode: the interrupt only takes the timestamp and submits the drain
+ * work, the drain reads the fifo of the device by fetch_data in bus bursts of
+ * fifo_max samples, stamps the samples and puts them to the ring as a batch.
+ * The drain is the only producer and the reader is the only consumer of the
+ * ring, so the reader never touches the bus. The samples which can't be put
+ * to the ring are dropped.
+ */
+
+/* The timestamp of the sample in ticks, index is counted from the sample at
+ * the interrupt and it's negative for the earlier ones */
+static rt_uint32_t sensor_fifo_ts(rt_sensor_t sensor, rt_uint32_t irq_ts, rt_int32_t index)
+{
+    rt_uint32_t num = 0, den = 1, offset;
+
+    if (sensor->config.odr > 0)
+    {
+        num = RT_SENSOR_FIFO_TS_PER_SECOND;
+        den = sensor->config.odr;
+    }
+    else if (sensor->info.period_min > 0)
+    {
+        num = RT_SENSOR_FIFO_TS_PER_SECOND * sensor->info.period_min;
+        den = 1000;
+    }
+
+    offset = (rt_uint32_t)(((rt_uint64_t)(index < 0 ? -index : index) * num + den / 2) / den);
+
+    return index < 0 ? irq_ts - offset : irq_ts + offset;
+}
+
+static rt_size_t sensor_fifo_fetch(rt_sensor_t sensor, struct rt_sensor_data *data)
+{
+    rt_size_t count;
+
+    if (sensor->module)
+    {
+        rt_mutex_take(sensor->module->lock, RT_WAITING_FOREVER);
+    }
+
+    /* The buffer is filled by the drain of another sensor in the module */
+    if (sensor->data_len > 0)
+    {
+        count = sensor->data_len / sizeof(struct rt_sensor_data);
+        if (count > sensor->info.fifo_max)
+        {
+            count = sensor->info.fifo_max;
+        }
+        rt_memcpy(data, sensor->data_buf, count * sizeof(struct rt_sensor_data));
+        sensor->data_len = 0;
+    }
+    else
+    {
+        count = sensor->ops->fetch_data(sensor, data, sensor->info.fifo_max);
+    }
+
+    if (sensor->module)
+    {
+        rt_mutex_release(sensor->module->lock);
+    }
+
+    return count;
+}
+
+static void sensor_fifo_drain(struct rt_sensor_fifo *fifo, rt_uint32_t irq_ts)
+{
+    rt_sensor_t sensor = fifo->sensor;
+    rt_size_t count, space, i;
+    rt_int32_t index = 0;
+    rt_uint32_t burst;
+
+    /* The fifo may be over the watermark when it's drained late, go on while
+     * the burst is full, at most a ring of bursts for one interrupt */
+    for (burst = 0; burst < RT_SENSOR_FIFO_RING_BATCHES; burst ++)
+    {
+        count = sensor_fifo_fetch(sensor, fifo->batch);
+        if (count == 0)
+        {
+            break;
+        }
+
+        /* The last sample of the first burst is taken as sampled at the
+         * interrupt, the others are extrapolated by the output data rate */
+        if (burst == 0)
+        {
+            index = 1 - (rt_int32_t)count;
+        }
+        for (i = 0; i < count; i ++, index ++)
+        {
+            fifo->batch[i].timestamp = sensor_fifo_ts(sensor, irq_ts, index);
+        }
+
+        space = rt_spsc_ring_space_len(fifo->ring) / sizeof(struct rt_sensor_data);
+        if (space > count)
+        {
+            space = count;
+        }
+        rt_spsc_ring_put(fifo->ring, (rt_uint8_t *)fifo->batch, space * sizeof(struct rt_sensor_data));
+
+        fifo->stats.batches ++;
+        fifo->stats.samples += count;
+        fifo->stats.dropped += count - space;
+
+        if (space > 0 && sensor->parent.rx_indicate != RT_NULL)
+        {
+            sensor->parent.rx_indicate(&sensor->parent,
+                                       rt_spsc_ring_data_len(fifo->ring) / sizeof(struct rt_sensor_data));
+        }
+
+        if (count < sensor->info.fifo_max)
+        {
+            break;
+        }
+    }
+}
+
+static void sensor_fifo_work(struct rt_work *work, void *work_data)
+{
+    struct rt_sensor_fifo *fifo = (struct rt_sensor_fifo *)work_data;
+    rt_uint32_t irq_ts;
+    rt_base_t level;
+
+    /* The work can't be submitted while it's running, so the interrupts in
+     * the drain are served by the loop */
+    while (1)
+    {
+        level = rt_hw_interrupt_disable();
+        if (!fifo->pending)
+        {
+            rt_hw_interrupt_enable(level);
+            break;
+        }
+        fifo->pending = RT_FALSE;
+        irq_ts = fifo->irq_ts;
+        rt_hw_interrupt_enable(level);
+
+        sensor_fifo_drain(fifo, irq_ts);
+    }
+}
+
+static rt_err_t sensor_fifo_create(rt_sensor_t sensor)
+{
+    struct rt_sensor_fifo *fifo;
+    rt_uint32_t size, ring_size;
+    rt_base_t level;
+
+    /* The ring is in power of two bytes, for RT_SENSOR_FIFO_RING_BATCHES full batches at least */
+    size = sensor->info.fifo_max * RT_SENSOR_FIFO_RING_BATCHES * sizeof(struct rt_sensor_data);
+    for (ring_size = 1; ring_size < size; ring_size <<= 1);
+
+    fifo = (struct rt_sensor_fifo *)rt_calloc(1, sizeof(struct rt_sensor_fifo));
+    if (fifo == RT_NULL)
+    {
+        return -RT_ENOMEM;
+    }
+    fifo->batch = (struct rt_sensor_data *)rt_malloc(sensor->info.fifo_max * sizeof(struct rt_sensor_data));
+    fifo->ring = rt_spsc_ring_create(ring_size);
+    if (fifo->batch == RT_NULL || fifo->ring == RT_NULL)
+    {
+        if (fifo->batch != RT_NULL)
+            rt_free(fifo->batch);
+        if (fifo->ring != RT_NULL)
+            rt_spsc_ring_destroy(fifo->ring);
+        rt_free(fifo);
+        return -RT_ENOMEM;
+    }
+    fifo->sensor = sensor;
+    rt_work_init(&fifo->work, sensor_fifo_work, fifo);
+
+    level = rt_hw_interrupt_disable();
+    sensor->fifo = fifo;
+    rt_hw_interrupt_enable(level);
+
+    return RT_EOK;
+}
+
+static void sensor_fifo_delete(rt_sensor_t sensor)
+{
+    struct rt_sensor_fifo *fifo;
+    rt_base_t level;
+
+    /* The interrupt of the module can't submit the work any more */
+    level = rt_hw_interrupt_disable();
+    fifo = sensor->fifo;
+    sensor->fifo = RT_NULL;
+    rt_hw_interrupt_enable(level);
+
+    if (fifo == RT_NULL)
+    {
+        return;
+    }
+
+    /* Wait for the running drain */
+    while (rt_work_cancel(&fifo->work) == -RT_EBUSY)
+    {
+        rt_thread_mdelay(1);
+    }
+
+    rt_spsc_ring_destroy(fifo->ring);
+    rt_free(fifo->batch);
+    rt_free(fifo);
+}
+#endif /* RT_SENSOR_USING_FIFO_RING */
+
 /* Sensor interrupt correlation function */
 /*
  * Sensor interrupt handler function
  */
 void rt_sensor_cb(rt_sensor_t sen)
 {
+#ifdef RT_SENSOR_USING_FIFO_RING
+    if (sen->fifo != RT_NULL)
+    {
+        if (sen->irq_handle != RT_NULL)
+        {
+            sen->irq_handle(sen);
+        }
+
+        /* Drain the fifo out of ISR, the batch is indicated by the drain */
+        sen->fifo->irq_ts = rt_sensor_fifo_get_ts();
+        sen->fifo->pending = RT_TRUE;
+        rt_work_submit(&sen->fifo->work, 0);
+        return;
+    }
+#endif
+
     if (sen->parent.rx_indicate == RT_NULL)
     {
         return;
@@ -162,6 +385,16 @@ static rt_err_t rt_sensor_open(rt_device_t dev, rt_uint16_t oflag)
     }
     else if (oflag & RT_DEVICE_FLAG_FIFO_RX && dev->flag & RT_DEVICE_FLAG_FIFO_RX)
     {
+#ifdef RT_SENSOR_USING_FIFO_RING
+        if (sensor->info.fifo_max > 0 && sensor->fifo == RT_NULL)
+        {
+            res = sensor_fifo_create(sensor);
+            if (res != RT_EOK)
+            {
+                goto __exit;
+            }
+        }
+#endif
         if (sensor->ops->control != RT_NULL)
         {
             /* If fifo mode is supported, configure it to fifo mode */
@@ -242,6 +475,11 @@ __exit:
         rt_mutex_release(sensor->module->lock);
     }
 
+#ifdef RT_SENSOR_USING_FIFO_RING
+    /* The drain takes the module lock */
+    sensor_fifo_delete(sensor);
+#endif
+
     return RT_EOK;
 }
 
@@ -256,6 +494,24 @@ static rt_size_t rt_sensor_read(rt_device_t dev, rt_off_t pos, void *buf, rt_siz
         return 0;
     }
 
+#ifdef RT_SENSOR_USING_FIFO_RING
+    if (sensor->fifo != RT_NULL)
+    {
+        struct rt_sensor_fifo *fifo = sensor->fifo;
+
+        /* Only the batches drained by interrupt are read */
+        if (len > rt_spsc_ring_data_len(fifo->ring) / sizeof(struct rt_sensor_data))
+        {
+            len = rt_spsc_ring_data_len(fifo->ring) / sizeof(struct rt_sensor_data);
+        }
+        result = rt_spsc_ring_get(fifo->ring, (rt_uint8_t *)buf, len * sizeof(struct rt_sensor_data));
+        result /= sizeof(struct rt_sensor_data);
+        fifo->stats.read += result;
+
+        return result;
+    }
+#endif
+
     if (sensor->module)
     {
         rt_mutex_take(sensor->module->lock, RT_WAITING_FOREVER);
@@ -349,8 +605,24 @@ static rt_err_t rt_sensor_control(rt_device_t dev, int cmd, void *args)
         /* Device self-test */
         result = sensor->ops->control(sensor, RT_SENSOR_CTRL_SELF_TEST, args);
         break;
+    case RT_SENSOR_CTRL_GET_FIFO_STATS:
+#ifdef RT_SENSOR_USING_FIFO_RING
+        if (args && sensor->fifo)
+        {
+            rt_memcpy(args, &sensor->fifo->stats, sizeof(struct rt_sensor_fifo_stats));
+        }
+        else
+        {
+            result = -RT_ERROR;
+        }
+#else
+        result = -RT_ENOSYS;
+#endif
+        break;
     default:
-        return -RT_ERROR;
+        /* Release the module lock below */
+        result = -RT_ERROR;
+        break;
     }
 
     if (sensor->module)
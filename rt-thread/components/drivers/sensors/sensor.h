@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2019-01-31     flybreak     first version
+ * 2026-10-19     Hehesheng    add fifo mode batching by ring buffer
  */
 
 #ifndef __SENSOR_H__
@@ -24,6 +25,11 @@ extern "C" {
 #define  rt_sensor_get_ts()  rt_tick_get()   /* API for the sensor to get the timestamp */
 #endif
 
+/* The samples of a fifo batch are stamped in ticks even if RTC is used, the
+ * seconds of RTC can't tell them apart */
+#define  rt_sensor_fifo_get_ts()       rt_tick_get()         /* API for the fifo mode to get the timestamp */
+#define  RT_SENSOR_FIFO_TS_PER_SECOND  RT_TICK_PER_SECOND    /* The resolution of the fifo timestamp */
+
 #define  RT_PIN_NONE                   0xFFFF    /* RT PIN NONE */
 #define  RT_DEVICE_FLAG_FIFO_RX        0x200     /* Flag to use when the sensor is open by fifo mode */
 
@@ -92,8 +98,8 @@ extern "C" {
 
 #define  RT_SENSOR_MODE_NONE           (0)
 #define  RT_SENSOR_MODE_POLLING        (1)  /* One shot only read a data */
-#define  RT_SENSOR_MODE_INT            (2)  /* TODO: One shot interrupt only read a data */
-#define  RT_SENSOR_MODE_FIFO           (3)  /* TODO: One shot interrupt read all fifo data */
+#define  RT_SENSOR_MODE_INT            (2)  /* One shot interrupt only read a data */
+#define  RT_SENSOR_MODE_FIFO           (3)  /* One shot interrupt read all fifo data */
 
 /* Sensor control cmd types */
 
@@ -104,6 +110,7 @@ extern "C" {
 #define  RT_SENSOR_CTRL_SET_MODE       (4)  /* Set sensor's work mode. ex. RT_SENSOR_MODE_POLLING,RT_SENSOR_MODE_INT */
 #define  RT_SENSOR_CTRL_SET_POWER      (5)  /* Set power mode. args type of sensor power mode. ex. RT_SENSOR_POWER_DOWN,RT_SENSOR_POWER_NORMAL */
 #define  RT_SENSOR_CTRL_SELF_TEST      (6)  /* Take a self test */
+#define  RT_SENSOR_CTRL_GET_FIFO_STATS (7)  /* Get statistics of fifo mode. args type of struct rt_sensor_fifo_stats */
 
 struct rt_sensor_info
 {
@@ -137,6 +144,28 @@ struct rt_sensor_config
 
 typedef struct rt_sensor_device *rt_sensor_t;
 
+struct rt_sensor_fifo_stats
+{
+    rt_uint32_t                  batches;   /* The times the fifo is drained */
+    rt_uint32_t                  samples;   /* The samples drained from the fifo */
+    rt_uint32_t                  dropped;   /* The samples dropped as the ring is full */
+    rt_uint32_t                  read;      /* The samples read by application */
+};
+
+#ifdef RT_SENSOR_USING_FIFO_RING
+struct rt_sensor_fifo
+{
+    rt_sensor_t                  sensor;
+    struct rt_spsc_ring         *ring;      /* The samples not read, the drain puts and the reader gets */
+    struct rt_sensor_data       *batch;     /* The samples of one drain, fifo_max at most */
+    struct rt_work               work;      /* Drain the fifo out of interrupt */
+    rt_uint32_t                  irq_ts;    /* The tick of the last interrupt */
+    rt_uint8_t                   pending;   /* The interrupt isn't served by the drain yet */
+
+    struct rt_sensor_fifo_stats  stats;
+};
+#endif
+
 struct rt_sensor_device
 {
     struct rt_device             parent;    /* The standard device */
@@ -152,6 +181,10 @@ struct rt_sensor_device
     struct rt_sensor_module     *module;    /* The sensor module */
     
     rt_err_t (*irq_handle)(rt_sensor_t sensor);             /* Called when an interrupt is generated, registered by the driver */
+
+#ifdef RT_SENSOR_USING_FIFO_RING
+    struct rt_sensor_fifo       *fifo;      /* The batches of fifo mode, RT_NULL if it isn't opened by fifo mode */
+#endif
 };
 
 struct rt_sensor_module
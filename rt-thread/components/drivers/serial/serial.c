@@ -22,6 +22,11 @@
  * 2017-11-15     JasonJia     fix poll rx issue when data is full.
  *                             add TCFLSH and FIONREAD support.
  * 2018-12-08     Ernest Chen  add DMA choice
+ * 2026-10-19     Hehesheng    invoke rx_indicate in softirq
+ * 2026-10-19     Hehesheng    copy rx fifo out of the lock, add rx statistics,
+ *                             per-device rx fifo size and peek span
+ * 2026-10-19     Hehesheng    queue DMA tx data in a byte ring, coalesce the
+ *                             writes into DMA bursts, add POLLOUT
  */
 
 #include <rthw.h>
@@ -49,6 +54,11 @@
 #undef putc
 #endif
 
+#ifdef RT_SERIAL_USING_DMA
+static int _serial_dma_tx_queue(struct rt_serial_device *serial, const rt_uint8_t *data, int length,
+                                rt_bool_t nonblock);
+#endif
+
 static rt_err_t serial_fops_rx_ind(rt_device_t dev, rt_size_t size)
 {
     rt_wqueue_wakeup(&(dev->wait_queue), (void*)POLLIN);
@@ -85,6 +95,10 @@ static int serial_fops_open(struct dfs_fd *fd)
         break;
     }
 
+    /* use the DMA tx ring for non-blocking write and POLLOUT */
+    if ((fd->flags & O_ACCMODE) != O_RDONLY && (device->flag & RT_DEVICE_FLAG_DMA_TX))
+        flags |= RT_DEVICE_FLAG_DMA_TX;
+
     if ((fd->flags & O_ACCMODE) != O_WRONLY)
         rt_device_set_rx_indicate(device, serial_fops_rx_ind);
     ret = rt_device_open(device, flags);
@@ -151,6 +165,19 @@ static int serial_fops_write(struct dfs_fd *fd, const void *buf, size_t count)
     rt_device_t device;
 
     device = (rt_device_t)fd->data;
+
+#ifdef RT_SERIAL_USING_DMA
+    if ((fd->flags & O_NONBLOCK) && (device->open_flag & RT_DEVICE_FLAG_DMA_TX))
+    {
+        int size;
+
+        size = _serial_dma_tx_queue((struct rt_serial_device *)device, buf, count, RT_TRUE);
+        if (size < 0)
+            return -EIO;
+        return (size == 0 && count != 0) ? -EAGAIN : size;
+    }
+#endif
+
     return rt_device_write(device, -1, buf, count);
 }
 
@@ -166,15 +193,14 @@ static int serial_fops_poll(struct dfs_fd *fd, struct rt_pollreq *req)
 
     serial = (struct rt_serial_device *)device;
 
-    /* only support POLLIN */
+    rt_poll_add(&(device->wait_queue), req);
+
     flags = fd->flags & O_ACCMODE;
     if (flags == O_RDONLY || flags == O_RDWR)
     {
         rt_base_t level;
         struct rt_serial_rx_fifo* rx_fifo;
 
-        rt_poll_add(&(device->wait_queue), req);
-
         rx_fifo = (struct rt_serial_rx_fifo*) serial->serial_rx;
 
         level = rt_hw_interrupt_disable();
@@ -183,6 +209,26 @@ static int serial_fops_poll(struct dfs_fd *fd, struct rt_pollreq *req)
         rt_hw_interrupt_enable(level);
     }
 
+    if (flags == O_WRONLY || flags == O_RDWR)
+    {
+#ifdef RT_SERIAL_USING_DMA
+        if (device->open_flag & RT_DEVICE_FLAG_DMA_TX)
+        {
+            struct rt_serial_tx_dma *tx_dma;
+
+            /* writable when there is free space in tx ring */
+            tx_dma = (struct rt_serial_tx_dma *) serial->serial_tx;
+            if (tx_dma->count < tx_dma->bufsz)
+                mask |= POLLOUT;
+        }
+        else
+#endif
+        {
+            /* the interrupt and polling tx write synchronously */
+            mask |= POLLOUT;
+        }
+    }
+
     return mask;
 }
 
@@ -252,82 +298,8 @@ rt_inline int _serial_poll_tx(struct rt_serial_device *serial, const rt_uint8_t
 }
 
 /*
- * Serial interrupt routines
+ * Serial FIFO routines
  */
-rt_inline int _serial_int_rx(struct rt_serial_device *serial, rt_uint8_t *data, int length)
-{
-    int size;
-    struct rt_serial_rx_fifo* rx_fifo;
-
-    RT_ASSERT(serial != RT_NULL);
-    size = length;
-
-    rx_fifo = (struct rt_serial_rx_fifo*) serial->serial_rx;
-    RT_ASSERT(rx_fifo != RT_NULL);
-
-    /* read from software FIFO */
-    while (length)
-    {
-        int ch;
-        rt_base_t level;
-
-        /* disable interrupt */
-        level = rt_hw_interrupt_disable();
-
-        /* there's no data: */
-        if ((rx_fifo->get_index == rx_fifo->put_index) && (rx_fifo->is_full == RT_FALSE))
-        {
-            /* no data, enable interrupt and break out */
-            rt_hw_interrupt_enable(level);
-            break;
-        }
-
-        /* otherwise there's the data: */
-        ch = rx_fifo->buffer[rx_fifo->get_index];
-        rx_fifo->get_index += 1;
-        if (rx_fifo->get_index >= serial->config.bufsz) rx_fifo->get_index = 0;
-
-        if (rx_fifo->is_full == RT_TRUE)
-        {
-            rx_fifo->is_full = RT_FALSE;
-        }
-
-        /* enable interrupt */
-        rt_hw_interrupt_enable(level);
-
-        *data = ch & 0xff;
-        data ++; length --;
-    }
-
-    return size - length;
-}
-
-rt_inline int _serial_int_tx(struct rt_serial_device *serial, const rt_uint8_t *data, int length)
-{
-    int size;
-    struct rt_serial_tx_fifo *tx;
-
-    RT_ASSERT(serial != RT_NULL);
-
-    size = length;
-    tx = (struct rt_serial_tx_fifo*) serial->serial_tx;
-    RT_ASSERT(tx != RT_NULL);
-
-    while (length)
-    {
-        if (serial->ops->putc(serial, *(char*)data) == -1)
-        {
-            rt_completion_wait(&(tx->completion), RT_WAITING_FOREVER);
-            continue;
-        }
-
-        data ++; length --;
-    }
-
-    return size - length;
-}
-
-#if defined(RT_USING_POSIX) || defined(RT_SERIAL_USING_DMA)
 static rt_size_t _serial_fifo_calc_recved_len(struct rt_serial_device *serial)
 {
     struct rt_serial_rx_fifo *rx_fifo = (struct rt_serial_rx_fifo *) serial->serial_rx;
@@ -350,33 +322,19 @@ static rt_size_t _serial_fifo_calc_recved_len(struct rt_serial_device *serial)
         }
     }
 }
-#endif /* RT_USING_POSIX || RT_SERIAL_USING_DMA */
-
-#ifdef RT_SERIAL_USING_DMA
-/**
- * Calculate DMA received data length.
- *
- * @param serial serial device
- *
- * @return length
- */
-static rt_size_t rt_dma_calc_recved_len(struct rt_serial_device *serial)
-{
-    return _serial_fifo_calc_recved_len(serial);
-}
 
 /**
- * Read data finish by DMA mode then update the get index for receive fifo.
+ * Read data finish then update the get index for receive fifo.
  *
  * @param serial serial device
  * @param len get data length for this operate
  */
-static void rt_dma_recv_update_get_index(struct rt_serial_device *serial, rt_size_t len)
+static void _serial_fifo_update_get_index(struct rt_serial_device *serial, rt_size_t len)
 {
     struct rt_serial_rx_fifo *rx_fifo = (struct rt_serial_rx_fifo *) serial->serial_rx;
 
     RT_ASSERT(rx_fifo != RT_NULL);
-    RT_ASSERT(len <= rt_dma_calc_recved_len(serial));
+    RT_ASSERT(len <= _serial_fifo_calc_recved_len(serial));
 
     if (rx_fifo->is_full && len != 0) rx_fifo->is_full = RT_FALSE;
 
@@ -388,54 +346,146 @@ static void rt_dma_recv_update_get_index(struct rt_serial_device *serial, rt_siz
 }
 
 /**
- * DMA received finish then update put index for receive fifo.
+ * Receive data finish then update put index for receive fifo. The oldest
+ * data is overwritten when the fifo is overflowed.
  *
  * @param serial serial device
  * @param len received length for this transmit
  */
-static void rt_dma_recv_update_put_index(struct rt_serial_device *serial, rt_size_t len)
+static void _serial_fifo_update_put_index(struct rt_serial_device *serial, rt_size_t len)
 {
     struct rt_serial_rx_fifo *rx_fifo = (struct rt_serial_rx_fifo *)serial->serial_rx;
+    rt_size_t recved;
 
     RT_ASSERT(rx_fifo != RT_NULL);
+    RT_ASSERT(len <= serial->config.bufsz);
+
+    recved = _serial_fifo_calc_recved_len(serial) + len;
 
-    if (rx_fifo->get_index <= rx_fifo->put_index)
+    rx_fifo->put_index = (rx_fifo->put_index + len) % serial->config.bufsz;
+    rx_fifo->stats.received += len;
+
+    if (recved >= serial->config.bufsz)
     {
-        rx_fifo->put_index += len;
-        /* beyond the fifo end */
-        if (rx_fifo->put_index >= serial->config.bufsz)
+        if (recved > serial->config.bufsz)
         {
-            rx_fifo->put_index %= serial->config.bufsz;
-            /* force overwrite get index */
-            if (rx_fifo->put_index >= rx_fifo->get_index)
-            {
-                rx_fifo->is_full = RT_TRUE;
-            }
+            rx_fifo->stats.overflows ++;
+            rx_fifo->stats.lost += recved - serial->config.bufsz;
         }
+
+        /* the fifo is full, the get index follows the put index */
+        rx_fifo->get_index = rx_fifo->put_index;
+        rx_fifo->is_full = RT_TRUE;
+        recved = serial->config.bufsz;
     }
-    else
+
+    if (recved > rx_fifo->stats.peak)
+        rx_fifo->stats.peak = recved;
+}
+
+/* get the rx fifo, or RT_NULL if the rx isn't in fifo mode */
+static struct rt_serial_rx_fifo *_serial_get_rx_fifo(struct rt_serial_device *serial)
+{
+    if (serial->parent.open_flag & RT_DEVICE_FLAG_INT_RX)
+        return (struct rt_serial_rx_fifo *)serial->serial_rx;
+#ifdef RT_SERIAL_USING_DMA
+    if ((serial->parent.open_flag & RT_DEVICE_FLAG_DMA_RX) && serial->config.bufsz != 0)
+        return (struct rt_serial_rx_fifo *)serial->serial_rx;
+#endif
+
+    return RT_NULL;
+}
+
+/*
+ * Read data from fifo. The indexes are taken with interrupt disabled, and the
+ * data is copied with interrupt enabled. If the fifo is overflowed during the
+ * copy, the copied data may be overwritten, read again from the oldest data.
+ */
+static int _serial_fifo_rx(struct rt_serial_device *serial, rt_uint8_t *data, int length)
+{
+    struct rt_serial_rx_fifo *rx_fifo = (struct rt_serial_rx_fifo *) serial->serial_rx;
+    rt_size_t recv_len, span;
+    rt_uint16_t get_index;
+    rt_uint32_t overflows;
+    rt_bool_t locked = RT_FALSE;
+    rt_base_t level;
+
+    RT_ASSERT(rx_fifo != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    while (1)
     {
-        rx_fifo->put_index += len;
-        if (rx_fifo->put_index >= rx_fifo->get_index)
+        recv_len = _serial_fifo_calc_recved_len(serial);
+        if (recv_len > (rt_size_t)length)
+            recv_len = length;
+        get_index = rx_fifo->get_index;
+        overflows = rx_fifo->stats.overflows;
+
+        /* copy out of the lock in the first round */
+        if (!locked) rt_hw_interrupt_enable(level);
+
+        span = serial->config.bufsz - get_index;
+        if (recv_len <= span)
+            rt_memcpy(data, rx_fifo->buffer + get_index, recv_len);
+        else
         {
-            /* beyond the fifo end */
-            if (rx_fifo->put_index >= serial->config.bufsz)
-            {
-                rx_fifo->put_index %= serial->config.bufsz;
-            }
-            /* force overwrite get index */
-            rx_fifo->is_full = RT_TRUE;
+            rt_memcpy(data, rx_fifo->buffer + get_index, span);
+            rt_memcpy(data + span, rx_fifo->buffer, recv_len - span);
         }
+
+        if (!locked) level = rt_hw_interrupt_disable();
+
+        if (rx_fifo->stats.overflows == overflows)
+        {
+            _serial_fifo_update_get_index(serial, recv_len);
+            break;
+        }
+
+        /* overflowed during the copy, copy again with interrupt disabled */
+        locked = RT_TRUE;
     }
-    
-    if(rx_fifo->is_full == RT_TRUE) 
+    rt_hw_interrupt_enable(level);
+
+    return recv_len;
+}
+
+/*
+ * Serial interrupt routines
+ */
+rt_inline int _serial_int_rx(struct rt_serial_device *serial, rt_uint8_t *data, int length)
+{
+    RT_ASSERT(serial != RT_NULL);
+
+    /* read from software FIFO */
+    return _serial_fifo_rx(serial, data, length);
+}
+
+rt_inline int _serial_int_tx(struct rt_serial_device *serial, const rt_uint8_t *data, int length)
+{
+    int size;
+    struct rt_serial_tx_fifo *tx;
+
+    RT_ASSERT(serial != RT_NULL);
+
+    size = length;
+    tx = (struct rt_serial_tx_fifo*) serial->serial_tx;
+    RT_ASSERT(tx != RT_NULL);
+
+    while (length)
     {
-        rx_fifo->get_index = rx_fifo->put_index; 
-    } 
-    
-    if (rx_fifo->get_index >= serial->config.bufsz) rx_fifo->get_index = 0;
+        if (serial->ops->putc(serial, *(char*)data) == -1)
+        {
+            rt_completion_wait(&(tx->completion), RT_WAITING_FOREVER);
+            continue;
+        }
+
+        data ++; length --;
+    }
+
+    return size - length;
 }
 
+#ifdef RT_SERIAL_USING_DMA
 /*
  * Serial DMA routines
  */
@@ -445,8 +495,6 @@ rt_inline int _serial_dma_rx(struct rt_serial_device *serial, rt_uint8_t *data,
 
     RT_ASSERT((serial != RT_NULL) && (data != RT_NULL));
 
-    level = rt_hw_interrupt_disable();
-
     if (serial->config.bufsz == 0)
     {
         int result = RT_EOK;
@@ -455,6 +503,7 @@ rt_inline int _serial_dma_rx(struct rt_serial_device *serial, rt_uint8_t *data,
         rx_dma = (struct rt_serial_rx_dma*)serial->serial_rx;
         RT_ASSERT(rx_dma != RT_NULL);
 
+        level = rt_hw_interrupt_disable();
         if (rx_dma->activated != RT_TRUE)
         {
             rx_dma->activated = RT_TRUE;
@@ -471,63 +520,145 @@ rt_inline int _serial_dma_rx(struct rt_serial_device *serial, rt_uint8_t *data,
     }
     else
     {
-        struct rt_serial_rx_fifo *rx_fifo = (struct rt_serial_rx_fifo *) serial->serial_rx;
-        rt_size_t recv_len = 0, fifo_recved_len = rt_dma_calc_recved_len(serial);
-
-        RT_ASSERT(rx_fifo != RT_NULL);
+        return _serial_fifo_rx(serial, data, length);
+    }
+}
 
-        if (length < (int)fifo_recved_len)
-            recv_len = length;
-        else
-            recv_len = fifo_recved_len;
+/*
+ * Start the next DMA burst with the pending bytes in tx ring, with interrupt
+ * disabled. The burst is the continuous bytes from get index, so the writes
+ * queued during the last burst are transmitted in one burst.
+ *
+ * @return the length of burst, 0 if there is no pending byte
+ */
+static rt_size_t _serial_dma_tx_next(struct rt_serial_tx_dma *tx_dma, rt_uint8_t **data)
+{
+    rt_size_t burst;
 
-        if (rx_fifo->get_index + recv_len < serial->config.bufsz)
-            rt_memcpy(data, rx_fifo->buffer + rx_fifo->get_index, recv_len);
-        else
-        {
-            rt_memcpy(data, rx_fifo->buffer + rx_fifo->get_index,
-                    serial->config.bufsz - rx_fifo->get_index);
-            rt_memcpy(data + serial->config.bufsz - rx_fifo->get_index, rx_fifo->buffer,
-                    recv_len + rx_fifo->get_index - serial->config.bufsz);
-        }
-        rt_dma_recv_update_get_index(serial, recv_len);
-        rt_hw_interrupt_enable(level);
-        return recv_len;
+    if (tx_dma->count == 0)
+    {
+        tx_dma->activated = RT_FALSE;
+        return 0;
     }
+
+    burst = tx_dma->bufsz - tx_dma->get_index;
+    if (burst > tx_dma->count)
+        burst = tx_dma->count;
+
+    *data = tx_dma->buffer + tx_dma->get_index;
+    tx_dma->burst = burst;
+    tx_dma->activated = RT_TRUE;
+    tx_dma->stats.bursts ++;
+
+    return burst;
 }
 
-rt_inline int _serial_dma_tx(struct rt_serial_device *serial, const rt_uint8_t *data, int length)
+/*
+ * Transfer the burst by DMA. On failure, the pending bytes are dropped, so
+ * they never stay in the ring without a DMA burst to send them.
+ */
+static rt_err_t _serial_dma_tx_start(struct rt_serial_device *serial, rt_uint8_t *data, rt_size_t burst)
+{
+    rt_base_t level;
+    struct rt_serial_tx_dma *tx_dma;
+
+    tx_dma = (struct rt_serial_tx_dma*)(serial->serial_tx);
+
+    if (serial->ops->dma_transmit(serial, data, burst, RT_SERIAL_DMA_TX) == burst)
+        return RT_EOK;
+
+    level = rt_hw_interrupt_disable();
+    tx_dma->get_index = (tx_dma->get_index + tx_dma->count) % tx_dma->bufsz;
+    tx_dma->stats.dropped += tx_dma->count;
+    tx_dma->count = 0;
+    tx_dma->burst = 0;
+    tx_dma->activated = RT_FALSE;
+    tx_dma->stats.bursts --;
+    rt_hw_interrupt_enable(level);
+
+    /* resume the writer waiting for free space */
+    rt_wqueue_wakeup(&(tx_dma->wait_queue), RT_NULL);
+
+    return -RT_EIO;
+}
+
+/*
+ * Queue the data in tx ring and start the DMA burst if it's idle. The writer
+ * waits for free space if the ring is full, except that it's non-blocking,
+ * in ISR or before scheduler starts.
+ *
+ * @return the queued length, -RT_EIO if the DMA transfer failed
+ */
+static int _serial_dma_tx_queue(struct rt_serial_device *serial, const rt_uint8_t *data, int length,
+                                rt_bool_t nonblock)
 {
     rt_base_t level;
-    rt_err_t result;
+    rt_size_t put_index, span, size, burst;
+    rt_uint8_t *burst_data = RT_NULL;
     struct rt_serial_tx_dma *tx_dma;
+    int written = 0;
 
     tx_dma = (struct rt_serial_tx_dma*)(serial->serial_tx);
+    RT_ASSERT(tx_dma != RT_NULL);
+
+    if (rt_interrupt_get_nest() != 0 || rt_thread_self() == RT_NULL)
+        nonblock = RT_TRUE;
 
-    result = rt_data_queue_push(&(tx_dma->data_queue), data, length, RT_WAITING_FOREVER);
-    if (result == RT_EOK)
+    while (written < length)
     {
         level = rt_hw_interrupt_disable();
+
+        /* copy to the continuous free space */
+        put_index = (tx_dma->get_index + tx_dma->count) % tx_dma->bufsz;
+        span = tx_dma->bufsz - tx_dma->count;
+        if (span > tx_dma->bufsz - put_index)
+            span = tx_dma->bufsz - put_index;
+        size = length - written;
+        if (size > span)
+            size = span;
+        rt_memcpy(tx_dma->buffer + put_index, data + written, size);
+        tx_dma->count += size;
+        tx_dma->stats.written += size;
+        written += size;
+
+        burst = 0;
         if (tx_dma->activated != RT_TRUE)
-        {
-            tx_dma->activated = RT_TRUE;
-            rt_hw_interrupt_enable(level);
+            burst = _serial_dma_tx_next(tx_dma, &burst_data);
+        if (size == 0)
+            tx_dma->stats.full ++;
 
-            /* make a DMA transfer */
-            serial->ops->dma_transmit(serial, (rt_uint8_t *)data, length, RT_SERIAL_DMA_TX);
-        }
-        else
+        rt_hw_interrupt_enable(level);
+
+        /* make a DMA transfer */
+        if (burst && _serial_dma_tx_start(serial, burst_data, burst) != RT_EOK)
+            return -RT_EIO;
+
+        if (size == 0)
         {
-            rt_hw_interrupt_enable(level);
-        }
+            if (nonblock) break;
 
-        return length;
+            /* wait for the DMA burst done */
+            rt_wqueue_wait(&(tx_dma->wait_queue), 0, RT_WAITING_FOREVER);
+        }
     }
-    else
+
+    return written;
+}
+
+rt_inline int _serial_dma_tx(struct rt_serial_device *serial, const rt_uint8_t *data, int length)
+{
+    int size;
+
+    size = _serial_dma_tx_queue(serial, data, length, RT_FALSE);
+    if (size < 0)
     {
-        rt_set_errno(result);
-        return 0;
+        rt_set_errno(size);
+        size = 0;
     }
+    else if (size == 0)
+        rt_set_errno(-RT_EFULL);
+
+    return size;
 }
 #endif /* RT_SERIAL_USING_DMA */
 
@@ -591,11 +722,9 @@ static rt_err_t rt_serial_open(struct rt_device *dev, rt_uint16_t oflag)
             rx_fifo = (struct rt_serial_rx_fifo*) rt_malloc (sizeof(struct rt_serial_rx_fifo) +
                 serial->config.bufsz);
             RT_ASSERT(rx_fifo != RT_NULL);
+            rt_memset(rx_fifo, 0, sizeof(struct rt_serial_rx_fifo) + serial->config.bufsz);
             rx_fifo->buffer = (rt_uint8_t*) (rx_fifo + 1);
-            rt_memset(rx_fifo->buffer, 0, serial->config.bufsz);
-            rx_fifo->put_index = 0;
-            rx_fifo->get_index = 0;
-            rx_fifo->is_full = RT_FALSE;
+            rx_fifo->stats.bufsz = serial->config.bufsz;
 
             serial->serial_rx = rx_fifo;
             dev->open_flag |= RT_DEVICE_FLAG_INT_RX;
@@ -619,11 +748,9 @@ static rt_err_t rt_serial_open(struct rt_device *dev, rt_uint16_t oflag)
                 rx_fifo = (struct rt_serial_rx_fifo*) rt_malloc (sizeof(struct rt_serial_rx_fifo) +
                     serial->config.bufsz);
                 RT_ASSERT(rx_fifo != RT_NULL);
+                rt_memset(rx_fifo, 0, sizeof(struct rt_serial_rx_fifo) + serial->config.bufsz);
                 rx_fifo->buffer = (rt_uint8_t*) (rx_fifo + 1);
-                rt_memset(rx_fifo->buffer, 0, serial->config.bufsz);
-                rx_fifo->put_index = 0;
-                rx_fifo->get_index = 0;
-                rx_fifo->is_full = RT_FALSE;
+                rx_fifo->stats.bufsz = serial->config.bufsz;
                 serial->serial_rx = rx_fifo;
                 /* configure fifo address and length to low level device */
                 serial->ops->control(serial, RT_DEVICE_CTRL_CONFIG, (void *) RT_DEVICE_FLAG_DMA_RX);
@@ -667,11 +794,15 @@ static rt_err_t rt_serial_open(struct rt_device *dev, rt_uint16_t oflag)
         {
             struct rt_serial_tx_dma* tx_dma;
 
-            tx_dma = (struct rt_serial_tx_dma*) rt_malloc (sizeof(struct rt_serial_tx_dma));
+            tx_dma = (struct rt_serial_tx_dma*) rt_malloc (sizeof(struct rt_serial_tx_dma) +
+                RT_SERIAL_TX_DMA_BUFSZ);
             RT_ASSERT(tx_dma != RT_NULL);
+            rt_memset(tx_dma, 0, sizeof(struct rt_serial_tx_dma));
             tx_dma->activated = RT_FALSE;
+            tx_dma->buffer = (rt_uint8_t*) (tx_dma + 1);
+            tx_dma->bufsz = RT_SERIAL_TX_DMA_BUFSZ;
+            rt_wqueue_init(&(tx_dma->wait_queue));
 
-            rt_data_queue_init(&(tx_dma->data_queue), 8, 4, RT_NULL);
             serial->serial_tx = tx_dma;
 
             dev->open_flag |= RT_DEVICE_FLAG_DMA_TX;
@@ -717,8 +848,9 @@ static rt_err_t rt_serial_close(struct rt_device *dev)
         rx_fifo = (struct rt_serial_rx_fifo*)serial->serial_rx;
         RT_ASSERT(rx_fifo != RT_NULL);
 
-        rt_free(rx_fifo);
+        /* the rx softirq may run before the device is closed */
         serial->serial_rx = RT_NULL;
+        rt_free(rx_fifo);
         dev->open_flag &= ~RT_DEVICE_FLAG_INT_RX;
         /* configure low level device */
         serial->ops->control(serial, RT_DEVICE_CTRL_CLR_INT, (void*)RT_DEVICE_FLAG_INT_RX);
@@ -726,24 +858,27 @@ static rt_err_t rt_serial_close(struct rt_device *dev)
 #ifdef RT_SERIAL_USING_DMA
     else if (dev->open_flag & RT_DEVICE_FLAG_DMA_RX)
     {
+        void *serial_rx = serial->serial_rx;
+
+        /* the rx softirq may run before the device is closed */
+        serial->serial_rx = RT_NULL;
         if (serial->config.bufsz == 0) {
             struct rt_serial_rx_dma* rx_dma;
 
-            rx_dma = (struct rt_serial_rx_dma*)serial->serial_rx;
+            rx_dma = (struct rt_serial_rx_dma*)serial_rx;
             RT_ASSERT(rx_dma != RT_NULL);
 
             rt_free(rx_dma);
         } else {
             struct rt_serial_rx_fifo* rx_fifo;
 
-            rx_fifo = (struct rt_serial_rx_fifo*)serial->serial_rx;
+            rx_fifo = (struct rt_serial_rx_fifo*)serial_rx;
             RT_ASSERT(rx_fifo != RT_NULL);
 
             rt_free(rx_fifo);
         }
         /* configure low level device */
         serial->ops->control(serial, RT_DEVICE_CTRL_CLR_INT, (void *) RT_DEVICE_FLAG_DMA_RX);
-        serial->serial_rx = RT_NULL;
         dev->open_flag &= ~RT_DEVICE_FLAG_DMA_RX;
     }
 #endif /* RT_SERIAL_USING_DMA */
@@ -765,10 +900,39 @@ static rt_err_t rt_serial_close(struct rt_device *dev)
     else if (dev->open_flag & RT_DEVICE_FLAG_DMA_TX)
     {
         struct rt_serial_tx_dma* tx_dma;
+        rt_tick_t start, timeout;
+        rt_base_t level;
 
         tx_dma = (struct rt_serial_tx_dma*)serial->serial_tx;
         RT_ASSERT(tx_dma != RT_NULL);
 
+        /* the DMA may be reading the ring, wait for the queued bytes sent. A
+         * byte takes 10 bits at most on the wire, the wait is twice of it and
+         * 10 ms more. It never waits in ISR or before scheduler starts. */
+        if (rt_interrupt_get_nest() == 0 && rt_thread_self() != RT_NULL)
+        {
+            timeout = rt_tick_from_millisecond(tx_dma->count * 10 * 1000 / serial->config.baud_rate * 2 + 10);
+            start = rt_tick_get();
+            while ((tx_dma->count != 0 || tx_dma->activated == RT_TRUE) &&
+                   rt_tick_get() - start < timeout)
+            {
+                rt_thread_mdelay(1);
+            }
+        }
+
+        if (tx_dma->count != 0 || tx_dma->activated == RT_TRUE)
+        {
+            /* the tx done interrupt is lost, stop the DMA and drop the bytes */
+            serial->ops->control(serial, RT_DEVICE_CTRL_CLR_INT, (void *)RT_DEVICE_FLAG_DMA_TX);
+
+            level = rt_hw_interrupt_disable();
+            tx_dma->stats.dropped += tx_dma->count;
+            tx_dma->count = 0;
+            tx_dma->burst = 0;
+            tx_dma->activated = RT_FALSE;
+            rt_hw_interrupt_enable(level);
+        }
+
         rt_free(tx_dma);
         serial->serial_tx = RT_NULL;
         dev->open_flag &= ~RT_DEVICE_FLAG_DMA_TX;
@@ -970,6 +1134,56 @@ static rt_err_t rt_serial_control(struct rt_device *dev,
 
             break;
 
+        case RT_SERIAL_CTRL_SET_RX_BUFSZ:
+            if (serial->parent.ref_count)
+            {
+                /* can not change buffer size when serial is opened */
+                return -RT_EBUSY;
+            }
+            if ((rt_ubase_t)args == 0 || (rt_ubase_t)args > 0xFFFF)
+            {
+                /* the rx fifo indexes wrap modulo bufsz */
+                return -RT_EINVAL;
+            }
+            serial->config.bufsz = (rt_ubase_t)args;
+            break;
+
+        case RT_SERIAL_CTRL_GET_RX_STATS:
+            {
+                struct rt_serial_rx_fifo *rx_fifo;
+                rt_base_t level;
+
+                if (args == RT_NULL) return -RT_EINVAL;
+
+                level = rt_hw_interrupt_disable();
+                rx_fifo = _serial_get_rx_fifo(serial);
+                if (rx_fifo == RT_NULL)
+                {
+                    rt_hw_interrupt_enable(level);
+                    return -RT_ERROR;
+                }
+                *(struct rt_serial_rx_stats *)args = rx_fifo->stats;
+                rt_hw_interrupt_enable(level);
+            }
+            break;
+
+#ifdef RT_SERIAL_USING_DMA
+        case RT_SERIAL_CTRL_GET_TX_STATS:
+            {
+                struct rt_serial_tx_dma *tx_dma;
+                rt_base_t level;
+
+                if (args == RT_NULL) return -RT_EINVAL;
+                if (!(dev->open_flag & RT_DEVICE_FLAG_DMA_TX)) return -RT_ERROR;
+
+                level = rt_hw_interrupt_disable();
+                tx_dma = (struct rt_serial_tx_dma *)serial->serial_tx;
+                *(struct rt_serial_tx_stats *)args = tx_dma->stats;
+                rt_hw_interrupt_enable(level);
+            }
+            break;
+#endif /* RT_SERIAL_USING_DMA */
+
 #ifdef RT_USING_POSIX_TERMIOS
         case TCGETA:
             {
@@ -1100,6 +1314,30 @@ const static struct rt_device_ops serial_ops =
 /*
  * serial register
  */
+#ifdef RT_USING_SOFTIRQ
+/* the bottom half of rx interrupt, tell the received length to upper layer */
+static void _serial_rx_softirq(void *parameter)
+{
+    struct rt_serial_device *serial = (struct rt_serial_device *)parameter;
+    struct rt_serial_rx_fifo *rx_fifo;
+    rt_size_t rx_length = 0;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    rx_fifo = _serial_get_rx_fifo(serial);
+    if (rx_fifo != RT_NULL)
+    {
+        rx_length = _serial_fifo_calc_recved_len(serial);
+    }
+    rt_hw_interrupt_enable(level);
+
+    if (rx_length && serial->parent.rx_indicate != RT_NULL)
+    {
+        serial->parent.rx_indicate(&serial->parent, rx_length);
+    }
+}
+#endif /* RT_USING_SOFTIRQ */
+
 rt_err_t rt_hw_serial_register(struct rt_serial_device *serial,
                                const char              *name,
                                rt_uint32_t              flag,
@@ -1127,6 +1365,10 @@ rt_err_t rt_hw_serial_register(struct rt_serial_device *serial,
 #endif
     device->user_data   = data;
 
+#ifdef RT_USING_SOFTIRQ
+    rt_softirq_init(&(serial->rx_softirq), name, _serial_rx_softirq, serial, RT_SERIAL_SOFTIRQ_PRIORITY);
+#endif
+
     /* register a character device */
     ret = rt_device_register(device, name, flag);
 
@@ -1138,6 +1380,75 @@ rt_err_t rt_hw_serial_register(struct rt_serial_device *serial,
     return ret;
 }
 
+/**
+ * This function will return the continuous received data in rx fifo, the
+ * data can be parsed in place, then consumed by rt_serial_rx_consume.
+ *
+ * @param serial serial device
+ * @param span the start of received data
+ *
+ * @return the length of continuous received data
+ */
+rt_size_t rt_serial_rx_peek(struct rt_serial_device *serial, rt_uint8_t **span)
+{
+    struct rt_serial_rx_fifo *rx_fifo;
+    rt_size_t length = 0;
+    rt_base_t level;
+
+    RT_ASSERT(serial != RT_NULL);
+    RT_ASSERT(span != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    rx_fifo = _serial_get_rx_fifo(serial);
+    if (rx_fifo != RT_NULL)
+    {
+        length = _serial_fifo_calc_recved_len(serial);
+        if (length > (rt_size_t)(serial->config.bufsz - rx_fifo->get_index))
+            length = serial->config.bufsz - rx_fifo->get_index;
+        *span = rx_fifo->buffer + rx_fifo->get_index;
+        rx_fifo->peek_overflows = rx_fifo->stats.overflows;
+    }
+    rt_hw_interrupt_enable(level);
+
+    return length;
+}
+RTM_EXPORT(rt_serial_rx_peek);
+
+/**
+ * This function will consume the data peeked by rt_serial_rx_peek.
+ *
+ * @param serial serial device
+ * @param length the length of data to be consumed
+ *
+ * @return the consumed length, 0 if the fifo is overflowed after peek, the
+ *         peeked data may be overwritten and shall be dropped.
+ */
+rt_size_t rt_serial_rx_consume(struct rt_serial_device *serial, rt_size_t length)
+{
+    struct rt_serial_rx_fifo *rx_fifo;
+    rt_size_t recved;
+    rt_base_t level;
+
+    RT_ASSERT(serial != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    rx_fifo = _serial_get_rx_fifo(serial);
+    if (rx_fifo == RT_NULL || rx_fifo->peek_overflows != rx_fifo->stats.overflows)
+    {
+        rt_hw_interrupt_enable(level);
+        return 0;
+    }
+
+    recved = _serial_fifo_calc_recved_len(serial);
+    if (length > recved)
+        length = recved;
+    _serial_fifo_update_get_index(serial, length);
+    rt_hw_interrupt_enable(level);
+
+    return length;
+}
+RTM_EXPORT(rt_serial_rx_consume);
+
 /* ISR for serial interrupt */
 void rt_hw_serial_isr(struct rt_serial_device *serial, int event)
 {
@@ -1163,21 +1474,19 @@ void rt_hw_serial_isr(struct rt_serial_device *serial, int event)
                 level = rt_hw_interrupt_disable();
 
                 rx_fifo->buffer[rx_fifo->put_index] = ch;
-                rx_fifo->put_index += 1;
-                if (rx_fifo->put_index >= serial->config.bufsz) rx_fifo->put_index = 0;
-
-                /* if the next position is read index, discard this 'read char' */
-                if (rx_fifo->put_index == rx_fifo->get_index)
-                {
-                    rx_fifo->get_index += 1;
-                    rx_fifo->is_full = RT_TRUE;
-                    if (rx_fifo->get_index >= serial->config.bufsz) rx_fifo->get_index = 0;
-                }
+                _serial_fifo_update_put_index(serial, 1);
 
                 /* enable interrupt */
                 rt_hw_interrupt_enable(level);
             }
 
+#ifdef RT_USING_SOFTIRQ
+            /* invoke callback in the bottom half */
+            if (serial->parent.rx_indicate != RT_NULL)
+            {
+                rt_softirq_raise(&(serial->rx_softirq));
+            }
+#else
             /* invoke callback */
             if (serial->parent.rx_indicate != RT_NULL)
             {
@@ -1185,8 +1494,7 @@ void rt_hw_serial_isr(struct rt_serial_device *serial, int event)
 
                 /* get rx length */
                 level = rt_hw_interrupt_disable();
-                rx_length = (rx_fifo->put_index >= rx_fifo->get_index)? (rx_fifo->put_index - rx_fifo->get_index):
-                    (serial->config.bufsz - (rx_fifo->get_index - rx_fifo->put_index));
+                rx_length = _serial_fifo_calc_recved_len(serial);
                 rt_hw_interrupt_enable(level);
 
                 if (rx_length)
@@ -1194,6 +1502,7 @@ void rt_hw_serial_isr(struct rt_serial_device *serial, int event)
                     serial->parent.rx_indicate(&serial->parent, rx_length);
                 }
             }
+#endif /* RT_USING_SOFTIRQ */
             break;
         }
         case RT_SERIAL_EVENT_TX_DONE:
@@ -1207,29 +1516,38 @@ void rt_hw_serial_isr(struct rt_serial_device *serial, int event)
 #ifdef RT_SERIAL_USING_DMA
         case RT_SERIAL_EVENT_TX_DMADONE:
         {
-            const void *data_ptr;
-            rt_size_t data_size;
-            const void *last_data_ptr;
+            rt_uint8_t *data_ptr = RT_NULL;
+            rt_size_t burst;
+            rt_base_t level;
             struct rt_serial_tx_dma *tx_dma;
 
             tx_dma = (struct rt_serial_tx_dma*) serial->serial_tx;
+            RT_ASSERT(tx_dma != RT_NULL);
 
-            rt_data_queue_pop(&(tx_dma->data_queue), &last_data_ptr, &data_size, 0);
-            if (rt_data_queue_peak(&(tx_dma->data_queue), &data_ptr, &data_size) == RT_EOK)
-            {
-                /* transmit next data node */
-                tx_dma->activated = RT_TRUE;
-                serial->ops->dma_transmit(serial, (rt_uint8_t *)data_ptr, data_size, RT_SERIAL_DMA_TX);
-            }
-            else
+            level = rt_hw_interrupt_disable();
+            /* release the space of last burst */
+            tx_dma->get_index = (tx_dma->get_index + tx_dma->burst) % tx_dma->bufsz;
+            tx_dma->count -= tx_dma->burst;
+            tx_dma->burst = 0;
+            /* chain the bytes queued during last burst */
+            burst = _serial_dma_tx_next(tx_dma, &data_ptr);
+            rt_hw_interrupt_enable(level);
+
+            if (burst)
             {
-                tx_dma->activated = RT_FALSE;
+                _serial_dma_tx_start(serial, data_ptr, burst);
             }
 
-            /* invoke callback */
-            if (serial->parent.tx_complete != RT_NULL)
+            /* resume the writer waiting for free space */
+            rt_wqueue_wakeup(&(tx_dma->wait_queue), RT_NULL);
+#ifdef RT_USING_POSIX
+            rt_wqueue_wakeup(&(serial->parent.wait_queue), (void*)POLLOUT);
+#endif
+
+            /* invoke callback when all of the data is transmitted */
+            if (burst == 0 && serial->parent.tx_complete != RT_NULL)
             {
-                serial->parent.tx_complete(&serial->parent, (void*)last_data_ptr);
+                serial->parent.tx_complete(&serial->parent, RT_NULL);
             }
             break;
         }
@@ -1257,9 +1575,18 @@ void rt_hw_serial_isr(struct rt_serial_device *serial, int event)
                 /* disable interrupt */
                 level = rt_hw_interrupt_disable();
                 /* update fifo put index */
-                rt_dma_recv_update_put_index(serial, length);
+                _serial_fifo_update_put_index(serial, length);
+#ifdef RT_USING_SOFTIRQ
+                /* enable interrupt */
+                rt_hw_interrupt_enable(level);
+                /* invoke callback in the bottom half */
+                if (serial->parent.rx_indicate != RT_NULL)
+                {
+                    rt_softirq_raise(&(serial->rx_softirq));
+                }
+#else
                 /* calculate received total length */
-                length = rt_dma_calc_recved_len(serial);
+                length = _serial_fifo_calc_recved_len(serial);
                 /* enable interrupt */
                 rt_hw_interrupt_enable(level);
                 /* invoke callback */
@@ -1267,6 +1594,7 @@ void rt_hw_serial_isr(struct rt_serial_device *serial, int event)
                 {
                     serial->parent.rx_indicate(&(serial->parent), length);
                 }
+#endif /* RT_USING_SOFTIRQ */
             }
             break;
         }
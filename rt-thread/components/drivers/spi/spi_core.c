@@ -11,13 +11,73 @@
  * 2012-05-18     bernard      Changed SPI message to message list.
  *                             Added take/release SPI device/bus interface.
  * 2012-09-28     aozima       fixed rt_spi_release_bus assert error.
+ * 2026-10-19     Hehesheng    add asynchronous transfer queue.
  */
 
+#include <rthw.h>
 #include <drivers/spi.h>
 
 extern rt_err_t rt_spi_bus_device_init(struct rt_spi_bus *bus, const char *name);
 extern rt_err_t rt_spidev_device_init(struct rt_spi_device *dev, const char *name);
 
+#ifdef RT_SPI_USING_ASYNC
+static void _spi_async_kick(struct rt_spi_bus *bus);
+static void _spi_async_resume(struct rt_spi_bus *bus);
+static void _spi_async_work(struct rt_work *work, void *work_data);
+static struct rt_spi_message *_spi_async_transfer(struct rt_spi_device  *device,
+                                                  struct rt_spi_message *message);
+
+/* the asynchronous transfer is supported by the bus driver */
+#define _spi_async_capable(bus)  ((bus)->mode == RT_SPI_BUS_MODE_SPI && (bus)->ops->xfer_start != RT_NULL)
+
+/*
+ * Take the bus lock for the synchronous transfer. The queued requests stop
+ * at the request boundary, and the thread waits for the request in transfer.
+ */
+static rt_err_t _spi_bus_take(struct rt_spi_bus *bus)
+{
+    rt_err_t result;
+    rt_base_t level;
+
+    result = rt_mutex_take(&(bus->lock), RT_WAITING_FOREVER);
+    if (result != RT_EOK)
+        return result;
+
+    level = rt_hw_interrupt_disable();
+    bus->async_hold ++;
+    while (bus->async_current != RT_NULL)
+    {
+        rt_hw_interrupt_enable(level);
+        /* the request may wait for the workqueue, which may be this thread */
+        _spi_async_resume(bus);
+        rt_completion_wait(&(bus->async_idle), RT_WAITING_FOREVER);
+        level = rt_hw_interrupt_disable();
+    }
+    rt_hw_interrupt_enable(level);
+
+    return RT_EOK;
+}
+
+/* release the bus lock and restart the queued requests */
+static void _spi_bus_release(struct rt_spi_bus *bus)
+{
+    rt_base_t level;
+    rt_uint16_t hold;
+
+    level = rt_hw_interrupt_disable();
+    hold = -- bus->async_hold;
+    rt_hw_interrupt_enable(level);
+
+    rt_mutex_release(&(bus->lock));
+
+    if (hold == 0)
+        _spi_async_kick(bus);
+}
+#else
+#define _spi_bus_take(bus)       rt_mutex_take(&((bus)->lock), RT_WAITING_FOREVER)
+#define _spi_bus_release(bus)    rt_mutex_release(&((bus)->lock))
+#endif /* RT_SPI_USING_ASYNC */
+
 rt_err_t rt_spi_bus_register(struct rt_spi_bus       *bus,
                              const char              *name,
                              const struct rt_spi_ops *ops)
@@ -37,6 +97,15 @@ rt_err_t rt_spi_bus_register(struct rt_spi_bus       *bus,
     /* set bus mode */
     bus->mode = RT_SPI_BUS_MODE_SPI;
 
+#ifdef RT_SPI_USING_ASYNC
+    rt_list_init(&(bus->async_devices));
+    bus->async_current = RT_NULL;
+    bus->async_hold = 0;
+    bus->async_defer = RT_FALSE;
+    rt_completion_init(&(bus->async_idle));
+    rt_work_init(&(bus->async_work), _spi_async_work, bus);
+#endif
+
     return RT_EOK;
 }
 
@@ -61,6 +130,10 @@ rt_err_t rt_spi_bus_attach_device(struct rt_spi_device *device,
 
         rt_memset(&device->config, 0, sizeof(device->config));
         device->parent.user_data = user_data;
+#ifdef RT_SPI_USING_ASYNC
+        rt_list_init(&(device->async_queue));
+        rt_list_init(&(device->async_node));
+#endif
 
         return RT_EOK;
     }
@@ -83,7 +156,7 @@ rt_err_t rt_spi_configure(struct rt_spi_device        *device,
 
     if (device->bus != RT_NULL)
     {
-        result = rt_mutex_take(&(device->bus->lock), RT_WAITING_FOREVER);
+        result = _spi_bus_take(device->bus);
         if (result == RT_EOK)
         {
             if (device->bus->owner == device)
@@ -92,7 +165,7 @@ rt_err_t rt_spi_configure(struct rt_spi_device        *device,
             }
 
             /* release lock */
-            rt_mutex_release(&(device->bus->lock));
+            _spi_bus_release(device->bus);
         }
     }
 
@@ -111,7 +184,30 @@ rt_err_t rt_spi_send_then_send(struct rt_spi_device *device,
     RT_ASSERT(device != RT_NULL);
     RT_ASSERT(device->bus != RT_NULL);
 
-    result = rt_mutex_take(&(device->bus->lock), RT_WAITING_FOREVER);
+#ifdef RT_SPI_USING_ASYNC
+    if (_spi_async_capable(device->bus))
+    {
+        struct rt_spi_message message2;
+
+        message.send_buf    = send_buf1;
+        message.recv_buf    = RT_NULL;
+        message.length      = send_length1;
+        message.cs_take     = 1;
+        message.cs_release  = 0;
+        message.next        = &message2;
+
+        message2.send_buf   = send_buf2;
+        message2.recv_buf   = RT_NULL;
+        message2.length     = send_length2;
+        message2.cs_take    = 0;
+        message2.cs_release = 1;
+        message2.next       = RT_NULL;
+
+        return _spi_async_transfer(device, &message) == RT_NULL ? RT_EOK : -RT_EIO;
+    }
+#endif
+
+    result = _spi_bus_take(device->bus);
     if (result == RT_EOK)
     {
         if (device->bus->owner != device)
@@ -169,7 +265,7 @@ rt_err_t rt_spi_send_then_send(struct rt_spi_device *device,
     }
 
 __exit:
-    rt_mutex_release(&(device->bus->lock));
+    _spi_bus_release(device->bus);
 
     return result;
 }
@@ -186,7 +282,30 @@ rt_err_t rt_spi_send_then_recv(struct rt_spi_device *device,
     RT_ASSERT(device != RT_NULL);
     RT_ASSERT(device->bus != RT_NULL);
 
-    result = rt_mutex_take(&(device->bus->lock), RT_WAITING_FOREVER);
+#ifdef RT_SPI_USING_ASYNC
+    if (_spi_async_capable(device->bus))
+    {
+        struct rt_spi_message message2;
+
+        message.send_buf    = send_buf;
+        message.recv_buf    = RT_NULL;
+        message.length      = send_length;
+        message.cs_take     = 1;
+        message.cs_release  = 0;
+        message.next        = &message2;
+
+        message2.send_buf   = RT_NULL;
+        message2.recv_buf   = recv_buf;
+        message2.length     = recv_length;
+        message2.cs_take    = 0;
+        message2.cs_release = 1;
+        message2.next       = RT_NULL;
+
+        return _spi_async_transfer(device, &message) == RT_NULL ? RT_EOK : -RT_EIO;
+    }
+#endif
+
+    result = _spi_bus_take(device->bus);
     if (result == RT_EOK)
     {
         if (device->bus->owner != device)
@@ -244,7 +363,7 @@ rt_err_t rt_spi_send_then_recv(struct rt_spi_device *device,
     }
 
 __exit:
-    rt_mutex_release(&(device->bus->lock));
+    _spi_bus_release(device->bus);
 
     return result;
 }
@@ -260,7 +379,21 @@ rt_size_t rt_spi_transfer(struct rt_spi_device *device,
     RT_ASSERT(device != RT_NULL);
     RT_ASSERT(device->bus != RT_NULL);
 
-    result = rt_mutex_take(&(device->bus->lock), RT_WAITING_FOREVER);
+#ifdef RT_SPI_USING_ASYNC
+    if (_spi_async_capable(device->bus))
+    {
+        message.send_buf   = send_buf;
+        message.recv_buf   = recv_buf;
+        message.length     = length;
+        message.cs_take    = 1;
+        message.cs_release = 1;
+        message.next       = RT_NULL;
+
+        return _spi_async_transfer(device, &message) == RT_NULL ? length : 0;
+    }
+#endif
+
+    result = _spi_bus_take(device->bus);
     if (result == RT_EOK)
     {
         if (device->bus->owner != device)
@@ -305,7 +438,7 @@ rt_size_t rt_spi_transfer(struct rt_spi_device *device,
     }
 
 __exit:
-    rt_mutex_release(&(device->bus->lock));
+    _spi_bus_release(device->bus);
 
     return result;
 }
@@ -323,7 +456,15 @@ struct rt_spi_message *rt_spi_transfer_message(struct rt_spi_device  *device,
     if (index == RT_NULL)
         return index;
 
-    result = rt_mutex_take(&(device->bus->lock), RT_WAITING_FOREVER);
+#ifdef RT_SPI_USING_ASYNC
+    if (_spi_async_capable(device->bus))
+    {
+        /* sleep on the queued request instead of polling the transfer */
+        return _spi_async_transfer(device, message);
+    }
+#endif
+
+    result = _spi_bus_take(device->bus);
     if (result != RT_EOK)
     {
         rt_set_errno(-RT_EBUSY);
@@ -368,7 +509,7 @@ struct rt_spi_message *rt_spi_transfer_message(struct rt_spi_device  *device,
 
 __exit:
     /* release bus lock */
-    rt_mutex_release(&(device->bus->lock));
+    _spi_bus_release(device->bus);
 
     return index;
 }
@@ -380,7 +521,7 @@ rt_err_t rt_spi_take_bus(struct rt_spi_device *device)
     RT_ASSERT(device != RT_NULL);
     RT_ASSERT(device->bus != RT_NULL);
 
-    result = rt_mutex_take(&(device->bus->lock), RT_WAITING_FOREVER);
+    result = _spi_bus_take(device->bus);
     if (result != RT_EOK)
     {
         rt_set_errno(-RT_EBUSY);
@@ -406,7 +547,7 @@ rt_err_t rt_spi_take_bus(struct rt_spi_device *device)
             /* configure SPI bus failed */
             rt_set_errno(-RT_EIO);
             /* release lock */
-            rt_mutex_release(&(device->bus->lock));
+            _spi_bus_release(device->bus);
 
             return -RT_EIO;
         }
@@ -422,7 +563,7 @@ rt_err_t rt_spi_release_bus(struct rt_spi_device *device)
     RT_ASSERT(device->bus->owner == device);
 
     /* release lock */
-    rt_mutex_release(&(device->bus->lock));
+    _spi_bus_release(device->bus);
 
     return RT_EOK;
 }
@@ -458,3 +599,324 @@ rt_err_t rt_spi_release(struct rt_spi_device *device)
 
     return result;
 }
+
+#ifdef RT_SPI_USING_ASYNC
+/*
+ * The asynchronous requests are queued by device, and the devices with queued
+ * requests are served in turn. The request in transfer is started by the
+ * thread submitting it, and the next message or request is chained in the
+ * transfer done interrupt, so the bus isn't idle between the requests. The
+ * request of another device needs the bus configured again, which is done in
+ * system workqueue instead of interrupt. When a thread takes the bus for the
+ * synchronous transfer, the chain stops at the request boundary.
+ *
+ * If the bus driver doesn't support xfer_start, the requests are transferred
+ * by xfer in the thread submitting them. The chip select only message, and
+ * the message the driver can't start, are transferred by xfer in thread too,
+ * deferred to system workqueue if they are reached in interrupt.
+ */
+
+/* pick the request of next device, with interrupt disabled */
+static struct rt_spi_request *_spi_async_next(struct rt_spi_bus *bus)
+{
+    struct rt_spi_device *device;
+    struct rt_spi_request *request;
+
+    if (rt_list_isempty(&(bus->async_devices)))
+        return RT_NULL;
+
+    device = rt_list_entry(bus->async_devices.next, struct rt_spi_device, async_node);
+    request = rt_list_entry(device->async_queue.next, struct rt_spi_request, list);
+    rt_list_remove(&(request->list));
+
+    /* move the device to the tail */
+    rt_list_remove(&(device->async_node));
+    if (!rt_list_isempty(&(device->async_queue)))
+        rt_list_insert_before(&(bus->async_devices), &(device->async_node));
+
+    return request;
+}
+
+/* continue the current request in system workqueue */
+static rt_err_t _spi_async_defer(struct rt_spi_bus *bus)
+{
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    bus->async_defer = RT_TRUE;
+    rt_hw_interrupt_enable(level);
+    rt_work_submit(&(bus->async_work), 0);
+
+    return RT_EOK;
+}
+
+/*
+ * Start the messages of request from the current one.
+ *
+ * @return RT_EOK if the transfer is in progress, -RT_EEMPTY if all of the
+ *         messages are transferred, others on failed.
+ */
+static rt_err_t _spi_async_start(struct rt_spi_bus *bus, struct rt_spi_request *request)
+{
+    struct rt_spi_device *device = request->device;
+    struct rt_spi_message *message;
+    rt_err_t result;
+
+    if (bus->owner != device)
+    {
+        /* the bus driver can't be configured in ISR, continue in thread */
+        if (rt_interrupt_get_nest() != 0)
+            return _spi_async_defer(bus);
+
+        /* not the same owner as current, re-configure SPI bus */
+        if (bus->ops->configure(device, &device->config) != RT_EOK)
+            return -RT_EIO;
+
+        bus->owner = device;
+    }
+
+    while (request->current != RT_NULL)
+    {
+        message = request->current;
+
+        if (message->length != 0 && bus->ops->xfer_start != RT_NULL)
+        {
+            /* rt_spi_bus_xfer_done is invoked when it's done */
+            result = bus->ops->xfer_start(device, message);
+            if (result != -RT_ENOSYS)
+                return result == RT_EOK ? RT_EOK : -RT_EIO;
+
+            /* the driver can't start it, e.g. the buffer isn't reachable by DMA */
+        }
+
+        /* xfer is polling and may block, continue in thread */
+        if (rt_interrupt_get_nest() != 0)
+            return _spi_async_defer(bus);
+
+        /* the chip select only message, or the message transferred by xfer */
+        if (bus->ops->xfer(device, message) == 0 && message->length != 0)
+            return -RT_EIO;
+
+        request->current = message->next;
+    }
+
+    return -RT_EEMPTY;
+}
+
+/* run the requests until a transfer is in progress or there is no request */
+static void _spi_async_run(struct rt_spi_bus *bus, struct rt_spi_request *request, rt_err_t result)
+{
+    rt_base_t level;
+
+    while (request != RT_NULL)
+    {
+        if (result == RT_EOK)
+        {
+            result = _spi_async_start(bus, request);
+            if (result == RT_EOK)
+                return;
+        }
+
+        /* the request is done */
+        request->result = (result == -RT_EEMPTY) ? RT_EOK : result;
+        if (request->done != RT_NULL)
+            request->done(request);
+        else
+            rt_completion_done(&(request->completion));
+
+        level = rt_hw_interrupt_disable();
+        request = (bus->async_hold == 0) ? _spi_async_next(bus) : RT_NULL;
+        bus->async_current = request;
+        /* wake up the thread taking the bus */
+        if (request == RT_NULL && bus->async_hold != 0)
+            rt_completion_done(&(bus->async_idle));
+        rt_hw_interrupt_enable(level);
+
+        result = RT_EOK;
+    }
+}
+
+/* start the queued requests if the bus is idle */
+static void _spi_async_kick(struct rt_spi_bus *bus)
+{
+    rt_base_t level;
+    struct rt_spi_request *request = RT_NULL;
+
+    level = rt_hw_interrupt_disable();
+    if (bus->async_current == RT_NULL && bus->async_hold == 0)
+    {
+        request = _spi_async_next(bus);
+        bus->async_current = request;
+    }
+    rt_hw_interrupt_enable(level);
+
+    _spi_async_run(bus, request, RT_EOK);
+}
+
+/* continue the request deferred by the interrupt in thread */
+static void _spi_async_resume(struct rt_spi_bus *bus)
+{
+    rt_base_t level;
+    struct rt_spi_request *request = RT_NULL;
+
+    level = rt_hw_interrupt_disable();
+    if (bus->async_defer)
+    {
+        bus->async_defer = RT_FALSE;
+        request = bus->async_current;
+    }
+    rt_hw_interrupt_enable(level);
+
+    if (request != RT_NULL)
+        _spi_async_run(bus, request, RT_EOK);
+}
+
+static void _spi_async_work(struct rt_work *work, void *work_data)
+{
+    _spi_async_resume((struct rt_spi_bus *)work_data);
+}
+
+/*
+ * Transfer the message list by xfer_start and sleep on its completion. The
+ * bus lock is taken as the other synchronous transfers, so the thread holding
+ * the bus inherits the priority of waiters.
+ */
+static struct rt_spi_message *_spi_async_transfer(struct rt_spi_device  *device,
+                                                  struct rt_spi_message *message)
+{
+    struct rt_spi_request request;
+    struct rt_spi_bus *bus = device->bus;
+    rt_base_t level;
+
+    rt_spi_request_init(&request, device, message, RT_NULL, RT_NULL);
+
+    if (_spi_bus_take(bus) != RT_EOK)
+    {
+        rt_set_errno(-RT_EBUSY);
+        return message;
+    }
+
+    /* the queue is stopped and idle, run the request at once */
+    level = rt_hw_interrupt_disable();
+    bus->async_current = &request;
+    rt_hw_interrupt_enable(level);
+    _spi_async_run(bus, &request, RT_EOK);
+
+    rt_completion_wait(&(request.completion), RT_WAITING_FOREVER);
+
+    _spi_bus_release(bus);
+
+    if (request.result != RT_EOK)
+    {
+        rt_set_errno(-RT_EIO);
+        return request.current;
+    }
+
+    rt_set_errno(RT_EOK);
+
+    return RT_NULL;
+}
+
+void rt_spi_request_init(struct rt_spi_request *request,
+                         struct rt_spi_device  *device,
+                         struct rt_spi_message *message,
+                         void (*done)(struct rt_spi_request *request),
+                         void                  *user_data)
+{
+    RT_ASSERT(request != RT_NULL);
+    RT_ASSERT(device != RT_NULL);
+
+    rt_list_init(&(request->list));
+    request->device    = device;
+    request->message   = message;
+    request->current   = message;
+    request->done      = done;
+    request->user_data = user_data;
+    request->result    = RT_EOK;
+    rt_completion_init(&(request->completion));
+}
+
+rt_err_t rt_spi_transfer_async(struct rt_spi_request *request)
+{
+    rt_base_t level;
+    struct rt_spi_device *device;
+    struct rt_spi_bus *bus;
+
+    RT_ASSERT(request != RT_NULL);
+    RT_ASSERT(request->device != RT_NULL);
+    RT_ASSERT(request->device->bus != RT_NULL);
+
+    device = request->device;
+    bus = device->bus;
+
+    if (bus->mode != RT_SPI_BUS_MODE_SPI)
+        return -RT_ENOSYS;
+
+    /* the bus without xfer_start is served in thread */
+    if (bus->ops->xfer_start == RT_NULL && rt_interrupt_get_nest() != 0)
+        return -RT_ENOSYS;
+
+    request->current = request->message;
+    request->result  = RT_EOK;
+    rt_completion_init(&(request->completion));
+
+    level = rt_hw_interrupt_disable();
+    rt_list_insert_before(&(device->async_queue), &(request->list));
+    if (rt_list_isempty(&(device->async_node)))
+        rt_list_insert_before(&(bus->async_devices), &(device->async_node));
+    rt_hw_interrupt_enable(level);
+
+    _spi_async_kick(bus);
+
+    return RT_EOK;
+}
+
+rt_err_t rt_spi_request_wait(struct rt_spi_request *request, rt_int32_t timeout)
+{
+    rt_base_t level;
+    struct rt_spi_device *device;
+
+    RT_ASSERT(request != RT_NULL);
+    RT_ASSERT(request->done == RT_NULL);
+
+    if (rt_completion_wait(&(request->completion), timeout) == RT_EOK)
+        return request->result;
+
+    /* remove the request not started yet, it's owned by caller again */
+    level = rt_hw_interrupt_disable();
+    if (!rt_list_isempty(&(request->list)))
+    {
+        device = request->device;
+        rt_list_remove(&(request->list));
+        if (rt_list_isempty(&(device->async_queue)))
+            rt_list_remove(&(device->async_node));
+        rt_hw_interrupt_enable(level);
+
+        return -RT_ETIMEOUT;
+    }
+    rt_hw_interrupt_enable(level);
+
+    /* the request is in transfer, the bus is using it until it's done */
+    rt_completion_wait(&(request->completion), RT_WAITING_FOREVER);
+
+    return request->result;
+}
+
+void rt_spi_bus_xfer_done(struct rt_spi_bus *bus, rt_err_t result)
+{
+    struct rt_spi_request *request;
+
+    RT_ASSERT(bus != RT_NULL);
+
+    request = bus->async_current;
+    RT_ASSERT(request != RT_NULL);
+
+    /* chain the next message */
+    if (result == RT_EOK)
+        request->current = request->current->next;
+    else
+        result = -RT_EIO;
+
+    _spi_async_run(bus, request, result);
+}
+#endif /* RT_SPI_USING_ASYNC */
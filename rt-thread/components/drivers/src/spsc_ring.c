@@ -0,0 +1,332 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <string.h>
+
+/*
+ * The counter accessors. The acquire load makes sure the data written by the
+ * other side before its release store is visible, so no interrupt lock is
+ * required between one producer and one consumer.
+ */
+#if defined(__GNUC__) || defined(__CLANG_ARM)
+#define SPSC_LOAD_ACQUIRE(p)        __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define SPSC_STORE_RELEASE(p, v)    __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#elif defined(__CC_ARM)
+rt_inline rt_uint32_t SPSC_LOAD_ACQUIRE(volatile rt_uint32_t *p)
+{
+    rt_uint32_t value = *p;
+    __dmb(0xF);
+    return value;
+}
+#define SPSC_STORE_RELEASE(p, v)    do { __dmb(0xF); *(p) = (v); } while (0)
+#elif defined(__IAR_SYSTEMS_ICC__)
+#include <intrinsics.h>
+rt_inline rt_uint32_t SPSC_LOAD_ACQUIRE(volatile rt_uint32_t *p)
+{
+    rt_uint32_t value = *p;
+    __DMB();
+    return value;
+}
+#define SPSC_STORE_RELEASE(p, v)    do { __DMB(); *(p) = (v); } while (0)
+#else
+#error "spsc ring: no memory ordering support for this tool chain"
+#endif
+
+/**
+ * This function will initialize a spsc ring buffer.
+ *
+ * @param ring the spsc ring object
+ * @param pool the buffer of ring
+ * @param size the size of buffer, which must be a power of two
+ *
+ * @return RT_EOK on successful, -RT_EINVAL if the size is not a power of two
+ */
+rt_err_t rt_spsc_ring_init(struct rt_spsc_ring *ring, rt_uint8_t *pool, rt_uint32_t size)
+{
+    RT_ASSERT(ring != RT_NULL);
+    RT_ASSERT(pool != RT_NULL);
+
+    /* the free-running counters need a power of two size */
+    if (size == 0 || (size & (size - 1)) != 0 || size > 0x80000000UL)
+        return -RT_EINVAL;
+
+    ring->buffer_ptr = pool;
+    ring->buffer_size = size;
+    ring->mask = size - 1;
+    ring->head = 0;
+    ring->tail = 0;
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_spsc_ring_init);
+
+/**
+ * This function will drop all the data in spsc ring buffer.
+ *
+ * @note it shall not be invoked while the producer or the consumer is using
+ * the ring.
+ *
+ * @param ring the spsc ring object
+ */
+void rt_spsc_ring_reset(struct rt_spsc_ring *ring)
+{
+    RT_ASSERT(ring != RT_NULL);
+
+    ring->head = 0;
+    ring->tail = 0;
+}
+RTM_EXPORT(rt_spsc_ring_reset);
+
+#ifdef RT_USING_HEAP
+
+/**
+ * This function will create a spsc ring buffer, the buffer is allocated
+ * together with the ring object.
+ *
+ * @param size the size of buffer, which must be a power of two
+ *
+ * @return the spsc ring object, RT_NULL on failure
+ */
+struct rt_spsc_ring *rt_spsc_ring_create(rt_uint32_t size)
+{
+    struct rt_spsc_ring *ring;
+
+    ring = (struct rt_spsc_ring *)rt_malloc(sizeof(struct rt_spsc_ring) + size);
+    if (ring == RT_NULL)
+        return RT_NULL;
+
+    if (rt_spsc_ring_init(ring, (rt_uint8_t *)(ring + 1), size) != RT_EOK)
+    {
+        rt_free(ring);
+        return RT_NULL;
+    }
+
+    return ring;
+}
+RTM_EXPORT(rt_spsc_ring_create);
+
+/**
+ * This function will destroy a spsc ring buffer created by
+ * rt_spsc_ring_create.
+ *
+ * @param ring the spsc ring object
+ */
+void rt_spsc_ring_destroy(struct rt_spsc_ring *ring)
+{
+    RT_ASSERT(ring != RT_NULL);
+
+    rt_free(ring);
+}
+RTM_EXPORT(rt_spsc_ring_destroy);
+
+#endif
+
+/**
+ * This function will get the free space of spsc ring buffer, it shall be
+ * invoked by the producer.
+ *
+ * @param ring the spsc ring object
+ *
+ * @return the free space in bytes
+ */
+rt_uint32_t rt_spsc_ring_space_len(struct rt_spsc_ring *ring)
+{
+    RT_ASSERT(ring != RT_NULL);
+
+    return ring->buffer_size - (ring->head - SPSC_LOAD_ACQUIRE(&ring->tail));
+}
+RTM_EXPORT(rt_spsc_ring_space_len);
+
+/**
+ * This function will get the data length of spsc ring buffer, it shall be
+ * invoked by the consumer.
+ *
+ * @param ring the spsc ring object
+ *
+ * @return the data length in bytes
+ */
+rt_uint32_t rt_spsc_ring_data_len(struct rt_spsc_ring *ring)
+{
+    RT_ASSERT(ring != RT_NULL);
+
+    return SPSC_LOAD_ACQUIRE(&ring->head) - ring->tail;
+}
+RTM_EXPORT(rt_spsc_ring_data_len);
+
+/**
+ * This function will claim the contiguous free span of spsc ring buffer
+ * for the producer. The span may be shorter than the free space when the
+ * free space wraps around the end of buffer.
+ *
+ * @param ring the spsc ring object
+ * @param ptr the start address of span
+ *
+ * @return the length of span in bytes, 0 if the ring is full
+ */
+rt_uint32_t rt_spsc_ring_write_claim(struct rt_spsc_ring *ring, rt_uint8_t **ptr)
+{
+    rt_uint32_t head, space, offset;
+
+    RT_ASSERT(ring != RT_NULL);
+    RT_ASSERT(ptr != RT_NULL);
+
+    head = ring->head;
+    space = ring->buffer_size - (head - SPSC_LOAD_ACQUIRE(&ring->tail));
+    offset = head & ring->mask;
+
+    /* stop at the end of buffer */
+    if (space > ring->buffer_size - offset)
+        space = ring->buffer_size - offset;
+
+    *ptr = &ring->buffer_ptr[offset];
+
+    return space;
+}
+RTM_EXPORT(rt_spsc_ring_write_claim);
+
+/**
+ * This function will publish the data written into the claimed span to the
+ * consumer.
+ *
+ * @param ring the spsc ring object
+ * @param length the length of data written, no more than the claimed span
+ */
+void rt_spsc_ring_write_commit(struct rt_spsc_ring *ring, rt_uint32_t length)
+{
+    RT_ASSERT(ring != RT_NULL);
+    RT_ASSERT(length <= rt_spsc_ring_space_len(ring));
+
+    SPSC_STORE_RELEASE(&ring->head, ring->head + length);
+}
+RTM_EXPORT(rt_spsc_ring_write_commit);
+
+/**
+ * This function will claim the contiguous data span of spsc ring buffer
+ * for the consumer. The span may be shorter than the data length when the
+ * data wraps around the end of buffer.
+ *
+ * @param ring the spsc ring object
+ * @param ptr the start address of span
+ *
+ * @return the length of span in bytes, 0 if the ring is empty
+ */
+rt_uint32_t rt_spsc_ring_read_claim(struct rt_spsc_ring *ring, rt_uint8_t **ptr)
+{
+    rt_uint32_t tail, length, offset;
+
+    RT_ASSERT(ring != RT_NULL);
+    RT_ASSERT(ptr != RT_NULL);
+
+    tail = ring->tail;
+    length = SPSC_LOAD_ACQUIRE(&ring->head) - tail;
+    offset = tail & ring->mask;
+
+    /* stop at the end of buffer */
+    if (length > ring->buffer_size - offset)
+        length = ring->buffer_size - offset;
+
+    *ptr = &ring->buffer_ptr[offset];
+
+    return length;
+}
+RTM_EXPORT(rt_spsc_ring_read_claim);
+
+/**
+ * This function will give the consumed span back to the producer.
+ *
+ * @param ring the spsc ring object
+ * @param length the length of data consumed, no more than the claimed span
+ */
+void rt_spsc_ring_read_commit(struct rt_spsc_ring *ring, rt_uint32_t length)
+{
+    RT_ASSERT(ring != RT_NULL);
+    RT_ASSERT(length <= rt_spsc_ring_data_len(ring));
+
+    SPSC_STORE_RELEASE(&ring->tail, ring->tail + length);
+}
+RTM_EXPORT(rt_spsc_ring_read_commit);
+
+/**
+ * This function will copy a block of data into spsc ring buffer, the data
+ * which exceeds the free space is dropped.
+ *
+ * @param ring the spsc ring object
+ * @param ptr the data
+ * @param length the length of data
+ *
+ * @return the length of data put
+ */
+rt_uint32_t rt_spsc_ring_put(struct rt_spsc_ring *ring, const rt_uint8_t *ptr, rt_uint32_t length)
+{
+    rt_uint32_t head, space, offset, first;
+
+    RT_ASSERT(ring != RT_NULL);
+
+    head = ring->head;
+    space = ring->buffer_size - (head - SPSC_LOAD_ACQUIRE(&ring->tail));
+
+    /* drop some data */
+    if (length > space)
+        length = space;
+    if (length == 0)
+        return 0;
+
+    offset = head & ring->mask;
+    first = ring->buffer_size - offset;
+    if (first > length)
+        first = length;
+
+    memcpy(&ring->buffer_ptr[offset], ptr, first);
+    memcpy(&ring->buffer_ptr[0], ptr + first, length - first);
+
+    SPSC_STORE_RELEASE(&ring->head, head + length);
+
+    return length;
+}
+RTM_EXPORT(rt_spsc_ring_put);
+
+/**
+ * This function will copy a block of data out of spsc ring buffer.
+ *
+ * @param ring the spsc ring object
+ * @param ptr the buffer to save data
+ * @param length the size of buffer
+ *
+ * @return the length of data got
+ */
+rt_uint32_t rt_spsc_ring_get(struct rt_spsc_ring *ring, rt_uint8_t *ptr, rt_uint32_t length)
+{
+    rt_uint32_t tail, size, offset, first;
+
+    RT_ASSERT(ring != RT_NULL);
+
+    tail = ring->tail;
+    size = SPSC_LOAD_ACQUIRE(&ring->head) - tail;
+
+    if (length > size)
+        length = size;
+    if (length == 0)
+        return 0;
+
+    offset = tail & ring->mask;
+    first = ring->buffer_size - offset;
+    if (first > length)
+        first = length;
+
+    memcpy(ptr, &ring->buffer_ptr[offset], first);
+    memcpy(ptr + first, &ring->buffer_ptr[0], length - first);
+
+    SPSC_STORE_RELEASE(&ring->tail, tail + length);
+
+    return length;
+}
+RTM_EXPORT(rt_spsc_ring_get);
@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2017-02-27     bernard      fix the re-work issue.
+ * 2026-10-19     Hehesheng    add worker pool, priority lanes, keys and stats
  */
 
 #include <rthw.h>
@@ -47,47 +48,169 @@ rt_inline rt_err_t _workqueue_work_completion(struct rt_workqueue *queue)
     return result;
 }
 
+/* it shall be invoked with interrupt disabled */
+static rt_bool_t _workqueue_work_running(struct rt_workqueue *queue, struct rt_work *work)
+{
+    rt_uint8_t index;
+
+    for (index = 0; index < queue->worker_num; index ++)
+    {
+        if (queue->workers[index].current == work)
+            return RT_TRUE;
+    }
+
+    return RT_FALSE;
+}
+
+/* it shall be invoked with interrupt disabled */
+static rt_bool_t _workqueue_key_running(struct rt_workqueue *queue, rt_ubase_t key)
+{
+    rt_uint8_t index;
+
+    for (index = 0; index < queue->worker_num; index ++)
+    {
+        if (queue->workers[index].current != RT_NULL &&
+                queue->workers[index].current->key == key)
+            return RT_TRUE;
+    }
+
+    return RT_FALSE;
+}
+
+/* get the first runnable work in the highest lane, with interrupt disabled */
+static struct rt_work *_workqueue_pick_work(struct rt_workqueue *queue)
+{
+    struct rt_list_node *node;
+    struct rt_work *work;
+    int lane;
+
+    for (lane = 0; lane < RT_WORK_PRIO_NUM; lane ++)
+    {
+        for (node = queue->work_list[lane].next; node != &(queue->work_list[lane]); node = node->next)
+        {
+            work = rt_list_entry(node, struct rt_work, list);
+            if (work->key == 0 || _workqueue_key_running(queue, work->key) == RT_FALSE)
+                return work;
+        }
+    }
+
+    return RT_NULL;
+}
+
+/* wake up an idle worker, with interrupt disabled */
+rt_inline rt_bool_t _workqueue_wake_worker(struct rt_workqueue *queue)
+{
+    if (queue->worker_idle == 0)
+        return RT_FALSE;
+
+    queue->worker_idle --;
+    return RT_TRUE;
+}
+
 static void _workqueue_thread_entry(void *parameter)
 {
     rt_base_t level;
+    rt_tick_t tick, latency;
+    rt_ubase_t key;
+    rt_bool_t wake;
     struct rt_work *work;
     struct rt_workqueue *queue;
+    struct rt_workqueue_worker *worker;
+    void (*work_func)(struct rt_work *work, void *work_data);
+    rt_tick_t budget;
 
-    queue = (struct rt_workqueue *) parameter;
-    RT_ASSERT(queue != RT_NULL);
+    worker = (struct rt_workqueue_worker *) parameter;
+    RT_ASSERT(worker != RT_NULL);
+    queue = worker->queue;
 
     while (1)
     {
-        if (rt_list_isempty(&(queue->work_list)))
+        level = rt_hw_interrupt_disable();
+        work = _workqueue_pick_work(queue);
+        if (work == RT_NULL)
         {
-            /* no software timer exist, suspend self. */
-            rt_thread_suspend(rt_thread_self());
-            rt_schedule();
+            /* no work can be done now, wait for submitting or completion */
+            queue->worker_idle ++;
+            rt_hw_interrupt_enable(level);
+
+            rt_sem_take(&(queue->wake), RT_WAITING_FOREVER);
+            continue;
         }
 
         /* we have work to do with. */
-        level = rt_hw_interrupt_disable();
-        work = rt_list_entry(queue->work_list.next, struct rt_work, list);
         rt_list_remove(&(work->list));
-        queue->work_current = work;
+        worker->current = work;
         work->flags &= ~RT_WORK_STATE_PENDING;
+
+        tick = rt_tick_get();
+        latency = tick - work->submit_tick;
+        queue->stats.depth --;
+        queue->stats.latency_total += latency;
+        if (latency > queue->stats.latency_max)
+            queue->stats.latency_max = latency;
+
+        /* the work may be freed or submitted again in work function */
+        key = work->key;
+        budget = work->budget;
+        work_func = work->work_func;
         rt_hw_interrupt_enable(level);
 
         /* do work */
-        work->work_func(work, work->work_data);
+        work_func(work, work->work_data);
+        tick = rt_tick_get() - tick;
+
         level = rt_hw_interrupt_disable();
         /* clean current work */
-        queue->work_current = RT_NULL;
+        worker->current = RT_NULL;
+
+        queue->stats.completed ++;
+        if (budget != 0 && tick > budget)
+            queue->stats.overrun ++;
+        if (tick > queue->stats.longest)
+        {
+            queue->stats.longest = tick;
+            queue->stats.longest_func = work_func;
+        }
+
+        /* the works with same key may be waiting for this one */
+        wake = RT_FALSE;
+        if (key != 0 && queue->stats.depth != 0)
+            wake = _workqueue_wake_worker(queue);
         rt_hw_interrupt_enable(level);
 
+        if (wake)
+            rt_sem_release(&(queue->wake));
+
         /* ack work completion */
         _workqueue_work_completion(queue);
     }
 }
 
+/* insert work to the tail of its lane, with interrupt disabled */
+static rt_bool_t _workqueue_insert_work(struct rt_workqueue *queue, struct rt_work *work)
+{
+    /* NOTE: the work MUST be initialized firstly */
+    rt_list_remove(&(work->list));
+
+    if (!(work->flags & RT_WORK_STATE_PENDING))
+    {
+        queue->stats.submitted ++;
+        queue->stats.depth ++;
+        if (queue->stats.depth > queue->stats.depth_max)
+            queue->stats.depth_max = queue->stats.depth;
+    }
+
+    rt_list_insert_before(&(queue->work_list[work->priority]), &(work->list));
+    work->flags |= RT_WORK_STATE_PENDING;
+    work->submit_tick = rt_tick_get();
+
+    return _workqueue_wake_worker(queue);
+}
+
 static rt_err_t _workqueue_submit_work(struct rt_workqueue *queue, struct rt_work *work)
 {
     rt_base_t level;
+    rt_bool_t wake;
 
     level = rt_hw_interrupt_disable();
     if (work->flags & RT_WORK_STATE_PENDING)
@@ -96,30 +219,18 @@ static rt_err_t _workqueue_submit_work(struct rt_workqueue *queue, struct rt_wor
         return -RT_EBUSY;
     }
 
-    if (queue->work_current == work)
+    if (_workqueue_work_running(queue, work))
     {
         rt_hw_interrupt_enable(level);
         return -RT_EBUSY;
     }
 
-    /* NOTE: the work MUST be initialized firstly */
-    rt_list_remove(&(work->list));
-
-    rt_list_insert_after(queue->work_list.prev, &(work->list));
-    work->flags |= RT_WORK_STATE_PENDING;
+    wake = _workqueue_insert_work(queue, work);
+    rt_hw_interrupt_enable(level);
 
-    /* whether the workqueue is doing work */
-    if (queue->work_current == RT_NULL)
-    {
-        rt_hw_interrupt_enable(level);
-        /* resume work thread */
-        rt_thread_resume(queue->work_thread);
-        rt_schedule();
-    }
-    else
-    {
-        rt_hw_interrupt_enable(level);
-    }
+    /* resume an idle worker */
+    if (wake)
+        rt_sem_release(&(queue->wake));
 
     return RT_EOK;
 }
@@ -129,12 +240,14 @@ static rt_err_t _workqueue_cancel_work(struct rt_workqueue *queue, struct rt_wor
     rt_base_t level;
 
     level = rt_hw_interrupt_disable();
-    if (queue->work_current == work)
+    if (_workqueue_work_running(queue, work))
     {
         rt_hw_interrupt_enable(level);
         return -RT_EBUSY;
     }
     rt_list_remove(&(work->list));
+    if (work->flags & RT_WORK_STATE_PENDING)
+        queue->stats.depth --;
     work->flags &= ~RT_WORK_STATE_PENDING;
     rt_hw_interrupt_enable(level);
 
@@ -246,37 +359,80 @@ static void _delayed_work_timeout_handler(void *parameter)
     _workqueue_submit_work(delayed_work->workqueue, &(delayed_work->work));
 }
 
-struct rt_workqueue *rt_workqueue_create(const char *name, rt_uint16_t stack_size, rt_uint8_t priority)
+/**
+ * This function will create a workqueue with a pool of worker threads.
+ *
+ * @param name the name of worker threads
+ * @param stack_size the stack size of each worker thread
+ * @param priority the priority of worker threads
+ * @param workers the number of worker threads
+ *
+ * @return the workqueue, RT_NULL on failure
+ */
+struct rt_workqueue *rt_workqueue_create_pool(const char *name, rt_uint16_t stack_size, rt_uint8_t priority,
+        rt_uint8_t workers)
 {
     struct rt_workqueue *queue = RT_NULL;
+    char thread_name[RT_NAME_MAX];
+    int index;
+
+    RT_ASSERT(workers > 0);
+
+    queue = (struct rt_workqueue *)RT_KERNEL_MALLOC(sizeof(struct rt_workqueue) +
+            workers * sizeof(struct rt_workqueue_worker));
+    if (queue == RT_NULL)
+        return RT_NULL;
 
-    queue = (struct rt_workqueue *)RT_KERNEL_MALLOC(sizeof(struct rt_workqueue));
-    if (queue != RT_NULL)
+    rt_memset(queue, 0, sizeof(struct rt_workqueue) + workers * sizeof(struct rt_workqueue_worker));
+
+    /* initialize work list */
+    for (index = 0; index < RT_WORK_PRIO_NUM; index ++)
+        rt_list_init(&(queue->work_list[index]));
+    rt_sem_init(&(queue->sem), "wqueue", 0, RT_IPC_FLAG_FIFO);
+    rt_sem_init(&(queue->wake), "wqwake", 0, RT_IPC_FLAG_FIFO);
+    queue->workers = (struct rt_workqueue_worker *)(queue + 1);
+
+    /* create the work threads */
+    for (index = 0; index < workers; index ++)
     {
-        /* initialize work list */
-        rt_list_init(&(queue->work_list));
-        queue->work_current = RT_NULL;
-        rt_sem_init(&(queue->sem), "wqueue", 0, RT_IPC_FLAG_FIFO);
-
-        /* create the work thread */
-        queue->work_thread = rt_thread_create(name, _workqueue_thread_entry, queue, stack_size, priority, 10);
-        if (queue->work_thread == RT_NULL)
+        if (workers == 1)
+            rt_strncpy(thread_name, name, RT_NAME_MAX);
+        else
+            rt_snprintf(thread_name, sizeof(thread_name), "%.*s%d", RT_NAME_MAX - 4, name, index);
+
+        queue->workers[index].queue = queue;
+        queue->workers[index].thread = rt_thread_create(thread_name, _workqueue_thread_entry,
+                                       &(queue->workers[index]), stack_size, priority, 10);
+        if (queue->workers[index].thread == RT_NULL)
         {
-            RT_KERNEL_FREE(queue);
+            rt_workqueue_destroy(queue);
             return RT_NULL;
         }
-
-        rt_thread_startup(queue->work_thread);
+        queue->worker_num ++;
     }
+    queue->work_thread = queue->workers[0].thread;
+
+    for (index = 0; index < workers; index ++)
+        rt_thread_startup(queue->workers[index].thread);
 
     return queue;
 }
 
+struct rt_workqueue *rt_workqueue_create(const char *name, rt_uint16_t stack_size, rt_uint8_t priority)
+{
+    return rt_workqueue_create_pool(name, stack_size, priority, 1);
+}
+
 rt_err_t rt_workqueue_destroy(struct rt_workqueue *queue)
 {
+    int index;
+
     RT_ASSERT(queue != RT_NULL);
 
-    rt_thread_delete(queue->work_thread);
+    for (index = 0; index < queue->worker_num; index ++)
+        rt_thread_delete(queue->workers[index].thread);
+    rt_sem_detach(&(queue->sem));
+    rt_sem_detach(&(queue->wake));
     RT_KERNEL_FREE(queue);
 
     return RT_EOK;
@@ -308,28 +464,23 @@ rt_err_t rt_workqueue_submit_work(struct rt_workqueue *queue, struct rt_work *wo
 rt_err_t rt_workqueue_critical_work(struct rt_workqueue *queue, struct rt_work *work)
 {
     rt_base_t level;
+    rt_bool_t wake;
     RT_ASSERT(queue != RT_NULL);
     RT_ASSERT(work != RT_NULL);
 
     level = rt_hw_interrupt_disable();
-    if (queue->work_current == work)
+    if (_workqueue_work_running(queue, work))
     {
         rt_hw_interrupt_enable(level);
         return -RT_EBUSY;
     }
 
-    /* NOTE: the work MUST be initialized firstly */
-    rt_list_remove(&(work->list));
+    wake = _workqueue_insert_work(queue, work);
+    rt_hw_interrupt_enable(level);
 
-    rt_list_insert_after(queue->work_list.prev, &(work->list));
-    if (queue->work_current == RT_NULL)
-    {
-        rt_hw_interrupt_enable(level);
-        /* resume work thread */
-        rt_thread_resume(queue->work_thread);
-        rt_schedule();
-    }
-    else rt_hw_interrupt_enable(level);
+    /* resume an idle worker */
+    if (wake)
+        rt_sem_release(&(queue->wake));
 
     return RT_EOK;
 }
@@ -357,15 +508,17 @@ rt_err_t rt_workqueue_cancel_work_sync(struct rt_workqueue *queue, struct rt_wor
     RT_ASSERT(work != RT_NULL);
 
     level = rt_hw_interrupt_disable();
-    if (queue->work_current == work) /* it's current work in the queue */
+    /* it's current work of a worker, wait for work completion */
+    while (_workqueue_work_running(queue, work))
     {
-        /* wait for work completion */
+        rt_hw_interrupt_enable(level);
         rt_sem_take(&(queue->sem), RT_WAITING_FOREVER);
+        level = rt_hw_interrupt_disable();
     }
-    else
-    {
-        rt_list_remove(&(work->list));
-    }
+
+    rt_list_remove(&(work->list));
+    if (work->flags & RT_WORK_STATE_PENDING)
+        queue->stats.depth --;
     work->flags &= ~RT_WORK_STATE_PENDING;
     rt_hw_interrupt_enable(level);
 
@@ -375,19 +528,69 @@ rt_err_t rt_workqueue_cancel_work_sync(struct rt_workqueue *queue, struct rt_wor
 rt_err_t rt_workqueue_cancel_all_work(struct rt_workqueue *queue)
 {
     struct rt_list_node *node, *next;
+    rt_base_t level;
+    int lane;
     RT_ASSERT(queue != RT_NULL);
 
-    rt_enter_critical();
-    for (node = queue->work_list.next; node != &(queue->work_list); node = next)
+    level = rt_hw_interrupt_disable();
+    for (lane = 0; lane < RT_WORK_PRIO_NUM; lane ++)
     {
-        next = node->next;
-        rt_list_remove(node);
+        for (node = queue->work_list[lane].next; node != &(queue->work_list[lane]); node = next)
+        {
+            next = node->next;
+            rt_list_remove(node);
+            rt_list_entry(node, struct rt_work, list)->flags &= ~RT_WORK_STATE_PENDING;
+        }
     }
-    rt_exit_critical();
+    queue->stats.depth = 0;
+    rt_hw_interrupt_enable(level);
+
+    return RT_EOK;
+}
+
+/**
+ * This function will get the statistics of workqueue.
+ *
+ * @param queue the workqueue
+ * @param stats the buffer to save statistics
+ *
+ * @return RT_EOK
+ */
+rt_err_t rt_workqueue_get_stats(struct rt_workqueue *queue, struct rt_workqueue_stats *stats)
+{
+    rt_base_t level;
+
+    RT_ASSERT(queue != RT_NULL);
+    RT_ASSERT(stats != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    *stats = queue->stats;
+    rt_hw_interrupt_enable(level);
 
     return RT_EOK;
 }
 
+/**
+ * This function will reset the statistics of workqueue, the pending works
+ * are kept in depth.
+ *
+ * @param queue the workqueue
+ */
+void rt_workqueue_reset_stats(struct rt_workqueue *queue)
+{
+    rt_base_t level;
+    rt_uint16_t depth;
+
+    RT_ASSERT(queue != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    depth = queue->stats.depth;
+    rt_memset(&(queue->stats), 0, sizeof(queue->stats));
+    queue->stats.depth = depth;
+    queue->stats.depth_max = depth;
+    rt_hw_interrupt_enable(level);
+}
+
 void rt_delayed_work_init(struct rt_delayed_work *work, void (*work_func)(struct rt_work *work,
                           void *work_data), void *work_data)
 {
@@ -396,6 +599,10 @@ void rt_delayed_work_init(struct rt_delayed_work *work, void (*work_func)(struct
 }
 
 #ifdef RT_USING_SYSTEM_WORKQUEUE
+#ifndef RT_SYSTEM_WORKQUEUE_WORKERS
+#define RT_SYSTEM_WORKQUEUE_WORKERS     1
+#endif
+
 static struct rt_workqueue *sys_workq;
 
 rt_err_t rt_work_submit(struct rt_work *work, rt_tick_t time)
@@ -410,8 +617,8 @@ rt_err_t rt_work_cancel(struct rt_work *work)
 
 static int rt_work_sys_workqueue_init(void)
 {
-    sys_workq = rt_workqueue_create("sys_work", RT_SYSTEM_WORKQUEUE_STACKSIZE,
-                                    RT_SYSTEM_WORKQUEUE_PRIORITY);
+    sys_workq = rt_workqueue_create_pool("sys_work", RT_SYSTEM_WORKQUEUE_STACKSIZE,
+                                         RT_SYSTEM_WORKQUEUE_PRIORITY, RT_SYSTEM_WORKQUEUE_WORKERS);
 
     return RT_EOK;
 }
@@ -29,6 +29,7 @@
  * 2018-11-22     Jesven       list_thread add smp support
  * 2018-12-27     Jesven       Fix the problem that disable interrupt too long in list_thread 
  *                             Provide protection for the "first layer of objects" when list_*
+ * 2026-10-19     Hehesheng    list_event shows the threads in all waiting buckets
  */
 
 #include <rthw.h>
@@ -370,6 +371,40 @@ long list_event(void)
                 rt_hw_interrupt_enable(level);
 
                 e = (struct rt_event *)obj;
+#ifdef RT_USING_EVENT_BUCKETS
+                {
+                    int bucket, count, shown;
+                    rt_list_t *list;
+
+                    count = 0;
+                    for (bucket = 0; bucket < RT_EVENT_WAIT_BUCKETS; bucket++)
+                    {
+                        list = bucket ? &e->wait_list[bucket - 1] : &e->parent.suspend_thread;
+                        count += rt_list_len(list);
+                    }
+
+                    if (count > 0)
+                    {
+                        rt_kprintf("%-*.*s  0x%08x %03d:",
+                                maxlen, RT_NAME_MAX,
+                                e->parent.parent.name,
+                                e->set,
+                                count);
+                        shown = 0;
+                        for (bucket = 0; bucket < RT_EVENT_WAIT_BUCKETS; bucket++)
+                        {
+                            list = bucket ? &e->wait_list[bucket - 1] : &e->parent.suspend_thread;
+                            if (rt_list_isempty(list))
+                                continue;
+                            if (shown++)
+                                rt_kprintf("/");
+                            show_wait_queue(list);
+                        }
+                        rt_kprintf("\n");
+                        continue;
+                    }
+                }
+#endif
                 if (!rt_list_isempty(&e->parent.suspend_thread))
                 {
                     rt_kprintf("%-*.*s  0x%08x %03d:",
@@ -53,6 +53,11 @@ static void _dlmodule_set_name(struct rt_dlmodule *module, const char *path)
 
     rt_strncpy(object->name, first, size);
     object->name[size] = '\0';
+
+#ifdef RT_USING_OBJECT_HASH
+    /* the name is changed in place, update the name hash index */
+    rt_object_rehash(object);
+#endif
 }
 
 #define RT_MODULE_ARG_MAX    8
@@ -386,6 +386,11 @@
 #define CHECKSUM_CHECK_ICMP             0
 #endif
 
+/* the custom pbuf references the buffer of driver, it's used by zero-copy rx */
+#ifdef RT_LWIP_USING_CUSTOM_PBUF
+#define LWIP_SUPPORT_CUSTOM_PBUF        1
+#endif
+
 /* ---------- IP options ---------- */
 /* Define IP_FORWARD to 1 if you wish to have the ability to forward
    IP packets across network interfaces. If you are going to run lwIP
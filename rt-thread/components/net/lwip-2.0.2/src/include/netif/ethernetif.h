@@ -14,6 +14,10 @@
 /* eth flag with auto_linkup or phy_linkup */
 #define ETHIF_LINK_AUTOUP	0x0000
 #define ETHIF_LINK_PHYUP	0x0100
+/* eth flag with eth_tx never blocking, it's called in tcpip thread directly */
+#define ETHIF_TX_DIRECT		0x0200
+/* eth flag with eth_tx_kick set, the frames are batched and kicked together */
+#define ETHIF_TX_BATCH		0x0400
 
 struct eth_device
 {
@@ -31,6 +35,14 @@ struct eth_device
     /* eth device interface */
     struct pbuf* (*eth_rx)(rt_device_t dev);
     rt_err_t (*eth_tx)(rt_device_t dev, struct pbuf* p);
+
+#ifdef RT_LWIP_USING_ETH_TX_BATCH
+    /* optional, used with ETHIF_TX_BATCH flag only, eth_tx only queues the
+     * frame and eth_tx_kick starts DMA for all the queued frames, the frames
+     * are kept until eth_device_tx_done */
+    rt_err_t (*eth_tx_kick)(rt_device_t dev);
+    void *tx_batch;
+#endif
 };
 
 #ifdef __cplusplus
@@ -41,6 +53,9 @@ extern "C" {
     rt_err_t eth_device_init(struct eth_device * dev, const char *name);
     rt_err_t eth_device_init_with_flag(struct eth_device *dev, const char *name, rt_uint16_t flag);
     rt_err_t eth_device_linkchange(struct eth_device* dev, rt_bool_t up);
+#ifdef RT_LWIP_USING_ETH_TX_BATCH
+    rt_err_t eth_device_tx_done(struct eth_device* dev, rt_uint32_t count);
+#endif
 
     int eth_system_device_init(void);
 
@@ -38,6 +38,7 @@
  *                             after lwIP initialization.
  * 2013-02-28     aozima       fixed list_tcps bug: ipaddr_ntoa isn't reentrant.
  * 2016-08-18     Bernard      port to lwIP 2.0.0
+ * 2026-10-19     Hehesheng    add direct and batching tx
  */
 
 #include "lwip/opt.h"
@@ -91,6 +92,29 @@ static char eth_tx_thread_stack[512];
 static char eth_tx_thread_mb_pool[RT_LWIP_ETHTHREAD_MBOX_SIZE * 4];
 static char eth_tx_thread_stack[RT_LWIP_ETHTHREAD_STACKSIZE];
 #endif
+
+#ifdef RT_LWIP_USING_ETH_TX_BATCH
+#ifndef RT_LWIP_ETH_TX_BATCH_NUM
+#define RT_LWIP_ETH_TX_BATCH_NUM    16
+#endif
+
+/**
+ * Tx batch of Ethernet interface. The frames in [head, sent) are in driver,
+ * and the frames in [sent, tail) are waiting for Tx thread.
+ */
+struct eth_tx_batch
+{
+    struct eth_tx_msg msg;      /* the message to Tx thread, its buf is RT_NULL */
+    struct pbuf *frames[RT_LWIP_ETH_TX_BATCH_NUM];
+    rt_uint16_t head;
+    rt_uint16_t sent;
+    rt_uint16_t tail;
+    rt_uint16_t done;           /* the frames finished by driver */
+    rt_uint8_t  posted;         /* the message is in mailbox */
+};
+#endif /* RT_LWIP_USING_ETH_TX_BATCH */
+#elif defined(RT_LWIP_USING_ETH_TX_BATCH)
+#error "the Tx batch needs Tx thread"
 #endif
 
 #ifndef LWIP_NO_RX_THREAD
@@ -352,6 +376,152 @@ static int netdev_flags_sync(struct netif *lwip_netif)
 }
 #endif /* RT_USING_NETDEV */
 
+#ifdef RT_LWIP_USING_ETH_TX_BATCH
+/* post the batch to Tx thread, it's posted once until Tx thread takes it */
+static rt_err_t ethernetif_tx_batch_post(struct eth_tx_batch *batch)
+{
+    rt_uint32_t level;
+    rt_uint8_t posted;
+    rt_err_t result = RT_EOK;
+
+    level = rt_hw_interrupt_disable();
+    posted = batch->posted;
+    batch->posted = 1;
+    rt_hw_interrupt_enable(level);
+
+    if (!posted)
+    {
+        result = rt_mb_send(&eth_tx_thread_mb, (rt_ubase_t)&(batch->msg));
+        if (result != RT_EOK)
+            batch->posted = 0;
+    }
+
+    return result;
+}
+
+/* keep the frame after linkoutput returns, the frame referencing memory of others is copied */
+static struct pbuf *ethernetif_tx_hold(struct pbuf *p)
+{
+    struct pbuf *q;
+
+    for (q = p; q != NULL; q = q->next)
+    {
+        if (q->type == PBUF_REF || q->type == PBUF_ROM)
+            break;
+    }
+
+    if (q == NULL)
+    {
+        pbuf_ref(p);
+        return p;
+    }
+
+    q = pbuf_alloc(PBUF_RAW, p->tot_len, PBUF_RAM);
+    if (q != NULL && pbuf_copy(q, p) != ERR_OK)
+    {
+        pbuf_free(q);
+        q = NULL;
+    }
+
+    return q;
+}
+
+static err_t ethernetif_tx_batch_queue(struct eth_device *enetif, struct pbuf *p)
+{
+    struct eth_tx_batch *batch = (struct eth_tx_batch *)enetif->tx_batch;
+    rt_uint32_t level;
+    rt_uint16_t next;
+
+    next = (batch->tail + 1) % RT_LWIP_ETH_TX_BATCH_NUM;
+    if (next == batch->head || (p = ethernetif_tx_hold(p)) == NULL)
+    {
+        LINK_STATS_INC(link.memerr);
+        return ERR_MEM;
+    }
+
+    batch->frames[batch->tail] = p;
+    level = rt_hw_interrupt_disable();
+    batch->tail = next;
+    rt_hw_interrupt_enable(level);
+
+    ethernetif_tx_batch_post(batch);
+    return ERR_OK;
+}
+
+/* release the finished frames, and hand the waiting frames to driver at once */
+static void ethernetif_tx_batch_service(struct eth_device *enetif)
+{
+    struct eth_tx_batch *batch = (struct eth_tx_batch *)enetif->tx_batch;
+    rt_uint32_t level;
+    rt_uint16_t done, tail, count = 0;
+
+    level = rt_hw_interrupt_disable();
+    batch->posted = 0;
+    done = batch->done;
+    batch->done = 0;
+    tail = batch->tail;
+    rt_hw_interrupt_enable(level);
+
+    while (done > 0 && batch->head != batch->sent)
+    {
+        pbuf_free(batch->frames[batch->head]);
+        batch->frames[batch->head] = NULL;
+        batch->head = (batch->head + 1) % RT_LWIP_ETH_TX_BATCH_NUM;
+        done --;
+    }
+
+    while (batch->sent != tail)
+    {
+        if (enetif->eth_tx(&(enetif->parent), batch->frames[batch->sent]) != RT_EOK)
+        {
+            /* the driver is full, try again when some frames are finished */
+            if (batch->head != batch->sent)
+                break;
+
+            /* nothing is in driver, drop it */
+            LINK_STATS_INC(link.drop);
+            pbuf_free(batch->frames[batch->sent]);
+            batch->frames[batch->sent] = NULL;
+            batch->sent = (batch->sent + 1) % RT_LWIP_ETH_TX_BATCH_NUM;
+            batch->head = batch->sent;
+            continue;
+        }
+
+        batch->sent = (batch->sent + 1) % RT_LWIP_ETH_TX_BATCH_NUM;
+        count ++;
+    }
+
+    if (count > 0)
+        enetif->eth_tx_kick(&(enetif->parent));
+}
+
+/**
+ * This function will tell the finished frames of Tx batch. The frames are
+ * finished in order, and they are released in Tx thread later. It can be
+ * invoked in ISR.
+ *
+ * @param dev the Ethernet device
+ * @param count the number of finished frames
+ *
+ * @return the error code, RT_EOK on successful
+ */
+rt_err_t eth_device_tx_done(struct eth_device* dev, rt_uint32_t count)
+{
+    struct eth_tx_batch *batch;
+    rt_uint32_t level;
+
+    RT_ASSERT(dev != RT_NULL);
+    batch = (struct eth_tx_batch *)dev->tx_batch;
+    RT_ASSERT(batch != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    batch->done += count;
+    rt_hw_interrupt_enable(level);
+
+    return ethernetif_tx_batch_post(batch);
+}
+#endif /* RT_LWIP_USING_ETH_TX_BATCH */
+
 static err_t ethernetif_linkoutput(struct netif *netif, struct pbuf *p)
 {
 #ifndef LWIP_NO_TX_THREAD
@@ -361,6 +531,23 @@ static err_t ethernetif_linkoutput(struct netif *netif, struct pbuf *p)
     RT_ASSERT(netif != RT_NULL);
     enetif = (struct eth_device*)netif->state;
 
+#ifdef RT_LWIP_USING_ETH_TX_BATCH
+    if (enetif->tx_batch != RT_NULL)
+    {
+        return ethernetif_tx_batch_queue(enetif, p);
+    }
+#endif
+
+    /* the driver never blocks, call it in tcpip thread */
+    if (enetif->flags & ETHIF_TX_DIRECT)
+    {
+        if (enetif->eth_tx(&(enetif->parent), p) != RT_EOK)
+        {
+            return ERR_IF;
+        }
+        return ERR_OK;
+    }
+
     /* send a message to eth tx thread */
     msg.netif = netif;
     msg.buf   = p;
@@ -469,6 +656,27 @@ rt_err_t eth_device_init_with_flag(struct eth_device *dev, const char *name, rt_
     }
     rt_memset(netif, 0, sizeof(struct netif));
 
+#ifdef RT_LWIP_USING_ETH_TX_BATCH
+    dev->tx_batch = RT_NULL;
+    /* the driver opts in by flag, eth_tx_kick may be garbage otherwise */
+    if (flags & ETHIF_TX_BATCH)
+    {
+        struct eth_tx_batch *batch;
+
+        RT_ASSERT(dev->eth_tx_kick != RT_NULL);
+
+        batch = (struct eth_tx_batch *) rt_calloc(1, sizeof(struct eth_tx_batch));
+        if (batch == RT_NULL)
+        {
+            rt_kprintf("malloc tx batch failed\n");
+            rt_free(netif);
+            return -RT_ERROR;
+        }
+        batch->msg.netif = netif;
+        dev->tx_batch = batch;
+    }
+#endif
+
     /* set netif */
     dev->netif = netif;
     /* device flags, which will be set to netif flags when initializing */
@@ -591,6 +799,14 @@ static void eth_tx_thread_entry(void* parameter)
             struct eth_device* enetif;
 
             RT_ASSERT(msg->netif != RT_NULL);
+#ifdef RT_LWIP_USING_ETH_TX_BATCH
+            /* the message of Tx batch */
+            if (msg->buf == RT_NULL)
+            {
+                ethernetif_tx_batch_service((struct eth_device*)msg->netif->state);
+                continue;
+            }
+#endif
             RT_ASSERT(msg->buf   != RT_NULL);
 
             enetif = (struct eth_device*)msg->netif->state;
@@ -224,6 +224,144 @@ START_TEST(test_pbuf_get_put_at_edge)
 }
 END_TEST
 
+#if LWIP_SUPPORT_CUSTOM_PBUF
+/* A zero-copy rx driver model: the ring buffers are passed up in place by
+ * custom pbufs, the ring is refilled from a spare pool at once, and a buffer
+ * goes back to the pool when the last reference of its pbuf is freed.
+ */
+#define TEST_RX_RING      4
+#define TEST_RX_POOL      (TEST_RX_RING + 3)
+#define TEST_RX_BUFSIZE   256
+
+struct test_rx_pbuf {
+  struct pbuf_custom pc;
+  u8_t buffer[TEST_RX_BUFSIZE];
+  int in_pool;
+};
+
+static struct test_rx_pbuf test_rx_pbufs[TEST_RX_POOL];
+static struct test_rx_pbuf *test_rx_ring[TEST_RX_RING];
+static int test_rx_frees;
+
+static struct test_rx_pbuf *
+test_rx_pool_alloc(void)
+{
+  int i;
+  for (i = 0; i < TEST_RX_POOL; i++) {
+    if (test_rx_pbufs[i].in_pool) {
+      test_rx_pbufs[i].in_pool = 0;
+      return &test_rx_pbufs[i];
+    }
+  }
+  return NULL;
+}
+
+static int
+test_rx_pool_count(void)
+{
+  int i, count = 0;
+  for (i = 0; i < TEST_RX_POOL; i++) {
+    count += test_rx_pbufs[i].in_pool;
+  }
+  return count;
+}
+
+static void
+test_rx_pbuf_free(struct pbuf *p)
+{
+  struct test_rx_pbuf *rx = (struct test_rx_pbuf *)p;
+  fail_unless(rx->in_pool == 0, "rx buffer freed twice");
+  rx->in_pool = 1;
+  test_rx_frees++;
+}
+
+/* receive a frame in the slot of ring, NULL if the driver shall copy it */
+static struct pbuf *
+test_rx_frame(int slot, u16_t len, u8_t fill)
+{
+  struct test_rx_pbuf *rx = test_rx_ring[slot];
+  struct test_rx_pbuf *spare = test_rx_pool_alloc();
+  if (spare == NULL) {
+    return NULL;
+  }
+  test_rx_ring[slot] = spare;
+  memset(rx->buffer, fill, len);
+  rx->pc.custom_free_function = test_rx_pbuf_free;
+  return pbuf_alloced_custom(PBUF_RAW, len, PBUF_REF, &rx->pc, rx->buffer, TEST_RX_BUFSIZE);
+}
+
+/** Custom pbufs go back to the pool once, after the last reference is freed,
+ * and the rx ring always keeps its buffers */
+START_TEST(test_pbuf_custom_rx_refill)
+{
+  struct pbuf *p[TEST_RX_POOL], *chain;
+  struct test_rx_pbuf *rx;
+  int i, count;
+  LWIP_UNUSED_ARG(_i);
+
+  test_rx_frees = 0;
+  for (i = 0; i < TEST_RX_POOL; i++) {
+    test_rx_pbufs[i].in_pool = 1;
+  }
+  for (i = 0; i < TEST_RX_RING; i++) {
+    test_rx_ring[i] = test_rx_pool_alloc();
+  }
+  fail_unless(test_rx_pool_count() == TEST_RX_POOL - TEST_RX_RING);
+
+  /* the frames held by stack use up the spare buffers */
+  for (i = 0; i < TEST_RX_POOL - TEST_RX_RING; i++) {
+    p[i] = test_rx_frame(i % TEST_RX_RING, 60 + i, (u8_t)i);
+    fail_unless(p[i] != NULL);
+    fail_unless(p[i]->tot_len == 60 + i);
+    fail_unless(((u8_t *)p[i]->payload)[0] == (u8_t)i);
+  }
+  /* pool is empty: the frame is copied and the ring keeps its buffer */
+  rx = test_rx_ring[0];
+  fail_unless(test_rx_frame(0, 60, 0xAA) == NULL);
+  fail_unless(test_rx_ring[0] == rx);
+  for (i = 0; i < TEST_RX_RING; i++) {
+    fail_unless(test_rx_ring[i] != NULL && test_rx_ring[i]->in_pool == 0);
+  }
+
+  /* headers stripped and a second reference taken: not freed yet */
+  fail_unless(pbuf_header(p[0], -14) == 0);
+  pbuf_ref(p[0]);
+  fail_unless(pbuf_free(p[0]) == 0);
+  fail_unless(test_rx_frees == 0);
+
+  /* chained into a queue with a pool pbuf, like out-of-sequence data */
+  chain = pbuf_alloc(PBUF_RAW, 100, PBUF_POOL);
+  fail_unless(chain != NULL);
+  pbuf_cat(chain, p[1]);
+  pbuf_chain(chain, p[2]);
+  fail_unless(chain->tot_len == 100 + p[1]->len + p[2]->len);
+  pbuf_realloc(p[0], 20);
+  fail_unless(pbuf_free(p[0]) == 1);
+  fail_unless(test_rx_frees == 1);
+  fail_unless(test_rx_pool_count() == 1);
+
+  /* the chained frame keeps its reference until the chain is freed */
+  count = pbuf_free(chain);
+  fail_unless(count == 2, "freed %d pbufs", count);
+  fail_unless(test_rx_frees == 2);
+  fail_unless(pbuf_free(p[2]) == 1);
+  fail_unless(test_rx_frees == 3);
+
+  /* every buffer is back, and the ring can be refilled again */
+  fail_unless(test_rx_pool_count() == TEST_RX_POOL - TEST_RX_RING);
+  for (i = 0; i < TEST_RX_POOL - TEST_RX_RING; i++) {
+    p[i] = test_rx_frame(i % TEST_RX_RING, 200, 0);
+    fail_unless(p[i] != NULL);
+  }
+  for (i = 0; i < TEST_RX_POOL - TEST_RX_RING; i++) {
+    fail_unless(pbuf_free(p[i]) == 1);
+  }
+  fail_unless(test_rx_frees == 2 * (TEST_RX_POOL - TEST_RX_RING));
+  fail_unless(test_rx_pool_count() == TEST_RX_POOL - TEST_RX_RING);
+}
+END_TEST
+#endif /* LWIP_SUPPORT_CUSTOM_PBUF */
+
 /** Create the suite including all tests for this module */
 Suite *
 pbuf_suite(void)
@@ -233,7 +371,10 @@ pbuf_suite(void)
     TESTFUNC(test_pbuf_split_64k_on_small_pbufs),
     TESTFUNC(test_pbuf_queueing_bigger_than_64k),
     TESTFUNC(test_pbuf_take_at_edge),
-    TESTFUNC(test_pbuf_get_put_at_edge)
+    TESTFUNC(test_pbuf_get_put_at_edge),
+#if LWIP_SUPPORT_CUSTOM_PBUF
+    TESTFUNC(test_pbuf_custom_rx_refill),
+#endif
   };
   return create_suite("PBUF", tests, sizeof(tests)/sizeof(testfunc), pbuf_setup, pbuf_teardown);
 }
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+#include "kbench.h"
+
+#ifdef RT_USING_CPUTIME
+#include <rtdevice.h>
+#endif
+
+#define DBG_TAG    "kbench"
+#define DBG_LVL    DBG_INFO
+#include <rtdbg.h>
+
+/* the cost of an empty measurement, it is subtracted from every sample */
+static rt_uint32_t _overhead = (rt_uint32_t)-1;
+
+/**
+ * This function will return the current cycle counter. It falls back to the
+ * OS tick if no cputime is registered.
+ *
+ * @return the cycle counter
+ */
+rt_uint32_t kbench_cycles(void)
+{
+#ifdef RT_USING_CPUTIME
+    if (clock_cpu_getres() != 0)
+        return clock_cpu_gettime();
+#endif
+
+    return rt_tick_get();
+}
+
+/**
+ * This function will return the frequency of kbench_cycles.
+ *
+ * @return the frequency in Hz
+ */
+rt_uint32_t kbench_cycles_freq(void)
+{
+#ifdef RT_USING_CPUTIME
+    float res = clock_cpu_getres();
+
+    if (res != 0)
+        return (rt_uint32_t)(1000000000.0f / res);
+#endif
+
+    return RT_TICK_PER_SECOND;
+}
+
+/**
+ * This function will return the unit name of samples.
+ *
+ * @return "cycles" or "ticks"
+ */
+const char *kbench_unit(void)
+{
+#ifdef RT_USING_CPUTIME
+    if (clock_cpu_getres() != 0)
+        return "cycles";
+#endif
+
+    return "ticks";
+}
+
+static void _kbench_calibrate(void)
+{
+    rt_uint32_t start, cost;
+    int i;
+
+    for (i = 0; i < 32; i++)
+    {
+        start = kbench_cycles();
+        cost = kbench_cycles() - start;
+        if (cost < _overhead)
+            _overhead = cost;
+    }
+}
+
+/**
+ * This function will start a benchmark item and drop the old samples.
+ *
+ * @param bench the benchmark samples
+ * @param name the item name, it shall not contain any white space
+ */
+void kbench_begin(struct kbench *bench, const char *name)
+{
+    RT_ASSERT(bench != RT_NULL);
+
+    if (_overhead == (rt_uint32_t)-1)
+        _kbench_calibrate();
+
+    bench->name = name;
+    bench->count = 0;
+}
+
+/**
+ * This function will add one sample, the measurement overhead is removed.
+ *
+ * @param bench the benchmark samples
+ * @param cycles the measured cycles
+ */
+void kbench_add(struct kbench *bench, rt_uint32_t cycles)
+{
+    RT_ASSERT(bench != RT_NULL);
+
+    if (bench->count >= RT_KBENCH_SAMPLES)
+        return;
+
+    bench->samples[bench->count++] = cycles > _overhead ? cycles - _overhead : 0;
+}
+
+/**
+ * This function will sort the samples and print the result line.
+ *
+ * @param bench the benchmark samples
+ * @param result the buffer to save result, it can be RT_NULL
+ */
+void kbench_report(struct kbench *bench, struct kbench_result *result)
+{
+    struct kbench_result res;
+    rt_uint32_t i, j, value;
+
+    RT_ASSERT(bench != RT_NULL);
+
+    if (bench->count == 0)
+    {
+        LOG_W("%s: no samples", bench->name);
+        return;
+    }
+
+    /* insertion sort, the samples are nearly sorted in most cases */
+    for (i = 1; i < bench->count; i++)
+    {
+        value = bench->samples[i];
+        for (j = i; j > 0 && bench->samples[j - 1] > value; j--)
+            bench->samples[j] = bench->samples[j - 1];
+        bench->samples[j] = value;
+    }
+
+    res.count  = bench->count;
+    res.min    = bench->samples[0];
+    res.median = bench->samples[bench->count / 2];
+    res.p99    = bench->samples[(bench->count * 99) / 100];
+    res.max    = bench->samples[bench->count - 1];
+
+    rt_kprintf("[kbench] name=%s n=%d min=%d median=%d p99=%d max=%d unit=%s freq=%d\n",
+               bench->name, res.count, res.min, res.median, res.p99, res.max,
+               kbench_unit(), kbench_cycles_freq());
+
+    if (result)
+        *result = res;
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#ifndef _KBENCH_H_
+#define _KBENCH_H_
+
+#include <rtthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef RT_KBENCH_SAMPLES
+#define RT_KBENCH_SAMPLES              256
+#endif
+
+/*
+ * The samples of one benchmark item. Every item is reported as one line:
+ *
+ * [kbench] name=<name> n=<samples> min=<> median=<> p99=<> max=<> unit=<unit> freq=<Hz>
+ *
+ * The unit is "cycles" when the cputime is available, otherwise it is "ticks"
+ * and the numbers only make sense for the long running items.
+ */
+struct kbench
+{
+    const char *name;
+    rt_uint32_t count;
+    rt_uint32_t samples[RT_KBENCH_SAMPLES];
+};
+
+/* the result after kbench_report */
+struct kbench_result
+{
+    rt_uint32_t count;
+    rt_uint32_t min;
+    rt_uint32_t median;
+    rt_uint32_t p99;
+    rt_uint32_t max;
+};
+
+rt_uint32_t kbench_cycles(void);
+rt_uint32_t kbench_cycles_freq(void);
+const char *kbench_unit(void);
+
+void kbench_begin(struct kbench *bench, const char *name);
+void kbench_add(struct kbench *bench, rt_uint32_t cycles);
+void kbench_report(struct kbench *bench, struct kbench_result *result);
+
+/* measure the statement for RT_KBENCH_SAMPLES times */
+#define KBENCH_RUN(bench, name, statement)                  \
+    do {                                                    \
+        rt_uint32_t __start;                                \
+        kbench_begin((bench), (name));                      \
+        while ((bench)->count < RT_KBENCH_SAMPLES)          \
+        {                                                   \
+            __start = kbench_cycles();                      \
+            statement;                                      \
+            kbench_add((bench), kbench_cycles() - __start); \
+        }                                                   \
+        kbench_report((bench), RT_NULL);                    \
+    } while (0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _KBENCH_H_ */
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rtthread.h>
+#include "utest.h"
+#include "kbench.h"
+
+#define THREAD_STACK_SIZE   1024
+#define EVENT_PING          (1 << 0)
+#define EVENT_PONG          (1 << 1)
+
+enum ipc_type
+{
+    IPC_SEM = 0,
+    IPC_EVENT,
+    IPC_MAILBOX,
+    IPC_MQ,
+};
+
+static struct kbench bench;
+static struct rt_thread peer;
+static rt_uint8_t peer_stack[THREAD_STACK_SIZE];
+
+static struct rt_semaphore sem_ping, sem_pong;
+static struct rt_mutex mutex;
+static struct rt_event event;
+static struct rt_mailbox mb_ping, mb_pong;
+static rt_ubase_t mb_ping_pool[4], mb_pong_pool[4];
+static struct rt_messagequeue mq_ping, mq_pong;
+static rt_uint8_t mq_ping_pool[4 * (sizeof(void *) + 16)];
+static rt_uint8_t mq_pong_pool[4 * (sizeof(void *) + 16)];
+
+static void ping(enum ipc_type type)
+{
+    rt_uint32_t recv;
+    rt_ubase_t value;
+    rt_uint8_t msg[16];
+
+    switch (type)
+    {
+    case IPC_SEM:
+        rt_sem_release(&sem_ping);
+        rt_sem_take(&sem_pong, RT_WAITING_FOREVER);
+        break;
+    case IPC_EVENT:
+        rt_event_send(&event, EVENT_PING);
+        rt_event_recv(&event, EVENT_PONG, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR,
+                      RT_WAITING_FOREVER, &recv);
+        break;
+    case IPC_MAILBOX:
+        rt_mb_send(&mb_ping, 0);
+        rt_mb_recv(&mb_pong, &value, RT_WAITING_FOREVER);
+        break;
+    case IPC_MQ:
+        rt_mq_send(&mq_ping, msg, sizeof(msg));
+        rt_mq_recv(&mq_pong, msg, sizeof(msg), RT_WAITING_FOREVER);
+        break;
+    }
+}
+
+static void peer_entry(void *parameter)
+{
+    enum ipc_type type = (enum ipc_type)(rt_ubase_t)parameter;
+    rt_uint32_t recv;
+    rt_ubase_t value;
+    rt_uint8_t msg[16];
+    rt_uint32_t i;
+
+    /* one more round for warm up */
+    for (i = 0; i <= RT_KBENCH_SAMPLES; i++)
+    {
+        switch (type)
+        {
+        case IPC_SEM:
+            rt_sem_take(&sem_ping, RT_WAITING_FOREVER);
+            rt_sem_release(&sem_pong);
+            break;
+        case IPC_EVENT:
+            rt_event_recv(&event, EVENT_PING, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR,
+                          RT_WAITING_FOREVER, &recv);
+            rt_event_send(&event, EVENT_PONG);
+            break;
+        case IPC_MAILBOX:
+            rt_mb_recv(&mb_ping, &value, RT_WAITING_FOREVER);
+            rt_mb_send(&mb_pong, value);
+            break;
+        case IPC_MQ:
+            rt_mq_recv(&mq_ping, msg, sizeof(msg), RT_WAITING_FOREVER);
+            rt_mq_send(&mq_pong, msg, sizeof(msg));
+            break;
+        }
+    }
+}
+
+static void ping_pong(enum ipc_type type, const char *name)
+{
+    rt_uint32_t start;
+
+    /* the peer has higher priority, so every ping switches to it at once */
+    rt_thread_init(&peer, "kb_peer", peer_entry, (void *)(rt_ubase_t)type,
+                   peer_stack, sizeof(peer_stack),
+                   rt_thread_self()->current_priority - 1, 10);
+    rt_thread_startup(&peer);
+
+    ping(type);
+    kbench_begin(&bench, name);
+    while (bench.count < RT_KBENCH_SAMPLES)
+    {
+        start = kbench_cycles();
+        ping(type);
+        kbench_add(&bench, kbench_cycles() - start);
+    }
+    kbench_report(&bench, RT_NULL);
+
+    /* the peer has exited */
+    uassert_int_equal(peer.stat & RT_THREAD_STAT_MASK, RT_THREAD_CLOSE);
+}
+
+static void test_ping_pong(void)
+{
+    ping_pong(IPC_SEM, "ipc.sem_round_trip");
+    ping_pong(IPC_EVENT, "ipc.event_round_trip");
+    ping_pong(IPC_MAILBOX, "ipc.mailbox_round_trip");
+    ping_pong(IPC_MQ, "ipc.mq_round_trip");
+}
+
+static void test_uncontended(void)
+{
+    rt_uint32_t recv;
+    rt_ubase_t value;
+    rt_uint8_t msg[16];
+
+    KBENCH_RUN(&bench, "ipc.sem_release_take",
+               rt_sem_release(&sem_ping); rt_sem_take(&sem_ping, 0));
+    KBENCH_RUN(&bench, "ipc.mutex_take_release",
+               rt_mutex_take(&mutex, 0); rt_mutex_release(&mutex));
+    KBENCH_RUN(&bench, "ipc.event_send_recv",
+               rt_event_send(&event, EVENT_PING);
+               rt_event_recv(&event, EVENT_PING, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR, 0, &recv));
+    KBENCH_RUN(&bench, "ipc.mailbox_send_recv",
+               rt_mb_send(&mb_ping, 0); rt_mb_recv(&mb_ping, &value, 0));
+    KBENCH_RUN(&bench, "ipc.mq_send_recv",
+               rt_mq_send(&mq_ping, msg, sizeof(msg)); rt_mq_recv(&mq_ping, msg, sizeof(msg), 0));
+
+    uassert_int_equal(sem_ping.value, 0);
+    uassert_true(mutex.owner == RT_NULL);
+}
+
+static rt_err_t utest_tc_init(void)
+{
+    rt_sem_init(&sem_ping, "kb_ping", 0, RT_IPC_FLAG_FIFO);
+    rt_sem_init(&sem_pong, "kb_pong", 0, RT_IPC_FLAG_FIFO);
+    rt_mutex_init(&mutex, "kb_mtx", RT_IPC_FLAG_FIFO);
+    rt_event_init(&event, "kb_evt", RT_IPC_FLAG_FIFO);
+    rt_mb_init(&mb_ping, "kb_ping", mb_ping_pool,
+               sizeof(mb_ping_pool) / sizeof(mb_ping_pool[0]), RT_IPC_FLAG_FIFO);
+    rt_mb_init(&mb_pong, "kb_pong", mb_pong_pool,
+               sizeof(mb_pong_pool) / sizeof(mb_pong_pool[0]), RT_IPC_FLAG_FIFO);
+    rt_mq_init(&mq_ping, "kb_ping", mq_ping_pool, 16, sizeof(mq_ping_pool), RT_IPC_FLAG_FIFO);
+    rt_mq_init(&mq_pong, "kb_pong", mq_pong_pool, 16, sizeof(mq_pong_pool), RT_IPC_FLAG_FIFO);
+
+    return RT_EOK;
+}
+
+static rt_err_t utest_tc_cleanup(void)
+{
+    rt_sem_detach(&sem_ping);
+    rt_sem_detach(&sem_pong);
+    rt_mutex_detach(&mutex);
+    rt_event_detach(&event);
+    rt_mb_detach(&mb_ping);
+    rt_mb_detach(&mb_pong);
+    rt_mq_detach(&mq_ping);
+    rt_mq_detach(&mq_pong);
+
+    return RT_EOK;
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(test_ping_pong);
+    UTEST_UNIT_RUN(test_uncontended);
+}
+UTEST_TC_EXPORT(testcase, "kbench.kernel.ipc", utest_tc_init, utest_tc_cleanup, 20);
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rtthread.h>
+#include "utest.h"
+#include "kbench.h"
+
+#define COPY_SIZE_MAX       1024
+
+static struct kbench bench;
+static rt_uint32_t src[COPY_SIZE_MAX / 4 + 1];
+static rt_uint32_t dst[COPY_SIZE_MAX / 4 + 1];
+static char text[128];
+static char name[32];
+
+static void test_memcpy(void)
+{
+    static const rt_size_t size[] = {16, 64, 256, 1024};
+    rt_size_t i;
+
+    rt_memset(src, 0x5A, sizeof(src));
+
+    for (i = 0; i < sizeof(size) / sizeof(size[0]); i++)
+    {
+        rt_snprintf(name, sizeof(name), "kservice.memcpy_%d", size[i]);
+        KBENCH_RUN(&bench, name, rt_memcpy(dst, src, size[i]));
+
+        /* the unaligned copy */
+        rt_snprintf(name, sizeof(name), "kservice.memcpy_%d_unaligned", size[i]);
+        KBENCH_RUN(&bench, name, rt_memcpy((char *)dst + 1, (char *)src + 3, size[i]));
+
+        rt_snprintf(name, sizeof(name), "kservice.memset_%d", size[i]);
+        KBENCH_RUN(&bench, name, rt_memset(dst, 0, size[i]));
+
+        rt_snprintf(name, sizeof(name), "kservice.memmove_%d", size[i]);
+        KBENCH_RUN(&bench, name, rt_memmove((char *)dst + 4, dst, size[i]));
+    }
+
+    rt_memcpy(dst, src, COPY_SIZE_MAX);
+    uassert_buf_equal(dst, src, COPY_SIZE_MAX);
+}
+
+static void test_snprintf(void)
+{
+    int length = 0;
+
+    KBENCH_RUN(&bench, "kservice.snprintf_int",
+               length = rt_snprintf(text, sizeof(text), "%d", -123456));
+    uassert_int_equal(length, 7);
+
+    KBENCH_RUN(&bench, "kservice.snprintf_mixed",
+               length = rt_snprintf(text, sizeof(text), "%s: %08x %5d %-8s|%c",
+                                    "thread", 0xdeadbeef, 42, "tail", 'x'));
+    uassert_str_equal(text, "thread: deadbeef    42 tail    |x");
+    uassert_int_equal(length, rt_strlen(text));
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(test_memcpy);
+    UTEST_UNIT_RUN(test_snprintf);
+}
+UTEST_TC_EXPORT(testcase, "kbench.kernel.kservice", RT_NULL, RT_NULL, 10);
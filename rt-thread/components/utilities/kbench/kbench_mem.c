@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rtthread.h>
+#include "utest.h"
+#include "kbench.h"
+
+#define ALLOC_SIZES         4
+#define POOL_BLOCK_SIZE     64
+#define POOL_BLOCK_COUNT    16
+#define MEMHEAP_SIZE        4096
+
+static struct kbench bench;
+static const rt_size_t alloc_size[ALLOC_SIZES] = {16, 64, 256, 1024};
+static void *ptr[RT_KBENCH_SAMPLES];
+static char name[RT_NAME_MAX * 2 + 16];
+
+#ifdef RT_USING_HEAP
+#if defined(RT_USING_MEMHEAP_AS_HEAP)
+#define HEAP_NAME           "memheap"
+#elif defined(RT_USING_SLAB)
+#define HEAP_NAME           "slab"
+#else
+#define HEAP_NAME           "small_mem"
+#endif
+
+static void test_heap(void)
+{
+    rt_uint32_t start, count;
+    int i;
+
+    for (i = 0; i < ALLOC_SIZES; i++)
+    {
+        /* the blocks are kept until all samples are taken, so the heap grows */
+        rt_snprintf(name, sizeof(name), "mem.%s_malloc_%d", HEAP_NAME, alloc_size[i]);
+        kbench_begin(&bench, name);
+        while (bench.count < RT_KBENCH_SAMPLES)
+        {
+            start = kbench_cycles();
+            ptr[bench.count] = rt_malloc(alloc_size[i]);
+            kbench_add(&bench, kbench_cycles() - start);
+            if (ptr[bench.count - 1] == RT_NULL)
+                break;
+        }
+        kbench_report(&bench, RT_NULL);
+        uassert_not_null(ptr[bench.count - 1]);
+
+        count = bench.count;
+        rt_snprintf(name, sizeof(name), "mem.%s_free_%d", HEAP_NAME, alloc_size[i]);
+        kbench_begin(&bench, name);
+        while (bench.count < count)
+        {
+            start = kbench_cycles();
+            rt_free(ptr[bench.count]);
+            kbench_add(&bench, kbench_cycles() - start);
+        }
+        kbench_report(&bench, RT_NULL);
+    }
+
+    rt_snprintf(name, sizeof(name), "mem.%s_malloc_free_64", HEAP_NAME);
+    KBENCH_RUN(&bench, name, rt_free(rt_malloc(64)));
+}
+#endif /* RT_USING_HEAP */
+
+#ifdef RT_USING_MEMHEAP
+static struct rt_memheap memheap;
+static rt_uint8_t memheap_pool[MEMHEAP_SIZE];
+
+static void test_memheap(void)
+{
+    rt_memheap_init(&memheap, "kb_heap", memheap_pool, sizeof(memheap_pool));
+    KBENCH_RUN(&bench, "mem.memheap_alloc_free_64",
+               rt_memheap_free(rt_memheap_alloc(&memheap, 64)));
+    uassert_true(memheap.max_used_size < MEMHEAP_SIZE);
+    rt_memheap_detach(&memheap);
+}
+#endif /* RT_USING_MEMHEAP */
+
+#ifdef RT_USING_MEMPOOL
+static struct rt_mempool mempool;
+static rt_uint8_t mempool_pool[POOL_BLOCK_COUNT * (POOL_BLOCK_SIZE + sizeof(rt_uint8_t *))];
+
+static void test_mempool(void)
+{
+    rt_mp_init(&mempool, "kb_mp", mempool_pool, sizeof(mempool_pool), POOL_BLOCK_SIZE);
+    KBENCH_RUN(&bench, "mem.mempool_alloc_free",
+               rt_mp_free(rt_mp_alloc(&mempool, 0)));
+    uassert_int_equal(mempool.block_free_count, POOL_BLOCK_COUNT);
+    rt_mp_detach(&mempool);
+}
+#endif /* RT_USING_MEMPOOL */
+
+#ifdef RT_USING_OBJCACHE
+static void test_objcache(void)
+{
+    rt_objcache_t cache;
+    rt_uint32_t start, count;
+
+    cache = rt_objcache_create("kb_oc", POOL_BLOCK_SIZE, POOL_BLOCK_COUNT, RT_NULL, RT_NULL);
+    uassert_not_null(cache);
+    if (cache == RT_NULL)
+        return;
+
+    /* the objects are kept until all samples are taken, so the cache grows */
+    kbench_begin(&bench, "mem.objcache_alloc");
+    while (bench.count < RT_KBENCH_SAMPLES)
+    {
+        start = kbench_cycles();
+        ptr[bench.count] = rt_objcache_alloc(cache);
+        kbench_add(&bench, kbench_cycles() - start);
+        if (ptr[bench.count - 1] == RT_NULL)
+            break;
+    }
+    kbench_report(&bench, RT_NULL);
+    uassert_not_null(ptr[bench.count - 1]);
+
+    count = bench.count;
+    kbench_begin(&bench, "mem.objcache_free");
+    while (bench.count < count)
+    {
+        start = kbench_cycles();
+        rt_objcache_free(cache, ptr[bench.count]);
+        kbench_add(&bench, kbench_cycles() - start);
+    }
+    kbench_report(&bench, RT_NULL);
+
+    KBENCH_RUN(&bench, "mem.objcache_alloc_free",
+               rt_objcache_free(cache, rt_objcache_alloc(cache)));
+    uassert_int_equal(rt_objcache_delete(cache), RT_EOK);
+}
+#endif /* RT_USING_OBJCACHE */
+
+static void testcase(void)
+{
+#ifdef RT_USING_HEAP
+    UTEST_UNIT_RUN(test_heap);
+#endif
+#ifdef RT_USING_MEMHEAP
+    UTEST_UNIT_RUN(test_memheap);
+#endif
+#ifdef RT_USING_MEMPOOL
+    UTEST_UNIT_RUN(test_mempool);
+#endif
+#ifdef RT_USING_OBJCACHE
+    UTEST_UNIT_RUN(test_objcache);
+#endif
+}
+UTEST_TC_EXPORT(testcase, "kbench.kernel.mem", RT_NULL, RT_NULL, 20);
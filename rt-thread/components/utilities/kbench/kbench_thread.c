@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rtthread.h>
+#include "utest.h"
+#include "kbench.h"
+
+#define THREAD_STACK_SIZE   1024
+
+static struct kbench bench;
+static struct rt_thread peer;
+static rt_uint8_t peer_stack[THREAD_STACK_SIZE];
+static volatile rt_bool_t peer_running;
+
+static void peer_entry(void *parameter)
+{
+    while (peer_running)
+        rt_thread_yield();
+}
+
+static void test_yield(void)
+{
+    rt_uint32_t start;
+    rt_uint8_t priority = rt_thread_self()->current_priority;
+
+    /* a peer with the same priority, every yield switches to it and back */
+    peer_running = RT_TRUE;
+    rt_thread_init(&peer, "kb_peer", peer_entry, RT_NULL,
+                   peer_stack, sizeof(peer_stack), priority, 10);
+    rt_thread_startup(&peer);
+    rt_thread_yield();
+
+    kbench_begin(&bench, "thread.yield_switch");
+    while (bench.count < RT_KBENCH_SAMPLES)
+    {
+        start = kbench_cycles();
+        rt_thread_yield();
+        /* two context switches in one round */
+        kbench_add(&bench, (kbench_cycles() - start) / 2);
+    }
+    kbench_report(&bench, RT_NULL);
+
+    /* let the peer exit */
+    peer_running = RT_FALSE;
+    rt_thread_yield();
+    uassert_int_equal(peer.stat & RT_THREAD_STAT_MASK, RT_THREAD_CLOSE);
+
+    /* no peer, the yield returns without context switch */
+    KBENCH_RUN(&bench, "thread.yield_alone", rt_thread_yield());
+    uassert_true(bench.count == RT_KBENCH_SAMPLES);
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(test_yield);
+}
+UTEST_TC_EXPORT(testcase, "kbench.kernel.thread", RT_NULL, RT_NULL, 10);
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+#include "utest.h"
+#include "kbench.h"
+
+#define THREAD_STACK_SIZE   1024
+
+static struct kbench bench;
+static struct rt_timer timer;
+
+/* the tick jitter */
+static struct kbench jitter;
+static volatile rt_uint32_t last_cycles;
+static rt_uint32_t period;
+static struct rt_thread load;
+static rt_uint8_t load_stack[THREAD_STACK_SIZE];
+static volatile rt_bool_t load_running;
+
+static void timeout(void *parameter)
+{
+}
+
+static void test_timer(void)
+{
+    rt_timer_init(&timer, "kb_tmr", timeout, RT_NULL, 100, RT_TIMER_FLAG_ONE_SHOT);
+    KBENCH_RUN(&bench, "timer.start_stop",
+               rt_timer_start(&timer); rt_timer_stop(&timer));
+
+    rt_timer_start(&timer);
+    KBENCH_RUN(&bench, "timer.control_get_time",
+               rt_timer_control(&timer, RT_TIMER_CTRL_GET_TIME, &period));
+    rt_timer_stop(&timer);
+
+    uassert_int_equal(timer.parent.flag & RT_TIMER_FLAG_ACTIVATED, 0);
+    rt_timer_detach(&timer);
+}
+
+static void test_irq_lock(void)
+{
+    rt_base_t level;
+
+    KBENCH_RUN(&bench, "irq.disable_enable",
+               level = rt_hw_interrupt_disable(); rt_hw_interrupt_enable(level));
+    uassert_true(bench.count == RT_KBENCH_SAMPLES);
+}
+
+/* the hard timer runs in the tick interrupt */
+static void jitter_timeout(void *parameter)
+{
+    rt_uint32_t now = kbench_cycles();
+    rt_uint32_t delta = now - last_cycles;
+
+    if (last_cycles != 0)
+        kbench_add(&jitter, delta > period ? delta - period : period - delta);
+    last_cycles = now;
+}
+
+static void load_entry(void *parameter)
+{
+    void *ptr;
+
+    /* run the kernel services which disable interrupt */
+    while (load_running)
+    {
+        ptr = rt_malloc(32);
+        rt_free(ptr);
+        rt_thread_yield();
+    }
+}
+
+/*
+ * The delay of the tick interrupt shows how long the interrupt is disabled
+ * by kernel while a low priority thread is calling kernel services.
+ */
+static void test_irq_off(void)
+{
+    period = kbench_cycles_freq() / RT_TICK_PER_SECOND;
+    last_cycles = 0;
+    kbench_begin(&jitter, "irq.tick_jitter");
+
+    load_running = RT_TRUE;
+    rt_thread_init(&load, "kb_load", load_entry, RT_NULL,
+                   load_stack, sizeof(load_stack), RT_THREAD_PRIORITY_MAX - 2, 10);
+    rt_thread_startup(&load);
+
+    rt_timer_init(&timer, "kb_jit", jitter_timeout, RT_NULL, 1,
+                  RT_TIMER_FLAG_PERIODIC | RT_TIMER_FLAG_HARD_TIMER);
+    rt_timer_start(&timer);
+    while (jitter.count < RT_KBENCH_SAMPLES)
+        rt_thread_mdelay(10);
+    rt_timer_stop(&timer);
+    rt_timer_detach(&timer);
+
+    load_running = RT_FALSE;
+    while ((load.stat & RT_THREAD_STAT_MASK) != RT_THREAD_CLOSE)
+        rt_thread_mdelay(10);
+
+    kbench_report(&jitter, RT_NULL);
+    uassert_true(jitter.count == RT_KBENCH_SAMPLES);
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(test_timer);
+    UTEST_UNIT_RUN(test_irq_lock);
+    UTEST_UNIT_RUN(test_irq_off);
+}
+UTEST_TC_EXPORT(testcase, "kbench.kernel.timer", RT_NULL, RT_NULL, 20);
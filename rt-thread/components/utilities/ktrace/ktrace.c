@@ -0,0 +1,637 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+#include <ktrace.h>
+
+#ifdef RT_USING_DFS
+#include <dfs_posix.h>
+#endif
+
+#if defined(RT_USING_SAL) && defined(SAL_USING_POSIX)
+#include <sys/socket.h>
+#define KTRACE_USING_SOCKET
+#endif
+
+#if (RT_KTRACE_BUF_EVENTS & (RT_KTRACE_BUF_EVENTS - 1)) != 0
+#error "RT_KTRACE_BUF_EVENTS must be a power of two"
+#endif
+
+#ifdef RT_USING_SMP
+#define KTRACE_CPUS                    RT_CPUS_NR
+#define KTRACE_CPU_ID()                rt_hw_cpu_id()
+#else
+#define KTRACE_CPUS                    1
+#define KTRACE_CPU_ID()                0
+#endif
+
+#define KTRACE_EVENT_MASK              (RT_KTRACE_BUF_EVENTS - 1)
+
+/* the event ring buffer of each cpu, the oldest events are overwritten */
+struct ktrace_ring
+{
+    rt_uint32_t head;
+    struct rt_ktrace_event events[RT_KTRACE_BUF_EVENTS];
+};
+
+static struct ktrace_ring _rings[KTRACE_CPUS];
+static volatile rt_bool_t _running = RT_FALSE;
+
+/*
+ * reserve one event slot. ISR and thread can record on the same cpu, so the
+ * head is advanced by an atomic add and every writer owns its slot.
+ */
+rt_inline rt_uint32_t _ktrace_reserve(struct ktrace_ring *ring)
+{
+#if defined(__GNUC__) || defined(__CLANG_ARM)
+    return __atomic_fetch_add(&ring->head, 1, __ATOMIC_RELAXED);
+#else
+    rt_base_t level;
+    rt_uint32_t index;
+
+    level = rt_hw_interrupt_disable();
+    index = ring->head ++;
+    rt_hw_interrupt_enable(level);
+
+    return index;
+#endif
+}
+
+#if defined(ARCH_ARM_CORTEX_M3) || defined(ARCH_ARM_CORTEX_M4) || defined(ARCH_ARM_CORTEX_M7)
+/* use DWT cycle counter as the timestamp source */
+#define DEMCR                          (*(volatile rt_uint32_t *)0xE000EDFC)
+#define DWT_CTRL                       (*(volatile rt_uint32_t *)0xE0001000)
+#define DWT_CYCCNT                     (*(volatile rt_uint32_t *)0xE0001004)
+#define DEMCR_TRCENA                   (1UL << 24)
+#define DWT_CTRL_CYCCNTENA             (1UL << 0)
+
+extern rt_uint32_t SystemCoreClock;
+
+static void _ktrace_timestamp_init(void)
+{
+    DEMCR |= DEMCR_TRCENA;
+    DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+}
+
+RT_WEAK rt_uint32_t rt_ktrace_timestamp(void)
+{
+    return DWT_CYCCNT;
+}
+
+RT_WEAK rt_uint32_t rt_ktrace_timestamp_freq(void)
+{
+    return SystemCoreClock;
+}
+
+rt_inline rt_uint32_t _ktrace_irq_number(void)
+{
+#if defined(__GNUC__) || defined(__CLANG_ARM)
+    rt_uint32_t ipsr;
+
+    __asm volatile ("mrs %0, ipsr" : "=r" (ipsr));
+    return ipsr & 0x1FF;
+#else
+    return 0;
+#endif
+}
+#else
+static void _ktrace_timestamp_init(void)
+{
+}
+
+RT_WEAK rt_uint32_t rt_ktrace_timestamp(void)
+{
+    return rt_tick_get();
+}
+
+RT_WEAK rt_uint32_t rt_ktrace_timestamp_freq(void)
+{
+    return RT_TICK_PER_SECOND;
+}
+
+rt_inline rt_uint32_t _ktrace_irq_number(void)
+{
+    return 0;
+}
+#endif
+
+/**
+ * This function will record an event into the ring buffer of current cpu.
+ *
+ * @param type the event type, KTRACE_USER and above are free for user
+ * @param info the 16 bits event information
+ * @param arg0 the first argument of event
+ * @param arg1 the second argument of event
+ */
+void rt_ktrace_record(rt_uint8_t type, rt_uint16_t info, rt_uint32_t arg0, rt_uint32_t arg1)
+{
+    struct ktrace_ring *ring;
+    struct rt_ktrace_event *event;
+
+    if (!_running)
+        return;
+
+    ring = &_rings[KTRACE_CPU_ID()];
+    event = &ring->events[_ktrace_reserve(ring) & KTRACE_EVENT_MASK];
+
+    event->timestamp = rt_ktrace_timestamp();
+    event->type = type;
+    event->cpu = (rt_uint8_t)KTRACE_CPU_ID();
+    event->info = info;
+    event->arg0 = arg0;
+    event->arg1 = arg1;
+}
+RTM_EXPORT(rt_ktrace_record);
+
+#ifdef RT_KTRACE_USING_SCHEDULER
+static void _ktrace_scheduler_hook(struct rt_thread *from, struct rt_thread *to)
+{
+    rt_ktrace_record(KTRACE_THREAD_SWITCH, 0, (rt_uint32_t)(rt_ubase_t)from, (rt_uint32_t)(rt_ubase_t)to);
+}
+#endif
+
+#ifdef RT_KTRACE_USING_IRQ
+static void _ktrace_irq_enter_hook(void)
+{
+    rt_ktrace_record(KTRACE_IRQ_ENTER, 0, _ktrace_irq_number(), rt_interrupt_get_nest());
+}
+
+static void _ktrace_irq_leave_hook(void)
+{
+    rt_ktrace_record(KTRACE_IRQ_LEAVE, 0, _ktrace_irq_number(), rt_interrupt_get_nest());
+}
+#endif
+
+#ifdef RT_KTRACE_USING_IPC
+rt_inline void _ktrace_object_record(rt_uint8_t type, struct rt_object *object)
+{
+    rt_ktrace_record(type, object->type & ~RT_Object_Class_Static,
+                     (rt_uint32_t)(rt_ubase_t)object, (rt_uint32_t)(rt_ubase_t)rt_thread_self());
+}
+
+static void _ktrace_trytake_hook(struct rt_object *object)
+{
+    _ktrace_object_record(KTRACE_OBJ_TRYTAKE, object);
+}
+
+static void _ktrace_take_hook(struct rt_object *object)
+{
+    _ktrace_object_record(KTRACE_OBJ_TAKE, object);
+}
+
+static void _ktrace_put_hook(struct rt_object *object)
+{
+    _ktrace_object_record(KTRACE_OBJ_PUT, object);
+}
+#endif
+
+#ifdef RT_KTRACE_USING_TIMER
+static void _ktrace_timer_enter_hook(struct rt_timer *timer)
+{
+    rt_ktrace_record(KTRACE_TIMER_ENTER, 0, (rt_uint32_t)(rt_ubase_t)timer,
+                     (rt_uint32_t)(rt_ubase_t)timer->timeout_func);
+}
+
+static void _ktrace_timer_exit_hook(struct rt_timer *timer)
+{
+    rt_ktrace_record(KTRACE_TIMER_EXIT, 0, (rt_uint32_t)(rt_ubase_t)timer,
+                     (rt_uint32_t)(rt_ubase_t)timer->timeout_func);
+}
+#endif
+
+#if defined(RT_KTRACE_USING_HEAP) && defined(RT_USING_HEAP)
+static void _ktrace_malloc_hook(void *ptr, rt_size_t size)
+{
+    rt_ktrace_record(KTRACE_MALLOC, 0, (rt_uint32_t)(rt_ubase_t)ptr, size);
+}
+
+static void _ktrace_free_hook(void *ptr)
+{
+    rt_ktrace_record(KTRACE_FREE, 0, (rt_uint32_t)(rt_ubase_t)ptr, 0);
+}
+#endif
+
+/* install or remove the kernel hooks */
+static void _ktrace_set_hooks(rt_bool_t enable)
+{
+#ifdef RT_KTRACE_USING_SCHEDULER
+    rt_scheduler_sethook(enable ? _ktrace_scheduler_hook : RT_NULL);
+#endif
+#ifdef RT_KTRACE_USING_IRQ
+    rt_interrupt_enter_sethook(enable ? _ktrace_irq_enter_hook : RT_NULL);
+    rt_interrupt_leave_sethook(enable ? _ktrace_irq_leave_hook : RT_NULL);
+#endif
+#ifdef RT_KTRACE_USING_IPC
+    rt_object_trytake_sethook(enable ? _ktrace_trytake_hook : RT_NULL);
+    rt_object_take_sethook(enable ? _ktrace_take_hook : RT_NULL);
+    rt_object_put_sethook(enable ? _ktrace_put_hook : RT_NULL);
+#endif
+#ifdef RT_KTRACE_USING_TIMER
+    rt_timer_enter_sethook(enable ? _ktrace_timer_enter_hook : RT_NULL);
+    rt_timer_exit_sethook(enable ? _ktrace_timer_exit_hook : RT_NULL);
+#endif
+#if defined(RT_KTRACE_USING_HEAP) && defined(RT_USING_HEAP)
+    rt_malloc_sethook(enable ? _ktrace_malloc_hook : RT_NULL);
+    rt_free_sethook(enable ? _ktrace_free_hook : RT_NULL);
+#endif
+}
+
+/**
+ * This function will start recording kernel events.
+ */
+void rt_ktrace_start(void)
+{
+    _running = RT_TRUE;
+    _ktrace_set_hooks(RT_TRUE);
+}
+RTM_EXPORT(rt_ktrace_start);
+
+/**
+ * This function will stop recording kernel events, the recorded events are
+ * kept in ring buffer.
+ */
+void rt_ktrace_stop(void)
+{
+    _ktrace_set_hooks(RT_FALSE);
+    _running = RT_FALSE;
+}
+RTM_EXPORT(rt_ktrace_stop);
+
+/**
+ * This function will drop all the recorded events.
+ */
+void rt_ktrace_clear(void)
+{
+    rt_base_t level;
+    int cpu;
+
+    level = rt_hw_interrupt_disable();
+    for (cpu = 0; cpu < KTRACE_CPUS; cpu ++)
+    {
+        _rings[cpu].head = 0;
+    }
+    rt_hw_interrupt_enable(level);
+}
+RTM_EXPORT(rt_ktrace_clear);
+
+rt_bool_t rt_ktrace_is_running(void)
+{
+    return _running;
+}
+RTM_EXPORT(rt_ktrace_is_running);
+
+/* collect the names of kernel objects, the table is allocated from heap */
+static struct rt_ktrace_name *_ktrace_collect_names(rt_uint16_t *count)
+{
+    struct rt_object_information *information;
+    struct rt_list_node *node;
+    struct rt_object *object;
+    struct rt_ktrace_name *names;
+    rt_uint32_t total = 0, index = 0;
+    int type;
+
+    /* count the objects at first, some may be created before the table is filled */
+    rt_enter_critical();
+    for (type = RT_Object_Class_Thread; type < RT_Object_Class_Unknown; type ++)
+    {
+        information = rt_object_get_information((enum rt_object_class_type)type);
+        if (information != RT_NULL)
+            total += rt_list_len(&information->object_list);
+    }
+    rt_exit_critical();
+
+    total += 8;
+    names = (struct rt_ktrace_name *)rt_calloc(total, sizeof(struct rt_ktrace_name));
+    if (names == RT_NULL)
+    {
+        *count = 0;
+        return RT_NULL;
+    }
+
+    rt_enter_critical();
+    for (type = RT_Object_Class_Thread; type < RT_Object_Class_Unknown && index < total; type ++)
+    {
+        information = rt_object_get_information((enum rt_object_class_type)type);
+        if (information == RT_NULL)
+            continue;
+
+        for (node  = information->object_list.next;
+             node != &(information->object_list) && index < total;
+             node  = node->next)
+        {
+            object = rt_list_entry(node, struct rt_object, list);
+
+            names[index].id = (rt_uint32_t)(rt_ubase_t)object;
+            names[index].type = (rt_uint8_t)type;
+            rt_strncpy(names[index].name, object->name,
+                       RT_NAME_MAX < KTRACE_NAME_MAX ? RT_NAME_MAX : KTRACE_NAME_MAX - 1);
+            index ++;
+        }
+    }
+    rt_exit_critical();
+
+    *count = (rt_uint16_t)(index > 0xFFFF ? 0xFFFF : index);
+
+    return names;
+}
+
+/**
+ * This function will dump the recorded events and object names. The tracing
+ * is paused during dumping.
+ *
+ * @param output the output function of dump data
+ * @param ctx the context of output function
+ *
+ * @return RT_EOK on successful
+ */
+rt_err_t rt_ktrace_dump(rt_ktrace_output_t output, void *ctx)
+{
+    struct rt_ktrace_header header;
+    struct rt_ktrace_name *names;
+    rt_uint32_t count, start, first, stream[2];
+    rt_bool_t running;
+    rt_err_t result = RT_EOK;
+    int cpu;
+
+    RT_ASSERT(output != RT_NULL);
+
+    running = _running;
+    if (running)
+        rt_ktrace_stop();
+
+    names = _ktrace_collect_names(&header.name_count);
+
+    header.magic = KTRACE_MAGIC;
+    header.version = KTRACE_VERSION;
+    header.event_size = sizeof(struct rt_ktrace_event);
+    header.timestamp_freq = rt_ktrace_timestamp_freq();
+    header.cpus = KTRACE_CPUS;
+    header.lost = 0;
+    for (cpu = 0; cpu < KTRACE_CPUS; cpu ++)
+    {
+        if (_rings[cpu].head > RT_KTRACE_BUF_EVENTS)
+            header.lost += _rings[cpu].head - RT_KTRACE_BUF_EVENTS;
+    }
+
+    if (output(ctx, &header, sizeof(header)) != sizeof(header))
+    {
+        result = -RT_EIO;
+        goto __exit;
+    }
+
+    if (header.name_count &&
+        output(ctx, names, header.name_count * sizeof(struct rt_ktrace_name)) !=
+        header.name_count * sizeof(struct rt_ktrace_name))
+    {
+        result = -RT_EIO;
+        goto __exit;
+    }
+
+    for (cpu = 0; cpu < KTRACE_CPUS; cpu ++)
+    {
+        count = _rings[cpu].head;
+        if (count > RT_KTRACE_BUF_EVENTS)
+            count = RT_KTRACE_BUF_EVENTS;
+        start = (_rings[cpu].head - count) & KTRACE_EVENT_MASK;
+
+        stream[0] = cpu;
+        stream[1] = count;
+        if (output(ctx, stream, sizeof(stream)) != sizeof(stream))
+        {
+            result = -RT_EIO;
+            goto __exit;
+        }
+
+        /* the events are in time order from the oldest one */
+        first = RT_KTRACE_BUF_EVENTS - start;
+        if (first > count)
+            first = count;
+
+        if (first && output(ctx, &_rings[cpu].events[start], first * sizeof(struct rt_ktrace_event)) !=
+                first * sizeof(struct rt_ktrace_event))
+        {
+            result = -RT_EIO;
+            goto __exit;
+        }
+        if (count - first && output(ctx, &_rings[cpu].events[0], (count - first) * sizeof(struct rt_ktrace_event)) !=
+                (count - first) * sizeof(struct rt_ktrace_event))
+        {
+            result = -RT_EIO;
+            goto __exit;
+        }
+    }
+
+__exit:
+    if (names)
+        rt_free(names);
+
+    if (running)
+        rt_ktrace_start();
+
+    return result;
+}
+RTM_EXPORT(rt_ktrace_dump);
+
+/**
+ * This function will initialize ktrace.
+ */
+int rt_ktrace_init(void)
+{
+    _ktrace_timestamp_init();
+
+#ifdef RT_KTRACE_AUTO_START
+    rt_ktrace_start();
+#endif
+
+    return 0;
+}
+INIT_PREV_EXPORT(rt_ktrace_init);
+
+#if defined(RT_USING_FINSH) && defined(FINSH_USING_MSH)
+#include <finsh.h>
+#include <stdlib.h>
+
+/* print the dump data as hex lines, which can be captured from console */
+static rt_size_t _ktrace_console_output(void *ctx, const void *buffer, rt_size_t size)
+{
+    const rt_uint8_t *ptr = (const rt_uint8_t *)buffer;
+    rt_size_t index;
+
+    for (index = 0; index < size; index ++)
+    {
+        rt_kprintf("%02x", ptr[index]);
+        if ((index & 0x1F) == 0x1F)
+            rt_kprintf("\n");
+    }
+    if (index & 0x1F)
+        rt_kprintf("\n");
+
+    return size;
+}
+
+#ifdef RT_USING_DFS
+static rt_size_t _ktrace_file_output(void *ctx, const void *buffer, rt_size_t size)
+{
+    int fd = *(int *)ctx;
+    int length;
+
+    length = write(fd, buffer, size);
+
+    return length < 0 ? 0 : length;
+}
+#endif
+
+#ifdef KTRACE_USING_SOCKET
+static rt_size_t _ktrace_socket_output(void *ctx, const void *buffer, rt_size_t size)
+{
+    int sock = *(int *)ctx;
+    rt_size_t sent = 0;
+    int length;
+
+    while (sent < size)
+    {
+        length = send(sock, (const char *)buffer + sent, size - sent, 0);
+        if (length <= 0)
+            break;
+        sent += length;
+    }
+
+    return sent;
+}
+#endif
+
+/* measure the average cost of recording one event */
+static void _ktrace_bench(void)
+{
+    rt_uint32_t begin, end, index;
+    rt_bool_t running = _running;
+
+    _running = RT_TRUE;
+    begin = rt_ktrace_timestamp();
+    for (index = 0; index < 1000; index ++)
+    {
+        rt_ktrace_record(KTRACE_USER, 0, index, 0);
+    }
+    end = rt_ktrace_timestamp();
+    _running = running;
+
+    rt_kprintf("record 1000 events: %u counts, %u.%03u counts per event (%u Hz)\n",
+               end - begin, (end - begin) / 1000, (end - begin) % 1000,
+               rt_ktrace_timestamp_freq());
+}
+
+static void ktrace(uint8_t argc, char **argv)
+{
+    int cpu;
+
+    if (argc < 2)
+    {
+        rt_kprintf("Usage:\n");
+        rt_kprintf("ktrace start                 - start recording\n");
+        rt_kprintf("ktrace stop                  - stop recording\n");
+        rt_kprintf("ktrace clear                 - drop the recorded events\n");
+        rt_kprintf("ktrace status                - show recording status\n");
+        rt_kprintf("ktrace dump                  - dump events as hex to console\n");
+#ifdef RT_USING_DFS
+        rt_kprintf("ktrace save <file>           - save events to file\n");
+#endif
+#ifdef KTRACE_USING_SOCKET
+        rt_kprintf("ktrace send <ip> <port>      - send events to TCP server\n");
+#endif
+        rt_kprintf("ktrace bench                 - measure the cost of one event\n");
+        return;
+    }
+
+    if (!rt_strcmp(argv[1], "start"))
+    {
+        rt_ktrace_start();
+    }
+    else if (!rt_strcmp(argv[1], "stop"))
+    {
+        rt_ktrace_stop();
+    }
+    else if (!rt_strcmp(argv[1], "clear"))
+    {
+        rt_ktrace_clear();
+    }
+    else if (!rt_strcmp(argv[1], "status"))
+    {
+        rt_kprintf("ktrace is %s, %d events per cpu\n", _running ? "running" : "stopped",
+                   RT_KTRACE_BUF_EVENTS);
+        for (cpu = 0; cpu < KTRACE_CPUS; cpu ++)
+        {
+            rt_kprintf("cpu%d: %u events recorded\n", cpu, _rings[cpu].head);
+        }
+    }
+    else if (!rt_strcmp(argv[1], "dump"))
+    {
+        rt_kprintf("ktrace dump begin\n");
+        rt_ktrace_dump(_ktrace_console_output, RT_NULL);
+        rt_kprintf("ktrace dump end\n");
+    }
+#ifdef RT_USING_DFS
+    else if (!rt_strcmp(argv[1], "save") && argc > 2)
+    {
+        int fd;
+
+        fd = open(argv[2], O_WRONLY | O_CREAT | O_TRUNC, 0);
+        if (fd < 0)
+        {
+            rt_kprintf("open %s failed\n", argv[2]);
+            return;
+        }
+        if (rt_ktrace_dump(_ktrace_file_output, &fd) != RT_EOK)
+        {
+            rt_kprintf("write %s failed\n", argv[2]);
+        }
+        close(fd);
+    }
+#endif
+#ifdef KTRACE_USING_SOCKET
+    else if (!rt_strcmp(argv[1], "send") && argc > 3)
+    {
+        struct sockaddr_in server_addr;
+        int sock;
+
+        sock = socket(AF_INET, SOCK_STREAM, 0);
+        if (sock < 0)
+        {
+            rt_kprintf("create socket failed\n");
+            return;
+        }
+
+        server_addr.sin_family = AF_INET;
+        server_addr.sin_port = htons(atoi(argv[3]));
+        server_addr.sin_addr.s_addr = inet_addr(argv[2]);
+        rt_memset(&(server_addr.sin_zero), 0, sizeof(server_addr.sin_zero));
+
+        if (connect(sock, (struct sockaddr *)&server_addr, sizeof(struct sockaddr)) < 0)
+        {
+            rt_kprintf("connect %s:%s failed\n", argv[2], argv[3]);
+        }
+        else if (rt_ktrace_dump(_ktrace_socket_output, &sock) != RT_EOK)
+        {
+            rt_kprintf("send to %s:%s failed\n", argv[2], argv[3]);
+        }
+        closesocket(sock);
+    }
+#endif
+    else if (!rt_strcmp(argv[1], "bench"))
+    {
+        _ktrace_bench();
+    }
+    else
+    {
+        rt_kprintf("Please input correct ktrace command.\n");
+    }
+}
+MSH_CMD_EXPORT(ktrace, Kernel event trace. Help: ktrace);
+#endif /* defined(RT_USING_FINSH) && defined(FINSH_USING_MSH) */
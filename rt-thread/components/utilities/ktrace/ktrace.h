@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#ifndef _KTRACE_H_
+#define _KTRACE_H_
+
+#include <rtthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define KTRACE_MAGIC                   0x4352544B      /* "KTRC" */
+#define KTRACE_VERSION                 1
+#define KTRACE_NAME_MAX                16
+
+/* event type */
+enum rt_ktrace_type
+{
+    KTRACE_THREAD_SWITCH = 1,                           /* arg0: from thread, arg1: to thread */
+    KTRACE_IRQ_ENTER,                                   /* arg0: irq number, arg1: nest */
+    KTRACE_IRQ_LEAVE,                                   /* arg0: irq number, arg1: nest */
+    KTRACE_OBJ_TRYTAKE,                                 /* arg0: object, arg1: thread */
+    KTRACE_OBJ_TAKE,                                    /* arg0: object, arg1: thread */
+    KTRACE_OBJ_PUT,                                     /* arg0: object, arg1: thread */
+    KTRACE_TIMER_ENTER,                                 /* arg0: timer, arg1: timeout function */
+    KTRACE_TIMER_EXIT,                                  /* arg0: timer, arg1: timeout function */
+    KTRACE_MALLOC,                                      /* arg0: pointer, arg1: size */
+    KTRACE_FREE,                                        /* arg0: pointer */
+    KTRACE_USER = 0x80,                                 /* user defined events */
+};
+
+/* the event record in ring buffer and in dump, 16 bytes */
+struct rt_ktrace_event
+{
+    rt_uint32_t timestamp;                              /* timestamp counter */
+    rt_uint8_t  type;                                   /* enum rt_ktrace_type */
+    rt_uint8_t  cpu;                                    /* cpu id */
+    rt_uint16_t info;                                   /* object class or user data */
+    rt_uint32_t arg0;
+    rt_uint32_t arg1;
+};
+
+/*
+ * The dump layout, all fields are little endian:
+ *
+ * struct rt_ktrace_header
+ * struct rt_ktrace_name     [name_count]
+ * {rt_uint32_t cpu, rt_uint32_t count, struct rt_ktrace_event [count]} [cpus]
+ */
+struct rt_ktrace_header
+{
+    rt_uint32_t magic;                                  /* KTRACE_MAGIC */
+    rt_uint16_t version;                                /* KTRACE_VERSION */
+    rt_uint16_t event_size;                             /* sizeof(struct rt_ktrace_event) */
+    rt_uint32_t timestamp_freq;                         /* timestamp counter frequency, Hz */
+    rt_uint16_t cpus;                                   /* number of event streams */
+    rt_uint16_t name_count;                             /* number of object names */
+    rt_uint32_t lost;                                   /* events overwritten in ring */
+};
+
+/* the name of kernel object referenced by events */
+struct rt_ktrace_name
+{
+    rt_uint32_t id;                                     /* address of object */
+    rt_uint8_t  type;                                   /* object class */
+    rt_uint8_t  reserved[3];
+    char        name[KTRACE_NAME_MAX];
+};
+
+/* write the dump data to output, return the written size */
+typedef rt_size_t (*rt_ktrace_output_t)(void *ctx, const void *buffer, rt_size_t size);
+
+int rt_ktrace_init(void);
+void rt_ktrace_start(void);
+void rt_ktrace_stop(void);
+void rt_ktrace_clear(void);
+rt_bool_t rt_ktrace_is_running(void);
+
+void rt_ktrace_record(rt_uint8_t type, rt_uint16_t info, rt_uint32_t arg0, rt_uint32_t arg1);
+rt_err_t rt_ktrace_dump(rt_ktrace_output_t output, void *ctx);
+
+/* the timestamp source, it can be re-implemented by BSP */
+rt_uint32_t rt_ktrace_timestamp(void);
+rt_uint32_t rt_ktrace_timestamp_freq(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _KTRACE_H_ */
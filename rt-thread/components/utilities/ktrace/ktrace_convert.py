@@ -0,0 +1,264 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2006-2019, RT-Thread Development Team
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Change Logs:
+# Date           Author       Notes
+# 2026-10-19     Hehesheng    the first version
+#
+# Convert the ktrace dump to Perfetto (Chrome JSON trace) or Common Trace
+# Format (CTF 1.8).
+#
+# The input is the binary file from `ktrace save` / `ktrace send`, or the
+# console log of `ktrace dump` which is wrapped by "ktrace dump begin" and
+# "ktrace dump end".
+#
+# Usage:
+#   ktrace_convert.py trace.bin -f perfetto -o trace.json
+#   ktrace_convert.py console.log -f ctf -o trace_ctf
+#
+
+import argparse
+import json
+import os
+import re
+import struct
+import sys
+
+KTRACE_MAGIC = 0x4352544B
+HEADER = struct.Struct('<IHHIHHI')
+NAME = struct.Struct('<IB3x16s')
+STREAM = struct.Struct('<II')
+EVENT = struct.Struct('<IBBHII')
+
+EVENT_TYPES = {
+    1: ('thread_switch', 'from', 'to'),
+    2: ('irq_enter', 'irq', 'nest'),
+    3: ('irq_leave', 'irq', 'nest'),
+    4: ('object_trytake', 'object', 'thread'),
+    5: ('object_take', 'object', 'thread'),
+    6: ('object_put', 'object', 'thread'),
+    7: ('timer_enter', 'timer', 'function'),
+    8: ('timer_exit', 'timer', 'function'),
+    9: ('malloc', 'pointer', 'size'),
+    10: ('free', 'pointer', 'unused'),
+}
+
+OBJECT_CLASSES = {
+    1: 'thread', 2: 'sem', 3: 'mutex', 4: 'event', 5: 'mailbox', 6: 'mq',
+    7: 'memheap', 8: 'mempool', 9: 'device', 10: 'timer', 11: 'module',
+}
+
+
+def load_input(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+
+    if len(data) >= 4 and struct.unpack_from('<I', data)[0] == KTRACE_MAGIC:
+        return data
+
+    # console log with hex lines
+    text = data.decode('utf-8', 'ignore')
+    match = re.search(r'ktrace dump begin(.*?)ktrace dump end', text, re.S)
+    if not match:
+        sys.exit('%s: no ktrace dump found' % path)
+    return bytes.fromhex(''.join(re.findall(r'[0-9a-fA-F]+', match.group(1))))
+
+
+def parse(data):
+    magic, version, event_size, freq, cpus, name_count, lost = HEADER.unpack_from(data)
+    if magic != KTRACE_MAGIC or event_size != EVENT.size:
+        sys.exit('bad ktrace dump header')
+
+    offset = HEADER.size
+    names = {}
+    for _ in range(name_count):
+        obj_id, obj_type, name = NAME.unpack_from(data, offset)
+        names[obj_id] = (obj_type, name.split(b'\0')[0].decode('utf-8', 'ignore'))
+        offset += NAME.size
+
+    streams = []
+    for _ in range(cpus):
+        cpu, count = STREAM.unpack_from(data, offset)
+        offset += STREAM.size
+        events = [EVENT.unpack_from(data, offset + i * EVENT.size) for i in range(count)]
+        offset += count * EVENT.size
+        streams.append((cpu, events))
+
+    return {'version': version, 'freq': freq or 1, 'lost': lost,
+            'names': names, 'streams': streams}
+
+
+def unwrap(events):
+    """ extend the 32 bits timestamp to 64 bits """
+    base, last = 0, None
+    for ev in events:
+        if last is not None and ev[0] < last:
+            base += 1 << 32
+        last = ev[0]
+        yield (base + ev[0],) + ev[1:]
+
+
+def object_name(trace, obj_id):
+    if obj_id in trace['names']:
+        return trace['names'][obj_id][1]
+    return '0x%08x' % obj_id
+
+
+def to_perfetto(trace, output):
+    us = 1000000.0 / trace['freq']
+    out = []
+    live = {}
+    heap = 0
+
+    for obj_id, (obj_type, name) in trace['names'].items():
+        if obj_type == 1:
+            out.append({'ph': 'M', 'name': 'thread_name', 'pid': 0, 'tid': obj_id,
+                        'args': {'name': name}})
+
+    for cpu, events in trace['streams']:
+        irq_tid = 'cpu%d irq' % cpu
+        timer_tid = 'cpu%d timer' % cpu
+        for ts, ev_type, _, info, arg0, arg1 in unwrap(events):
+            ts = ts * us
+            if ev_type == 1:
+                out.append({'ph': 'E', 'pid': 0, 'tid': arg0, 'ts': ts})
+                out.append({'ph': 'B', 'pid': 0, 'tid': arg1, 'ts': ts,
+                            'name': object_name(trace, arg1), 'args': {'cpu': cpu}})
+            elif ev_type == 2:
+                out.append({'ph': 'B', 'pid': 1, 'tid': irq_tid, 'ts': ts,
+                            'name': 'irq %d' % arg0, 'args': {'nest': arg1}})
+            elif ev_type == 3:
+                out.append({'ph': 'E', 'pid': 1, 'tid': irq_tid, 'ts': ts})
+            elif ev_type in (4, 5, 6):
+                name = '%s %s %s' % (EVENT_TYPES[ev_type][0].split('_')[1],
+                                     OBJECT_CLASSES.get(info, 'object'),
+                                     object_name(trace, arg0))
+                out.append({'ph': 'i', 's': 't', 'pid': 0, 'tid': arg1, 'ts': ts,
+                            'name': name})
+            elif ev_type == 7:
+                out.append({'ph': 'B', 'pid': 1, 'tid': timer_tid, 'ts': ts,
+                            'name': object_name(trace, arg0),
+                            'args': {'function': '0x%08x' % arg1}})
+            elif ev_type == 8:
+                out.append({'ph': 'E', 'pid': 1, 'tid': timer_tid, 'ts': ts})
+            elif ev_type == 9:
+                live[arg0] = arg1
+                heap += arg1
+                out.append({'ph': 'C', 'pid': 1, 'ts': ts, 'name': 'heap',
+                            'args': {'traced bytes': heap}})
+            elif ev_type == 10:
+                heap -= live.pop(arg0, 0)
+                out.append({'ph': 'C', 'pid': 1, 'ts': ts, 'name': 'heap',
+                            'args': {'traced bytes': heap}})
+            else:
+                out.append({'ph': 'i', 's': 'g', 'pid': 1, 'ts': ts,
+                            'name': 'user %d' % ev_type,
+                            'args': {'info': info, 'arg0': arg0, 'arg1': arg1}})
+
+    out.append({'ph': 'M', 'name': 'process_name', 'pid': 0, 'args': {'name': 'threads'}})
+    out.append({'ph': 'M', 'name': 'process_name', 'pid': 1, 'args': {'name': 'kernel'}})
+
+    with open(output, 'w') as f:
+        json.dump({'traceEvents': out, 'displayTimeUnit': 'ns',
+                   'metadata': {'lost events': trace['lost']}}, f)
+
+
+CTF_METADATA = '''/* CTF 1.8 */
+
+typealias integer { size = 8; align = 8; signed = false; } := uint8_t;
+typealias integer { size = 16; align = 8; signed = false; } := uint16_t;
+typealias integer { size = 32; align = 8; signed = false; } := uint32_t;
+typealias integer { size = 32; align = 8; signed = false; base = 16; } := address_t;
+
+trace {
+    major = 1;
+    minor = 8;
+    byte_order = le;
+    packet.header := struct {
+        uint32_t magic;
+        uint32_t stream_id;
+    };
+};
+
+env {
+    domain = "rt-thread";
+    tracer_name = "ktrace";
+    lost_events = %(lost)d;
+};
+
+clock {
+    name = cycles;
+    freq = %(freq)d;
+};
+
+typealias integer { size = 32; align = 8; signed = false; map = clock.cycles.value; } := cycles_t;
+
+stream {
+    id = 0;
+    event.header := struct {
+        cycles_t timestamp;
+        uint8_t id;
+    };
+};
+'''
+
+CTF_EVENT = '''
+event {
+    name = "%s";
+    id = %d;
+    stream_id = 0;
+    fields := struct {
+        uint8_t cpu;
+        uint16_t info;
+        address_t %s;
+        address_t %s;
+    };
+};
+'''
+
+
+def to_ctf(trace, output):
+    if not os.path.isdir(output):
+        os.makedirs(output)
+
+    with open(os.path.join(output, 'metadata'), 'w') as f:
+        f.write(CTF_METADATA % trace)
+        for ev_id, (name, arg0, arg1) in sorted(EVENT_TYPES.items()):
+            f.write(CTF_EVENT % (name, ev_id, arg0, arg1))
+        user_ids = set(ev[1] for _, events in trace['streams'] for ev in events
+                       if ev[1] not in EVENT_TYPES)
+        for ev_id in sorted(user_ids):
+            f.write(CTF_EVENT % ('user_%d' % ev_id, ev_id, 'arg0', 'arg1'))
+
+    # the event record of ktrace is the same layout as the CTF event
+    for cpu, events in trace['streams']:
+        with open(os.path.join(output, 'stream_%d' % cpu), 'wb') as f:
+            f.write(struct.pack('<II', 0xC1FC1FC1, 0))
+            for ev in events:
+                f.write(EVENT.pack(*ev))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='convert ktrace dump')
+    parser.add_argument('input', help='binary dump or console log')
+    parser.add_argument('-f', '--format', choices=['perfetto', 'ctf'], default='perfetto')
+    parser.add_argument('-o', '--output', help='output file (perfetto) or directory (ctf)')
+    args = parser.parse_args()
+
+    trace = parse(load_input(args.input))
+    output = args.output or (args.input + ('.json' if args.format == 'perfetto' else '.ctf'))
+
+    if args.format == 'perfetto':
+        to_perfetto(trace, output)
+    else:
+        to_ctf(trace, output)
+
+    count = sum(len(events) for _, events in trace['streams'])
+    print('%d events, %d lost, %d names -> %s' % (count, trace['lost'], len(trace['names']), output))
+
+
+if __name__ == '__main__':
+    main()
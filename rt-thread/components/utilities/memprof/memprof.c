@@ -0,0 +1,602 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+#include <memprof.h>
+
+#ifdef RT_USING_DFS
+#include <dfs_posix.h>
+#endif
+
+#if (RT_MEMPROF_ALLOCS & (RT_MEMPROF_ALLOCS - 1)) != 0
+#error "RT_MEMPROF_ALLOCS must be a power of two"
+#endif
+
+#if RT_MEMPROF_SITES > 255
+#error "RT_MEMPROF_SITES must be less than 256"
+#endif
+
+/*
+ * Every live allocation is kept in an open addressing table of 8 bytes
+ * entries: the pointer, the size and the index of call site. The call sites
+ * are kept in another table keyed by the caller address, the last one is
+ * used for the callers when the site table is full.
+ */
+
+#define MEMPROF_SIZE_MAX               0x00FFFFFF
+#define MEMPROF_ALLOC_MASK             (RT_MEMPROF_ALLOCS - 1)
+#define MEMPROF_PROBE_MAX              32
+#define MEMPROF_SITE_OTHER             (RT_MEMPROF_SITES - 1)
+
+/* the same as memheap.c */
+#define MEMPROF_HEAP_USED              0x01
+#define MEMPROF_HEAP_ITEM_SIZE         RT_ALIGN(sizeof(struct rt_memheap_item), RT_ALIGN_SIZE)
+
+struct memprof_alloc
+{
+    void       *ptr;
+    rt_uint32_t info;                                   /* size << 8 | site */
+};
+
+static struct memprof_alloc _allocs[RT_MEMPROF_ALLOCS];
+static struct rt_memprof_site _sites[RT_MEMPROF_SITES];
+
+static rt_uint32_t _live_bytes;
+static rt_uint32_t _peak_bytes;
+static rt_uint32_t _entries;                            /* used entries of _allocs */
+static rt_uint32_t _dropped;                            /* allocations not in table */
+static rt_tick_t _start_tick;
+static rt_bool_t _running;
+
+rt_inline rt_uint32_t _memprof_hash(void *ptr)
+{
+    return ((((rt_uint32_t)(rt_ubase_t)ptr >> 3) * 2654435761u) >> 16) & MEMPROF_ALLOC_MASK;
+}
+
+static rt_uint32_t _memprof_site(void *caller)
+{
+    rt_uint32_t index, count;
+
+    index = (((rt_uint32_t)(rt_ubase_t)caller >> 1) * 2654435761u >> 16) % MEMPROF_SITE_OTHER;
+    for (count = 0; count < MEMPROF_SITE_OTHER; count ++)
+    {
+        if (_sites[index].caller == caller)
+            return index;
+
+        if (_sites[index].caller == RT_NULL)
+        {
+            _sites[index].caller = caller;
+            return index;
+        }
+
+        if (++ index == MEMPROF_SITE_OTHER)
+            index = 0;
+    }
+
+    return MEMPROF_SITE_OTHER;
+}
+
+static void _memprof_malloc_hook(void *ptr, rt_size_t size, void *caller)
+{
+    struct rt_memprof_site *site;
+    rt_uint32_t index, count, site_index;
+    rt_base_t level;
+
+    if (size > MEMPROF_SIZE_MAX)
+        size = MEMPROF_SIZE_MAX;
+
+    level = rt_hw_interrupt_disable();
+
+    site_index = _memprof_site(caller);
+    site = &_sites[site_index];
+    site->allocs ++;
+    site->alloc_bytes += size;
+
+    /* the load and the probe are limited to bound the interrupt latency */
+    index = _memprof_hash(ptr);
+    count = MEMPROF_PROBE_MAX;
+    if (_entries < RT_MEMPROF_ALLOCS / 4 * 3)
+    {
+        for (count = 0; count < MEMPROF_PROBE_MAX; count ++)
+        {
+            if (_allocs[index].ptr == RT_NULL)
+                break;
+            index = (index + 1) & MEMPROF_ALLOC_MASK;
+        }
+    }
+
+    if (count == MEMPROF_PROBE_MAX)
+    {
+        /* the table is too full, this block is not tracked */
+        _dropped ++;
+    }
+    else
+    {
+        _allocs[index].ptr = ptr;
+        _allocs[index].info = ((rt_uint32_t)size << 8) | site_index;
+        _entries ++;
+
+        site->live_count ++;
+        site->live_bytes += size;
+        if (site->live_bytes > site->peak_bytes)
+            site->peak_bytes = site->live_bytes;
+
+        _live_bytes += size;
+        if (_live_bytes > _peak_bytes)
+            _peak_bytes = _live_bytes;
+    }
+
+    rt_hw_interrupt_enable(level);
+}
+
+static void _memprof_free_hook(void *ptr, void *caller)
+{
+    struct rt_memprof_site *site;
+    rt_uint32_t index, next, home, size, count;
+    rt_base_t level;
+
+    if (ptr == RT_NULL)
+        return;
+
+    level = rt_hw_interrupt_disable();
+
+    index = _memprof_hash(ptr);
+    for (count = 0; _allocs[index].ptr != ptr; count ++)
+    {
+        if (_allocs[index].ptr == RT_NULL || count == MEMPROF_PROBE_MAX)
+        {
+            /* allocated before start or dropped */
+            rt_hw_interrupt_enable(level);
+            return;
+        }
+        index = (index + 1) & MEMPROF_ALLOC_MASK;
+    }
+
+    size = _allocs[index].info >> 8;
+    site = &_sites[_allocs[index].info & 0xFF];
+    site->frees ++;
+    site->live_count --;
+    site->live_bytes -= size;
+    _live_bytes -= size;
+
+    /* backward shift deletion, keep the probe sequences unbroken */
+    next = index;
+    while (1)
+    {
+        next = (next + 1) & MEMPROF_ALLOC_MASK;
+        if (_allocs[next].ptr == RT_NULL)
+            break;
+
+        home = _memprof_hash(_allocs[next].ptr);
+        if (((next - home) & MEMPROF_ALLOC_MASK) >= ((next - index) & MEMPROF_ALLOC_MASK))
+        {
+            _allocs[index] = _allocs[next];
+            index = next;
+        }
+    }
+    _allocs[index].ptr = RT_NULL;
+    _entries --;
+
+    rt_hw_interrupt_enable(level);
+}
+
+/**
+ * This function will start profiling the heap allocations.
+ */
+void rt_memprof_start(void)
+{
+    if (_running)
+        return;
+
+    _start_tick = rt_tick_get();
+    _running = RT_TRUE;
+    rt_malloc_caller_sethook(_memprof_malloc_hook);
+    rt_free_caller_sethook(_memprof_free_hook);
+}
+RTM_EXPORT(rt_memprof_start);
+
+/**
+ * This function will stop profiling, the recorded statistics are kept.
+ */
+void rt_memprof_stop(void)
+{
+    rt_malloc_caller_sethook(RT_NULL);
+    rt_free_caller_sethook(RT_NULL);
+    _running = RT_FALSE;
+}
+RTM_EXPORT(rt_memprof_stop);
+
+/**
+ * This function will drop all recorded allocations and statistics.
+ */
+void rt_memprof_reset(void)
+{
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    rt_memset(_allocs, 0, sizeof(_allocs));
+    rt_memset(_sites, 0, sizeof(_sites));
+    _live_bytes = 0;
+    _peak_bytes = 0;
+    _entries = 0;
+    _dropped = 0;
+    _start_tick = rt_tick_get();
+    rt_hw_interrupt_enable(level);
+}
+RTM_EXPORT(rt_memprof_reset);
+
+/**
+ * This function will save the live bytes of each call site, the report
+ * shows the growth since the mark.
+ */
+void rt_memprof_mark(void)
+{
+    rt_uint32_t index;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    for (index = 0; index < RT_MEMPROF_SITES; index ++)
+    {
+        _sites[index].mark_bytes = _sites[index].live_bytes;
+    }
+    rt_hw_interrupt_enable(level);
+}
+RTM_EXPORT(rt_memprof_mark);
+
+/**
+ * This function will get the statistics of call site.
+ *
+ * @param index the index of call site
+ * @param site the statistics of call site
+ *
+ * @return RT_EOK on success, -RT_ERROR if the site is not used, -RT_EINVAL if
+ *         the index is out of range
+ */
+rt_err_t rt_memprof_get_site(rt_uint32_t index, struct rt_memprof_site *site)
+{
+    rt_base_t level;
+
+    RT_ASSERT(site != RT_NULL);
+
+    if (index >= RT_MEMPROF_SITES)
+        return -RT_EINVAL;
+
+    level = rt_hw_interrupt_disable();
+    *site = _sites[index];
+    rt_hw_interrupt_enable(level);
+
+    if (site->allocs == 0)
+        return -RT_ERROR;
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_memprof_get_site);
+
+/**
+ * This function will walk the blocks of memheap and get the fragmentation
+ * statistics.
+ *
+ * @param heap the memheap
+ * @param frag the fragmentation statistics
+ *
+ * @return RT_EOK on success, or the error of taking heap lock
+ */
+rt_err_t rt_memprof_get_frag(struct rt_memheap *heap, struct rt_memprof_frag *frag)
+{
+    struct rt_memheap_item *item, *end;
+    rt_uint32_t free_part[MEMPROF_MAP_CELLS];
+    rt_uint32_t size, cell_size, begin, stop, cell, part;
+    rt_err_t result;
+
+    RT_ASSERT(heap != RT_NULL);
+    RT_ASSERT(frag != RT_NULL);
+
+    rt_memset(frag, 0, sizeof(struct rt_memprof_frag));
+    rt_memset(free_part, 0, sizeof(free_part));
+
+    result = rt_sem_take(&(heap->lock), RT_WAITING_FOREVER);
+    if (result != RT_EOK)
+        return result;
+
+    frag->pool_size = heap->pool_size;
+    cell_size = (heap->pool_size + MEMPROF_MAP_CELLS - 1) / MEMPROF_MAP_CELLS;
+
+    /* the tailer block points back to the start of pool */
+    end = (struct rt_memheap_item *)heap->start_addr;
+    for (item = end; item->next != end; item = item->next)
+    {
+        if (item->magic & MEMPROF_HEAP_USED)
+            continue;
+
+        size = (rt_ubase_t)item->next - (rt_ubase_t)item - MEMPROF_HEAP_ITEM_SIZE;
+        frag->free_size += size;
+        frag->free_blocks ++;
+        if (size > frag->largest)
+            frag->largest = size;
+
+        for (cell = 0; cell < MEMPROF_FRAG_BUCKETS - 1 && (size >> (cell + 5)) != 0; cell ++);
+        frag->histogram[cell] ++;
+
+        /* spread the free bytes to the cells of map */
+        begin = (rt_ubase_t)item - (rt_ubase_t)heap->start_addr;
+        stop = (rt_ubase_t)item->next - (rt_ubase_t)heap->start_addr;
+        while (begin < stop)
+        {
+            cell = begin / cell_size;
+            part = (cell + 1) * cell_size;
+            if (part > stop)
+                part = stop;
+            free_part[cell] += part - begin;
+            begin = part;
+        }
+    }
+
+    rt_sem_release(&(heap->lock));
+
+    for (cell = 0; cell < MEMPROF_MAP_CELLS; cell ++)
+    {
+        frag->map[cell] = free_part[cell] * 100 / cell_size;
+    }
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_memprof_get_frag);
+
+/**
+ * This function will write the call sites sorted by live bytes.
+ *
+ * @param output the output function of report
+ * @param ctx the context of output function
+ * @param top the number of call sites, 0 for all
+ */
+void rt_memprof_report(rt_memprof_output_t output, void *ctx, rt_uint32_t top)
+{
+    struct rt_memprof_site site;
+    char line[96];
+    rt_uint8_t order[RT_MEMPROF_SITES];
+    rt_uint32_t count = 0, index, pos, seconds;
+
+    RT_ASSERT(output != RT_NULL);
+
+    /* insertion sort on the snapshot of live bytes */
+    for (index = 0; index < RT_MEMPROF_SITES; index ++)
+    {
+        if (_sites[index].allocs == 0)
+            continue;
+
+        for (pos = count; pos > 0 && _sites[order[pos - 1]].live_bytes < _sites[index].live_bytes; pos --)
+        {
+            order[pos] = order[pos - 1];
+        }
+        order[pos] = index;
+        count ++;
+    }
+    if (top == 0 || top > count)
+        top = count;
+
+    seconds = (rt_tick_get() - _start_tick) / RT_TICK_PER_SECOND;
+    if (seconds == 0)
+        seconds = 1;
+
+    rt_snprintf(line, sizeof(line), "memprof %s, %d seconds, live %d bytes, peak %d bytes, dropped %d\n",
+                _running ? "running" : "stopped", seconds, _live_bytes, _peak_bytes, _dropped);
+    output(ctx, line);
+    output(ctx, "caller        live  count     peak   allocs  allocs/s  growth\n");
+    output(ctx, "---------- ------- ------ -------- -------- --------- -------\n");
+
+    for (index = 0; index < top; index ++)
+    {
+        rt_memprof_get_site(order[index], &site);
+        if (order[index] == MEMPROF_SITE_OTHER)
+            rt_snprintf(line, sizeof(line), "%-10s", "(other)");
+        else
+            rt_snprintf(line, sizeof(line), "0x%08x", (rt_ubase_t)site.caller);
+        rt_snprintf(line + 10, sizeof(line) - 10, " %7d %6d %8d %8d %9d %7d\n",
+                    site.live_bytes, site.live_count, site.peak_bytes, site.allocs,
+                    site.allocs / seconds, (rt_int32_t)(site.live_bytes - site.mark_bytes));
+        output(ctx, line);
+    }
+}
+RTM_EXPORT(rt_memprof_report);
+
+/**
+ * This function will write the fragmentation map of all memheaps. Each
+ * character of the map is a part of pool: '#' used, '.' free, '+' mixed.
+ *
+ * @param output the output function of report
+ * @param ctx the context of output function
+ */
+void rt_memprof_report_frag(rt_memprof_output_t output, void *ctx)
+{
+    struct rt_object_information *information;
+    struct rt_list_node *node;
+    struct rt_memheap *heap;
+    struct rt_memprof_frag frag;
+    char line[MEMPROF_MAP_CELLS + 8];
+    rt_uint32_t index;
+
+    RT_ASSERT(output != RT_NULL);
+
+    information = rt_object_get_information(RT_Object_Class_MemHeap);
+    RT_ASSERT(information != RT_NULL);
+
+    /* the memheaps are created at startup and not detached */
+    for (node = information->object_list.next;
+         node != &(information->object_list);
+         node = node->next)
+    {
+        heap = (struct rt_memheap *)rt_list_entry(node, struct rt_object, list);
+        if (rt_memprof_get_frag(heap, &frag) != RT_EOK)
+            continue;
+
+        rt_snprintf(line, sizeof(line), "%.*s", RT_NAME_MAX, heap->parent.name);
+        output(ctx, line);
+        rt_snprintf(line, sizeof(line), ": pool %d, free %d in %d blocks, ",
+                    frag.pool_size, frag.free_size, frag.free_blocks);
+        output(ctx, line);
+        rt_snprintf(line, sizeof(line), "largest %d (%d%% of free)\n",
+                    frag.largest, frag.free_size ? frag.largest * 100 / frag.free_size : 0);
+        output(ctx, line);
+
+        for (index = 0; index < MEMPROF_FRAG_BUCKETS; index ++)
+        {
+            if (frag.histogram[index] == 0)
+                continue;
+            rt_snprintf(line, sizeof(line), "  %6d%s: %d\n", 16 << index,
+                        index == MEMPROF_FRAG_BUCKETS - 1 ? "+" : " ", frag.histogram[index]);
+            output(ctx, line);
+        }
+
+        line[0] = '[';
+        for (index = 0; index < MEMPROF_MAP_CELLS; index ++)
+        {
+            if (frag.map[index] == 0)
+                line[index + 1] = '#';
+            else if (frag.map[index] >= 100)
+                line[index + 1] = '.';
+            else
+                line[index + 1] = '+';
+        }
+        line[index + 1] = ']';
+        line[index + 2] = '\n';
+        line[index + 3] = '\0';
+        output(ctx, line);
+    }
+}
+RTM_EXPORT(rt_memprof_report_frag);
+
+/**
+ * This function will write the call sites as CSV, which can be converted to
+ * flame graph by memprof_flamegraph.py.
+ *
+ * @param output the output function of report
+ * @param ctx the context of output function
+ */
+void rt_memprof_export(rt_memprof_output_t output, void *ctx)
+{
+    struct rt_memprof_site site;
+    char line[96];
+    rt_uint32_t index;
+
+    RT_ASSERT(output != RT_NULL);
+
+    rt_snprintf(line, sizeof(line), "# memprof %d ticks=%d tick_hz=%d live=%d peak=%d dropped=%d\n",
+                MEMPROF_VERSION, rt_tick_get() - _start_tick, RT_TICK_PER_SECOND,
+                _live_bytes, _peak_bytes, _dropped);
+    output(ctx, line);
+    output(ctx, "caller,live_bytes,live_count,peak_bytes,allocs,alloc_bytes,frees,growth\n");
+
+    for (index = 0; index < RT_MEMPROF_SITES; index ++)
+    {
+        if (rt_memprof_get_site(index, &site) != RT_EOK)
+            continue;
+
+        rt_snprintf(line, sizeof(line), "0x%08x,%u,%u,%u,%u,%u,%u,%d\n",
+                    index == MEMPROF_SITE_OTHER ? 0 : (rt_ubase_t)site.caller,
+                    site.live_bytes, site.live_count, site.peak_bytes, site.allocs,
+                    site.alloc_bytes, site.frees, (rt_int32_t)(site.live_bytes - site.mark_bytes));
+        output(ctx, line);
+    }
+}
+RTM_EXPORT(rt_memprof_export);
+
+/**
+ * This function will initialize memprof.
+ */
+int rt_memprof_init(void)
+{
+#ifdef RT_MEMPROF_AUTO_START
+    rt_memprof_start();
+#endif
+
+    return 0;
+}
+INIT_PREV_EXPORT(rt_memprof_init);
+
+#if defined(RT_USING_FINSH) && defined(FINSH_USING_MSH)
+#include <finsh.h>
+#include <stdlib.h>
+
+static void _memprof_console_output(void *ctx, const char *str)
+{
+    rt_kprintf("%s", str);
+}
+
+#ifdef RT_USING_DFS
+static void _memprof_file_output(void *ctx, const char *str)
+{
+    write(*(int *)ctx, str, rt_strlen(str));
+}
+#endif
+
+static void memprof(uint8_t argc, char **argv)
+{
+    if (argc < 2)
+    {
+        rt_kprintf("Usage:\n");
+        rt_kprintf("memprof start                - start profiling\n");
+        rt_kprintf("memprof stop                 - stop profiling\n");
+        rt_kprintf("memprof reset                - drop the statistics\n");
+        rt_kprintf("memprof mark                 - save live bytes for growth\n");
+        rt_kprintf("memprof show [n]             - show the top n call sites\n");
+        rt_kprintf("memprof frag                 - show fragmentation of memheaps\n");
+#ifdef RT_USING_DFS
+        rt_kprintf("memprof save <file>          - save the call sites as CSV\n");
+#endif
+        return;
+    }
+
+    if (!rt_strcmp(argv[1], "start"))
+    {
+        rt_memprof_start();
+    }
+    else if (!rt_strcmp(argv[1], "stop"))
+    {
+        rt_memprof_stop();
+    }
+    else if (!rt_strcmp(argv[1], "reset"))
+    {
+        rt_memprof_reset();
+    }
+    else if (!rt_strcmp(argv[1], "mark"))
+    {
+        rt_memprof_mark();
+    }
+    else if (!rt_strcmp(argv[1], "show"))
+    {
+        rt_memprof_report(_memprof_console_output, RT_NULL, argc > 2 ? atoi(argv[2]) : 20);
+    }
+    else if (!rt_strcmp(argv[1], "frag"))
+    {
+        rt_memprof_report_frag(_memprof_console_output, RT_NULL);
+    }
+#ifdef RT_USING_DFS
+    else if (!rt_strcmp(argv[1], "save") && argc > 2)
+    {
+        int fd;
+
+        fd = open(argv[2], O_WRONLY | O_CREAT | O_TRUNC, 0);
+        if (fd < 0)
+        {
+            rt_kprintf("open %s failed\n", argv[2]);
+            return;
+        }
+        rt_memprof_export(_memprof_file_output, &fd);
+        close(fd);
+    }
+#endif
+    else
+    {
+        rt_kprintf("Please input correct memprof command.\n");
+    }
+}
+MSH_CMD_EXPORT(memprof, Heap allocation profiler. Help: memprof);
+#endif /* defined(RT_USING_FINSH) && defined(FINSH_USING_MSH) */
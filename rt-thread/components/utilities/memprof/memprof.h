@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#ifndef _MEMPROF_H_
+#define _MEMPROF_H_
+
+#include <rtthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MEMPROF_VERSION                1
+#define MEMPROF_FRAG_BUCKETS           13              /* 16 bytes ~ 64K bytes and above */
+#define MEMPROF_MAP_CELLS              64
+
+/* the statistics of one call site */
+struct rt_memprof_site
+{
+    void       *caller;                                 /* return address of heap interface */
+    rt_uint32_t live_bytes;                             /* allocated and not freed */
+    rt_uint32_t live_count;
+    rt_uint32_t peak_bytes;                             /* maximum of live_bytes */
+    rt_uint32_t allocs;                                 /* number of allocations */
+    rt_uint32_t alloc_bytes;                            /* bytes of allocations, wraps */
+    rt_uint32_t frees;                                  /* number of frees */
+    rt_uint32_t mark_bytes;                             /* live_bytes at the last mark */
+};
+
+/* the free list statistics and block map of one memheap */
+struct rt_memprof_frag
+{
+    rt_uint32_t pool_size;
+    rt_uint32_t free_size;
+    rt_uint32_t free_blocks;
+    rt_uint32_t largest;                                /* the largest free block */
+    rt_uint32_t histogram[MEMPROF_FRAG_BUCKETS];        /* free blocks of [2^(n+4), 2^(n+5)) bytes */
+    rt_uint8_t  map[MEMPROF_MAP_CELLS];                 /* free percent of each part of pool */
+};
+
+/* write one line of report */
+typedef void (*rt_memprof_output_t)(void *ctx, const char *str);
+
+int rt_memprof_init(void);
+void rt_memprof_start(void);
+void rt_memprof_stop(void);
+void rt_memprof_reset(void);
+void rt_memprof_mark(void);
+
+rt_err_t rt_memprof_get_site(rt_uint32_t index, struct rt_memprof_site *site);
+rt_err_t rt_memprof_get_frag(struct rt_memheap *heap, struct rt_memprof_frag *frag);
+
+void rt_memprof_report(rt_memprof_output_t output, void *ctx, rt_uint32_t top);
+void rt_memprof_report_frag(rt_memprof_output_t output, void *ctx);
+void rt_memprof_export(rt_memprof_output_t output, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _MEMPROF_H_ */
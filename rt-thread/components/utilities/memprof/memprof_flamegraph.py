@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2006-2019, RT-Thread Development Team
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Change Logs:
+# Date           Author       Notes
+# 2026-10-19     Hehesheng    the first version
+#
+# Convert the CSV from `memprof save` to the folded stack format, which is
+# the input of flamegraph.pl, speedscope and inferno.
+#
+# The caller addresses are resolved by addr2line when the ELF file is given.
+#
+# Usage:
+#   memprof_flamegraph.py heap.csv -e rtthread.elf -m live_bytes -o heap.folded
+#   flamegraph.pl heap.folded > heap.svg
+#
+
+import argparse
+import csv
+import subprocess
+import sys
+
+METRICS = ('live_bytes', 'live_count', 'peak_bytes', 'allocs', 'alloc_bytes', 'frees', 'growth')
+
+
+def load(path):
+    header = {}
+    with open(path) as f:
+        lines = f.read().splitlines()
+
+    if not lines or not lines[0].startswith('# memprof'):
+        sys.exit('%s: not a memprof file' % path)
+
+    for item in lines[0].split()[3:]:
+        key, _, value = item.partition('=')
+        header[key] = int(value)
+
+    return header, list(csv.DictReader(lines[1:]))
+
+
+def resolve(elf, addr2line, addresses):
+    """ map the caller address to 'function (file:line)' """
+    names = {}
+    if not elf or not addresses:
+        return names
+
+    # the return address points after the call instruction
+    query = ['0x%x' % max(addr - 1, 0) for addr in addresses]
+    try:
+        output = subprocess.check_output([addr2line, '-f', '-C', '-e', elf] + query)
+    except (OSError, subprocess.CalledProcessError) as e:
+        sys.exit('%s: %s' % (addr2line, e))
+
+    lines = output.decode('utf-8', 'ignore').splitlines()
+    for index, addr in enumerate(addresses):
+        function, location = lines[index * 2], lines[index * 2 + 1]
+        location = location.split(' ')[0].rsplit('/', 1)[-1]
+        names[addr] = '%s (%s)' % (function, location)
+
+    return names
+
+
+def main():
+    parser = argparse.ArgumentParser(description='convert memprof CSV to folded stacks')
+    parser.add_argument('input', help='CSV file from memprof save')
+    parser.add_argument('-e', '--elf', help='ELF file to resolve the caller address')
+    parser.add_argument('-m', '--metric', choices=METRICS, default='live_bytes')
+    parser.add_argument('-a', '--addr2line', default='arm-none-eabi-addr2line')
+    parser.add_argument('-o', '--output', help='output file, default stdout')
+    args = parser.parse_args()
+
+    header, sites = load(args.input)
+    addresses = [int(site['caller'], 16) for site in sites if int(site['caller'], 16)]
+    names = resolve(args.elf, args.addr2line, addresses)
+
+    out = open(args.output, 'w') if args.output else sys.stdout
+    total = 0
+    for site in sites:
+        value = int(site[args.metric])
+        if value <= 0:
+            continue
+        addr = int(site['caller'], 16)
+        name = names.get(addr, '0x%08x' % addr) if addr else '(other)'
+        out.write('heap;%s %d\n' % (name.replace(';', ':'), value))
+        total += value
+
+    if out is not sys.stdout:
+        out.close()
+    sys.stderr.write('%d sites, %s %d, %d seconds, dropped %d\n' %
+                     (len(sites), args.metric, total,
+                      header.get('ticks', 0) // max(header.get('tick_hz', 1), 1),
+                      header.get('dropped', 0)))
+
+
+if __name__ == '__main__':
+    main()
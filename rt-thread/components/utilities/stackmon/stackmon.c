@@ -0,0 +1,356 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+#include <stackmon.h>
+
+#ifdef RT_USING_SYSTEM_WORKQUEUE
+#include <rtdevice.h>
+#endif
+
+#ifdef RT_USING_DFS
+#include <dfs_posix.h>
+#endif
+
+#define DBG_TAG                        "stackmon"
+#define DBG_LVL                        DBG_INFO
+#include <rtdbg.h>
+
+/*
+ * The thread stack is filled with '#' when the thread is initialized, and
+ * the bytes are overwritten from the top as the stack grows. The lowest
+ * overwritten byte gives the peak usage. The idle hook scans a few bytes of
+ * one thread each time, from the stack end to the known peak, so the cost
+ * is spread over idle time.
+ */
+
+#define STACKMON_FILL                  '#'
+#define STACKMON_FILL_WORD             ((rt_ubase_t)-1 / 0xFF * STACKMON_FILL)
+#define STACKMON_SUGGEST_ALIGN         64
+
+/* the thread to be scanned by the idle hook */
+static rt_uint32_t _scan_index;
+
+#ifdef RT_USING_SYSTEM_WORKQUEUE
+static struct rt_work _warn_work;
+#endif
+
+/* get the thread by index, the scheduler shall be locked */
+static rt_thread_t _stackmon_thread_at(rt_uint32_t index)
+{
+    struct rt_object_information *information;
+    struct rt_list_node *node;
+
+    information = rt_object_get_information(RT_Object_Class_Thread);
+    RT_ASSERT(information != RT_NULL);
+
+    for (node = information->object_list.next;
+         node != &(information->object_list);
+         node = node->next)
+    {
+        if (index-- == 0)
+            return (rt_thread_t)rt_list_entry(node, struct rt_object, list);
+    }
+
+    return RT_NULL;
+}
+
+/* return the offset of the first used byte from stack end in [offset, limit) */
+static rt_uint32_t _stackmon_find(rt_thread_t thread, rt_uint32_t offset, rt_uint32_t limit)
+{
+#if defined(ARCH_CPU_STACK_GROWS_UPWARD)
+    rt_uint8_t *end = (rt_uint8_t *)thread->stack_addr + thread->stack_size - 1;
+
+    while (offset < limit && *(end - offset) == STACKMON_FILL)
+        offset ++;
+#else
+    rt_uint8_t *end = (rt_uint8_t *)thread->stack_addr;
+
+    while (offset < limit && ((rt_ubase_t)(end + offset) & (sizeof(rt_ubase_t) - 1)))
+    {
+        if (end[offset] != STACKMON_FILL)
+            return offset;
+        offset ++;
+    }
+
+    /* compare by words */
+    while (offset + sizeof(rt_ubase_t) <= limit &&
+           *(rt_ubase_t *)(end + offset) == STACKMON_FILL_WORD)
+    {
+        offset += sizeof(rt_ubase_t);
+    }
+
+    while (offset < limit && end[offset] == STACKMON_FILL)
+        offset ++;
+#endif
+
+    return offset;
+}
+
+/* record the peak usage, return RT_TRUE if a new warning is pending */
+static rt_bool_t _stackmon_update(rt_thread_t thread, rt_uint32_t peak)
+{
+    if (peak <= thread->stack_peak)
+        return RT_FALSE;
+
+    thread->stack_peak = peak;
+    if (thread->stack_warn == STACKMON_WARN_NONE &&
+        peak >= thread->stack_size / 100 * RT_STACKMON_WARN_PERCENT)
+    {
+        thread->stack_warn = STACKMON_WARN_PENDING;
+        return RT_TRUE;
+    }
+
+    return RT_FALSE;
+}
+
+#ifdef RT_USING_SYSTEM_WORKQUEUE
+/* print the pending warnings out of idle thread */
+static void _stackmon_warn(struct rt_work *work, void *work_data)
+{
+    char name[RT_NAME_MAX];
+    rt_uint32_t index, peak, size;
+    rt_thread_t thread;
+
+    for (index = 0; ; index ++)
+    {
+        rt_enter_critical();
+        thread = _stackmon_thread_at(index);
+        if (thread == RT_NULL)
+        {
+            rt_exit_critical();
+            break;
+        }
+        if (thread->stack_warn != STACKMON_WARN_PENDING)
+        {
+            rt_exit_critical();
+            continue;
+        }
+        thread->stack_warn = STACKMON_WARN_DONE;
+        rt_strncpy(name, thread->name, RT_NAME_MAX);
+        peak = thread->stack_peak;
+        size = thread->stack_size;
+        rt_exit_critical();
+
+        LOG_W("thread %.*s stack used %d of %d bytes (%d%%), suggested size %d",
+              RT_NAME_MAX, name, peak, size, peak * 100 / size, rt_stackmon_suggest(peak));
+    }
+}
+#endif
+
+static void _stackmon_idle_hook(void)
+{
+    rt_thread_t thread;
+    rt_uint32_t limit, end, offset;
+    rt_bool_t warn = RT_FALSE;
+
+    rt_enter_critical();
+
+    thread = _stackmon_thread_at(_scan_index);
+    if (thread == RT_NULL)
+    {
+        /* start the next round */
+        _scan_index = 0;
+        rt_exit_critical();
+        return;
+    }
+
+    /* the bytes above limit are known as used */
+    limit = thread->stack_size - thread->stack_peak;
+    end = thread->stack_scan + RT_STACKMON_SCAN_STEP;
+    if (end > limit)
+        end = limit;
+
+    offset = _stackmon_find(thread, thread->stack_scan, end);
+    if (offset < end || end == limit)
+    {
+        if (offset < end)
+            warn = _stackmon_update(thread, thread->stack_size - offset);
+
+        /* this thread is done, go to the next one */
+        thread->stack_scan = 0;
+        _scan_index ++;
+    }
+    else
+    {
+        thread->stack_scan = end;
+    }
+
+    rt_exit_critical();
+
+#ifdef RT_USING_SYSTEM_WORKQUEUE
+    if (warn)
+        rt_work_submit(&_warn_work, 0);
+#else
+    (void)warn;
+#endif
+}
+
+/**
+ * This function will scan the whole stack of thread and return the peak
+ * usage.
+ *
+ * @param thread the thread
+ *
+ * @return the peak stack usage in bytes
+ */
+rt_uint32_t rt_stackmon_peak(rt_thread_t thread)
+{
+    rt_uint32_t peak;
+
+    RT_ASSERT(thread != RT_NULL);
+
+    rt_enter_critical();
+    _stackmon_update(thread, thread->stack_size -
+                     _stackmon_find(thread, 0, thread->stack_size - thread->stack_peak));
+    peak = thread->stack_peak;
+    rt_exit_critical();
+
+    return peak;
+}
+RTM_EXPORT(rt_stackmon_peak);
+
+/**
+ * This function will return the suggested stack size for the peak usage,
+ * with RT_STACKMON_MARGIN_PERCENT of margin.
+ *
+ * @param peak the peak stack usage in bytes
+ *
+ * @return the suggested stack size
+ */
+rt_uint32_t rt_stackmon_suggest(rt_uint32_t peak)
+{
+    return RT_ALIGN(peak + peak / 100 * RT_STACKMON_MARGIN_PERCENT, STACKMON_SUGGEST_ALIGN);
+}
+RTM_EXPORT(rt_stackmon_suggest);
+
+/**
+ * This function will scan all threads and write the report line by line.
+ *
+ * @param output the output function of report
+ * @param ctx the context of output function
+ */
+void rt_stackmon_report(rt_stackmon_output_t output, void *ctx)
+{
+    char name[RT_NAME_MAX];
+    char line[80];
+    rt_uint32_t index, peak, size, suggest;
+    rt_uint32_t total_size = 0, total_suggest = 0;
+    rt_uint8_t warn;
+    rt_thread_t thread;
+
+    RT_ASSERT(output != RT_NULL);
+
+    rt_snprintf(line, sizeof(line), "%-*.*s  stack   peak usage suggest\n",
+                RT_NAME_MAX, RT_NAME_MAX, "thread");
+    output(ctx, line);
+    rt_snprintf(line, sizeof(line), "%-*.*s ------ ------ ----- -------\n",
+                RT_NAME_MAX, RT_NAME_MAX, "------------------------------");
+    output(ctx, line);
+
+    for (index = 0; ; index ++)
+    {
+        rt_enter_critical();
+        thread = _stackmon_thread_at(index);
+        if (thread == RT_NULL)
+        {
+            rt_exit_critical();
+            break;
+        }
+        rt_strncpy(name, thread->name, RT_NAME_MAX);
+        size = thread->stack_size;
+        peak = rt_stackmon_peak(thread);
+        warn = thread->stack_warn;
+        rt_exit_critical();
+
+        suggest = rt_stackmon_suggest(peak);
+        total_size += size;
+        total_suggest += suggest;
+
+        rt_snprintf(line, sizeof(line), "%-*.*s %6d %6d %4d%%%c %6d\n",
+                    RT_NAME_MAX, RT_NAME_MAX, name, size, peak, peak * 100 / size,
+                    warn != STACKMON_WARN_NONE ? '!' : ' ', suggest);
+        output(ctx, line);
+    }
+
+    rt_snprintf(line, sizeof(line), "total stack %d bytes, suggested %d bytes, %d bytes can be freed\n",
+                total_size, total_suggest,
+                total_size > total_suggest ? total_size - total_suggest : 0);
+    output(ctx, line);
+}
+RTM_EXPORT(rt_stackmon_report);
+
+/**
+ * This function will initialize stackmon and start the scan in idle time.
+ */
+int rt_stackmon_init(void)
+{
+#ifdef RT_USING_SYSTEM_WORKQUEUE
+    rt_work_init(&_warn_work, _stackmon_warn, RT_NULL);
+#endif
+
+    if (rt_thread_idle_sethook(_stackmon_idle_hook) != RT_EOK)
+    {
+        LOG_E("no free idle hook");
+        return -RT_EFULL;
+    }
+
+    return 0;
+}
+INIT_PREV_EXPORT(rt_stackmon_init);
+
+#if defined(RT_USING_FINSH) && defined(FINSH_USING_MSH)
+#include <finsh.h>
+
+static void _stackmon_console_output(void *ctx, const char *str)
+{
+    rt_kprintf("%s", str);
+}
+
+#ifdef RT_USING_DFS
+static void _stackmon_file_output(void *ctx, const char *str)
+{
+    write(*(int *)ctx, str, rt_strlen(str));
+}
+#endif
+
+static void stackmon(uint8_t argc, char **argv)
+{
+    if (argc < 2)
+    {
+        rt_stackmon_report(_stackmon_console_output, RT_NULL);
+    }
+#ifdef RT_USING_DFS
+    else if (!rt_strcmp(argv[1], "save") && argc > 2)
+    {
+        int fd;
+
+        fd = open(argv[2], O_WRONLY | O_CREAT | O_TRUNC, 0);
+        if (fd < 0)
+        {
+            rt_kprintf("open %s failed\n", argv[2]);
+            return;
+        }
+        rt_stackmon_report(_stackmon_file_output, &fd);
+        close(fd);
+    }
+#endif
+    else
+    {
+        rt_kprintf("Usage:\n");
+        rt_kprintf("stackmon                     - show the stack usage report\n");
+#ifdef RT_USING_DFS
+        rt_kprintf("stackmon save <file>         - save the stack usage report to file\n");
+#endif
+    }
+}
+MSH_CMD_EXPORT(stackmon, Thread stack high water report. Help: stackmon help);
+#endif /* defined(RT_USING_FINSH) && defined(FINSH_USING_MSH) */
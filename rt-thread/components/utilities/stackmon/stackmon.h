@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#ifndef _STACKMON_H_
+#define _STACKMON_H_
+
+#include <rtthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the value of rt_thread.stack_warn */
+#define STACKMON_WARN_NONE             0
+#define STACKMON_WARN_PENDING          1               /* over threshold, not printed yet */
+#define STACKMON_WARN_DONE             2
+
+/* write one line of report */
+typedef void (*rt_stackmon_output_t)(void *ctx, const char *str);
+
+int rt_stackmon_init(void);
+
+rt_uint32_t rt_stackmon_peak(rt_thread_t thread);
+rt_uint32_t rt_stackmon_suggest(rt_uint32_t peak);
+void rt_stackmon_report(rt_stackmon_output_t output, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _STACKMON_H_ */
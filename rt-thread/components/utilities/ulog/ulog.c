@@ -6,6 +6,7 @@
  * Change Logs:
  * Date           Author       Notes
  * 2018-08-25     armink       the first version
+ * 2026-10-19     Hehesheng    use rt_vsnprintf for float when RT_PRINTF_FLOAT is enabled
  */
 
 #include <stdarg.h>
@@ -16,7 +17,7 @@
 #include <syslog.h>
 #endif
 
-#ifdef ULOG_OUTPUT_FLOAT
+#if defined(ULOG_OUTPUT_FLOAT) && !defined(RT_PRINTF_FLOAT)
 #include <stdio.h>
 #endif
 
@@ -329,7 +330,7 @@ RT_WEAK rt_size_t ulog_formater(char *log_buf, rt_uint32_t level, const char *ta
 
     log_len += ulog_strcpy(log_len, log_buf + log_len, ": ");
 
-#ifdef ULOG_OUTPUT_FLOAT
+#if defined(ULOG_OUTPUT_FLOAT) && !defined(RT_PRINTF_FLOAT)
     fmt_result = vsnprintf(log_buf + log_len, ULOG_LINE_BUF_SIZE - log_len, format, args);
 #else
     fmt_result = rt_vsnprintf(log_buf + log_len, ULOG_LINE_BUF_SIZE - log_len, format, args);
@@ -600,7 +601,7 @@ void ulog_raw(const char *format, ...)
     /* args point to the first variable parameter */
     va_start(args, format);
 
-#ifdef ULOG_OUTPUT_FLOAT
+#if defined(ULOG_OUTPUT_FLOAT) && !defined(RT_PRINTF_FLOAT)
     fmt_result = vsnprintf(log_buf, ULOG_LINE_BUF_SIZE, format, args);
 #else
     fmt_result = rt_vsnprintf(log_buf, ULOG_LINE_BUF_SIZE, format, args);
@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include "utest.h"
+#include "tc_helper.h"
+
+#define CHANNELS        3
+#define SCANS           32
+#define BLOCK_SAMPLES   (CHANNELS * SCANS)
+#define STREAM_BLOCKS   2000
+#define LOST_EVERY      97
+
+/* the ADC with a circular DMA buffer of two blocks, the DMA is the mock DMA */
+static struct rt_adc_device tc_adc;
+static struct rt_adc_stream_config tc_config;
+static rt_uint16_t dma_buf[2 * BLOCK_SAMPLES];
+static volatile rt_uint32_t produced;
+static volatile rt_uint32_t indications;
+static volatile rt_uint32_t bad_indications;
+static rt_bool_t adc_running;
+
+/* the sample holds the block number (9 bits) and the index in block (7 bits) */
+static rt_uint16_t tc_sample(rt_uint32_t index)
+{
+    return (rt_uint16_t)(((index / BLOCK_SAMPLES) & 0x1FF) << 7 | (index % BLOCK_SAMPLES));
+}
+
+/* the half and complete transfer interrupt, some blocks are lost by hardware */
+static void dma_timeout(void *parameter)
+{
+    rt_uint16_t *block;
+    rt_uint32_t i;
+
+    if (produced >= STREAM_BLOCKS)
+        return;
+
+    block = dma_buf + (produced & 1) * BLOCK_SAMPLES;
+    for (i = 0; i < BLOCK_SAMPLES; i++)
+        block[i] = tc_sample(produced * BLOCK_SAMPLES + i);
+
+    if (produced % LOST_EVERY == LOST_EVERY - 1)
+        rt_hw_adc_stream_done(&tc_adc, RT_NULL);
+    else
+        rt_hw_adc_stream_done(&tc_adc, block);
+    produced++;
+}
+
+static rt_err_t tc_adc_convert(struct rt_adc_device *device, rt_uint32_t channel, rt_uint32_t *value)
+{
+    *value = channel;
+    return RT_EOK;
+}
+
+static rt_err_t tc_adc_stream(struct rt_adc_device *device, const struct rt_adc_stream_config *config, rt_bool_t start)
+{
+    tc_config = *config;
+    adc_running = start;
+    if (start)
+    {
+        produced = 0;
+        tc_dma_start();
+    }
+    else
+    {
+        tc_dma_stop();
+    }
+    return RT_EOK;
+}
+
+static const struct rt_adc_ops tc_adc_ops =
+{
+    RT_NULL,
+    tc_adc_convert,
+    tc_adc_stream,
+};
+
+static rt_err_t tc_rx_ind(rt_device_t dev, rt_size_t size)
+{
+    if (size == 0 || size % sizeof(rt_uint16_t) != 0)
+        bad_indications++;
+    indications++;
+    return RT_EOK;
+}
+
+static rt_err_t tc_stream_config(void)
+{
+    struct rt_adc_stream_config config;
+
+    rt_memset(&config, 0, sizeof(config));
+    config.sample_rate = 1000;
+    config.block_size = SCANS;
+    config.channel_count = CHANNELS;
+    config.channels[0] = 3;
+    config.channels[1] = 7;
+    config.channels[2] = 16;
+    return rt_device_control(&tc_adc.parent, RT_ADC_CMD_STREAM_CONFIG, &config);
+}
+
+static void test_adc_stream_config(void)
+{
+    struct rt_adc_stream_config config;
+    rt_uint32_t value[2];
+
+    /* the single conversion before the stream is configured, pos is channel */
+    uassert_int_equal(rt_device_read(&tc_adc.parent, 5, value, sizeof(value)), sizeof(value));
+    uassert_int_equal(value[0], 5);
+    uassert_int_equal(value[1], 9);
+
+    /* the stream can't start without config, and the bad configs are refused */
+    uassert_true(rt_device_control(&tc_adc.parent, RT_ADC_CMD_STREAM_START, RT_NULL) != RT_EOK);
+    rt_memset(&config, 0, sizeof(config));
+    config.sample_rate = 1000;
+    config.block_size = SCANS;
+    uassert_int_equal(rt_device_control(&tc_adc.parent, RT_ADC_CMD_STREAM_CONFIG, &config), -RT_EINVAL);
+    config.channel_count = RT_ADC_STREAM_CHANNELS_MAX + 1;
+    uassert_int_equal(rt_device_control(&tc_adc.parent, RT_ADC_CMD_STREAM_CONFIG, &config), -RT_EINVAL);
+    uassert_int_equal(tc_stream_config(), RT_EOK);
+
+    /* the config is given to driver at start, and it can't be changed while running */
+    uassert_int_equal(rt_device_control(&tc_adc.parent, RT_ADC_CMD_STREAM_START, RT_NULL), RT_EOK);
+    uassert_true(adc_running);
+    uassert_int_equal(tc_config.channels[2], 16);
+    uassert_int_equal(tc_config.block_size, SCANS);
+    uassert_int_equal(tc_stream_config(), -RT_EBUSY);
+    uassert_int_equal(rt_device_control(&tc_adc.parent, RT_ADC_CMD_STREAM_STOP, RT_NULL), RT_EOK);
+    uassert_true(!adc_running);
+}
+
+/*
+ * The reader takes the odd sizes, and sleeps longer than the ring sometimes
+ * when slow. It checks the samples are in order, the dropped blocks are
+ * skipped as a whole, and the statistics add up.
+ */
+static void tc_stream_run(rt_bool_t slow)
+{
+    static rt_uint16_t buf[BLOCK_SAMPLES * 3];
+    struct rt_adc_stream_stats stats;
+    rt_uint32_t expect = 0, samples = 0, skipped = 0, errors = 0;
+    rt_uint32_t i, skip, finished;
+    rt_size_t size;
+
+    indications = bad_indications = 0;
+    uassert_int_equal(rt_device_control(&tc_adc.parent, RT_ADC_CMD_STREAM_START, RT_NULL), RT_EOK);
+
+    while (1)
+    {
+        finished = (produced == STREAM_BLOCKS);
+        /* the half sample in the odd size is ignored */
+        size = rt_device_read(&tc_adc.parent, 0, buf, (tc_random() % (BLOCK_SAMPLES * 3)) * 2 + 1);
+        if (size % sizeof(rt_uint16_t) != 0)
+            errors++;
+
+        for (i = 0; i < size / sizeof(rt_uint16_t); i++)
+        {
+            if (expect % BLOCK_SAMPLES == 0)
+            {
+                /* a new block, the dropped blocks before it are skipped */
+                if ((buf[i] & 0x7F) != 0)
+                    errors++;
+                skip = ((buf[i] >> 7) - expect / BLOCK_SAMPLES) & 0x1FF;
+                expect += skip * BLOCK_SAMPLES;
+                skipped += skip;
+            }
+            if (buf[i] != tc_sample(expect))
+                errors++;
+            expect++;
+        }
+        samples += size / sizeof(rt_uint16_t);
+
+        if (finished && size == 0)
+            break;
+        if (size == 0 || (slow && tc_random() % 16 == 0))
+            rt_thread_mdelay(slow ? 1 + tc_random() % (RT_ADC_STREAM_BLOCKS * 2) : 1);
+    }
+
+    uassert_int_equal(rt_device_control(&tc_adc.parent, RT_ADC_CMD_STREAM_GET_STATS, &stats), RT_EOK);
+    uassert_int_equal(rt_device_control(&tc_adc.parent, RT_ADC_CMD_STREAM_STOP, RT_NULL), RT_EOK);
+    rt_kprintf("adc stream %s: %d blocks, %d read, %d overruns, %d skipped\n", slow ? "slow" : "fast",
+               stats.blocks, samples / BLOCK_SAMPLES, stats.overruns, skipped);
+
+    uassert_int_equal(errors, 0);
+    uassert_int_equal(bad_indications, 0);
+    uassert_int_equal(stats.blocks, STREAM_BLOCKS);
+    uassert_int_equal(samples % BLOCK_SAMPLES, 0);
+    uassert_int_equal(samples / BLOCK_SAMPLES + stats.overruns, STREAM_BLOCKS);
+    uassert_int_equal(stats.samples_read, samples);
+    uassert_int_equal(indications, STREAM_BLOCKS - stats.overruns);
+    /* the trailing dropped blocks can't be seen by reader */
+    uassert_true(skipped <= stats.overruns);
+    if (slow)
+        uassert_true(stats.overruns > STREAM_BLOCKS / LOST_EVERY);
+    else
+        uassert_int_equal(stats.overruns, STREAM_BLOCKS / LOST_EVERY);
+}
+
+static void test_adc_stream_fast(void)
+{
+    tc_stream_run(RT_FALSE);
+}
+
+static void test_adc_stream_slow(void)
+{
+    tc_stream_run(RT_TRUE);
+}
+
+static void test_adc_stream_leave(void)
+{
+    rt_uint16_t buf[BLOCK_SAMPLES];
+    rt_uint32_t value;
+
+    /* the block done after stop is ignored */
+    rt_hw_adc_stream_done(&tc_adc, dma_buf);
+    uassert_int_equal(rt_device_read(&tc_adc.parent, 0, buf, sizeof(buf)), 0);
+
+    /* the null config leaves the stream mode */
+    uassert_int_equal(rt_device_control(&tc_adc.parent, RT_ADC_CMD_STREAM_CONFIG, RT_NULL), RT_EOK);
+    uassert_int_equal(rt_device_read(&tc_adc.parent, 2, &value, sizeof(value)), sizeof(value));
+    uassert_int_equal(value, 2);
+}
+
+static rt_err_t utest_tc_init(void)
+{
+    tc_srand(1);
+    tc_dma_init("tc_adc", dma_timeout, RT_NULL);
+    if (rt_hw_adc_register(&tc_adc, "tc_adc", &tc_adc_ops, RT_NULL) != RT_EOK)
+    {
+        tc_dma_detach();
+        return -RT_ERROR;
+    }
+    rt_device_set_rx_indicate(&tc_adc.parent, tc_rx_ind);
+    return rt_device_open(&tc_adc.parent, RT_DEVICE_OFLAG_RDONLY);
+}
+
+static rt_err_t utest_tc_cleanup(void)
+{
+    rt_device_control(&tc_adc.parent, RT_ADC_CMD_STREAM_STOP, RT_NULL);
+    rt_device_control(&tc_adc.parent, RT_ADC_CMD_STREAM_CONFIG, RT_NULL);
+    rt_device_close(&tc_adc.parent);
+    rt_device_unregister(&tc_adc.parent);
+    tc_dma_detach();
+    return RT_EOK;
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(test_adc_stream_config);
+    UTEST_UNIT_RUN(test_adc_stream_fast);
+    UTEST_UNIT_RUN(test_adc_stream_slow);
+    UTEST_UNIT_RUN(test_adc_stream_leave);
+}
+UTEST_TC_EXPORT(testcase, "testcases.drivers.adc_stream_tc", utest_tc_init, utest_tc_cleanup, 60);
@@ -0,0 +1,364 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <drivers/blk_cache.h>
+#include "utest.h"
+#include "tc_helper.h"
+
+#define SECTOR_SIZE     512
+#define SECTOR_NUM      64
+#define CACHE_SECTORS   8
+#define RANDOM_OPS      2000
+#define IOPS_OPS        200
+
+/* the RAM disk, every call costs one tick when the latency is set */
+static struct rt_device disk;
+static rt_uint8_t disk_data[SECTOR_NUM * SECTOR_SIZE];
+static rt_uint8_t ref_data[SECTOR_NUM * SECTOR_SIZE];
+static volatile rt_uint32_t disk_reads, disk_writes;
+static volatile int disk_fail, disk_latency;
+static rt_blk_cache_t cache;
+static rt_device_t dev;
+
+static rt_size_t disk_read(rt_device_t dev, rt_off_t pos, void *buffer, rt_size_t size)
+{
+    if (pos + size > SECTOR_NUM)
+        return 0;
+
+    if (disk_latency)
+        rt_thread_delay(1);
+    rt_memcpy(buffer, disk_data + pos * SECTOR_SIZE, size * SECTOR_SIZE);
+    disk_reads++;
+    return size;
+}
+
+static rt_size_t disk_write(rt_device_t dev, rt_off_t pos, const void *buffer, rt_size_t size)
+{
+    if (pos + size > SECTOR_NUM || disk_fail)
+        return 0;
+
+    if (disk_latency)
+        rt_thread_delay(1);
+    rt_memcpy(disk_data + pos * SECTOR_SIZE, buffer, size * SECTOR_SIZE);
+    disk_writes++;
+    return size;
+}
+
+static rt_err_t disk_control(rt_device_t dev, int cmd, void *args)
+{
+    struct rt_device_blk_geometry *geometry;
+
+    if (cmd == RT_DEVICE_CTRL_BLK_GETGEOME)
+    {
+        geometry = (struct rt_device_blk_geometry *)args;
+        geometry->bytes_per_sector = SECTOR_SIZE;
+        geometry->block_size = SECTOR_SIZE;
+        geometry->sector_count = SECTOR_NUM;
+    }
+    return RT_EOK;
+}
+
+#ifdef RT_USING_DEVICE_OPS
+const static struct rt_device_ops disk_ops =
+{
+    RT_NULL,
+    RT_NULL,
+    RT_NULL,
+    disk_read,
+    disk_write,
+    disk_control
+};
+#endif
+
+static void tc_fill(rt_uint8_t *buf, rt_size_t sectors)
+{
+    rt_size_t i;
+
+    for (i = 0; i < sectors * SECTOR_SIZE; i++)
+        buf[i] = (rt_uint8_t)tc_random();
+}
+
+static void tc_stats(struct rt_blk_cache_stats *stats)
+{
+    rt_device_control(dev, RT_BLK_CACHE_CTRL_GET_STATS, stats);
+}
+
+/* write back and drop all cached sectors, so the unit starts with an empty cache */
+static void tc_cache_drop(void)
+{
+    rt_uint32_t addrs[2] = {0, SECTOR_NUM - 1};
+
+    uassert_int_equal(rt_blk_cache_sync(cache), RT_EOK);
+    rt_device_control(dev, RT_DEVICE_CTRL_BLK_ERASE, addrs);
+    rt_device_control(dev, RT_BLK_CACHE_CTRL_RESET_STATS, RT_NULL);
+}
+
+static void test_blk_cache_rw(void)
+{
+    static rt_uint8_t buf[CACHE_SECTORS * SECTOR_SIZE];
+    rt_uint32_t sector, count;
+    int i, errors = 0;
+
+    /* the random reads and writes, some of them bypass the cache */
+    for (i = 0; i < RANDOM_OPS; i++)
+    {
+        count = 1 + tc_random() % 6;
+        sector = tc_random() % (SECTOR_NUM - count + 1);
+        if (tc_random() % 3 == 0)
+        {
+            tc_fill(buf, count);
+            rt_memcpy(ref_data + sector * SECTOR_SIZE, buf, count * SECTOR_SIZE);
+            if (rt_device_write(dev, sector, buf, count) != count)
+                errors++;
+        }
+        else
+        {
+            if (rt_device_read(dev, sector, buf, count) != count ||
+                rt_memcmp(buf, ref_data + sector * SECTOR_SIZE, count * SECTOR_SIZE) != 0)
+                errors++;
+        }
+    }
+    uassert_int_equal(errors, 0);
+
+    /* the disk is the same as the reference after sync */
+    uassert_int_equal(rt_blk_cache_sync(cache), RT_EOK);
+    uassert_buf_equal(disk_data, ref_data, sizeof(disk_data));
+}
+
+static void test_blk_cache_hits(void)
+{
+    struct rt_blk_cache_stats stats;
+    rt_uint8_t buf[SECTOR_SIZE];
+    rt_uint32_t reads;
+    int i;
+
+    tc_cache_drop();
+
+    /* the hot sectors are read from the device once */
+    reads = disk_reads;
+    for (i = 0; i < 40; i++)
+    {
+        rt_device_read(dev, 10 + (i % 4) * 10, buf, 1);
+        uassert_buf_equal(buf, disk_data + (10 + (i % 4) * 10) * SECTOR_SIZE, SECTOR_SIZE);
+    }
+    tc_stats(&stats);
+    uassert_int_equal(stats.misses, 4);
+    uassert_int_equal(stats.hits, 36);
+    uassert_int_equal(disk_reads - reads, 4);
+}
+
+#if RT_BLK_CACHE_READ_AHEAD > 0
+static void test_blk_cache_read_ahead(void)
+{
+    struct rt_blk_cache_stats stats;
+    rt_uint8_t buf[SECTOR_SIZE];
+    rt_uint32_t reads, count;
+
+    tc_cache_drop();
+
+    /* the second read is sequential, the next sectors are read in background */
+    rt_device_read(dev, 20, buf, 1);
+    rt_device_read(dev, 21, buf, 1);
+    rt_thread_mdelay(10);
+
+    count = RT_BLK_CACHE_READ_AHEAD;
+    if (count > CACHE_SECTORS / 2)
+        count = CACHE_SECTORS / 2;
+    tc_stats(&stats);
+    uassert_int_equal(stats.read_ahead, count);
+
+    reads = disk_reads;
+    rt_device_read(dev, 22, buf, 1);
+    uassert_buf_equal(buf, disk_data + 22 * SECTOR_SIZE, SECTOR_SIZE);
+    tc_stats(&stats);
+    uassert_int_equal(stats.hits, 1);
+    uassert_int_equal(disk_reads, reads);
+    rt_thread_mdelay(10);
+}
+#endif
+
+static void test_blk_cache_write_back(void)
+{
+    struct rt_blk_cache_stats stats;
+    rt_uint8_t buf[SECTOR_SIZE];
+    rt_uint32_t writes;
+    int i;
+
+    tc_cache_drop();
+
+    /* the repeated writes of a sector reach the device once */
+    writes = disk_writes;
+    for (i = 0; i < 3; i++)
+    {
+        tc_fill(buf, 1);
+        rt_device_write(dev, 30, buf, 1);
+    }
+    tc_stats(&stats);
+    uassert_int_equal(stats.writes, 3);
+    uassert_int_equal(stats.dirty, 1);
+    uassert_int_equal(disk_writes, writes);
+
+    uassert_int_equal(rt_device_control(dev, RT_DEVICE_CTRL_BLK_SYNC, RT_NULL), RT_EOK);
+    tc_stats(&stats);
+    uassert_int_equal(stats.dirty, 0);
+    uassert_int_equal(stats.write_backs, 1);
+    uassert_int_equal(disk_writes, writes + 1);
+    uassert_buf_equal(disk_data + 30 * SECTOR_SIZE, buf, SECTOR_SIZE);
+
+    /* the failed write back keeps the sector dirty */
+    disk_fail = 1;
+    tc_fill(buf, 1);
+    rt_device_write(dev, 31, buf, 1);
+    uassert_int_equal(rt_blk_cache_sync(cache), -RT_EIO);
+    tc_stats(&stats);
+    uassert_int_equal(stats.dirty, 1);
+
+#if RT_BLK_CACHE_FLUSH_MS > 0
+    /* the flush timer retries it until the device comes back */
+    rt_thread_mdelay(RT_BLK_CACHE_FLUSH_MS * 2);
+    tc_stats(&stats);
+    uassert_int_equal(stats.dirty, 1);
+    disk_fail = 0;
+    rt_thread_mdelay(RT_BLK_CACHE_FLUSH_MS * 2);
+    tc_stats(&stats);
+    uassert_int_equal(stats.dirty, 0);
+#else
+    disk_fail = 0;
+    uassert_int_equal(rt_blk_cache_sync(cache), RT_EOK);
+#endif
+    uassert_buf_equal(disk_data + 31 * SECTOR_SIZE, buf, SECTOR_SIZE);
+}
+
+static void test_blk_cache_bypass(void)
+{
+    struct rt_blk_cache_stats stats;
+    static rt_uint8_t buf[CACHE_SECTORS * SECTOR_SIZE];
+
+    tc_cache_drop();
+
+    /* the large read doesn't fill the cache */
+    rt_device_read(dev, 0, buf, CACHE_SECTORS);
+    uassert_buf_equal(buf, disk_data, CACHE_SECTORS * SECTOR_SIZE);
+    rt_device_read(dev, 2, buf, 1);
+    tc_stats(&stats);
+    uassert_int_equal(stats.bypass, CACHE_SECTORS);
+    uassert_int_equal(stats.hits, 0);
+
+    /* the large write drops the dirty sector it overwrites */
+    tc_fill(buf, 1);
+    rt_device_write(dev, 40, buf, 1);
+    tc_fill(buf, CACHE_SECTORS);
+    uassert_int_equal(rt_device_write(dev, 38, buf, CACHE_SECTORS), CACHE_SECTORS);
+    tc_stats(&stats);
+    uassert_int_equal(stats.dirty, 0);
+    uassert_buf_equal(disk_data + 38 * SECTOR_SIZE, buf, CACHE_SECTORS * SECTOR_SIZE);
+    rt_device_read(dev, 40, buf + SECTOR_SIZE, 1);
+    uassert_buf_equal(buf + SECTOR_SIZE, disk_data + 40 * SECTOR_SIZE, SECTOR_SIZE);
+}
+
+/* the small reads and writes in a working set smaller than the cache */
+static rt_tick_t tc_iops_run(rt_device_t device)
+{
+    rt_uint8_t buf[SECTOR_SIZE];
+    rt_tick_t tick;
+    rt_uint32_t sector;
+    int i;
+
+    tc_srand(1);
+    tick = rt_tick_get();
+    for (i = 0; i < IOPS_OPS; i++)
+    {
+        sector = 48 + tc_random() % (CACHE_SECTORS - 2);
+        if (i % 4 == 0)
+            rt_device_write(device, sector, buf, 1);
+        else
+            rt_device_read(device, sector, buf, 1);
+    }
+    if (device == dev)
+        rt_blk_cache_sync(cache);
+    tick = rt_tick_get() - tick;
+
+    return tick > 0 ? tick : 1;
+}
+
+static void test_blk_cache_iops(void)
+{
+    struct rt_blk_cache_stats stats;
+    rt_tick_t raw, cached;
+
+    tc_cache_drop();
+
+    disk_latency = 1;
+    raw = tc_iops_run(&disk);
+    cached = tc_iops_run(dev);
+    disk_latency = 0;
+
+    tc_stats(&stats);
+    rt_kprintf("blk cache: %d ops, raw %d ticks %d IOPS, cached %d ticks %d IOPS, %d hits %d misses %d write backs\n",
+               IOPS_OPS, raw, IOPS_OPS * RT_TICK_PER_SECOND / raw,
+               cached, IOPS_OPS * RT_TICK_PER_SECOND / cached,
+               stats.hits, stats.misses, stats.write_backs);
+    uassert_int_equal(stats.dirty, 0);
+    uassert_true(cached * 4 < raw);
+}
+
+static rt_err_t utest_tc_init(void)
+{
+    tc_srand(1);
+    disk_reads = disk_writes = 0;
+    disk_fail = disk_latency = 0;
+    tc_fill(disk_data, SECTOR_NUM);
+    rt_memcpy(ref_data, disk_data, sizeof(ref_data));
+
+    rt_memset(&disk, 0, sizeof(disk));
+    disk.type = RT_Device_Class_Block;
+#ifdef RT_USING_DEVICE_OPS
+    disk.ops = &disk_ops;
+#else
+    disk.read = disk_read;
+    disk.write = disk_write;
+    disk.control = disk_control;
+#endif
+    if (rt_device_register(&disk, "tc_disk", RT_DEVICE_FLAG_RDWR) != RT_EOK)
+        return -RT_ERROR;
+
+    cache = rt_blk_cache_create("tc_bc", "tc_disk", CACHE_SECTORS);
+    if (cache == RT_NULL)
+    {
+        rt_device_unregister(&disk);
+        return -RT_ERROR;
+    }
+    dev = &cache->parent;
+    return rt_device_open(dev, RT_DEVICE_OFLAG_RDWR);
+}
+
+static rt_err_t utest_tc_cleanup(void)
+{
+    disk_fail = 0;
+    rt_device_close(dev);
+    rt_blk_cache_delete(cache);
+    rt_device_unregister(&disk);
+    return RT_EOK;
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(test_blk_cache_rw);
+    UTEST_UNIT_RUN(test_blk_cache_hits);
+#if RT_BLK_CACHE_READ_AHEAD > 0
+    UTEST_UNIT_RUN(test_blk_cache_read_ahead);
+#endif
+    UTEST_UNIT_RUN(test_blk_cache_write_back);
+    UTEST_UNIT_RUN(test_blk_cache_bypass);
+    UTEST_UNIT_RUN(test_blk_cache_iops);
+}
+UTEST_TC_EXPORT(testcase, "testcases.drivers.blk_cache_tc", utest_tc_init, utest_tc_cleanup, 20);
@@ -0,0 +1,309 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <lwip/pbuf.h>
+#include <lwip/netifapi.h>
+#include <netif/ethernetif.h>
+#include "utest.h"
+#include "tc_helper.h"
+
+#define FRAME_NUM       5000
+#define FRAME_SIZE      64
+#define DMA_SLOTS       8
+/* the local experimental type, the frames of stack itself (DHCP) are not counted */
+#define FRAME_TYPE      0x88B5
+#define FRAME_SEQ_OFS   14
+
+/* the loopback Ethernet device, the DMA is finished in the handler of mock DMA */
+struct tc_eth
+{
+    struct eth_device parent;
+
+    rt_uint32_t next_seq;                   /* the sequence number of next frame sent */
+    rt_uint32_t sent;
+    rt_uint32_t errors;
+    rt_uint32_t kicks;
+#ifdef RT_LWIP_USING_ETH_TX_BATCH
+    struct pbuf *dma[DMA_SLOTS];
+    rt_uint32_t dma_count;
+    rt_uint32_t dma_started;
+#endif
+};
+
+static struct tc_eth tc_thread_eth, tc_direct_eth;
+#ifdef RT_LWIP_USING_ETH_TX_BATCH
+static struct tc_eth tc_batch_eth;
+#endif
+static struct rt_semaphore producer_done;
+static volatile rt_uint32_t switches;
+
+static void tc_frame_fill(rt_uint8_t *frame, rt_uint32_t seq)
+{
+    rt_memset(frame, 0, FRAME_SIZE);
+    frame[12] = FRAME_TYPE >> 8;
+    frame[13] = FRAME_TYPE & 0xFF;
+    rt_memcpy(frame + FRAME_SEQ_OFS, &seq, sizeof(seq));
+}
+
+/* the frames are sent in order, and no one is lost */
+static void tc_eth_check(struct tc_eth *eth, struct pbuf *p)
+{
+    rt_uint8_t type[2];
+    rt_uint32_t seq = 0;
+
+    pbuf_copy_partial(p, type, sizeof(type), 12);
+    if (type[0] != (FRAME_TYPE >> 8) || type[1] != (FRAME_TYPE & 0xFF))
+        return;
+
+    pbuf_copy_partial(p, &seq, sizeof(seq), FRAME_SEQ_OFS);
+    if (p->tot_len != FRAME_SIZE || seq != eth->next_seq)
+        eth->errors++;
+    eth->next_seq++;
+    eth->sent++;
+}
+
+static rt_err_t tc_eth_tx(rt_device_t dev, struct pbuf *p)
+{
+    struct tc_eth *eth = (struct tc_eth *)dev;
+
+#ifdef RT_LWIP_USING_ETH_TX_BATCH
+    if (eth->parent.flags & ETHIF_TX_BATCH)
+    {
+        /* the frame is kept until the DMA is finished */
+        if (eth->dma_count == DMA_SLOTS)
+            return -RT_EFULL;
+        eth->dma[eth->dma_count++] = p;
+        return RT_EOK;
+    }
+#endif
+
+    /* the frame is copied to DMA buffer */
+    tc_eth_check(eth, p);
+    return RT_EOK;
+}
+
+#ifdef RT_LWIP_USING_ETH_TX_BATCH
+static rt_err_t tc_eth_tx_kick(rt_device_t dev)
+{
+    struct tc_eth *eth = (struct tc_eth *)dev;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    eth->dma_started = eth->dma_count;
+    rt_hw_interrupt_enable(level);
+    eth->kicks++;
+    return RT_EOK;
+}
+
+/* the DMA finishes the frames kicked, and tells them in interrupt */
+static void dma_timeout(void *parameter)
+{
+    struct tc_eth *eth = &tc_batch_eth;
+    rt_uint32_t count, i;
+
+    count = eth->dma_started;
+    if (count == 0)
+        return;
+
+    for (i = 0; i < count; i++)
+        tc_eth_check(eth, eth->dma[i]);
+    for (i = count; i < eth->dma_count; i++)
+        eth->dma[i - count] = eth->dma[i];
+    eth->dma_count -= count;
+    eth->dma_started = 0;
+
+    eth_device_tx_done(&eth->parent, count);
+}
+#endif
+
+static void tc_switch_hook(rt_thread_t from, rt_thread_t to)
+{
+    switches++;
+}
+
+/* the producer runs as tcpip thread, above the Tx thread */
+static void producer_entry(void *parameter)
+{
+    struct netif *netif = (struct netif *)parameter;
+    struct pbuf *p;
+    rt_uint32_t seq;
+
+    for (seq = 0; seq < FRAME_NUM; seq++)
+    {
+        while ((p = pbuf_alloc(PBUF_RAW, FRAME_SIZE, PBUF_RAM)) == RT_NULL)
+            rt_thread_mdelay(1);
+        tc_frame_fill((rt_uint8_t *)p->payload, seq);
+
+        /* the batch is full, wait for the Tx thread */
+        while (netif->linkoutput(netif, p) == ERR_MEM)
+            rt_thread_mdelay(1);
+        pbuf_free(p);
+    }
+
+    rt_sem_release(&producer_done);
+}
+
+static void tc_eth_bench(struct tc_eth *eth, const char *mode)
+{
+    rt_thread_t thread;
+    rt_tick_t tick;
+    rt_uint32_t count;
+    int retry = 1000;
+
+    eth->next_seq = eth->sent = eth->errors = eth->kicks = 0;
+    switches = 0;
+    rt_scheduler_sethook(tc_switch_hook);
+    tick = rt_tick_get();
+
+    thread = rt_thread_create("tc_etp", producer_entry, eth->parent.netif, 2048,
+                              RT_LWIP_TCPTHREAD_PRIORITY, 10);
+    uassert_not_null(thread);
+    if (thread == RT_NULL)
+    {
+        rt_scheduler_sethook(RT_NULL);
+        return;
+    }
+    rt_thread_startup(thread);
+    rt_sem_take(&producer_done, RT_WAITING_FOREVER);
+    while (eth->sent < FRAME_NUM && --retry)
+        rt_thread_mdelay(1);
+
+    tick = rt_tick_get() - tick;
+    rt_scheduler_sethook(RT_NULL);
+    count = switches;
+
+    rt_kprintf("ethernetif tx %s: %d frames, %d ticks, %d.%02d switches/frame, %d.%02d kicks/frame\n",
+               mode, eth->sent, tick, count / FRAME_NUM, count * 100 / FRAME_NUM % 100,
+               eth->kicks / FRAME_NUM, eth->kicks * 100 / FRAME_NUM % 100);
+    uassert_int_equal(eth->sent, FRAME_NUM);
+    uassert_int_equal(eth->errors, 0);
+}
+
+static void test_ethernetif_tx_thread(void)
+{
+    /* the frame is sent by Tx thread, the caller waits for the ack */
+    tc_eth_bench(&tc_thread_eth, "thread");
+    uassert_true(switches >= FRAME_NUM * 2);
+}
+
+static void test_ethernetif_tx_direct(void)
+{
+    /* the frame is sent in the caller */
+    tc_eth_bench(&tc_direct_eth, "direct");
+    uassert_true(switches < FRAME_NUM / 10);
+}
+
+#ifdef RT_LWIP_USING_ETH_TX_BATCH
+static void test_ethernetif_tx_batch(void)
+{
+    struct netif *netif = tc_batch_eth.parent.netif;
+    struct pbuf *p;
+    rt_uint8_t data[FRAME_SIZE];
+
+    /* the frames are queued and kicked together, they are freed after DMA */
+    tc_eth_bench(&tc_batch_eth, "batch");
+    uassert_true(tc_batch_eth.kicks * 4 < FRAME_NUM);
+    uassert_true(switches < FRAME_NUM);
+    uassert_int_equal(tc_batch_eth.dma_count, 0);
+
+    /* the frame referencing the memory of caller is copied */
+    p = pbuf_alloc(PBUF_RAW, FRAME_SIZE, PBUF_REF);
+    uassert_not_null(p);
+    if (p == RT_NULL)
+        return;
+    tc_frame_fill(data, tc_batch_eth.next_seq);
+    p->payload = data;
+    uassert_int_equal(netif->linkoutput(netif, p), ERR_OK);
+    pbuf_free(p);
+    rt_memset(data + FRAME_SEQ_OFS, 0xFF, FRAME_SIZE - FRAME_SEQ_OFS);
+
+    rt_thread_mdelay(5);
+    uassert_int_equal(tc_batch_eth.sent, FRAME_NUM + 1);
+    uassert_int_equal(tc_batch_eth.errors, 0);
+}
+#endif
+
+static rt_err_t tc_eth_init(struct tc_eth *eth, const char *name, rt_uint16_t flags)
+{
+    rt_memset(eth, 0, sizeof(struct tc_eth));
+    eth->parent.eth_tx = tc_eth_tx;
+#ifdef RT_LWIP_USING_ETH_TX_BATCH
+    eth->parent.eth_tx_kick = tc_eth_tx_kick;
+#endif
+
+    /* the link is never up, so no IP packet is routed to it */
+    if (eth_device_init_with_flag(&eth->parent, name, flags | ETHIF_LINK_PHYUP) != RT_EOK)
+        return -RT_ERROR;
+    if (eth->parent.netif->state != eth)
+        return -RT_ERROR;
+
+    return RT_EOK;
+}
+
+static void tc_eth_deinit(struct tc_eth *eth)
+{
+    struct netif *netif = eth->parent.netif;
+
+    if (netif == RT_NULL)
+        return;
+
+    netifapi_netif_remove(netif);
+    rt_device_unregister(&eth->parent.parent);
+    rt_sem_detach(&eth->parent.tx_ack);
+#ifdef RT_LWIP_USING_ETH_TX_BATCH
+    rt_free(eth->parent.tx_batch);
+#endif
+    rt_free(netif);
+    eth->parent.netif = RT_NULL;
+}
+
+static rt_err_t utest_tc_init(void)
+{
+    /* the netif is added to the running stack */
+    if (rt_thread_find("tcpip") == RT_NULL)
+        return -RT_ERROR;
+
+    rt_sem_init(&producer_done, "tc_etp", 0, RT_IPC_FLAG_FIFO);
+    if (tc_eth_init(&tc_thread_eth, "u0", 0) != RT_EOK ||
+        tc_eth_init(&tc_direct_eth, "u1", ETHIF_TX_DIRECT) != RT_EOK)
+        return -RT_ERROR;
+#ifdef RT_LWIP_USING_ETH_TX_BATCH
+    if (tc_eth_init(&tc_batch_eth, "u2", ETHIF_TX_BATCH) != RT_EOK)
+        return -RT_ERROR;
+    tc_dma_init("tc_etd", dma_timeout, RT_NULL);
+    tc_dma_start();
+#endif
+    return RT_EOK;
+}
+
+static rt_err_t utest_tc_cleanup(void)
+{
+#ifdef RT_LWIP_USING_ETH_TX_BATCH
+    tc_dma_detach();
+    tc_eth_deinit(&tc_batch_eth);
+#endif
+    tc_eth_deinit(&tc_direct_eth);
+    tc_eth_deinit(&tc_thread_eth);
+    rt_sem_detach(&producer_done);
+    return RT_EOK;
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(test_ethernetif_tx_thread);
+    UTEST_UNIT_RUN(test_ethernetif_tx_direct);
+#ifdef RT_LWIP_USING_ETH_TX_BATCH
+    UTEST_UNIT_RUN(test_ethernetif_tx_batch);
+#endif
+}
+UTEST_TC_EXPORT(testcase, "testcases.drivers.ethernetif_tx_tc", utest_tc_init, utest_tc_cleanup, 60);
@@ -0,0 +1,436 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <drivers/mmcsd_core.h>
+#include "utest.h"
+
+#define CARD_SECTORS    1024
+#define LOG_SIZE        64
+#define STREAM_NUM      4
+#define STREAM_WRITES   64
+
+/*
+ * The time of card in us: 50 a command, 250 plus 52 a block for the data,
+ * and the busy time of write is less if the blocks are pre-erased.
+ */
+#define CARD_CMD_US             50
+#define CARD_DATA_US(blks)      (250 + (blks) * 52)
+#define CARD_BUSY_US(blks)      (900 + (blks) * 120)
+#define CARD_ERASED_US(blks)    (300 + (blks) * 40)
+
+struct tc_card_log
+{
+    rt_uint32_t cmd_code;
+    rt_uint32_t sector;
+    rt_uint32_t blks;
+};
+
+/* the SD card on a mock host, the requests are done in the caller */
+static struct rt_mmcsd_host *host;
+static struct rt_mmcsd_card *card;
+static rt_uint8_t *card_data;
+static rt_device_t dev;
+static rt_uint32_t card_us;
+static rt_uint32_t erase_count;
+static rt_bool_t app_cmd;
+static struct tc_card_log card_log[LOG_SIZE];
+static volatile int log_count;
+static volatile int card_hold;
+static struct rt_semaphore card_sem;
+static volatile int done_count;
+
+static void tc_card_data(struct rt_mmcsd_cmd *cmd, struct rt_mmcsd_data *data)
+{
+    rt_uint32_t sector = cmd->arg;
+
+    if (sector + data->blks > CARD_SECTORS)
+    {
+        data->err = -RT_EIO;
+        return;
+    }
+
+    if (log_count < LOG_SIZE)
+    {
+        card_log[log_count].cmd_code = cmd->cmd_code;
+        card_log[log_count].sector = sector;
+        card_log[log_count].blks = data->blks;
+        log_count++;
+    }
+
+    card_us += CARD_DATA_US(data->blks);
+    if (data->flags & DATA_DIR_WRITE)
+    {
+        rt_memcpy(card_data + (sector << 9), data->buf, data->blks << 9);
+        card_us += (erase_count == data->blks) ? CARD_ERASED_US(data->blks) : CARD_BUSY_US(data->blks);
+    }
+    else
+    {
+        rt_memcpy(data->buf, card_data + (sector << 9), data->blks << 9);
+    }
+    erase_count = 0;
+}
+
+static void tc_host_request(struct rt_mmcsd_host *host, struct rt_mmcsd_req *req)
+{
+    struct rt_mmcsd_cmd *cmd = req->cmd;
+
+    card_us += CARD_CMD_US;
+    switch (cmd->cmd_code)
+    {
+    case READ_SINGLE_BLOCK:
+    case READ_MULTIPLE_BLOCK:
+    case WRITE_BLOCK:
+    case WRITE_MULTIPLE_BLOCK:
+        tc_card_data(cmd, req->data);
+        break;
+    case APP_CMD:
+        cmd->resp[0] = R1_APP_CMD;
+        break;
+    case SD_APP_SET_WR_BLK_ERASE_COUNT:
+        if (app_cmd)
+            erase_count = cmd->arg;
+        break;
+    case SEND_STATUS:
+        cmd->resp[0] = R1_READY_FOR_DATA | (4 << 9);
+        break;
+    default:
+        break;
+    }
+    app_cmd = (cmd->cmd_code == APP_CMD);
+
+    if (req->stop)
+        card_us += CARD_CMD_US;
+
+    /* the card is busy until the test releases it */
+    if (card_hold)
+        rt_sem_take(&card_sem, RT_WAITING_FOREVER);
+    mmcsd_req_complete(host);
+}
+
+static const struct rt_mmcsd_host_ops tc_host_ops =
+{
+    tc_host_request,
+    RT_NULL,
+    RT_NULL,
+    RT_NULL,
+};
+
+static void tc_fill(rt_uint8_t *buf, rt_uint32_t sector, rt_uint8_t version)
+{
+    int i;
+
+    for (i = 0; i < 512; i++)
+        buf[i] = (rt_uint8_t)(sector + version + i);
+}
+
+static void tc_done(struct rt_mmcsd_blk_request *request)
+{
+    done_count++;
+}
+
+/* the first request is taken by the queue thread and waits in the card */
+static void tc_card_hold(struct rt_mmcsd_blk_request *request, rt_uint8_t *buf)
+{
+    card_hold = 1;
+    rt_mmcsd_blk_request_init(request, 0, buf, 1, 0, tc_done, RT_NULL);
+    uassert_int_equal(rt_mmcsd_blk_submit(dev, request), RT_EOK);
+    rt_thread_mdelay(2);
+    log_count = 0;
+}
+
+static void tc_card_release(void)
+{
+    card_hold = 0;
+    rt_sem_release(&card_sem);
+}
+
+static void tc_wait_done(int count)
+{
+    int retry = 1000;
+
+    while (done_count < count && --retry)
+        rt_thread_mdelay(1);
+}
+
+static void test_blk_queue_merge(void)
+{
+    static rt_uint8_t buf[5][512];
+    struct rt_mmcsd_blk_request first, request[4];
+    struct rt_mmcsd_blk_stats before, after;
+    static const rt_uint32_t sectors[4] = {12, 10, 13, 11};
+    int i, errors = 0;
+
+    rt_device_control(dev, RT_MMCSD_BLK_CTRL_GET_STATS, &before);
+    done_count = 0;
+    tc_card_hold(&first, buf[4]);
+
+    /* the writes of continuous sectors queued out of order */
+    for (i = 0; i < 4; i++)
+    {
+        tc_fill(buf[i], sectors[i], 1);
+        rt_mmcsd_blk_request_init(&request[i], sectors[i], buf[i], 1, 1, tc_done, RT_NULL);
+        uassert_int_equal(rt_mmcsd_blk_submit(dev, &request[i]), RT_EOK);
+    }
+    tc_card_release();
+    tc_wait_done(5);
+    uassert_int_equal(done_count, 5);
+
+    /* they are done by one multiple block write with pre-erase */
+    uassert_int_equal(log_count, 1);
+    uassert_int_equal(card_log[0].cmd_code, WRITE_MULTIPLE_BLOCK);
+    uassert_int_equal(card_log[0].sector, 10);
+    uassert_int_equal(card_log[0].blks, 4);
+    for (i = 0; i < 4; i++)
+    {
+        if (request[i].result != RT_EOK ||
+            rt_memcmp(card_data + (sectors[i] << 9), buf[i], 512) != 0)
+            errors++;
+    }
+    uassert_int_equal(errors, 0);
+
+    rt_device_control(dev, RT_MMCSD_BLK_CTRL_GET_STATS, &after);
+    uassert_int_equal(after.requests - before.requests, 5);
+    uassert_int_equal(after.merged - before.merged, 3);
+    uassert_int_equal(after.pre_erases - before.pre_erases, 1);
+    uassert_int_equal(after.depth, 0);
+    uassert_true(after.depth_max >= 4);
+}
+
+static void test_blk_queue_order(void)
+{
+    static rt_uint8_t buf[6][512], read_buf[1024];
+    struct rt_mmcsd_blk_request first, request[5];
+    int i;
+
+    done_count = 0;
+    tc_card_hold(&first, buf[5]);
+
+    /* C-SCAN from the last transfer, the read overlapped with an earlier write waits for it */
+    rt_mmcsd_blk_request_init(&request[0], 300, buf[0], 1, 0, tc_done, RT_NULL);
+    tc_fill(buf[1], 200, 2);
+    rt_mmcsd_blk_request_init(&request[1], 200, buf[1], 1, 1, tc_done, RT_NULL);
+    rt_mmcsd_blk_request_init(&request[2], 199, read_buf, 2, 0, tc_done, RT_NULL);
+    rt_mmcsd_blk_request_init(&request[3], 100, buf[3], 2, 0, tc_done, RT_NULL);
+    rt_mmcsd_blk_request_init(&request[4], 400, buf[4], 1, 0, tc_done, RT_NULL);
+    for (i = 0; i < 5; i++)
+        uassert_int_equal(rt_mmcsd_blk_submit(dev, &request[i]), RT_EOK);
+    tc_card_release();
+    tc_wait_done(6);
+    uassert_int_equal(done_count, 6);
+
+    uassert_int_equal(log_count, 5);
+    uassert_int_equal(card_log[0].sector, 100);
+    uassert_int_equal(card_log[1].sector, 200);
+    uassert_int_equal(card_log[1].cmd_code, WRITE_BLOCK);
+    uassert_int_equal(card_log[2].sector, 300);
+    uassert_int_equal(card_log[3].sector, 400);
+    /* the read is ready after the write, it's taken in the next scan */
+    uassert_int_equal(card_log[4].sector, 199);
+    uassert_int_equal(card_log[4].cmd_code, READ_MULTIPLE_BLOCK);
+    uassert_buf_equal(read_buf + 512, buf[1], 512);
+}
+
+static void test_blk_queue_wait(void)
+{
+    static rt_uint8_t buf[2][512];
+    struct rt_mmcsd_blk_request request;
+
+    /* the request without callback is waited, and the error is reported */
+    tc_fill(buf[0], 500, 3);
+    rt_mmcsd_blk_request_init(&request, 500, buf[0], 1, 1, RT_NULL, RT_NULL);
+    uassert_int_equal(rt_mmcsd_blk_submit(dev, &request), RT_EOK);
+    uassert_int_equal(rt_mmcsd_blk_request_wait(&request, RT_TICK_PER_SECOND), RT_EOK);
+
+    uassert_int_equal(rt_device_read(dev, 500, buf[1], 1), 1);
+    uassert_buf_equal(buf[1], buf[0], 512);
+
+    rt_mmcsd_blk_request_init(&request, CARD_SECTORS - 1, buf[0], 2, 0, RT_NULL, RT_NULL);
+    uassert_int_equal(rt_mmcsd_blk_submit(dev, &request), RT_EOK);
+    uassert_int_equal(rt_mmcsd_blk_request_wait(&request, RT_TICK_PER_SECOND), -RT_EIO);
+}
+
+static void tc_release_timeout(void *parameter)
+{
+    tc_card_release();
+}
+
+static void test_blk_queue_wait_timeout(void)
+{
+    static rt_uint8_t buf[2][512];
+    struct rt_mmcsd_blk_request first, request;
+    struct rt_mmcsd_blk_stats stats;
+    struct rt_timer timer;
+
+    done_count = 0;
+    tc_card_hold(&first, buf[1]);
+
+    /* the request not taken is removed on timeout, the card never sees it */
+    rt_mmcsd_blk_request_init(&request, 600, buf[0], 1, 0, RT_NULL, RT_NULL);
+    uassert_int_equal(rt_mmcsd_blk_submit(dev, &request), RT_EOK);
+    uassert_int_equal(rt_mmcsd_blk_request_wait(&request, 5), -RT_ETIMEOUT);
+    rt_device_control(dev, RT_MMCSD_BLK_CTRL_GET_STATS, &stats);
+    uassert_int_equal(stats.depth, 1);
+    tc_card_release();
+    tc_wait_done(1);
+    rt_thread_mdelay(5);
+    uassert_int_equal(done_count, 1);
+    uassert_int_equal(log_count, 0);
+
+    /* the request in transfer is waited until the card finishes it */
+    card_hold = 1;
+    rt_mmcsd_blk_request_init(&request, 600, buf[0], 1, 0, RT_NULL, RT_NULL);
+    uassert_int_equal(rt_mmcsd_blk_submit(dev, &request), RT_EOK);
+    rt_thread_mdelay(2);
+    rt_timer_init(&timer, "tc_sd", tc_release_timeout, RT_NULL, 20, RT_TIMER_FLAG_ONE_SHOT);
+    rt_timer_start(&timer);
+    uassert_int_equal(rt_mmcsd_blk_request_wait(&request, 5), RT_EOK);
+    rt_timer_detach(&timer);
+    uassert_int_equal(log_count, 1);
+    rt_device_control(dev, RT_MMCSD_BLK_CTRL_GET_STATS, &stats);
+    uassert_int_equal(stats.depth, 0);
+}
+
+/*
+ * The file system like writes: some files are appended by single sector at
+ * the same time. They are written one by one through the device, then all
+ * of them are submitted while the card is busy, and the throughput by the
+ * card time is printed.
+ */
+static void test_blk_queue_throughput(void)
+{
+    static struct rt_mmcsd_blk_request request[STREAM_NUM * STREAM_WRITES];
+    static rt_uint8_t buf[STREAM_NUM * STREAM_WRITES][512];
+    static rt_uint8_t hold_buf[512];
+    struct rt_mmcsd_blk_request first;
+    struct rt_mmcsd_blk_stats before, after;
+    rt_uint32_t sector, sync_us, queue_us, sync_rate, queue_rate;
+    int i, errors = 0;
+
+    for (i = 0; i < STREAM_NUM * STREAM_WRITES; i++)
+    {
+        sector = 600 + (i % STREAM_NUM) * 100 + i / STREAM_NUM;
+        tc_fill(buf[i], sector, 4);
+    }
+
+    card_us = 0;
+    for (i = 0; i < STREAM_NUM * STREAM_WRITES; i++)
+    {
+        sector = 600 + (i % STREAM_NUM) * 100 + i / STREAM_NUM;
+        if (rt_device_write(dev, sector, buf[i], 1) != 1)
+            errors++;
+    }
+    sync_us = card_us;
+
+    rt_device_control(dev, RT_MMCSD_BLK_CTRL_GET_STATS, &before);
+    done_count = 0;
+    /* the writes are queued while the card is busy with a read */
+    tc_card_hold(&first, hold_buf);
+    card_us = 0;
+    for (i = 0; i < STREAM_NUM * STREAM_WRITES; i++)
+    {
+        sector = 600 + (i % STREAM_NUM) * 100 + i / STREAM_NUM;
+        rt_mmcsd_blk_request_init(&request[i], sector, buf[i], 1, 1, tc_done, RT_NULL);
+        if (rt_mmcsd_blk_submit(dev, &request[i]) != RT_EOK)
+            errors++;
+    }
+    tc_card_release();
+    tc_wait_done(STREAM_NUM * STREAM_WRITES + 1);
+    queue_us = card_us;
+    rt_device_control(dev, RT_MMCSD_BLK_CTRL_GET_STATS, &after);
+
+    for (i = 0; i < STREAM_NUM * STREAM_WRITES; i++)
+    {
+        sector = 600 + (i % STREAM_NUM) * 100 + i / STREAM_NUM;
+        if (request[i].result != RT_EOK || rt_memcmp(card_data + (sector << 9), buf[i], 512) != 0)
+            errors++;
+    }
+    uassert_int_equal(errors, 0);
+    uassert_int_equal(done_count, STREAM_NUM * STREAM_WRITES + 1);
+
+    sync_rate = STREAM_NUM * STREAM_WRITES * 512 / 1024 * 1000 / (sync_us / 1000);
+    queue_rate = STREAM_NUM * STREAM_WRITES * 512 / 1024 * 1000 / (queue_us / 1000);
+    rt_kprintf("mmcsd queue: %d writes, one by one %d us %d KB/s, queued %d us %d KB/s, %d transfers %d merged %d pre-erases\n",
+               STREAM_NUM * STREAM_WRITES, sync_us, sync_rate, queue_us, queue_rate,
+               after.transfers - before.transfers, after.merged - before.merged,
+               after.pre_erases - before.pre_erases);
+    uassert_true(after.merged > before.merged);
+    uassert_true(queue_rate > sync_rate);
+}
+
+static rt_err_t utest_tc_init(void)
+{
+    /* don't touch the real card */
+    if (rt_device_find("sd0") != RT_NULL)
+        return -RT_EBUSY;
+
+    card_data = rt_calloc(CARD_SECTORS, 512);
+    host = mmcsd_alloc_host();
+    card = rt_calloc(1, sizeof(struct rt_mmcsd_card));
+    if (card_data == RT_NULL || host == RT_NULL || card == RT_NULL)
+        goto __error;
+
+    rt_sem_init(&card_sem, "tc_sd", 0, RT_IPC_FLAG_FIFO);
+    card_hold = 0;
+    app_cmd = RT_FALSE;
+    erase_count = 0;
+
+    host->ops = &tc_host_ops;
+    host->io_cfg.clock = 25000000;
+    host->card = card;
+    card->host = host;
+    card->rca = 1;
+    card->card_type = CARD_TYPE_SD;
+    card->flags = CARD_FLAG_SDHC;
+    card->card_capacity = CARD_SECTORS / 2;
+    card->card_blksize = 512;
+
+    /* no partition table, the whole card is sd0 */
+    if (rt_mmcsd_blk_probe(card) != RT_EOK)
+    {
+        rt_sem_detach(&card_sem);
+        goto __error;
+    }
+    dev = rt_device_find("sd0");
+    if (dev == RT_NULL)
+        return -RT_ERROR;
+    return rt_device_open(dev, RT_DEVICE_OFLAG_RDWR);
+
+__error:
+    rt_free(card);
+    if (host != RT_NULL)
+        mmcsd_free_host(host);
+    rt_free(card_data);
+    return -RT_ENOMEM;
+}
+
+static rt_err_t utest_tc_cleanup(void)
+{
+    rt_device_close(dev);
+    rt_mmcsd_blk_remove(card);
+    /* let the queue thread exit */
+    rt_thread_mdelay(10);
+    rt_sem_detach(&card_sem);
+    rt_free(card);
+    mmcsd_free_host(host);
+    rt_free(card_data);
+    return RT_EOK;
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(test_blk_queue_merge);
+    UTEST_UNIT_RUN(test_blk_queue_order);
+    UTEST_UNIT_RUN(test_blk_queue_wait);
+    UTEST_UNIT_RUN(test_blk_queue_wait_timeout);
+    UTEST_UNIT_RUN(test_blk_queue_throughput);
+}
+UTEST_TC_EXPORT(testcase, "testcases.drivers.mmcsd_blk_queue_tc", utest_tc_init, utest_tc_cleanup, 20);
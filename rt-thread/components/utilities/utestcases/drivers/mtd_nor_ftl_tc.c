@@ -0,0 +1,317 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <drivers/mtd_nor_ftl.h>
+#include "utest.h"
+#include "tc_helper.h"
+
+#define NOR_BLOCK_SIZE  4096
+#define NOR_BLOCKS      256
+#define NOR_PAGE_SIZE   256
+#define SECTOR_SIZE     RT_NOR_FTL_SECTOR_SIZE
+#define WORKLOAD_OPS    20000
+
+/* the time of W25Q64 in us, a page program is 0.7 ms and a block erase is 45 ms */
+#define NOR_READ_US(len)        (5 + (len) * 4 / 25)
+#define NOR_PROGRAM_US(len)     (((len) + NOR_PAGE_SIZE - 1) / NOR_PAGE_SIZE * 700 + (len) * 4 / 25)
+#define NOR_ERASE_US(len)       ((len) / NOR_BLOCK_SIZE * 45000)
+
+/* the NOR flash in RAM, the program only clears bits */
+static struct rt_mtd_nor_device nor;
+static rt_uint8_t *nor_data;
+static rt_uint64_t nor_us;
+static rt_nor_ftl_t ftl;
+static rt_uint16_t *versions;
+static rt_uint32_t used;
+static rt_uint32_t wa_half;
+
+static rt_err_t nor_read_id(struct rt_mtd_nor_device *device)
+{
+    return RT_EOK;
+}
+
+static rt_size_t nor_read(struct rt_mtd_nor_device *device, rt_off_t offset, rt_uint8_t *data, rt_uint32_t length)
+{
+    rt_memcpy(data, nor_data + offset, length);
+    nor_us += NOR_READ_US(length);
+    return length;
+}
+
+static rt_size_t nor_write(struct rt_mtd_nor_device *device, rt_off_t offset, const rt_uint8_t *data, rt_uint32_t length)
+{
+    rt_uint32_t i;
+
+    for (i = 0; i < length; i++)
+        nor_data[offset + i] &= data[i];
+    nor_us += NOR_PROGRAM_US(length);
+    return length;
+}
+
+static rt_err_t nor_erase_block(struct rt_mtd_nor_device *device, rt_off_t offset, rt_uint32_t length)
+{
+    if (offset % NOR_BLOCK_SIZE || length % NOR_BLOCK_SIZE)
+        return -RT_EINVAL;
+
+    rt_memset(nor_data + offset, 0xFF, length);
+    nor_us += NOR_ERASE_US(length);
+    return RT_EOK;
+}
+
+static const struct rt_mtd_nor_driver_ops nor_ops =
+{
+    nor_read_id,
+    nor_read,
+    nor_write,
+    nor_erase_block,
+};
+
+/* every word of sector holds its number and version */
+static void tc_fill(rt_uint8_t *buf, rt_uint32_t sector, rt_uint16_t version)
+{
+    int i;
+
+    for (i = 0; i < SECTOR_SIZE; i += 4)
+    {
+        buf[i] = sector & 0xFF;
+        buf[i + 1] = sector >> 8;
+        buf[i + 2] = version & 0xFF;
+        buf[i + 3] = version >> 8;
+    }
+}
+
+static rt_err_t tc_ftl_mount(void)
+{
+    ftl = rt_nor_ftl_create("tc_ftl", "tc_nor");
+    if (ftl == RT_NULL)
+        return -RT_ERROR;
+
+    return rt_device_open(&ftl->parent, RT_DEVICE_OFLAG_RDWR);
+}
+
+static void tc_ftl_unmount(void)
+{
+    if (ftl == RT_NULL)
+        return;
+
+    rt_device_close(&ftl->parent);
+    rt_nor_ftl_delete(ftl);
+    ftl = RT_NULL;
+}
+
+static int tc_ftl_write(rt_uint32_t sector, rt_uint32_t count)
+{
+    static rt_uint8_t buf[16 * SECTOR_SIZE];
+    rt_uint32_t i;
+
+    for (i = 0; i < count; i++)
+        tc_fill(buf + i * SECTOR_SIZE, sector + i, versions[sector + i] + 1);
+    if (rt_device_write(&ftl->parent, sector, buf, count) != count)
+        return -1;
+
+    for (i = 0; i < count; i++)
+        versions[sector + i]++;
+    return 0;
+}
+
+/* read back all used sectors, return the number of wrong ones */
+static int tc_ftl_verify(void)
+{
+    rt_uint8_t buf[SECTOR_SIZE], expect[SECTOR_SIZE];
+    rt_uint32_t sector;
+    int errors = 0;
+
+    for (sector = 0; sector < used; sector++)
+    {
+        tc_fill(expect, sector, versions[sector]);
+        if (rt_device_read(&ftl->parent, sector, buf, 1) != 1 ||
+            rt_memcmp(buf, expect, SECTOR_SIZE) != 0)
+            errors++;
+    }
+    return errors;
+}
+
+/* format the FTL and fill the percent of it */
+static int tc_ftl_prepare(int percent)
+{
+    rt_uint32_t sector, count;
+
+    tc_ftl_unmount();
+    rt_memset(nor_data, 0xFF, NOR_BLOCKS * NOR_BLOCK_SIZE);
+    if (tc_ftl_mount() != RT_EOK)
+        return -1;
+
+    used = ftl->sector_count * percent / 100;
+    rt_memset(versions, 0, ftl->sector_count * sizeof(rt_uint16_t));
+    for (sector = 0; sector < used; sector += count)
+    {
+        count = used - sector < 8 ? used - sector : 8;
+        if (tc_ftl_write(sector, count) != 0)
+            return -1;
+    }
+    return 0;
+}
+
+/*
+ * The FAT like workload on the filled FTL: a half of writes are the FAT and
+ * directory sectors, the others are the small writes of warm files and the
+ * large sequential writes. It prints the write amplification, and the
+ * throughput by the flash time against the in-place rewrite of 4 KB block.
+ */
+static void tc_ftl_workload(int percent)
+{
+    struct rt_nor_ftl_stats before, after;
+    rt_uint32_t sector, count, host, wa, rate, raw;
+    rt_uint64_t us;
+    int i, errors = 0;
+
+    if (tc_ftl_prepare(percent) != 0)
+    {
+        uassert_true(RT_FALSE);
+        return;
+    }
+
+    rt_device_control(&ftl->parent, RT_NOR_FTL_CTRL_GET_STATS, &before);
+    us = nor_us;
+    for (i = 0; i < WORKLOAD_OPS; i++)
+    {
+        count = tc_random() % 100;
+        if (count < 50)
+        {
+            sector = tc_random() % 64;
+            count = 1;
+        }
+        else if (count < 90)
+        {
+            sector = 64 + tc_random() % (used / 4);
+            count = 1 + tc_random() % 8;
+        }
+        else
+        {
+            sector = tc_random() % (used - 16);
+            count = 16;
+        }
+        if (sector + count > used)
+            count = used - sector;
+
+        if (tc_ftl_write(sector, count) != 0)
+            errors++;
+        /* let the garbage collection run in background */
+        if (i % 64 == 0)
+            rt_thread_mdelay(1);
+    }
+    rt_thread_mdelay(10);
+    rt_device_control(&ftl->parent, RT_NOR_FTL_CTRL_GET_STATS, &after);
+    us = nor_us - us;
+
+    host = after.host_writes - before.host_writes;
+    wa = (after.page_writes - before.page_writes) * 100 / host;
+    rate = (rt_uint32_t)((rt_uint64_t)host * SECTOR_SIZE * 1000000 / 1024 / us);
+    raw = (rt_uint32_t)((rt_uint64_t)SECTOR_SIZE * 1000000 / 1024 /
+                        (NOR_ERASE_US(NOR_BLOCK_SIZE) + NOR_PROGRAM_US(NOR_BLOCK_SIZE)));
+    rt_kprintf("nor ftl: %d%% full, %d host sectors, WA %d.%02d, %d erases, wear %d-%d, %d KB/s, in-place %d KB/s\n",
+               percent, host, wa / 100, wa % 100, after.erases - before.erases,
+               after.erase_min, after.erase_max, rate, raw);
+
+    uassert_int_equal(errors, 0);
+    uassert_int_equal(tc_ftl_verify(), 0);
+    uassert_true(wa >= 100);
+    uassert_true(rate > raw);
+    if (percent == 50)
+        wa_half = wa;
+    else
+        uassert_true(wa > wa_half);
+
+    /* the map is rebuilt from flash */
+    tc_ftl_unmount();
+    uassert_int_equal(tc_ftl_mount(), RT_EOK);
+    if (ftl != RT_NULL)
+    {
+        uassert_int_equal(ftl->blank, RT_FALSE);
+        uassert_int_equal(tc_ftl_verify(), 0);
+    }
+}
+
+static void test_nor_ftl_blank(void)
+{
+    rt_uint8_t buf[SECTOR_SIZE];
+    int i, errors = 0;
+
+    /* the blank flash is mounted, and the sector never written reads 0xFF */
+    tc_ftl_unmount();
+    rt_memset(nor_data, 0xFF, NOR_BLOCKS * NOR_BLOCK_SIZE);
+    uassert_int_equal(tc_ftl_mount(), RT_EOK);
+    if (ftl == RT_NULL)
+        return;
+
+    uassert_int_equal(ftl->blank, RT_TRUE);
+    uassert_int_equal(rt_device_read(&ftl->parent, 0, buf, 1), 1);
+    for (i = 0; i < SECTOR_SIZE; i++)
+    {
+        if (buf[i] != 0xFF)
+            errors++;
+    }
+    uassert_int_equal(errors, 0);
+}
+
+static void test_nor_ftl_half(void)
+{
+    tc_ftl_workload(50);
+}
+
+static void test_nor_ftl_three_quarters(void)
+{
+    tc_ftl_workload(75);
+}
+
+static void test_nor_ftl_full(void)
+{
+    tc_ftl_workload(90);
+}
+
+static rt_err_t utest_tc_init(void)
+{
+    tc_srand(1);
+    ftl = RT_NULL;
+    nor_data = (rt_uint8_t *)rt_malloc(NOR_BLOCKS * NOR_BLOCK_SIZE);
+    versions = (rt_uint16_t *)rt_malloc(NOR_BLOCKS * NOR_BLOCK_SIZE / SECTOR_SIZE * sizeof(rt_uint16_t));
+    if (nor_data == RT_NULL || versions == RT_NULL)
+    {
+        rt_free(versions);
+        rt_free(nor_data);
+        return -RT_ENOMEM;
+    }
+
+    rt_memset(&nor, 0, sizeof(nor));
+    nor.block_size = NOR_BLOCK_SIZE;
+    nor.block_start = 0;
+    nor.block_end = NOR_BLOCKS;
+    nor.ops = &nor_ops;
+    return rt_mtd_nor_register_device("tc_nor", &nor);
+}
+
+static rt_err_t utest_tc_cleanup(void)
+{
+    tc_ftl_unmount();
+    rt_device_unregister(&nor.parent);
+    rt_free(versions);
+    rt_free(nor_data);
+    return RT_EOK;
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(test_nor_ftl_blank);
+    UTEST_UNIT_RUN(test_nor_ftl_half);
+    UTEST_UNIT_RUN(test_nor_ftl_three_quarters);
+    UTEST_UNIT_RUN(test_nor_ftl_full);
+}
+UTEST_TC_EXPORT(testcase, "testcases.drivers.mtd_nor_ftl_tc", utest_tc_init, utest_tc_cleanup, 60);
@@ -0,0 +1,346 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+#include "sensor.h"
+#include "utest.h"
+#include "tc_helper.h"
+
+#define FIFO_MAX        32                              /* the watermark and the burst */
+#define HW_DEPTH        64                              /* the hardware fifo */
+#define ODR             100
+#define SAMPLE_TICKS    (RT_TICK_PER_SECOND / ODR)
+
+/* the interrupt handler of sensor framework, the driver raises it by the pin */
+extern void rt_sensor_cb(rt_sensor_t sen);
+
+/* the accelerometer with a hardware fifo, it samples in a hard timer */
+static struct rt_sensor_device tc_sensor;
+static struct rt_timer hw_timer;
+static rt_int32_t hw_fifo[HW_DEPTH];
+static rt_uint32_t hw_ticks[HW_DEPTH];
+static rt_uint32_t hw_count;
+static rt_uint32_t hw_overflow;
+static volatile rt_uint32_t hw_remaining;
+static rt_uint32_t hw_burst;                            /* the samples taken at once */
+static rt_int32_t hw_seq;
+static volatile rt_uint32_t indications;
+static volatile rt_uint32_t bad_indications;
+
+/* the burst read of the hardware fifo, z is the tick when it's sampled */
+static rt_size_t tc_fetch_data(struct rt_sensor_device *sensor, void *buf, rt_size_t len)
+{
+    struct rt_sensor_data *data = (struct rt_sensor_data *)buf;
+    rt_size_t count, i;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    count = hw_count < len ? hw_count : len;
+    for (i = 0; i < count; i++)
+    {
+        data[i].type = RT_SENSOR_CLASS_ACCE;
+        data[i].timestamp = 0;
+        data[i].data.acce.x = hw_fifo[i];
+        data[i].data.acce.y = -hw_fifo[i];
+        data[i].data.acce.z = hw_ticks[i];
+    }
+    for (i = count; i < hw_count; i++)
+    {
+        hw_fifo[i - count] = hw_fifo[i];
+        hw_ticks[i - count] = hw_ticks[i];
+    }
+    hw_count -= count;
+    rt_hw_interrupt_enable(level);
+
+    return count;
+}
+
+static rt_err_t tc_control(struct rt_sensor_device *sensor, int cmd, void *args)
+{
+    return RT_EOK;
+}
+
+static const struct rt_sensor_ops tc_sensor_ops =
+{
+    tc_fetch_data,
+    tc_control,
+};
+
+/* the sampling, the watermark interrupt is raised when the fifo reaches it */
+static void hw_timeout(void *parameter)
+{
+    rt_uint32_t i, last = hw_count;
+
+    for (i = 0; i < hw_burst && hw_remaining > 0; i++, hw_remaining--)
+    {
+        if (hw_count == HW_DEPTH)
+        {
+            /* the oldest one is overwritten */
+            rt_memmove(hw_fifo, hw_fifo + 1, (HW_DEPTH - 1) * sizeof(hw_fifo[0]));
+            rt_memmove(hw_ticks, hw_ticks + 1, (HW_DEPTH - 1) * sizeof(hw_ticks[0]));
+            hw_count--;
+            hw_overflow++;
+        }
+        hw_fifo[hw_count] = hw_seq++;
+        hw_ticks[hw_count] = rt_tick_get();
+        hw_count++;
+    }
+
+    if (last < FIFO_MAX && hw_count >= FIFO_MAX)
+        rt_sensor_cb(&tc_sensor);
+}
+
+static rt_err_t tc_rx_ind(rt_device_t dev, rt_size_t size)
+{
+    if (size == 0)
+        bad_indications++;
+    indications++;
+    return RT_EOK;
+}
+
+static void tc_hw_run(rt_uint32_t count, rt_uint32_t burst)
+{
+    hw_seq = 0;
+    hw_burst = burst;
+    hw_remaining = count;
+    indications = bad_indications = 0;
+}
+
+/* the samples are in order, return the number of the ones skipped */
+static rt_uint32_t tc_check(struct rt_sensor_data *data, rt_size_t count, rt_int32_t *next, rt_uint32_t *errors)
+{
+    rt_uint32_t gaps = 0;
+    rt_size_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        if (data[i].type != RT_SENSOR_CLASS_ACCE || data[i].data.acce.y != -data[i].data.acce.x ||
+            data[i].data.acce.x < *next)
+        {
+            (*errors)++;
+            continue;
+        }
+        gaps += data[i].data.acce.x - *next;
+        *next = data[i].data.acce.x + 1;
+    }
+    return gaps;
+}
+
+static void tc_get_stats(struct rt_sensor_fifo_stats *stats)
+{
+    uassert_int_equal(rt_device_control(&tc_sensor.parent, RT_SENSOR_CTRL_GET_FIFO_STATS, stats), RT_EOK);
+}
+
+static void test_sensor_fifo_paced(void)
+{
+    static struct rt_sensor_data buf[100];
+    struct rt_sensor_fifo_stats before, after;
+    rt_uint32_t total = FIFO_MAX * 40, got = 0, errors = 0, gaps = 0, wrong_ts = 0;
+    rt_int32_t next = 0;
+    rt_size_t count, i;
+
+    /* each watermark is drained in time, so the timestamps are exact */
+    tc_get_stats(&before);
+    tc_hw_run(total, 1);
+    while (got < total)
+    {
+        count = rt_device_read(&tc_sensor.parent, 0, buf, 1 + tc_random() % 100);
+        gaps += tc_check(buf, count, &next, &errors);
+        for (i = 0; i < count; i++)
+        {
+            if (buf[i].timestamp != (rt_uint32_t)buf[i].data.acce.z)
+                wrong_ts++;
+        }
+        got += count;
+        if (count == 0)
+            rt_thread_mdelay(SAMPLE_TICKS * FIFO_MAX / 2);
+    }
+    tc_get_stats(&after);
+
+    uassert_int_equal(errors, 0);
+    uassert_int_equal(gaps, 0);
+    uassert_int_equal(wrong_ts, 0);
+    uassert_int_equal(after.samples - before.samples, total);
+    uassert_int_equal(after.read - before.read, total);
+    uassert_int_equal(after.dropped - before.dropped, 0);
+    uassert_int_equal(after.batches - before.batches, total / FIFO_MAX);
+    uassert_int_equal(indications, total / FIFO_MAX);
+    uassert_int_equal(bad_indications, 0);
+}
+
+static void test_sensor_fifo_full(void)
+{
+    static struct rt_sensor_data buf[FIFO_MAX * 4];
+    struct rt_sensor_fifo_stats before, after;
+    rt_uint32_t total = FIFO_MAX * RT_SENSOR_FIFO_RING_BATCHES * 3, got = 0, errors = 0;
+    rt_int32_t next = 0;
+    rt_size_t count;
+
+    /* the reader sleeps, the ring is full and the newest batches are dropped */
+    tc_get_stats(&before);
+    tc_hw_run(total, 1);
+    while (hw_remaining > 0 || hw_count >= FIFO_MAX)
+        rt_thread_mdelay(SAMPLE_TICKS * FIFO_MAX);
+    rt_thread_mdelay(SAMPLE_TICKS);
+
+    while ((count = rt_device_read(&tc_sensor.parent, 0, buf, FIFO_MAX * 4)) > 0)
+    {
+        if (got == 0 && buf[0].data.acce.x != 0)
+            errors++;
+        tc_check(buf, count, &next, &errors);
+        got += count;
+    }
+    tc_get_stats(&after);
+    rt_kprintf("sensor fifo full: %d drained, %d kept, %d dropped\n",
+               after.samples - before.samples, got, after.dropped - before.dropped);
+
+    uassert_int_equal(errors, 0);
+    uassert_true(got >= FIFO_MAX * RT_SENSOR_FIFO_RING_BATCHES);
+    uassert_true(got < total);
+    uassert_int_equal(after.samples - before.samples, total);
+    uassert_int_equal(after.read - before.read, got);
+    uassert_int_equal(after.dropped - before.dropped, total - got);
+}
+
+static void test_sensor_fifo_late(void)
+{
+    static struct rt_sensor_data buf[FIFO_MAX * 2];
+    struct rt_sensor_fifo_stats before, after;
+    rt_uint32_t errors = 0, wrong_ts = 0;
+    rt_int32_t next = 0;
+    rt_size_t count, i;
+
+    /* the fifo is over the watermark when it's drained, it's read in two
+     * bursts, the last sample of the first one is at the interrupt */
+    tc_get_stats(&before);
+    tc_hw_run(FIFO_MAX + FIFO_MAX / 2, FIFO_MAX + FIFO_MAX / 2);
+    rt_thread_mdelay(SAMPLE_TICKS * 2);
+
+    count = rt_device_read(&tc_sensor.parent, 0, buf, FIFO_MAX * 2);
+    tc_get_stats(&after);
+    tc_check(buf, count, &next, &errors);
+    for (i = 0; i < count; i++)
+    {
+        if (buf[i].timestamp != buf[FIFO_MAX - 1].timestamp + ((rt_int32_t)i - (FIFO_MAX - 1)) * SAMPLE_TICKS)
+            wrong_ts++;
+    }
+
+    uassert_int_equal(count, FIFO_MAX + FIFO_MAX / 2);
+    uassert_int_equal(errors, 0);
+    uassert_int_equal(wrong_ts, 0);
+    uassert_int_equal(buf[FIFO_MAX - 1].timestamp, buf[0].data.acce.z);
+    uassert_int_equal(after.batches - before.batches, 2);
+    uassert_int_equal(indications, 2);
+}
+
+static void test_sensor_fifo_free_running(void)
+{
+    static struct rt_sensor_data buf[200];
+    struct rt_sensor_fifo_stats before, after;
+    rt_uint32_t total = 20011, got = 0, errors = 0, gaps = 0;
+    rt_int32_t next = 0;
+    rt_size_t count;
+
+    /* the hardware takes the samples in bursts and overflows, the reader is
+     * slow sometimes, every sample is read, dropped or lost by hardware */
+    tc_get_stats(&before);
+    hw_overflow = 0;
+    tc_hw_run(total, 1 + FIFO_MAX / 4);
+    while (1)
+    {
+        count = rt_device_read(&tc_sensor.parent, 0, buf, 1 + tc_random() % 200);
+        gaps += tc_check(buf, count, &next, &errors);
+        got += count;
+        if (count == 0)
+        {
+            if (hw_remaining == 0)
+            {
+                rt_thread_mdelay(SAMPLE_TICKS);
+                if (rt_device_read(&tc_sensor.parent, 0, buf, 1) == 0)
+                    break;
+                gaps += tc_check(buf, 1, &next, &errors);
+                got++;
+            }
+            rt_thread_mdelay(1 + tc_random() % (SAMPLE_TICKS * FIFO_MAX));
+        }
+    }
+    tc_get_stats(&after);
+    rt_kprintf("sensor fifo free: %d produced, %d read, %d dropped, %d hardware overflow, %d left\n",
+               total, got, after.dropped - before.dropped, hw_overflow, hw_count);
+
+    uassert_int_equal(errors, 0);
+    uassert_int_equal(after.read - before.read, got);
+    uassert_int_equal(after.samples - before.samples, got + after.dropped - before.dropped);
+    uassert_int_equal(total, got + after.dropped - before.dropped + hw_overflow + hw_count);
+    /* the tail below the watermark stays in the hardware fifo */
+    uassert_true(hw_count < FIFO_MAX);
+    uassert_true(gaps <= after.dropped - before.dropped + hw_overflow);
+    uassert_int_equal(bad_indications, 0);
+}
+
+static void test_sensor_fifo_close(void)
+{
+    struct rt_sensor_fifo_stats stats;
+
+    /* close stops the drain and frees the ring, the late interrupt is ignored */
+    uassert_int_equal(rt_device_close(&tc_sensor.parent), RT_EOK);
+    uassert_null(tc_sensor.fifo);
+    rt_sensor_cb(&tc_sensor);
+    uassert_true(rt_device_control(&tc_sensor.parent, RT_SENSOR_CTRL_GET_FIFO_STATS, &stats) != RT_EOK);
+}
+
+static rt_err_t utest_tc_init(void)
+{
+    tc_srand(1);
+    hw_count = 0;
+    hw_remaining = 0;
+
+    rt_memset(&tc_sensor, 0, sizeof(tc_sensor));
+    tc_sensor.info.type = RT_SENSOR_CLASS_ACCE;
+    tc_sensor.info.fifo_max = FIFO_MAX;
+    tc_sensor.config.irq_pin.pin = RT_PIN_NONE;
+    tc_sensor.ops = &tc_sensor_ops;
+    if (rt_hw_sensor_register(&tc_sensor, "tc", RT_DEVICE_FLAG_RDONLY | RT_DEVICE_FLAG_FIFO_RX, RT_NULL) != RT_EOK)
+        return -RT_ERROR;
+
+    if (rt_device_open(&tc_sensor.parent, RT_DEVICE_FLAG_FIFO_RX) != RT_EOK || tc_sensor.fifo == RT_NULL)
+    {
+        rt_device_unregister(&tc_sensor.parent);
+        return -RT_ERROR;
+    }
+    rt_device_set_rx_indicate(&tc_sensor.parent, tc_rx_ind);
+    rt_device_control(&tc_sensor.parent, RT_SENSOR_CTRL_SET_ODR, (void *)ODR);
+
+    rt_timer_init(&hw_timer, "tc_sen", hw_timeout, RT_NULL, SAMPLE_TICKS,
+                  RT_TIMER_FLAG_PERIODIC | RT_TIMER_FLAG_HARD_TIMER);
+    rt_timer_start(&hw_timer);
+    return RT_EOK;
+}
+
+static rt_err_t utest_tc_cleanup(void)
+{
+    rt_timer_detach(&hw_timer);
+    if (tc_sensor.parent.ref_count > 0)
+        rt_device_close(&tc_sensor.parent);
+    rt_device_unregister(&tc_sensor.parent);
+    return RT_EOK;
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(test_sensor_fifo_paced);
+    UTEST_UNIT_RUN(test_sensor_fifo_full);
+    UTEST_UNIT_RUN(test_sensor_fifo_late);
+    UTEST_UNIT_RUN(test_sensor_fifo_free_running);
+    UTEST_UNIT_RUN(test_sensor_fifo_close);
+}
+UTEST_TC_EXPORT(testcase, "testcases.drivers.sensor_fifo_tc", utest_tc_init, utest_tc_cleanup, 60);
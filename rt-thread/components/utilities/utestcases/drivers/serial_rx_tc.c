@@ -0,0 +1,300 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include "utest.h"
+
+#define FIFO_SIZE       100
+#define STREAM_SIZE     5000
+
+/* the fake uart, the bytes are received by interrupt or DMA in a hard timer */
+static struct rt_serial_device serial;
+static rt_device_t dev;
+static struct rt_timer isr_timer;
+static rt_uint8_t rx_seq, read_seq;
+static volatile int rx_pending;
+static int rx_getc_left;
+static rt_uint16_t dma_pos;
+static volatile rt_size_t indicated;
+
+static rt_err_t tc_configure(struct rt_serial_device *serial, struct serial_configure *cfg)
+{
+    return RT_EOK;
+}
+
+static rt_err_t tc_control(struct rt_serial_device *serial, int cmd, void *arg)
+{
+    /* the DMA writes the fifo from the start */
+    if (cmd == RT_DEVICE_CTRL_CONFIG && (rt_ubase_t)arg == RT_DEVICE_FLAG_DMA_RX)
+        dma_pos = 0;
+    return RT_EOK;
+}
+
+static int tc_putc(struct rt_serial_device *serial, char c)
+{
+    return 1;
+}
+
+static int tc_getc(struct rt_serial_device *serial)
+{
+    if (rx_getc_left == 0)
+        return -1;
+
+    rx_getc_left--;
+    return rx_seq++;
+}
+
+static rt_size_t tc_dma_transmit(struct rt_serial_device *serial, rt_uint8_t *buf, rt_size_t size, int direction)
+{
+    return 0;
+}
+
+static const struct rt_uart_ops tc_uart_ops =
+{
+    tc_configure,
+    tc_control,
+    tc_putc,
+    tc_getc,
+    tc_dma_transmit,
+};
+
+/* receive the pending bytes as the uart interrupt does */
+static void isr_timeout(void *parameter)
+{
+    struct rt_serial_rx_fifo *rx_fifo = (struct rt_serial_rx_fifo *)serial.serial_rx;
+    int length, count, i;
+
+    if (dev->open_flag & RT_DEVICE_FLAG_INT_RX)
+    {
+        rx_getc_left = rx_pending;
+        rt_hw_serial_isr(&serial, RT_SERIAL_EVENT_RX_IND);
+    }
+    else
+    {
+        /* the DMA writes the ring, then reports the length by IDLE interrupt */
+        length = rx_pending;
+        while (length > 0)
+        {
+            count = length;
+            if (count > serial.config.bufsz - dma_pos)
+                count = serial.config.bufsz - dma_pos;
+            for (i = 0; i < count; i++)
+                rx_fifo->buffer[dma_pos + i] = rx_seq++;
+            dma_pos = (dma_pos + count) % serial.config.bufsz;
+            length -= count;
+            rt_hw_serial_isr(&serial, RT_SERIAL_EVENT_RX_DMADONE | (count << 8));
+        }
+    }
+    rx_pending = 0;
+}
+
+static void tc_receive(int length)
+{
+    rx_pending = length;
+    rt_timer_start(&isr_timer);
+    while (rx_pending)
+        rt_thread_mdelay(1);
+    /* the rx indication may be done in the bottom half */
+    rt_thread_mdelay(1);
+}
+
+static rt_err_t tc_rx_ind(rt_device_t dev, rt_size_t size)
+{
+    indicated = size;
+    return RT_EOK;
+}
+
+/* read the data and check they are in order, the lost bytes are skipped */
+static int tc_read_check(rt_uint8_t *buf, rt_size_t size, rt_uint32_t lost)
+{
+    rt_size_t length, i;
+    int errors = 0;
+
+    read_seq += lost;
+    length = rt_device_read(dev, 0, buf, size);
+    for (i = 0; i < length; i++)
+    {
+        if (buf[i] != read_seq++)
+            errors++;
+    }
+    return errors ? -1 : (int)length;
+}
+
+static rt_err_t tc_open(rt_uint16_t oflag)
+{
+    rx_seq = read_seq = 0;
+    indicated = 0;
+    if (rt_device_control(dev, RT_SERIAL_CTRL_SET_RX_BUFSZ, (void *)FIFO_SIZE) != RT_EOK)
+        return -RT_ERROR;
+    if (rt_device_open(dev, oflag) != RT_EOK)
+        return -RT_ERROR;
+
+    rt_device_set_rx_indicate(dev, tc_rx_ind);
+    return RT_EOK;
+}
+
+static void test_serial_rx_bufsz(void)
+{
+    struct rt_serial_rx_stats stats;
+
+    /* the zero and oversized fifo are refused */
+    uassert_int_equal(rt_device_control(dev, RT_SERIAL_CTRL_SET_RX_BUFSZ, (void *)0), -RT_EINVAL);
+    uassert_int_equal(rt_device_control(dev, RT_SERIAL_CTRL_SET_RX_BUFSZ, (void *)0x10000), -RT_EINVAL);
+    /* no fifo before it's opened */
+    uassert_int_equal(rt_device_control(dev, RT_SERIAL_CTRL_GET_RX_STATS, &stats), -RT_ERROR);
+
+    uassert_int_equal(tc_open(RT_DEVICE_FLAG_INT_RX), RT_EOK);
+    uassert_int_equal(rt_device_control(dev, RT_SERIAL_CTRL_SET_RX_BUFSZ, (void *)200), -RT_EBUSY);
+    uassert_int_equal(rt_device_control(dev, RT_SERIAL_CTRL_GET_RX_STATS, &stats), RT_EOK);
+    uassert_int_equal(stats.bufsz, FIFO_SIZE);
+    uassert_int_equal(stats.received, 0);
+    rt_device_close(dev);
+}
+
+static void test_serial_rx_stream(rt_uint16_t oflag)
+{
+    struct rt_serial_rx_stats stats;
+    rt_uint8_t buf[FIFO_SIZE];
+    int total = 0, length, chunk, peak = 0;
+
+    uassert_int_equal(tc_open(oflag), RT_EOK);
+
+    while (total < STREAM_SIZE)
+    {
+        chunk = 1 + total % 61;
+        if (chunk > peak)
+            peak = chunk;
+        tc_receive(chunk);
+        uassert_int_equal(indicated, chunk);
+        length = tc_read_check(buf, sizeof(buf), 0);
+        uassert_int_equal(length, chunk);
+        if (length <= 0)
+            break;
+        total += length;
+    }
+
+    rt_device_control(dev, RT_SERIAL_CTRL_GET_RX_STATS, &stats);
+    uassert_int_equal(stats.received, total);
+    uassert_int_equal(stats.overflows, 0);
+    uassert_int_equal(stats.peak, peak);
+    rt_device_close(dev);
+}
+
+static void test_serial_int_rx(void)
+{
+    test_serial_rx_stream(RT_DEVICE_FLAG_INT_RX);
+}
+
+static void test_serial_rx_overflow(void)
+{
+    struct rt_serial_rx_stats stats;
+    rt_uint8_t buf[FIFO_SIZE];
+
+    uassert_int_equal(tc_open(RT_DEVICE_FLAG_INT_RX), RT_EOK);
+
+    /* the oldest bytes are overwritten and counted */
+    tc_receive(FIFO_SIZE - 10);
+    tc_receive(30);
+    rt_device_control(dev, RT_SERIAL_CTRL_GET_RX_STATS, &stats);
+    uassert_int_equal(stats.received, FIFO_SIZE + 20);
+    uassert_true(stats.overflows >= 1);
+    uassert_int_equal(stats.lost, 20);
+    uassert_int_equal(stats.peak, FIFO_SIZE);
+
+    /* the newest bytes of the whole fifo are kept */
+    uassert_int_equal(tc_read_check(buf, sizeof(buf), stats.lost), FIFO_SIZE);
+    uassert_int_equal(tc_read_check(buf, sizeof(buf), 0), 0);
+    rt_device_close(dev);
+}
+
+static void test_serial_rx_peek(void)
+{
+    rt_uint8_t *span;
+    rt_size_t length, i;
+    int errors = 0;
+
+    uassert_int_equal(tc_open(RT_DEVICE_FLAG_INT_RX), RT_EOK);
+
+    /* the span stops at the end of fifo */
+    tc_receive(70);
+    length = rt_serial_rx_peek(&serial, &span);
+    uassert_int_equal(length, 70);
+    uassert_int_equal(rt_serial_rx_consume(&serial, length), 70);
+    read_seq += 70;
+
+    tc_receive(50);
+    length = rt_serial_rx_peek(&serial, &span);
+    uassert_int_equal(length, FIFO_SIZE - 70);
+    for (i = 0; i < length; i++)
+    {
+        if (span[i] != read_seq++)
+            errors++;
+    }
+    uassert_int_equal(errors, 0);
+    uassert_int_equal(rt_serial_rx_consume(&serial, length), FIFO_SIZE - 70);
+    length = rt_serial_rx_peek(&serial, &span);
+    uassert_int_equal(length, 20);
+    uassert_true(span == ((struct rt_serial_rx_fifo *)serial.serial_rx)->buffer);
+
+    /* the span peeked before the overflow can't be consumed */
+    tc_receive(FIFO_SIZE);
+    uassert_int_equal(rt_serial_rx_consume(&serial, length), 0);
+    length = rt_serial_rx_peek(&serial, &span);
+    uassert_int_equal(rt_serial_rx_consume(&serial, length), length);
+
+    rt_device_close(dev);
+}
+
+#ifdef RT_SERIAL_USING_DMA
+static void test_serial_dma_rx(void)
+{
+    test_serial_rx_stream(RT_DEVICE_FLAG_DMA_RX);
+}
+#endif
+
+static rt_err_t utest_tc_init(void)
+{
+    struct serial_configure config = RT_SERIAL_CONFIG_DEFAULT;
+    rt_uint32_t flag = RT_DEVICE_FLAG_RDWR | RT_DEVICE_FLAG_INT_RX;
+
+#ifdef RT_SERIAL_USING_DMA
+    flag |= RT_DEVICE_FLAG_DMA_RX;
+#endif
+    rt_memset(&serial, 0, sizeof(serial));
+    serial.ops = &tc_uart_ops;
+    serial.config = config;
+    if (rt_hw_serial_register(&serial, "tc_uart", flag, RT_NULL) != RT_EOK)
+        return -RT_ERROR;
+    dev = &serial.parent;
+
+    rt_timer_init(&isr_timer, "tc_uart", isr_timeout, RT_NULL, 1,
+                  RT_TIMER_FLAG_ONE_SHOT | RT_TIMER_FLAG_HARD_TIMER);
+    return RT_EOK;
+}
+
+static rt_err_t utest_tc_cleanup(void)
+{
+    rt_timer_detach(&isr_timer);
+    rt_device_unregister(dev);
+    return RT_EOK;
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(test_serial_rx_bufsz);
+    UTEST_UNIT_RUN(test_serial_int_rx);
+    UTEST_UNIT_RUN(test_serial_rx_overflow);
+    UTEST_UNIT_RUN(test_serial_rx_peek);
+#ifdef RT_SERIAL_USING_DMA
+    UTEST_UNIT_RUN(test_serial_dma_rx);
+#endif
+}
+UTEST_TC_EXPORT(testcase, "testcases.drivers.serial_rx_tc", utest_tc_init, utest_tc_cleanup, 20);
@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include "utest.h"
+#include "tc_helper.h"
+
+#define SENT_SIZE       2048
+#define BURST_TICKS     2
+
+/* the fake uart, the DMA burst is done in the handler of mock DMA */
+static struct rt_serial_device serial;
+static rt_device_t dev;
+static rt_uint8_t sent[SENT_SIZE];
+static volatile rt_size_t sent_len;
+static volatile rt_size_t burst_len;
+static volatile int burst_ticks;
+static volatile int dma_fail;
+static volatile int dma_lost;
+static volatile int dma_stopped;
+static volatile int tx_completed;
+static rt_uint8_t isr_data[RT_SERIAL_TX_DMA_BUFSZ + 64];
+static volatile int isr_written;
+
+static rt_err_t tc_configure(struct rt_serial_device *serial, struct serial_configure *cfg)
+{
+    return RT_EOK;
+}
+
+static rt_err_t tc_control(struct rt_serial_device *serial, int cmd, void *arg)
+{
+    /* stop the tx DMA */
+    if (cmd == RT_DEVICE_CTRL_CLR_INT && (rt_ubase_t)arg == RT_DEVICE_FLAG_DMA_TX)
+    {
+        burst_len = 0;
+        dma_stopped++;
+    }
+    return RT_EOK;
+}
+
+static int tc_putc(struct rt_serial_device *serial, char c)
+{
+    return 1;
+}
+
+static int tc_getc(struct rt_serial_device *serial)
+{
+    return -1;
+}
+
+static rt_size_t tc_dma_transmit(struct rt_serial_device *serial, rt_uint8_t *buf, rt_size_t size, int direction)
+{
+    if (dma_fail || burst_len != 0)
+        return 0;
+
+    /* the data is read at the end of burst, it must stay in the ring */
+    burst_len = size;
+    burst_ticks = BURST_TICKS;
+    return size;
+}
+
+static const struct rt_uart_ops tc_uart_ops =
+{
+    tc_configure,
+    tc_control,
+    tc_putc,
+    tc_getc,
+    tc_dma_transmit,
+};
+
+static void dma_timeout(void *parameter)
+{
+    struct rt_serial_tx_dma *tx_dma = (struct rt_serial_tx_dma *)serial.serial_tx;
+    rt_size_t length;
+
+    if (burst_len == 0 || dma_lost || --burst_ticks > 0)
+        return;
+
+    length = burst_len;
+    if (sent_len + length <= SENT_SIZE)
+        rt_memcpy(sent + sent_len, tx_dma->buffer + tx_dma->get_index, length);
+    sent_len += length;
+    burst_len = 0;
+    rt_hw_serial_isr(&serial, RT_SERIAL_EVENT_TX_DMADONE);
+}
+
+static rt_err_t tc_tx_done(rt_device_t dev, void *buffer)
+{
+    tx_completed++;
+    return RT_EOK;
+}
+
+static void tc_open(void)
+{
+    sent_len = 0;
+    burst_len = 0;
+    dma_fail = 0;
+    dma_lost = 0;
+    dma_stopped = 0;
+    tx_completed = 0;
+    uassert_int_equal(rt_device_open(dev, RT_DEVICE_FLAG_DMA_TX), RT_EOK);
+    rt_device_set_tx_complete(dev, tc_tx_done);
+}
+
+static void tc_wait_sent(rt_size_t length)
+{
+    int retry = 1000;
+
+    while (sent_len < length && --retry)
+        rt_thread_mdelay(1);
+}
+
+static void tc_fill(rt_uint8_t *buf, rt_size_t size, rt_uint8_t seed)
+{
+    rt_size_t i;
+
+    for (i = 0; i < size; i++)
+        buf[i] = (rt_uint8_t)(seed + i * 7);
+}
+
+static void test_serial_tx_coalesce(void)
+{
+    struct rt_serial_tx_stats stats;
+    rt_uint8_t data[50];
+    int i;
+
+    tc_open();
+    tc_fill(data, sizeof(data), 1);
+
+    /* the writes queued during the first burst are sent in one burst */
+    for (i = 0; i < 10; i++)
+        uassert_int_equal(rt_device_write(dev, 0, data + i * 5, 5), 5);
+    tc_wait_sent(sizeof(data));
+
+    uassert_int_equal(sent_len, sizeof(data));
+    uassert_buf_equal(sent, data, sizeof(data));
+    rt_device_control(dev, RT_SERIAL_CTRL_GET_TX_STATS, &stats);
+    uassert_int_equal(stats.written, sizeof(data));
+    uassert_int_equal(stats.bursts, 2);
+    uassert_int_equal(stats.full, 0);
+    uassert_int_equal(stats.dropped, 0);
+    rt_thread_mdelay(BURST_TICKS + 1);
+    uassert_int_equal(tx_completed, 1);
+
+    rt_device_close(dev);
+}
+
+static void test_serial_tx_full(void)
+{
+    struct rt_serial_tx_stats stats;
+    static rt_uint8_t data[1000];
+
+    tc_open();
+    tc_fill(data, sizeof(data), 3);
+
+    /* the writer waits for the free space, the ring wraps around */
+    uassert_int_equal(rt_device_write(dev, 0, data, 7), 7);
+    uassert_int_equal(rt_device_write(dev, 0, data + 7, sizeof(data) - 7), sizeof(data) - 7);
+    tc_wait_sent(sizeof(data));
+
+    uassert_int_equal(sent_len, sizeof(data));
+    uassert_buf_equal(sent, data, sizeof(data));
+    rt_device_control(dev, RT_SERIAL_CTRL_GET_TX_STATS, &stats);
+    uassert_int_equal(stats.written, sizeof(data));
+    uassert_true(stats.full > 0);
+    uassert_true(stats.bursts < 10);
+
+    rt_device_close(dev);
+}
+
+static void isr_timeout(void *parameter)
+{
+    isr_written = rt_device_write(dev, 0, isr_data, sizeof(isr_data));
+}
+
+static void test_serial_tx_isr(void)
+{
+    struct rt_timer isr_timer;
+
+    tc_open();
+    tc_fill(isr_data, sizeof(isr_data), 5);
+
+    /* the write in ISR never waits, only the ring is queued */
+    isr_written = -1;
+    rt_timer_init(&isr_timer, "tc_utx", isr_timeout, RT_NULL, 1,
+                  RT_TIMER_FLAG_ONE_SHOT | RT_TIMER_FLAG_HARD_TIMER);
+    rt_timer_start(&isr_timer);
+    rt_thread_mdelay(2);
+    rt_timer_detach(&isr_timer);
+
+    uassert_int_equal(isr_written, RT_SERIAL_TX_DMA_BUFSZ);
+    tc_wait_sent(RT_SERIAL_TX_DMA_BUFSZ);
+    uassert_int_equal(sent_len, RT_SERIAL_TX_DMA_BUFSZ);
+    uassert_buf_equal(sent, isr_data, RT_SERIAL_TX_DMA_BUFSZ);
+
+    rt_device_close(dev);
+}
+
+static void test_serial_tx_fail(void)
+{
+    struct rt_serial_tx_stats stats;
+    struct rt_serial_tx_dma *tx_dma;
+    rt_uint8_t data[20];
+
+    tc_open();
+    tc_fill(data, sizeof(data), 7);
+
+    /* the bytes of failed burst are dropped, not left in the ring */
+    dma_fail = 1;
+    uassert_int_equal(rt_device_write(dev, 0, data, sizeof(data)), 0);
+    uassert_int_equal(rt_get_errno(), -RT_EIO);
+    tx_dma = (struct rt_serial_tx_dma *)serial.serial_tx;
+    uassert_int_equal(tx_dma->count, 0);
+    uassert_int_equal(tx_dma->activated, RT_FALSE);
+    rt_device_control(dev, RT_SERIAL_CTRL_GET_TX_STATS, &stats);
+    uassert_int_equal(stats.dropped, sizeof(data));
+    uassert_int_equal(stats.bursts, 0);
+
+    /* the next write is sent */
+    dma_fail = 0;
+    uassert_int_equal(rt_device_write(dev, 0, data, sizeof(data)), sizeof(data));
+    tc_wait_sent(sizeof(data));
+    uassert_int_equal(sent_len, sizeof(data));
+    uassert_buf_equal(sent, data, sizeof(data));
+
+    rt_device_close(dev);
+}
+
+static void test_serial_tx_close(void)
+{
+    static rt_uint8_t data[600];
+
+    tc_open();
+    tc_fill(data, sizeof(data), 9);
+
+    /* the close waits for the queued bytes sent before the ring is freed */
+    uassert_int_equal(rt_device_write(dev, 0, data, sizeof(data)), sizeof(data));
+    uassert_true(sent_len < sizeof(data));
+    rt_device_close(dev);
+    uassert_int_equal(sent_len, sizeof(data));
+    uassert_buf_equal(sent, data, sizeof(data));
+    uassert_null(serial.serial_tx);
+    uassert_int_equal(dma_stopped, 0);
+}
+
+static void test_serial_tx_close_lost(void)
+{
+    rt_uint8_t data[100];
+    rt_tick_t tick;
+
+    tc_open();
+    tc_fill(data, sizeof(data), 11);
+
+    /* the tx done interrupt never comes, the close stops the DMA in time */
+    dma_lost = 1;
+    uassert_int_equal(rt_device_write(dev, 0, data, sizeof(data)), sizeof(data));
+    tick = rt_tick_get();
+    rt_device_close(dev);
+    tick = rt_tick_get() - tick;
+    uassert_int_equal(dma_stopped, 1);
+    uassert_int_equal(burst_len, 0);
+    uassert_null(serial.serial_tx);
+    uassert_true(tick >= rt_tick_from_millisecond(10));
+    uassert_true(tick <= rt_tick_from_millisecond(100));
+}
+
+static rt_err_t utest_tc_init(void)
+{
+    struct serial_configure config = RT_SERIAL_CONFIG_DEFAULT;
+
+    rt_memset(&serial, 0, sizeof(serial));
+    serial.ops = &tc_uart_ops;
+    serial.config = config;
+    if (rt_hw_serial_register(&serial, "tc_utx", RT_DEVICE_FLAG_RDWR | RT_DEVICE_FLAG_DMA_TX, RT_NULL) != RT_EOK)
+        return -RT_ERROR;
+    dev = &serial.parent;
+
+    tc_dma_init("tc_dma", dma_timeout, RT_NULL);
+    tc_dma_start();
+    return RT_EOK;
+}
+
+static rt_err_t utest_tc_cleanup(void)
+{
+    tc_dma_detach();
+    rt_device_unregister(dev);
+    return RT_EOK;
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(test_serial_tx_coalesce);
+    UTEST_UNIT_RUN(test_serial_tx_full);
+    UTEST_UNIT_RUN(test_serial_tx_isr);
+    UTEST_UNIT_RUN(test_serial_tx_fail);
+    UTEST_UNIT_RUN(test_serial_tx_close);
+    UTEST_UNIT_RUN(test_serial_tx_close_lost);
+}
+UTEST_TC_EXPORT(testcase, "testcases.drivers.serial_tx_tc", utest_tc_init, utest_tc_cleanup, 20);
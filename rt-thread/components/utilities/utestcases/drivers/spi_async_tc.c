@@ -0,0 +1,385 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include "utest.h"
+#include "tc_helper.h"
+
+#define DEV_NUM         3
+#define REQ_NUM         4
+#define MSG_NUM         3
+#define MSG_SIZE        16
+#define LOG_SIZE        (DEV_NUM * REQ_NUM * 2)
+
+/* the mock bus, the DMA transfer is done in the handler of mock DMA */
+static struct rt_spi_bus bus;
+static struct rt_spi_device devices[DEV_NUM];
+static struct rt_spi_ops bus_ops;
+static struct rt_spi_device *volatile cs_owner;
+static struct rt_spi_device *volatile dma_device;
+static struct rt_spi_message *volatile dma_message;
+static volatile int dma_ticks;
+static volatile int dma_fail;
+static volatile int bus_errors;
+static volatile int configures, starts, xfers;
+
+struct tc_request
+{
+    struct rt_spi_request request;
+    struct rt_spi_message message[MSG_NUM];
+    rt_uint8_t send[MSG_NUM][MSG_SIZE];
+    rt_uint8_t recv[MSG_NUM][MSG_SIZE];
+};
+
+static struct tc_request requests[DEV_NUM][REQ_NUM];
+static int done_log[LOG_SIZE];
+static volatile int done_num;
+
+/* the chip select of the message is taken, or it's released */
+static void tc_cs(struct rt_spi_device *device, struct rt_spi_message *message, rt_bool_t end)
+{
+    if (!end)
+    {
+        if (message->cs_take)
+        {
+            if (cs_owner != RT_NULL)
+                bus_errors++;
+            cs_owner = device;
+        }
+        if (cs_owner != device || bus.owner != device)
+            bus_errors++;
+    }
+    else if (message->cs_release)
+    {
+        cs_owner = RT_NULL;
+    }
+}
+
+/* the slave returns the inverted data */
+static void tc_loopback(struct rt_spi_message *message)
+{
+    const rt_uint8_t *send = (const rt_uint8_t *)message->send_buf;
+    rt_uint8_t *recv = (rt_uint8_t *)message->recv_buf;
+    rt_size_t i;
+
+    if (recv == RT_NULL)
+        return;
+    for (i = 0; i < message->length; i++)
+        recv[i] = send ? ~send[i] : 0xFF;
+}
+
+static rt_err_t tc_configure(struct rt_spi_device *device, struct rt_spi_configuration *cfg)
+{
+    /* the HAL can't be initialized in ISR */
+    if (rt_interrupt_get_nest() != 0 || dma_message != RT_NULL)
+        bus_errors++;
+    configures++;
+    return RT_EOK;
+}
+
+static rt_uint32_t tc_xfer(struct rt_spi_device *device, struct rt_spi_message *message)
+{
+    /* the polling transfer blocks, it can't run in ISR */
+    if (rt_interrupt_get_nest() != 0 || dma_message != RT_NULL)
+        bus_errors++;
+
+    tc_cs(device, message, RT_FALSE);
+    tc_loopback(message);
+    tc_cs(device, message, RT_TRUE);
+    xfers++;
+    return message->length;
+}
+
+static rt_err_t tc_xfer_start(struct rt_spi_device *device, struct rt_spi_message *message)
+{
+    /* the odd length can't be done by DMA */
+    if (message->length & 1)
+        return -RT_ENOSYS;
+    if (dma_message != RT_NULL)
+        bus_errors++;
+
+    tc_cs(device, message, RT_FALSE);
+    dma_device = device;
+    dma_ticks = 2;
+    starts++;
+    dma_message = message;
+    return RT_EOK;
+}
+
+static void dma_timeout(void *parameter)
+{
+    struct rt_spi_message *message = dma_message;
+
+    if (message == RT_NULL || --dma_ticks > 0)
+        return;
+
+    dma_message = RT_NULL;
+    if (dma_fail)
+    {
+        dma_fail = 0;
+        /* the driver releases the chip select on error */
+        cs_owner = RT_NULL;
+        rt_spi_bus_xfer_done(&bus, -RT_EIO);
+        return;
+    }
+
+    tc_loopback(message);
+    tc_cs(dma_device, message, RT_TRUE);
+    rt_spi_bus_xfer_done(&bus, RT_EOK);
+}
+
+static void tc_done(struct rt_spi_request *request)
+{
+    struct rt_spi_device *device = request->device;
+
+    if (done_num < LOG_SIZE)
+        done_log[done_num] = device - devices;
+    done_num++;
+}
+
+static void tc_request_init(struct tc_request *req, int dev, int seq, void (*done)(struct rt_spi_request *))
+{
+    int i, j;
+
+    for (i = 0; i < MSG_NUM; i++)
+    {
+        for (j = 0; j < MSG_SIZE; j++)
+            req->send[i][j] = (rt_uint8_t)(dev * 64 + seq * 16 + i * 4 + j);
+        rt_memset(req->recv[i], 0, MSG_SIZE);
+
+        req->message[i].send_buf = req->send[i];
+        req->message[i].recv_buf = req->recv[i];
+        /* the middle message is transferred by xfer */
+        req->message[i].length = (i == 1) ? MSG_SIZE - 1 : MSG_SIZE;
+        req->message[i].cs_take = (i == 0);
+        req->message[i].cs_release = (i == MSG_NUM - 1);
+        req->message[i].next = (i < MSG_NUM - 1) ? &req->message[i + 1] : RT_NULL;
+    }
+    rt_spi_request_init(&req->request, &devices[dev], &req->message[0], done, RT_NULL);
+}
+
+static int tc_request_check(struct tc_request *req)
+{
+    int i, j, errors = 0;
+
+    for (i = 0; i < MSG_NUM; i++)
+    {
+        for (j = 0; j < (int)req->message[i].length; j++)
+        {
+            if (req->recv[i][j] != (rt_uint8_t)~req->send[i][j])
+                errors++;
+        }
+    }
+    return errors;
+}
+
+static void tc_wait_done(int num)
+{
+    int retry = 500;
+
+    while (done_num < num && --retry)
+        rt_thread_mdelay(1);
+}
+
+static void tc_reset(void)
+{
+    done_num = 0;
+    bus_errors = 0;
+    configures = starts = xfers = 0;
+}
+
+static void test_spi_async_turns(void)
+{
+    int dev, seq, errors = 0;
+
+    tc_reset();
+
+    /* the queue is stopped while the bus is taken */
+    uassert_int_equal(rt_spi_take_bus(&devices[0]), RT_EOK);
+    for (seq = 0; seq < REQ_NUM; seq++)
+    {
+        for (dev = 0; dev < DEV_NUM; dev++)
+        {
+            tc_request_init(&requests[dev][seq], dev, seq, tc_done);
+            uassert_int_equal(rt_spi_transfer_async(&requests[dev][seq].request), RT_EOK);
+        }
+    }
+    rt_thread_mdelay(5);
+    uassert_int_equal(done_num, 0);
+    rt_spi_release_bus(&devices[0]);
+
+    tc_wait_done(DEV_NUM * REQ_NUM);
+    uassert_int_equal(done_num, DEV_NUM * REQ_NUM);
+
+    /* the devices are served in turn, the requests of device in order */
+    for (seq = 0; seq < DEV_NUM * REQ_NUM; seq++)
+    {
+        if (done_log[seq] != seq % DEV_NUM)
+            errors++;
+    }
+    uassert_int_equal(errors, 0);
+    for (dev = 0; dev < DEV_NUM; dev++)
+    {
+        for (seq = 0; seq < REQ_NUM; seq++)
+        {
+            uassert_int_equal(requests[dev][seq].request.result, RT_EOK);
+            uassert_int_equal(tc_request_check(&requests[dev][seq]), 0);
+        }
+    }
+
+    /* the odd message falls back to xfer, the others are chained by DMA */
+    uassert_int_equal(starts, DEV_NUM * REQ_NUM * (MSG_NUM - 1));
+    uassert_int_equal(xfers, DEV_NUM * REQ_NUM);
+    uassert_int_equal(bus_errors, 0);
+    uassert_null(bus.async_current);
+}
+
+static void test_spi_async_sync(void)
+{
+    rt_uint8_t send[4] = {1, 2, 3, 4}, recv[8];
+    int dev, seq;
+
+    tc_reset();
+
+    for (seq = 0; seq < REQ_NUM; seq++)
+    {
+        for (dev = 1; dev < DEV_NUM; dev++)
+        {
+            tc_request_init(&requests[dev][seq], dev, seq, tc_done);
+            rt_spi_transfer_async(&requests[dev][seq].request);
+        }
+    }
+
+    /* the synchronous transfer waits for the request boundary */
+    uassert_int_equal(rt_spi_send_then_recv(&devices[0], send, sizeof(send), recv, sizeof(recv)), RT_EOK);
+    uassert_int_equal(recv[0], 0xFF);
+    uassert_int_equal(rt_spi_transfer(&devices[0], send, recv, sizeof(send)), sizeof(send));
+    uassert_int_equal(recv[3], (rt_uint8_t)~send[3]);
+
+    tc_wait_done((DEV_NUM - 1) * REQ_NUM);
+    uassert_int_equal(done_num, (DEV_NUM - 1) * REQ_NUM);
+    for (dev = 1; dev < DEV_NUM; dev++)
+    {
+        for (seq = 0; seq < REQ_NUM; seq++)
+            uassert_int_equal(tc_request_check(&requests[dev][seq]), 0);
+    }
+    uassert_int_equal(bus_errors, 0);
+}
+
+static void test_spi_async_wait(void)
+{
+    struct tc_request *first = &requests[0][0], *second = &requests[1][0];
+
+    tc_reset();
+
+    tc_request_init(first, 0, 0, RT_NULL);
+    tc_request_init(second, 1, 0, RT_NULL);
+    rt_spi_transfer_async(&first->request);
+    rt_spi_transfer_async(&second->request);
+
+    /* the queued request is removed on timeout, it's owned by caller again */
+    uassert_int_equal(rt_spi_request_wait(&second->request, 0), -RT_ETIMEOUT);
+    uassert_true(rt_list_isempty(&devices[1].async_queue));
+    uassert_true(rt_list_isempty(&devices[1].async_node));
+
+    /* the request in transfer is waited until it's done */
+    uassert_int_equal(rt_spi_request_wait(&first->request, 0), RT_EOK);
+    uassert_int_equal(tc_request_check(first), 0);
+    uassert_null(bus.async_current);
+    uassert_int_equal(bus_errors, 0);
+}
+
+static void test_spi_async_error(void)
+{
+    struct tc_request *failed = &requests[0][0], *next = &requests[1][0];
+
+    tc_reset();
+
+    tc_request_init(failed, 0, 0, tc_done);
+    tc_request_init(next, 1, 0, tc_done);
+    dma_fail = 1;
+    rt_spi_transfer_async(&failed->request);
+    rt_spi_transfer_async(&next->request);
+    tc_wait_done(2);
+
+    /* the failed message is reported, the next request is still served */
+    uassert_int_equal(failed->request.result, -RT_EIO);
+    uassert_true(failed->request.current == &failed->message[0]);
+    uassert_int_equal(next->request.result, RT_EOK);
+    uassert_int_equal(tc_request_check(next), 0);
+    uassert_int_equal(bus_errors, 0);
+}
+
+static void test_spi_async_thread(void)
+{
+    int seq;
+
+    tc_reset();
+
+    /* the bus without xfer_start runs the queue in the submitting thread */
+    bus_ops.xfer_start = RT_NULL;
+    for (seq = 0; seq < REQ_NUM; seq++)
+    {
+        tc_request_init(&requests[seq % DEV_NUM][seq], seq % DEV_NUM, seq, tc_done);
+        uassert_int_equal(rt_spi_transfer_async(&requests[seq % DEV_NUM][seq].request), RT_EOK);
+        uassert_int_equal(done_num, seq + 1);
+    }
+    for (seq = 0; seq < REQ_NUM; seq++)
+        uassert_int_equal(tc_request_check(&requests[seq % DEV_NUM][seq]), 0);
+    uassert_int_equal(starts, 0);
+    uassert_int_equal(bus_errors, 0);
+    bus_ops.xfer_start = tc_xfer_start;
+}
+
+static rt_err_t utest_tc_init(void)
+{
+    char name[RT_NAME_MAX];
+    int i;
+
+    bus_ops.configure = tc_configure;
+    bus_ops.xfer = tc_xfer;
+    bus_ops.xfer_start = tc_xfer_start;
+    if (rt_spi_bus_register(&bus, "tc_spi", &bus_ops) != RT_EOK)
+        return -RT_ERROR;
+
+    for (i = 0; i < DEV_NUM; i++)
+    {
+        rt_snprintf(name, sizeof(name), "tc_spi%d", i);
+        if (rt_spi_bus_attach_device(&devices[i], name, "tc_spi", RT_NULL) != RT_EOK)
+            return -RT_ERROR;
+    }
+
+    tc_dma_init("tc_spi", dma_timeout, RT_NULL);
+    tc_dma_start();
+    return RT_EOK;
+}
+
+static rt_err_t utest_tc_cleanup(void)
+{
+    int i;
+
+    tc_dma_detach();
+    for (i = 0; i < DEV_NUM; i++)
+        rt_device_unregister(&devices[i].parent);
+    rt_device_unregister(&bus.parent);
+    rt_mutex_detach(&bus.lock);
+    return RT_EOK;
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(test_spi_async_turns);
+    UTEST_UNIT_RUN(test_spi_async_sync);
+    UTEST_UNIT_RUN(test_spi_async_wait);
+    UTEST_UNIT_RUN(test_spi_async_error);
+    UTEST_UNIT_RUN(test_spi_async_thread);
+}
+UTEST_TC_EXPORT(testcase, "testcases.drivers.spi_async_tc", utest_tc_init, utest_tc_cleanup, 20);
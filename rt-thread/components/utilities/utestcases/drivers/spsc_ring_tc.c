@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include "utest.h"
+
+#define RING_SIZE       64
+#define STREAM_BYTES    20000
+#define ISR_CHUNK       23
+
+static struct rt_spsc_ring ring;
+static rt_uint8_t ring_pool[RING_SIZE];
+static struct rt_timer producer;
+static volatile rt_uint32_t produced;
+static rt_uint8_t buf[RING_SIZE * 2];
+
+static void test_spsc_init(void)
+{
+    uassert_int_equal(rt_spsc_ring_init(&ring, ring_pool, 0), -RT_EINVAL);
+    uassert_int_equal(rt_spsc_ring_init(&ring, ring_pool, 48), -RT_EINVAL);
+    uassert_int_equal(rt_spsc_ring_init(&ring, ring_pool, RING_SIZE), RT_EOK);
+    uassert_int_equal(rt_spsc_ring_get_size(&ring), RING_SIZE);
+    uassert_int_equal(rt_spsc_ring_data_len(&ring), 0);
+    uassert_int_equal(rt_spsc_ring_space_len(&ring), RING_SIZE);
+}
+
+static void test_spsc_put_get(void)
+{
+    rt_uint32_t i, round;
+
+    rt_spsc_ring_init(&ring, ring_pool, RING_SIZE);
+    /* the free-running counters wrap around during the test */
+    ring.head = ring.tail = 0xFFFFFFFFUL - RING_SIZE * 3;
+
+    for (round = 0; round < 16; round++)
+    {
+        for (i = 0; i < sizeof(buf); i++)
+            buf[i] = (rt_uint8_t)(round * 31 + i);
+
+        /* the put is cut at the free space */
+        uassert_int_equal(rt_spsc_ring_put(&ring, buf, 40), 40);
+        uassert_int_equal(rt_spsc_ring_put(&ring, buf + 40, 40), RING_SIZE - 40);
+        uassert_int_equal(rt_spsc_ring_space_len(&ring), 0);
+        uassert_int_equal(rt_spsc_ring_put(&ring, buf, 1), 0);
+
+        rt_memset(buf + RING_SIZE, 0, RING_SIZE);
+        uassert_int_equal(rt_spsc_ring_get(&ring, buf + RING_SIZE, 17 + round), 17 + round);
+        uassert_int_equal(rt_spsc_ring_get(&ring, buf + RING_SIZE + 17 + round, RING_SIZE),
+                          RING_SIZE - 17 - round);
+        uassert_buf_equal(buf, buf + RING_SIZE, RING_SIZE);
+        uassert_int_equal(rt_spsc_ring_data_len(&ring), 0);
+
+        /* move the position so the next round wraps at another offset */
+        rt_spsc_ring_put(&ring, buf, 7);
+        rt_spsc_ring_get(&ring, buf + RING_SIZE, 7);
+    }
+}
+
+static void test_spsc_claim_commit(void)
+{
+    rt_uint8_t *ptr;
+    rt_uint32_t len;
+
+    rt_spsc_ring_init(&ring, ring_pool, RING_SIZE);
+    rt_spsc_ring_put(&ring, buf, 48);
+    rt_spsc_ring_get(&ring, buf, 48);
+
+    /* the span stops at the end of buffer */
+    len = rt_spsc_ring_write_claim(&ring, &ptr);
+    uassert_int_equal(len, RING_SIZE - 48);
+    uassert_true(ptr == &ring_pool[48]);
+    rt_memset(ptr, 'a', len);
+    rt_spsc_ring_write_commit(&ring, len);
+
+    len = rt_spsc_ring_write_claim(&ring, &ptr);
+    uassert_int_equal(len, 48);
+    uassert_true(ptr == &ring_pool[0]);
+    rt_memset(ptr, 'b', 10);
+    rt_spsc_ring_write_commit(&ring, 10);
+    uassert_int_equal(rt_spsc_ring_data_len(&ring), RING_SIZE - 48 + 10);
+
+    len = rt_spsc_ring_read_claim(&ring, &ptr);
+    uassert_int_equal(len, RING_SIZE - 48);
+    uassert_int_equal(ptr[0], 'a');
+    /* a partial commit keeps the rest of the span */
+    rt_spsc_ring_read_commit(&ring, 4);
+    len = rt_spsc_ring_read_claim(&ring, &ptr);
+    uassert_int_equal(len, RING_SIZE - 48 - 4);
+    rt_spsc_ring_read_commit(&ring, len);
+
+    len = rt_spsc_ring_read_claim(&ring, &ptr);
+    uassert_int_equal(len, 10);
+    uassert_int_equal(ptr[9], 'b');
+    rt_spsc_ring_read_commit(&ring, len);
+    uassert_int_equal(rt_spsc_ring_read_claim(&ring, &ptr), 0);
+}
+
+/* the producer runs in the tick interrupt */
+static void producer_timeout(void *parameter)
+{
+    rt_uint8_t *ptr;
+    rt_uint32_t len, i, n = ISR_CHUNK;
+
+    while (n > 0 && produced < STREAM_BYTES)
+    {
+        len = rt_spsc_ring_write_claim(&ring, &ptr);
+        if (len == 0)
+            break;
+        if (len > n)
+            len = n;
+        if (len > STREAM_BYTES - produced)
+            len = STREAM_BYTES - produced;
+        for (i = 0; i < len; i++)
+            ptr[i] = (rt_uint8_t)((produced + i) * 7);
+        rt_spsc_ring_write_commit(&ring, len);
+        produced += len;
+        n -= len;
+    }
+}
+
+static void test_spsc_isr_stream(void)
+{
+    rt_uint32_t consumed = 0, errors = 0, i, len;
+    rt_tick_t start = rt_tick_get();
+    rt_uint8_t *ptr;
+
+    rt_spsc_ring_init(&ring, ring_pool, RING_SIZE);
+    produced = 0;
+    rt_timer_init(&producer, "tc_spsc", producer_timeout, RT_NULL, 1,
+                  RT_TIMER_FLAG_PERIODIC | RT_TIMER_FLAG_HARD_TIMER);
+    rt_timer_start(&producer);
+
+    while (consumed < STREAM_BYTES && rt_tick_get() - start < RT_TICK_PER_SECOND * 10)
+    {
+        len = rt_spsc_ring_read_claim(&ring, &ptr);
+        if (len == 0)
+        {
+            rt_thread_mdelay(1);
+            continue;
+        }
+        /* take the span in two steps to mix partial commits in */
+        if (len > 5)
+            len -= 5;
+        for (i = 0; i < len; i++)
+        {
+            if (ptr[i] != (rt_uint8_t)((consumed + i) * 7))
+                errors++;
+        }
+        rt_spsc_ring_read_commit(&ring, len);
+        consumed += len;
+    }
+
+    rt_timer_stop(&producer);
+    rt_timer_detach(&producer);
+
+    uassert_int_equal(consumed, STREAM_BYTES);
+    uassert_int_equal(errors, 0);
+    uassert_int_equal(rt_spsc_ring_data_len(&ring), 0);
+}
+
+static rt_err_t utest_tc_init(void)
+{
+    return RT_EOK;
+}
+
+static rt_err_t utest_tc_cleanup(void)
+{
+    return RT_EOK;
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(test_spsc_init);
+    UTEST_UNIT_RUN(test_spsc_put_get);
+    UTEST_UNIT_RUN(test_spsc_claim_commit);
+    UTEST_UNIT_RUN(test_spsc_isr_stream);
+}
+UTEST_TC_EXPORT(testcase, "testcases.drivers.spsc_ring_tc", utest_tc_init, utest_tc_cleanup, 20);
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rtthread.h>
+#include "tc_helper.h"
+
+static rt_uint32_t tc_seed = 1;
+static struct rt_timer tc_dma_timer;
+
+void tc_srand(rt_uint32_t seed)
+{
+    tc_seed = seed;
+}
+
+rt_uint32_t tc_random(void)
+{
+    tc_seed = tc_seed * 1103515245 + 12345;
+    return (tc_seed >> 16) & 0x7FFF;
+}
+
+void tc_dma_init(const char *name, void (*handler)(void *parameter), void *parameter)
+{
+    rt_timer_init(&tc_dma_timer, name, handler, parameter, 1,
+                  RT_TIMER_FLAG_PERIODIC | RT_TIMER_FLAG_HARD_TIMER);
+}
+
+void tc_dma_start(void)
+{
+    rt_timer_start(&tc_dma_timer);
+}
+
+void tc_dma_stop(void)
+{
+    rt_timer_stop(&tc_dma_timer);
+}
+
+void tc_dma_detach(void)
+{
+    rt_timer_detach(&tc_dma_timer);
+}
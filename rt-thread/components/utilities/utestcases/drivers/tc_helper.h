@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#ifndef __TC_HELPER_H__
+#define __TC_HELPER_H__
+
+#include <rtthread.h>
+
+/* the pseudo random number in 0 ~ 0x7FFF, the sequence is repeated by seed */
+void tc_srand(rt_uint32_t seed);
+rt_uint32_t tc_random(void);
+
+/*
+ * The DMA of mock drivers. The handler is invoked by a periodic hard timer
+ * every tick, it runs as the transfer done interrupt.
+ */
+void tc_dma_init(const char *name, void (*handler)(void *parameter), void *parameter);
+void tc_dma_start(void);
+void tc_dma_stop(void);
+void tc_dma_detach(void);
+
+#endif /* __TC_HELPER_H__ */
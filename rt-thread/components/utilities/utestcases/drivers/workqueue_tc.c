@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+#include <rtdevice.h>
+#include "utest.h"
+
+#define WORKERS         3
+#define WORK_NUM        6
+
+struct tc_work
+{
+    struct rt_work work;
+    int id;
+    int sleep;
+};
+
+static struct rt_workqueue *queue;
+static rt_uint8_t worker_priority;
+static struct tc_work works[WORK_NUM];
+static struct rt_delayed_work delayed;
+static int order[WORK_NUM];
+static volatile int order_num;
+static volatile int running, running_max;
+static volatile int key_running, key_running_max;
+static volatile rt_tick_t delayed_tick;
+
+static void tc_work_func(struct rt_work *work, void *work_data)
+{
+    struct tc_work *tw = (struct tc_work *)work;
+    rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    order[order_num++] = tw->id;
+    running++;
+    if (running > running_max)
+        running_max = running;
+    if (work->key != 0)
+    {
+        key_running++;
+        if (key_running > key_running_max)
+            key_running_max = key_running;
+    }
+    rt_hw_interrupt_enable(level);
+
+    if (tw->sleep)
+        rt_thread_mdelay(tw->sleep);
+
+    level = rt_hw_interrupt_disable();
+    running--;
+    if (work->key != 0)
+        key_running--;
+    rt_hw_interrupt_enable(level);
+}
+
+static void tc_works_init(int sleep)
+{
+    int i;
+
+    for (i = 0; i < WORK_NUM; i++)
+    {
+        rt_work_init(&works[i].work, tc_work_func, RT_NULL);
+        works[i].id = i;
+        works[i].sleep = sleep;
+    }
+    order_num = 0;
+    running = running_max = 0;
+    key_running = key_running_max = 0;
+}
+
+static void tc_wait_idle(void)
+{
+    struct rt_workqueue_stats stats;
+    int retry = 100;
+
+    do
+    {
+        rt_thread_mdelay(10);
+        rt_workqueue_get_stats(queue, &stats);
+    } while ((stats.depth != 0 || running != 0) && --retry);
+}
+
+static void test_workqueue_priority(void)
+{
+    struct rt_workqueue *single;
+
+    single = rt_workqueue_create("tc_wq1", 2048, worker_priority);
+    uassert_not_null(single);
+    if (single == RT_NULL)
+        return;
+
+    tc_works_init(0);
+    rt_work_set_priority(&works[0].work, RT_WORK_PRIO_LOW);
+    rt_work_set_priority(&works[1].work, RT_WORK_PRIO_NORMAL);
+    rt_work_set_priority(&works[2].work, RT_WORK_PRIO_HIGH);
+    rt_work_set_priority(&works[3].work, RT_WORK_PRIO_HIGH);
+
+    uassert_int_equal(rt_workqueue_dowork(single, &works[0].work), RT_EOK);
+    uassert_int_equal(rt_workqueue_dowork(single, &works[1].work), RT_EOK);
+    uassert_int_equal(rt_workqueue_dowork(single, &works[2].work), RT_EOK);
+    uassert_int_equal(rt_workqueue_dowork(single, &works[3].work), RT_EOK);
+    /* the pending work can't be submitted again */
+    uassert_int_equal(rt_workqueue_dowork(single, &works[3].work), -RT_EBUSY);
+
+    rt_thread_mdelay(10);
+    uassert_int_equal(order_num, 4);
+    /* the higher lanes first, FIFO in the same lane */
+    uassert_int_equal(order[0], 2);
+    uassert_int_equal(order[1], 3);
+    uassert_int_equal(order[2], 1);
+    uassert_int_equal(order[3], 0);
+
+    rt_workqueue_destroy(single);
+}
+
+static void test_workqueue_pool(void)
+{
+    int i;
+
+    tc_works_init(20);
+    for (i = 0; i < WORK_NUM; i++)
+        uassert_int_equal(rt_workqueue_dowork(queue, &works[i].work), RT_EOK);
+
+    rt_thread_mdelay(5);
+    /* the running work can't be submitted or cancelled */
+    uassert_int_equal(rt_workqueue_dowork(queue, &works[0].work), -RT_EBUSY);
+    uassert_int_equal(rt_workqueue_cancel_work(queue, &works[0].work), -RT_EBUSY);
+
+    tc_wait_idle();
+    uassert_int_equal(order_num, WORK_NUM);
+    uassert_int_equal(running_max, WORKERS);
+}
+
+static void test_workqueue_key(void)
+{
+    int i, next;
+
+    tc_works_init(10);
+    /* works 0 .. 3 share a key, 4 and 5 are free to run aside */
+    for (i = 0; i < 4; i++)
+        rt_work_set_key(&works[i].work, 0x55);
+    for (i = 0; i < WORK_NUM; i++)
+        rt_workqueue_dowork(queue, &works[i].work);
+
+    tc_wait_idle();
+    uassert_int_equal(order_num, WORK_NUM);
+    uassert_int_equal(key_running_max, 1);
+    uassert_true(running_max >= 2);
+    /* the keyed works keep the submitting order */
+    for (i = 0, next = 0; i < WORK_NUM; i++)
+    {
+        if (order[i] < 4)
+            uassert_int_equal(order[i], next++);
+    }
+}
+
+static void test_workqueue_cancel(void)
+{
+    tc_works_init(20);
+
+    rt_workqueue_dowork(queue, &works[0].work);
+    rt_thread_mdelay(5);
+    uassert_int_equal(running, 1);
+    /* wait for the running work */
+    uassert_int_equal(rt_workqueue_cancel_work_sync(queue, &works[0].work), RT_EOK);
+    uassert_int_equal(running, 0);
+
+    /* the pending work is removed */
+    works[1].sleep = 0;
+    rt_workqueue_dowork(queue, &works[1].work);
+    uassert_int_equal(rt_workqueue_cancel_work(queue, &works[1].work), RT_EOK);
+    rt_thread_mdelay(5);
+    uassert_int_equal(order_num, 1);
+}
+
+static void tc_delayed_func(struct rt_work *work, void *work_data)
+{
+    delayed_tick = rt_tick_get();
+}
+
+static void test_workqueue_delayed(void)
+{
+    rt_tick_t start;
+
+    rt_delayed_work_init(&delayed, tc_delayed_func, RT_NULL);
+    delayed_tick = 0;
+    start = rt_tick_get();
+    uassert_int_equal(rt_workqueue_submit_work(queue, &delayed.work, 20), RT_EOK);
+    rt_thread_mdelay(5);
+    uassert_int_equal(delayed_tick, 0);
+    rt_thread_mdelay(40);
+    uassert_true(delayed_tick - start >= 20);
+
+    /* the cancelled delayed work is never run */
+    delayed_tick = 0;
+    rt_workqueue_submit_work(queue, &delayed.work, 20);
+    uassert_int_equal(rt_workqueue_cancel_work(queue, &delayed.work), RT_EOK);
+    rt_thread_mdelay(40);
+    uassert_int_equal(delayed_tick, 0);
+}
+
+static void test_workqueue_stats(void)
+{
+    struct rt_workqueue_stats stats;
+    int i;
+
+    rt_workqueue_reset_stats(queue);
+    tc_works_init(5);
+    rt_work_set_budget(&works[0].work, 2);
+    rt_work_set_budget(&works[1].work, 50);
+    for (i = 0; i < WORK_NUM; i++)
+        rt_workqueue_dowork(queue, &works[i].work);
+
+    rt_workqueue_get_stats(queue, &stats);
+    uassert_int_equal(stats.submitted, WORK_NUM);
+    uassert_int_equal(stats.depth_max, WORK_NUM);
+
+    tc_wait_idle();
+    rt_workqueue_get_stats(queue, &stats);
+    uassert_int_equal(stats.completed, WORK_NUM);
+    uassert_int_equal(stats.depth, 0);
+    uassert_int_equal(stats.overrun, 1);
+    uassert_true(stats.longest >= 5);
+    uassert_true(stats.longest_func == tc_work_func);
+    /* the last works waited for a free worker */
+    uassert_true(stats.latency_max >= 5);
+}
+
+static rt_err_t utest_tc_init(void)
+{
+    /* the workers run below the test thread, so the works are queued first */
+    worker_priority = rt_thread_self()->current_priority + 2;
+    if (worker_priority > RT_THREAD_PRIORITY_MAX - 2)
+        return -RT_ERROR;
+
+    queue = rt_workqueue_create_pool("tc_wq", 2048, worker_priority, WORKERS);
+    if (queue == RT_NULL)
+        return -RT_ENOMEM;
+
+    return RT_EOK;
+}
+
+static rt_err_t utest_tc_cleanup(void)
+{
+    rt_workqueue_destroy(queue);
+    return RT_EOK;
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(test_workqueue_priority);
+    UTEST_UNIT_RUN(test_workqueue_pool);
+    UTEST_UNIT_RUN(test_workqueue_key);
+    UTEST_UNIT_RUN(test_workqueue_cancel);
+    UTEST_UNIT_RUN(test_workqueue_delayed);
+    UTEST_UNIT_RUN(test_workqueue_stats);
+}
+UTEST_TC_EXPORT(testcase, "testcases.drivers.workqueue_tc", utest_tc_init, utest_tc_cleanup, 20);
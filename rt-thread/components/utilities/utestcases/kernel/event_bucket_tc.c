@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rtthread.h>
+#include "utest.h"
+
+#define WAITER_NUM      32
+
+struct tc_waiter
+{
+    rt_uint32_t set;
+    rt_uint8_t  opt;
+    rt_int32_t  timeout;
+    rt_err_t    result;
+    rt_uint32_t recved;
+    volatile int done;
+};
+
+static struct rt_event event;
+static struct tc_waiter waiters[WAITER_NUM];
+static rt_uint8_t waiter_priority;
+static struct rt_timer isr_timer;
+
+static void waiter_entry(void *parameter)
+{
+    struct tc_waiter *waiter = (struct tc_waiter *)parameter;
+
+    waiter->result = rt_event_recv(&event, waiter->set, waiter->opt,
+                                   waiter->timeout, &waiter->recved);
+    waiter->done = 1;
+}
+
+/* the waiter runs above the test thread, so it's suspended when this returns */
+static void tc_waiter_start(int index, rt_uint32_t set, rt_uint8_t opt, rt_int32_t timeout)
+{
+    struct tc_waiter *waiter = &waiters[index];
+    rt_thread_t thread;
+
+    waiter->set = set;
+    waiter->opt = opt;
+    waiter->timeout = timeout;
+    waiter->result = -RT_ERROR;
+    waiter->recved = 0;
+    waiter->done = 0;
+
+    thread = rt_thread_create("tc_evw", waiter_entry, waiter, 1024, waiter_priority, 10);
+    uassert_not_null(thread);
+    if (thread != RT_NULL)
+        rt_thread_startup(thread);
+}
+
+/* get the mask of waiters which have received */
+static rt_uint32_t tc_waiter_done(int num)
+{
+    rt_uint32_t mask = 0;
+    int i;
+
+    for (i = 0; i < num; i++)
+    {
+        if (waiters[i].done)
+            mask |= 1UL << i;
+    }
+    return mask;
+}
+
+static void tc_event_reset(void)
+{
+    rt_event_control(&event, RT_IPC_CMD_RESET, RT_NULL);
+    /* let the resumed waiters exit */
+    rt_thread_mdelay(1);
+}
+
+static void test_event_or_bits(void)
+{
+    int i;
+
+    /* every bit has its own waiter, so all buckets are used */
+    for (i = 0; i < WAITER_NUM; i++)
+        tc_waiter_start(i, 1UL << i, RT_EVENT_FLAG_OR, RT_WAITING_FOREVER);
+    uassert_int_equal(tc_waiter_done(WAITER_NUM), 0);
+
+    /* only the waiters of the bits being set are resumed */
+    rt_event_send(&event, 1UL << 5);
+    uassert_int_equal(tc_waiter_done(WAITER_NUM), 1UL << 5);
+    uassert_int_equal(waiters[5].result, RT_EOK);
+    uassert_int_equal(waiters[5].recved, 1UL << 5);
+
+    rt_event_send(&event, (1UL << 0) | (1UL << 9) | (1UL << 31));
+    uassert_int_equal(tc_waiter_done(WAITER_NUM), (1UL << 0) | (1UL << 5) | (1UL << 9) | (1UL << 31));
+
+    /* all of the others in one send */
+    rt_event_send(&event, 0xFFFFFFFF);
+    uassert_int_equal(tc_waiter_done(WAITER_NUM), 0xFFFFFFFF);
+    for (i = 0; i < WAITER_NUM; i++)
+        uassert_int_equal(waiters[i].result, RT_EOK);
+
+    tc_event_reset();
+}
+
+static void test_event_and_bits(void)
+{
+    /* the requested bits are in the different buckets */
+    tc_waiter_start(0, (1UL << 1) | (1UL << 6), RT_EVENT_FLAG_AND, RT_WAITING_FOREVER);
+    /* the waiter is resumed by the bit which is not its lowest one */
+    tc_waiter_start(1, (1UL << 3) | (1UL << 8), RT_EVENT_FLAG_OR, RT_WAITING_FOREVER);
+
+    rt_event_send(&event, 1UL << 6);
+    uassert_int_equal(tc_waiter_done(2), 0);
+    rt_event_send(&event, 1UL << 8);
+    uassert_int_equal(tc_waiter_done(2), 1UL << 1);
+    uassert_int_equal(waiters[1].recved, 1UL << 8);
+
+    rt_event_send(&event, 1UL << 1);
+    uassert_int_equal(tc_waiter_done(2), 0x3);
+    uassert_int_equal(waiters[0].recved, (1UL << 1) | (1UL << 6));
+
+    tc_event_reset();
+}
+
+static void test_event_clear(void)
+{
+    tc_waiter_start(0, 1UL << 2, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR, RT_WAITING_FOREVER);
+    tc_waiter_start(1, 1UL << 2, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR, RT_WAITING_FOREVER);
+
+    /* the bit is taken by the first waiter */
+    rt_event_send(&event, 1UL << 2);
+    uassert_int_equal(tc_waiter_done(2), 0x1);
+    uassert_int_equal(event.set, 0);
+
+    rt_event_send(&event, 1UL << 2);
+    uassert_int_equal(tc_waiter_done(2), 0x3);
+    uassert_int_equal(event.set, 0);
+
+    tc_event_reset();
+}
+
+static void test_event_timeout(void)
+{
+    tc_waiter_start(0, (1UL << 4) | (1UL << 12), RT_EVENT_FLAG_AND, 10);
+    rt_thread_mdelay(20);
+    uassert_int_equal(tc_waiter_done(1), 0x1);
+    uassert_int_equal(waiters[0].result, -RT_ETIMEOUT);
+
+    /* the bits left by the timed out waiter don't lose the next wakeup */
+    tc_waiter_start(1, 1UL << 12, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR, RT_WAITING_FOREVER);
+    rt_event_send(&event, 1UL << 4);
+    uassert_int_equal(tc_waiter_done(2), 0x1);
+    rt_event_send(&event, 1UL << 12);
+    uassert_int_equal(tc_waiter_done(2), 0x3);
+    uassert_int_equal(waiters[1].result, RT_EOK);
+    uassert_int_equal(event.set, 1UL << 4);
+
+    tc_event_reset();
+}
+
+static void isr_timeout(void *parameter)
+{
+    rt_event_send(&event, 0x00FF00FF);
+}
+
+static void test_event_isr(void)
+{
+    int i;
+
+    for (i = 0; i < 8; i++)
+        tc_waiter_start(i, 0x00010001UL << i, RT_EVENT_FLAG_OR, RT_WAITING_FOREVER);
+
+    rt_timer_start(&isr_timer);
+    rt_thread_mdelay(10);
+    uassert_int_equal(tc_waiter_done(8), 0xFF);
+    for (i = 0; i < 8; i++)
+        uassert_int_equal(waiters[i].recved, 0x00010001UL << i);
+
+    tc_event_reset();
+}
+
+static rt_err_t utest_tc_init(void)
+{
+    if (rt_thread_self()->current_priority == 0)
+        return -RT_ERROR;
+    waiter_priority = rt_thread_self()->current_priority - 1;
+
+    rt_event_init(&event, "tc_ev", RT_IPC_FLAG_FIFO);
+    rt_timer_init(&isr_timer, "tc_evt", isr_timeout, RT_NULL, 1,
+                  RT_TIMER_FLAG_ONE_SHOT | RT_TIMER_FLAG_HARD_TIMER);
+    return RT_EOK;
+}
+
+static rt_err_t utest_tc_cleanup(void)
+{
+    rt_timer_detach(&isr_timer);
+    rt_event_detach(&event);
+    return RT_EOK;
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(test_event_or_bits);
+    UTEST_UNIT_RUN(test_event_and_bits);
+    UTEST_UNIT_RUN(test_event_clear);
+    UTEST_UNIT_RUN(test_event_timeout);
+    UTEST_UNIT_RUN(test_event_isr);
+}
+UTEST_TC_EXPORT(testcase, "testcases.kernel.event_bucket_tc", utest_tc_init, utest_tc_cleanup, 10);
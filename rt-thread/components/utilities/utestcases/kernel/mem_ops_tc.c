@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rtthread.h>
+#include "utest.h"
+
+#define BUF_SIZE        384
+#define GUARD           16
+#define MAX_OFFSET      8
+
+static const rt_ubase_t lengths[] =
+{
+    0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100, 255, 300
+};
+
+static rt_uint8_t src[BUF_SIZE + GUARD * 2];
+static rt_uint8_t dst[BUF_SIZE + GUARD * 2];
+static rt_uint8_t ref[BUF_SIZE + GUARD * 2];
+static rt_uint32_t seed = 1;
+
+static rt_uint8_t tc_rand(void)
+{
+    seed = seed * 1103515245UL + 12345UL;
+    return (rt_uint8_t)(seed >> 16);
+}
+
+static void tc_fill(rt_uint8_t *buf, rt_ubase_t size)
+{
+    rt_ubase_t i;
+
+    for (i = 0; i < size; i++)
+        buf[i] = tc_rand();
+}
+
+/* the plain byte loops as reference */
+static void ref_copy(rt_uint8_t *d, const rt_uint8_t *s, rt_ubase_t n)
+{
+    rt_uint8_t tmp[BUF_SIZE + GUARD * 2];
+    rt_ubase_t i;
+
+    for (i = 0; i < n; i++)
+        tmp[i] = s[i];
+    for (i = 0; i < n; i++)
+        d[i] = tmp[i];
+}
+
+static void test_memcpy(void)
+{
+    rt_ubase_t so, doff, l, n, errors = 0;
+    void *ret;
+
+    for (so = 0; so < MAX_OFFSET; so++)
+    {
+        for (doff = 0; doff < MAX_OFFSET; doff++)
+        {
+            for (l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++)
+            {
+                n = lengths[l];
+                tc_fill(src, sizeof(src));
+                tc_fill(dst, sizeof(dst));
+                rt_memcpy(ref, dst, sizeof(dst));
+                ref_copy(ref + GUARD + doff, src + GUARD + so, n);
+
+                ret = rt_memcpy(dst + GUARD + doff, src + GUARD + so, n);
+                /* the guard bytes around the destination are untouched */
+                if (ret != dst + GUARD + doff || rt_memcmp(dst, ref, sizeof(dst)) != 0)
+                    errors++;
+            }
+        }
+    }
+    uassert_int_equal(errors, 0);
+}
+
+static void test_memset(void)
+{
+    rt_ubase_t doff, l, n, i, errors = 0;
+    int c;
+    void *ret;
+
+    for (doff = 0; doff < MAX_OFFSET; doff++)
+    {
+        for (l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++)
+        {
+            n = lengths[l];
+            c = tc_rand();
+            tc_fill(dst, sizeof(dst));
+            rt_memcpy(ref, dst, sizeof(dst));
+            for (i = 0; i < n; i++)
+                ref[GUARD + doff + i] = (rt_uint8_t)c;
+
+            /* only the low byte of the value is used */
+            ret = rt_memset(dst + GUARD + doff, c | 0x5A00, n);
+            if (ret != dst + GUARD + doff || rt_memcmp(dst, ref, sizeof(dst)) != 0)
+                errors++;
+        }
+    }
+    uassert_int_equal(errors, 0);
+}
+
+static void test_memmove(void)
+{
+    rt_ubase_t so, doff, l, n, errors = 0;
+    void *ret;
+
+    /* the source and destination overlap in both directions */
+    for (so = 0; so < MAX_OFFSET * 2; so++)
+    {
+        for (doff = 0; doff < MAX_OFFSET * 2; doff++)
+        {
+            for (l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++)
+            {
+                n = lengths[l];
+                tc_fill(dst, sizeof(dst));
+                rt_memcpy(ref, dst, sizeof(dst));
+                ref_copy(ref + GUARD + doff, ref + GUARD + so, n);
+
+                ret = rt_memmove(dst + GUARD + doff, dst + GUARD + so, n);
+                if (ret != dst + GUARD + doff || rt_memcmp(dst, ref, sizeof(dst)) != 0)
+                    errors++;
+            }
+        }
+    }
+    uassert_int_equal(errors, 0);
+}
+
+static void test_memcmp(void)
+{
+    tc_fill(src, sizeof(src));
+    rt_memcpy(dst, src, sizeof(src));
+    uassert_int_equal(rt_memcmp(dst + 3, src + 3, 200), 0);
+
+    dst[150] = src[150] + 1;
+    uassert_true(rt_memcmp(dst + 3, src + 3, 200) > 0);
+    uassert_true(rt_memcmp(src + 3, dst + 3, 200) < 0);
+    uassert_int_equal(rt_memcmp(dst + 3, src + 3, 147), 0);
+}
+
+static rt_err_t utest_tc_init(void)
+{
+    seed = 1;
+    return RT_EOK;
+}
+
+static rt_err_t utest_tc_cleanup(void)
+{
+    return RT_EOK;
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(test_memcpy);
+    UTEST_UNIT_RUN(test_memset);
+    UTEST_UNIT_RUN(test_memmove);
+    UTEST_UNIT_RUN(test_memcmp);
+}
+UTEST_TC_EXPORT(testcase, "testcases.kernel.mem_ops_tc", utest_tc_init, utest_tc_cleanup, 60);
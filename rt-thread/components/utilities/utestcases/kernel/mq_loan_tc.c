@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rtthread.h>
+#include "utest.h"
+
+#define MSG_SIZE        16
+#define MSG_NUM         4
+#define MSG_COUNT       200
+
+static struct rt_messagequeue mq;
+static rt_uint8_t mq_pool[(RT_ALIGN(MSG_SIZE, RT_ALIGN_SIZE) + sizeof(void *)) * MSG_NUM];
+static struct rt_thread consumer;
+static rt_uint8_t consumer_stack[1024];
+static struct rt_semaphore consumer_done;
+static int consumer_count;
+static int consumer_error;
+static void *consumer_last;
+
+static void test_mq_loan_commit(void)
+{
+    void *buf[MSG_NUM + 1];
+    char msg[MSG_SIZE];
+    int i;
+
+    for (i = 0; i < MSG_NUM; i++)
+    {
+        buf[i] = rt_mq_loan(&mq);
+        uassert_not_null(buf[i]);
+    }
+    /* the loaned messages are not free any more */
+    uassert_null(rt_mq_loan(&mq));
+    uassert_int_equal(rt_mq_send(&mq, "x", 1), -RT_EFULL);
+
+    /* give one back, then it can be loaned again */
+    rt_mq_cancel(&mq, buf[MSG_NUM - 1]);
+    buf[MSG_NUM] = rt_mq_loan(&mq);
+    uassert_true(buf[MSG_NUM] == buf[MSG_NUM - 1]);
+
+    for (i = 0; i < MSG_NUM; i++)
+    {
+        rt_memset(buf[i], 'a' + i, MSG_SIZE);
+        /* the last one is urgent and received first */
+        uassert_int_equal(rt_mq_commit(&mq, buf[i], i == MSG_NUM - 1), RT_EOK);
+    }
+
+    uassert_int_equal(rt_mq_recv(&mq, msg, sizeof(msg), 0), RT_EOK);
+    uassert_int_equal(msg[0], 'a' + MSG_NUM - 1);
+    for (i = 0; i < MSG_NUM - 1; i++)
+    {
+        uassert_int_equal(rt_mq_recv(&mq, msg, sizeof(msg), 0), RT_EOK);
+        uassert_int_equal(msg[0], 'a' + i);
+        uassert_int_equal(msg[MSG_SIZE - 1], 'a' + i);
+    }
+    uassert_int_equal(rt_mq_recv(&mq, msg, sizeof(msg), 0), -RT_ETIMEOUT);
+}
+
+static void test_mq_peek_release(void)
+{
+    void *buf;
+    int i;
+
+    for (i = 0; i < MSG_NUM; i++)
+    {
+        uassert_int_equal(rt_mq_send(&mq, "0123456789", 10), RT_EOK);
+    }
+
+    uassert_int_equal(rt_mq_peek(&mq, &buf, 0), RT_EOK);
+    uassert_buf_equal(buf, "0123456789", 10);
+
+    /* the message in place is still owned by the receiver */
+    uassert_int_equal(rt_mq_send(&mq, "x", 1), -RT_EFULL);
+    rt_mq_release(&mq, buf);
+    uassert_int_equal(rt_mq_send(&mq, "x", 1), RT_EOK);
+
+    for (i = 0; i < MSG_NUM; i++)
+    {
+        uassert_int_equal(rt_mq_peek(&mq, &buf, 0), RT_EOK);
+        rt_mq_release(&mq, buf);
+    }
+    uassert_int_equal(((char *)buf)[0], 'x');
+    uassert_int_equal(rt_mq_peek(&mq, &buf, 10), -RT_ETIMEOUT);
+}
+
+static void consumer_entry(void *parameter)
+{
+    void *buf;
+    int i;
+
+    for (i = 0; i < MSG_COUNT; i++)
+    {
+        if (rt_mq_peek(&mq, &buf, RT_WAITING_FOREVER) != RT_EOK)
+        {
+            consumer_error++;
+            break;
+        }
+        if (*(int *)buf != i)
+            consumer_error++;
+        consumer_last = buf;
+        consumer_count++;
+        rt_mq_release(&mq, buf);
+    }
+    rt_sem_release(&consumer_done);
+}
+
+static void test_mq_zero_copy(void)
+{
+    void *buf;
+    int i;
+
+    consumer_count = 0;
+    consumer_error = 0;
+    rt_thread_init(&consumer, "tc_mqc", consumer_entry, RT_NULL, consumer_stack,
+                   sizeof(consumer_stack), RT_THREAD_PRIORITY_MAX - 3, 10);
+    rt_thread_startup(&consumer);
+
+    for (i = 0; i < MSG_COUNT; i++)
+    {
+        while ((buf = rt_mq_loan(&mq)) == RT_NULL)
+            rt_thread_mdelay(1);
+        *(int *)buf = i;
+        rt_mq_commit(&mq, buf, RT_FALSE);
+        if (i % 7 == 0)
+            rt_thread_mdelay(1);
+    }
+
+    uassert_int_equal(rt_sem_take(&consumer_done, RT_TICK_PER_SECOND * 5), RT_EOK);
+    uassert_int_equal(consumer_count, MSG_COUNT);
+    uassert_int_equal(consumer_error, 0);
+    /* the consumer gets the buffer the producer filled, not a copy */
+    uassert_true(consumer_last == buf);
+}
+
+static rt_err_t utest_tc_init(void)
+{
+    rt_mq_init(&mq, "tc_mq", mq_pool, MSG_SIZE, sizeof(mq_pool), RT_IPC_FLAG_FIFO);
+    rt_sem_init(&consumer_done, "tc_mqd", 0, RT_IPC_FLAG_FIFO);
+    return RT_EOK;
+}
+
+static rt_err_t utest_tc_cleanup(void)
+{
+    rt_mq_detach(&mq);
+    rt_sem_detach(&consumer_done);
+    return RT_EOK;
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(test_mq_loan_commit);
+    UTEST_UNIT_RUN(test_mq_peek_release);
+    UTEST_UNIT_RUN(test_mq_zero_copy);
+}
+UTEST_TC_EXPORT(testcase, "testcases.kernel.mq_loan_tc", utest_tc_init, utest_tc_cleanup, 10);
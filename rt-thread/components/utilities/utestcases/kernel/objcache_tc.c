@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rtthread.h>
+#include "utest.h"
+
+#define OBJ_SIZE        20
+#define PAGE_OBJS       16
+#define OBJ_NUM         (PAGE_OBJS * 3)
+#define WORKER_NUM      3
+#define WORKER_LOOPS    500
+
+struct tc_obj
+{
+    rt_uint32_t magic;
+    rt_uint32_t owner;
+    rt_uint8_t  data[OBJ_SIZE - 8];
+};
+
+static rt_objcache_t cache;
+static void *objs[OBJ_NUM];
+static volatile int ctor_count, dtor_count;
+static volatile int worker_done, worker_error;
+static rt_thread_t workers[WORKER_NUM];
+static struct rt_timer isr_timer;
+static void *volatile isr_obj;
+static volatile int isr_done;
+
+static void tc_ctor(void *obj)
+{
+    ((struct tc_obj *)obj)->magic = 0x5A5A5A5A;
+    ctor_count++;
+}
+
+static void tc_dtor(void *obj)
+{
+    if (((struct tc_obj *)obj)->magic == 0x5A5A5A5A)
+        dtor_count++;
+}
+
+static void test_objcache_create(void)
+{
+    rt_objcache_t other;
+    void *obj;
+
+    uassert_not_null(cache);
+    uassert_true(rt_objcache_find("tc_oc") == cache);
+    uassert_null(rt_objcache_find("tc_none"));
+    /* the size is aligned, and no page is added before the first allocation */
+    uassert_int_equal(cache->obj_size, RT_ALIGN(sizeof(struct tc_obj), RT_ALIGN_SIZE));
+    uassert_int_equal(cache->page_count, 0);
+
+    other = rt_objcache_create("tc_oc2", 8, 4, RT_NULL, RT_NULL);
+    uassert_not_null(other);
+    obj = rt_objcache_alloc(other);
+    uassert_not_null(obj);
+    /* the cache in use can't be deleted */
+    uassert_int_equal(rt_objcache_delete(other), -RT_EBUSY);
+    rt_objcache_free(other, obj);
+    uassert_int_equal(rt_objcache_delete(other), RT_EOK);
+    uassert_null(rt_objcache_find("tc_oc2"));
+}
+
+static void test_objcache_grow_shrink(void)
+{
+    int i, j, same = 0;
+
+    ctor_count = dtor_count = 0;
+    for (i = 0; i < OBJ_NUM; i++)
+    {
+        objs[i] = rt_objcache_alloc(cache);
+        uassert_not_null(objs[i]);
+        if (objs[i] == RT_NULL)
+            return;
+        /* the object is constructed once when the page is added */
+        uassert_int_equal(((struct tc_obj *)objs[i])->magic, 0x5A5A5A5A);
+        rt_memset(((struct tc_obj *)objs[i])->data, i, sizeof(((struct tc_obj *)objs[i])->data));
+    }
+    uassert_int_equal(cache->page_count, OBJ_NUM / PAGE_OBJS);
+    uassert_int_equal(ctor_count, OBJ_NUM);
+
+    /* every object is a distinct block */
+    for (i = 0; i < OBJ_NUM; i++)
+    {
+        for (j = i + 1; j < OBJ_NUM; j++)
+        {
+            if (objs[i] == objs[j])
+                same++;
+        }
+        uassert_int_equal(((struct tc_obj *)objs[i])->data[0], (rt_uint8_t)i);
+    }
+    uassert_int_equal(same, 0);
+
+    /* the objects in magazines hold the pages until the cache is shrunk */
+    for (i = 0; i < OBJ_NUM; i++)
+        rt_objcache_free(cache, objs[i]);
+    uassert_true(cache->page_count >= 1);
+
+    rt_objcache_shrink(cache);
+    uassert_int_equal(cache->page_count, 0);
+    uassert_int_equal(cache->page_peak, OBJ_NUM / PAGE_OBJS);
+    uassert_int_equal(dtor_count, ctor_count);
+}
+
+static void test_objcache_magazine(void)
+{
+    rt_uint32_t misses;
+    void *obj, *again;
+    int i;
+
+    obj = rt_objcache_alloc(cache);
+    uassert_not_null(obj);
+    rt_objcache_free(cache, obj);
+
+    /* the object just freed is taken from the magazine */
+    misses = cache->misses;
+    for (i = 0; i < 100; i++)
+    {
+        again = rt_objcache_alloc(cache);
+        uassert_true(again == obj);
+        rt_objcache_free(cache, again);
+    }
+    uassert_int_equal(cache->misses, misses);
+    /* the free objects in pages and magazines are reused, no page is added */
+    uassert_int_equal(cache->page_count, 1);
+
+    rt_objcache_free(cache, RT_NULL);
+    rt_objcache_shrink(cache);
+}
+
+static void isr_timeout(void *parameter)
+{
+    isr_obj = rt_objcache_alloc(cache);
+    isr_done = 1;
+}
+
+static void test_objcache_isr(void)
+{
+    void *obj;
+
+    /* no page, and the page can't be added in interrupt */
+    rt_objcache_shrink(cache);
+    isr_done = 0;
+    rt_timer_start(&isr_timer);
+    while (!isr_done)
+        rt_thread_mdelay(1);
+    uassert_null(isr_obj);
+
+    /* the cached object can be allocated in interrupt */
+    obj = rt_objcache_alloc(cache);
+    rt_objcache_free(cache, obj);
+    isr_done = 0;
+    rt_timer_start(&isr_timer);
+    while (!isr_done)
+        rt_thread_mdelay(1);
+    uassert_not_null(isr_obj);
+    rt_objcache_free(cache, isr_obj);
+    rt_objcache_shrink(cache);
+}
+
+static void worker_entry(void *parameter)
+{
+    rt_uint32_t id = (rt_uint32_t)(rt_ubase_t)parameter;
+    struct tc_obj *obj[8];
+    int i, j;
+
+    for (i = 0; i < WORKER_LOOPS; i++)
+    {
+        for (j = 0; j < 8; j++)
+        {
+            obj[j] = rt_objcache_alloc(cache);
+            if (obj[j] == RT_NULL)
+            {
+                worker_error++;
+                break;
+            }
+            obj[j]->owner = id;
+        }
+        if (i % 16 == 0)
+            rt_thread_mdelay(1);
+        /* no other one gets the same object at the same time */
+        while (j-- > 0)
+        {
+            if (obj[j]->owner != id || obj[j]->magic != 0x5A5A5A5A)
+                worker_error++;
+            rt_objcache_free(cache, obj[j]);
+        }
+    }
+    worker_done++;
+}
+
+static void test_objcache_threads(void)
+{
+    rt_uint8_t priority;
+    int i;
+
+    worker_done = worker_error = 0;
+    priority = rt_thread_self()->current_priority;
+    for (i = 0; i < WORKER_NUM; i++)
+    {
+        /* the workers use the different magazines */
+        workers[i] = rt_thread_create("tc_ocw", worker_entry, (void *)(rt_ubase_t)(i + 1), 1024,
+                                      priority + 1 + i * (RT_THREAD_PRIORITY_MAX - priority - 2) / WORKER_NUM, 2);
+        uassert_not_null(workers[i]);
+        if (workers[i] != RT_NULL)
+            rt_thread_startup(workers[i]);
+    }
+
+    for (i = 0; i < 500 && worker_done != WORKER_NUM; i++)
+        rt_thread_mdelay(10);
+    uassert_int_equal(worker_done, WORKER_NUM);
+    uassert_int_equal(worker_error, 0);
+    uassert_int_equal(cache->allocs, cache->frees);
+
+    rt_objcache_shrink(cache);
+    uassert_int_equal(cache->page_count, 0);
+}
+
+static rt_err_t utest_tc_init(void)
+{
+    cache = rt_objcache_create("tc_oc", sizeof(struct tc_obj), PAGE_OBJS, tc_ctor, tc_dtor);
+    if (cache == RT_NULL)
+        return -RT_ENOMEM;
+
+    rt_timer_init(&isr_timer, "tc_oct", isr_timeout, RT_NULL, 1,
+                  RT_TIMER_FLAG_ONE_SHOT | RT_TIMER_FLAG_HARD_TIMER);
+    return RT_EOK;
+}
+
+static rt_err_t utest_tc_cleanup(void)
+{
+    rt_timer_detach(&isr_timer);
+    rt_objcache_shrink(cache);
+    rt_objcache_delete(cache);
+    return RT_EOK;
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(test_objcache_create);
+    UTEST_UNIT_RUN(test_objcache_grow_shrink);
+    UTEST_UNIT_RUN(test_objcache_magazine);
+    UTEST_UNIT_RUN(test_objcache_isr);
+    UTEST_UNIT_RUN(test_objcache_threads);
+}
+UTEST_TC_EXPORT(testcase, "testcases.kernel.objcache_tc", utest_tc_init, utest_tc_cleanup, 20);
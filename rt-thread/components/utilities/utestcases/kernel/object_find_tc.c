@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rtthread.h>
+#include "utest.h"
+
+#define OBJ_NUM         48
+
+static struct rt_semaphore sem[OBJ_NUM];
+static struct rt_device dev[4];
+static char name[RT_NAME_MAX + 8];
+
+static void test_object_find(void)
+{
+    int i;
+
+    for (i = 0; i < OBJ_NUM; i++)
+    {
+        rt_snprintf(name, sizeof(name), "tc_of%d", i);
+        rt_sem_init(&sem[i], name, 0, RT_IPC_FLAG_FIFO);
+    }
+
+    for (i = 0; i < OBJ_NUM; i++)
+    {
+        rt_snprintf(name, sizeof(name), "tc_of%d", i);
+        uassert_true(rt_object_find(name, RT_Object_Class_Semaphore) == &(sem[i].parent.parent));
+        /* the same name in another class isn't found */
+        uassert_null(rt_object_find(name, RT_Object_Class_Mutex));
+    }
+    uassert_null(rt_object_find("tc_of", RT_Object_Class_Semaphore));
+    uassert_null(rt_object_find(RT_NULL, RT_Object_Class_Semaphore));
+
+    /* the detached objects leave the index, the others are still found */
+    for (i = 0; i < OBJ_NUM; i += 2)
+        rt_sem_detach(&sem[i]);
+    for (i = 0; i < OBJ_NUM; i++)
+    {
+        rt_snprintf(name, sizeof(name), "tc_of%d", i);
+        if (i % 2 == 0)
+            uassert_null(rt_object_find(name, RT_Object_Class_Semaphore));
+        else
+            uassert_true(rt_object_find(name, RT_Object_Class_Semaphore) == &(sem[i].parent.parent));
+    }
+
+    for (i = 1; i < OBJ_NUM; i += 2)
+        rt_sem_detach(&sem[i]);
+    uassert_null(rt_object_find("tc_of1", RT_Object_Class_Semaphore));
+}
+
+static void test_object_long_name(void)
+{
+    int i;
+
+    /* the name is truncated to RT_NAME_MAX when the object is initialized */
+    for (i = 0; i < (int)sizeof(name) - 1; i++)
+        name[i] = 'a' + i % 26;
+    name[sizeof(name) - 1] = '\0';
+
+    rt_sem_init(&sem[0], name, 0, RT_IPC_FLAG_FIFO);
+    uassert_true(rt_object_find(name, RT_Object_Class_Semaphore) == &(sem[0].parent.parent));
+    uassert_true(rt_object_find(sem[0].parent.parent.name, RT_Object_Class_Semaphore) == &(sem[0].parent.parent));
+    rt_sem_detach(&sem[0]);
+    uassert_null(rt_object_find(name, RT_Object_Class_Semaphore));
+}
+
+static void test_object_dynamic(void)
+{
+#ifdef RT_USING_HEAP
+    rt_sem_t dsem;
+    rt_thread_t thread;
+
+    dsem = rt_sem_create("tc_ofd", 0, RT_IPC_FLAG_FIFO);
+    uassert_not_null(dsem);
+    uassert_true(rt_object_find("tc_ofd", RT_Object_Class_Semaphore) == &(dsem->parent.parent));
+    rt_sem_delete(dsem);
+    uassert_null(rt_object_find("tc_ofd", RT_Object_Class_Semaphore));
+
+    /* the caller thread is found by its name */
+    thread = rt_thread_self();
+    rt_strncpy(name, thread->name, RT_NAME_MAX);
+    name[RT_NAME_MAX] = '\0';
+    uassert_true(rt_thread_find(name) == thread);
+#endif
+}
+
+#ifdef RT_USING_OBJECT_HASH
+static void test_object_rehash(void)
+{
+    rt_sem_init(&sem[0], "tc_old", 0, RT_IPC_FLAG_FIFO);
+
+    /* the name is changed in place, then the object is moved to the bucket */
+    rt_strncpy(sem[0].parent.parent.name, "tc_new", RT_NAME_MAX);
+    rt_object_rehash(&(sem[0].parent.parent));
+
+    uassert_true(rt_object_find("tc_new", RT_Object_Class_Semaphore) == &(sem[0].parent.parent));
+    uassert_null(rt_object_find("tc_old", RT_Object_Class_Semaphore));
+
+    rt_sem_detach(&sem[0]);
+    uassert_null(rt_object_find("tc_new", RT_Object_Class_Semaphore));
+}
+#endif
+
+static void test_device_find(void)
+{
+    int i;
+
+    for (i = 0; i < 4; i++)
+    {
+        rt_memset(&dev[i], 0, sizeof(dev[i]));
+        rt_snprintf(name, sizeof(name), "tc_dev%d", i);
+        uassert_int_equal(rt_device_register(&dev[i], name, RT_DEVICE_FLAG_RDWR), RT_EOK);
+    }
+
+    for (i = 0; i < 4; i++)
+    {
+        rt_snprintf(name, sizeof(name), "tc_dev%d", i);
+        uassert_true(rt_device_find(name) == &dev[i]);
+    }
+    uassert_null(rt_device_find("tc_dev"));
+
+    rt_device_unregister(&dev[1]);
+    uassert_null(rt_device_find("tc_dev1"));
+    uassert_true(rt_device_find("tc_dev2") == &dev[2]);
+
+    for (i = 0; i < 4; i++)
+    {
+        if (i != 1)
+            rt_device_unregister(&dev[i]);
+    }
+    uassert_null(rt_device_find("tc_dev0"));
+}
+
+static rt_err_t utest_tc_init(void)
+{
+    return RT_EOK;
+}
+
+static rt_err_t utest_tc_cleanup(void)
+{
+    return RT_EOK;
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(test_object_find);
+    UTEST_UNIT_RUN(test_object_long_name);
+    UTEST_UNIT_RUN(test_object_dynamic);
+#ifdef RT_USING_OBJECT_HASH
+    UTEST_UNIT_RUN(test_object_rehash);
+#endif
+    UTEST_UNIT_RUN(test_device_find);
+}
+UTEST_TC_EXPORT(testcase, "testcases.kernel.object_find_tc", utest_tc_init, utest_tc_cleanup, 10);
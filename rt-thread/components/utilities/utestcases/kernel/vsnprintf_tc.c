@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rtthread.h>
+#include "utest.h"
+
+static char buf[128];
+
+#define uassert_format(expect, ...)                                             \
+    do                                                                          \
+    {                                                                           \
+        rt_int32_t len = rt_snprintf(buf, sizeof(buf), __VA_ARGS__);            \
+        uassert_int_equal(len, rt_strlen(expect));                              \
+        uassert_str_equal(buf, expect);                                         \
+    } while (0)
+
+static void test_snprintf_integer(void)
+{
+    uassert_format("0", "%d", 0);
+    uassert_format("7", "%d", 7);
+    uassert_format("-7", "%d", -7);
+    uassert_format("99 100 101", "%d %d %d", 99, 100, 101);
+    uassert_format("2147483647", "%d", 2147483647);
+    uassert_format("-2147483648", "%d", (int)0x80000000);
+    uassert_format("4294967295", "%u", 0xFFFFFFFFu);
+    uassert_format("1234567890", "%u", 1234567890u);
+
+    uassert_format("0", "%x", 0);
+    uassert_format("deadbeef", "%x", 0xDEADBEEF);
+    uassert_format("DEADBEEF", "%X", 0xDEADBEEF);
+    uassert_format("17777777777", "%o", 0x7FFFFFFF);
+    uassert_format("10", "%o", 8);
+
+    uassert_format("c", "%c", 'c');
+    uassert_format("str", "%s", "str");
+    uassert_format("(NULL)", "%s", (char *)RT_NULL);
+    uassert_format("100%", "%d%%", 100);
+
+#ifdef RT_PRINTF_LONGLONG
+    uassert_format("18446744073709551615", "%llu", 0xFFFFFFFFFFFFFFFFull);
+    uassert_format("-9223372036854775808", "%lld", (long long)0x8000000000000000ull);
+    uassert_format("1000000000000000000", "%lld", 1000000000000000000ll);
+    uassert_format("ffffffffffffffff", "%llx", 0xFFFFFFFFFFFFFFFFull);
+    uassert_format("1777777777777777777777", "%llo", 0xFFFFFFFFFFFFFFFFull);
+#endif
+}
+
+static void test_snprintf_width(void)
+{
+    uassert_format("   42", "%5d", 42);
+    uassert_format("42   |", "%-5d|", 42);
+    uassert_format("00042", "%05d", 42);
+    uassert_format("-0042", "%05d", -42);
+    uassert_format("+42", "%+d", 42);
+    uassert_format(" 42", "% d", 42);
+    uassert_format("   42", "%*d", 5, 42);
+    uassert_format("  abc", "%5s", "abc");
+    uassert_format("abc  |", "%-5s|", "abc");
+#ifdef RT_PRINTF_SPECIAL
+    uassert_format("0x1f", "%#x", 0x1F);
+    uassert_format("017", "%#o", 15);
+#endif
+#ifdef RT_PRINTF_PRECISION
+    uassert_format("00042", "%.5d", 42);
+    /* the '0' flag is ignored when a precision is given */
+    uassert_format("  042", "%05.3d", 42);
+    uassert_format("1", "%.0d", 1);
+    uassert_format("ab", "%.2s", "abc");
+    uassert_format("000000ff", "%.8x", 0xFF);
+#endif
+}
+
+static void test_snprintf_truncate(void)
+{
+    char small[8];
+    rt_int32_t len;
+
+    rt_memset(small, 'x', sizeof(small));
+    /* the length of the whole output is returned, the buffer is terminated */
+    len = rt_snprintf(small, 5, "%d", 123456789);
+    uassert_int_equal(len, 9);
+    uassert_str_equal(small, "1234");
+    uassert_int_equal(small[5], 'x');
+
+    len = rt_snprintf(small, 1, "%s", "abc");
+    uassert_int_equal(len, 3);
+    uassert_int_equal(small[0], '\0');
+
+    /* nothing is written into the zero sized buffer */
+    small[0] = 'x';
+    len = rt_snprintf(small, 0, "%x", 0xABCD);
+    uassert_int_equal(len, 4);
+    uassert_int_equal(small[0], 'x');
+
+    rt_memset(small, 'x', sizeof(small));
+    len = rt_snprintf(small, sizeof(small), "%-10d|", -1);
+    uassert_int_equal(len, 11);
+    uassert_str_equal(small, "-1     ");
+}
+
+#ifdef RT_PRINTF_FLOAT
+static void test_snprintf_float(void)
+{
+    union
+    {
+        double d;
+        rt_uint64_t bits;
+    } nan;
+
+    /* the quiet NaN with the sign bit clear */
+    nan.bits = 0x7FF8000000000000ULL;
+    uassert_format("3.141593", "%f", 3.14159265358979);
+    uassert_format("-0.500", "%.3f", -0.5);
+    uassert_format("0", "%.0f", 0.5);
+    uassert_format("2", "%.0f", 1.5);
+    uassert_format("2", "%.0f", 2.5);
+    uassert_format("0.1000000000000000055511151231257827", "%.34f", 0.1);
+    uassert_format("1e+100", "%.0e", 1e100);
+    uassert_format("1.234500e+03", "%e", 1234.5);
+    uassert_format("1.2345E-07", "%.4E", 1.2345e-7);
+    uassert_format("123457", "%g", 123456.7);
+    uassert_format("1.23457e+06", "%g", 1234567.0);
+    uassert_format("0.0001", "%g", 0.0001);
+    uassert_format("1e-05", "%g", 0.00001);
+    uassert_format("   1.50", "%7.2f", 1.5);
+    uassert_format("-001.50", "%07.2f", -1.5);
+    uassert_format("+1.0", "%+.1f", 1.0);
+    uassert_format("18446744073709551616.0", "%.1f", 18446744073709551616.0);
+    uassert_format("4.940656e-324", "%e", 4.9406564584124654e-324);
+    uassert_format("inf -inf nan", "%f %f %f", 1.0 / 0.0, -1.0 / 0.0, nan.d);
+    uassert_format("  -nan", "%6f", -nan.d);
+    uassert_format("INF", "%F", 1.0 / 0.0);
+}
+#endif /* RT_PRINTF_FLOAT */
+
+static rt_err_t utest_tc_init(void)
+{
+    return RT_EOK;
+}
+
+static rt_err_t utest_tc_cleanup(void)
+{
+    return RT_EOK;
+}
+
+static void testcase(void)
+{
+    UTEST_UNIT_RUN(test_snprintf_integer);
+    UTEST_UNIT_RUN(test_snprintf_width);
+    UTEST_UNIT_RUN(test_snprintf_truncate);
+#ifdef RT_PRINTF_FLOAT
+    UTEST_UNIT_RUN(test_snprintf_float);
+#endif
+}
+UTEST_TC_EXPORT(testcase, "testcases.kernel.vsnprintf_tc", utest_tc_init, utest_tc_cleanup, 10);
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#ifndef __RT_ATOMIC_H__
+#define __RT_ATOMIC_H__
+
+#include <rthw.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * The atomic operations on rt_atomic_t. All of them are sequentially
+ * consistent. The implementation is chosen in this order:
+ *
+ * RT_USING_STDC_ATOMIC: the __atomic builtins of compiler, e.g. host build
+ * RT_USING_HW_ATOMIC:   the libcpu port, e.g. LDREX/STREX on ARMv7
+ * otherwise:            the interrupt lock
+ */
+
+#if defined(RT_USING_STDC_ATOMIC)
+
+#define rt_atomic_load(ptr)             __atomic_load_n((ptr), __ATOMIC_SEQ_CST)
+#define rt_atomic_store(ptr, val)       __atomic_store_n((ptr), (val), __ATOMIC_SEQ_CST)
+#define rt_atomic_add(ptr, val)         __atomic_fetch_add((ptr), (val), __ATOMIC_SEQ_CST)
+#define rt_atomic_sub(ptr, val)         __atomic_fetch_sub((ptr), (val), __ATOMIC_SEQ_CST)
+#define rt_atomic_exchange(ptr, val)    __atomic_exchange_n((ptr), (val), __ATOMIC_SEQ_CST)
+#define rt_atomic_compare_exchange_strong(ptr, old, val) \
+    __atomic_compare_exchange_n((ptr), (old), (val), 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
+
+#elif defined(RT_USING_HW_ATOMIC)
+
+rt_atomic_t rt_hw_atomic_load(volatile rt_atomic_t *ptr);
+void rt_hw_atomic_store(volatile rt_atomic_t *ptr, rt_atomic_t val);
+rt_atomic_t rt_hw_atomic_add(volatile rt_atomic_t *ptr, rt_atomic_t val);
+rt_atomic_t rt_hw_atomic_sub(volatile rt_atomic_t *ptr, rt_atomic_t val);
+rt_atomic_t rt_hw_atomic_exchange(volatile rt_atomic_t *ptr, rt_atomic_t val);
+rt_bool_t rt_hw_atomic_compare_exchange_strong(volatile rt_atomic_t *ptr, rt_atomic_t *old, rt_atomic_t val);
+
+#define rt_atomic_load(ptr)             rt_hw_atomic_load(ptr)
+#define rt_atomic_store(ptr, val)       rt_hw_atomic_store((ptr), (val))
+#define rt_atomic_add(ptr, val)         rt_hw_atomic_add((ptr), (val))
+#define rt_atomic_sub(ptr, val)         rt_hw_atomic_sub((ptr), (val))
+#define rt_atomic_exchange(ptr, val)    rt_hw_atomic_exchange((ptr), (val))
+#define rt_atomic_compare_exchange_strong(ptr, old, val) \
+    rt_hw_atomic_compare_exchange_strong((ptr), (old), (val))
+
+#else
+
+rt_inline rt_atomic_t rt_soft_atomic_load(volatile rt_atomic_t *ptr)
+{
+    return *ptr;
+}
+
+rt_inline void rt_soft_atomic_store(volatile rt_atomic_t *ptr, rt_atomic_t val)
+{
+    *ptr = val;
+}
+
+rt_inline rt_atomic_t rt_soft_atomic_add(volatile rt_atomic_t *ptr, rt_atomic_t val)
+{
+    rt_base_t level;
+    rt_atomic_t result;
+
+    level = rt_hw_interrupt_disable();
+    result = *ptr;
+    *ptr = result + val;
+    rt_hw_interrupt_enable(level);
+
+    return result;
+}
+
+rt_inline rt_atomic_t rt_soft_atomic_sub(volatile rt_atomic_t *ptr, rt_atomic_t val)
+{
+    return rt_soft_atomic_add(ptr, -val);
+}
+
+rt_inline rt_atomic_t rt_soft_atomic_exchange(volatile rt_atomic_t *ptr, rt_atomic_t val)
+{
+    rt_base_t level;
+    rt_atomic_t result;
+
+    level = rt_hw_interrupt_disable();
+    result = *ptr;
+    *ptr = val;
+    rt_hw_interrupt_enable(level);
+
+    return result;
+}
+
+rt_inline rt_bool_t rt_soft_atomic_compare_exchange_strong(volatile rt_atomic_t *ptr, rt_atomic_t *old, rt_atomic_t val)
+{
+    rt_base_t level;
+    rt_bool_t result = RT_FALSE;
+
+    level = rt_hw_interrupt_disable();
+    if (*ptr == *old)
+    {
+        *ptr = val;
+        result = RT_TRUE;
+    }
+    else
+    {
+        *old = *ptr;
+    }
+    rt_hw_interrupt_enable(level);
+
+    return result;
+}
+
+#define rt_atomic_load(ptr)             rt_soft_atomic_load(ptr)
+#define rt_atomic_store(ptr, val)       rt_soft_atomic_store((ptr), (val))
+#define rt_atomic_add(ptr, val)         rt_soft_atomic_add((ptr), (val))
+#define rt_atomic_sub(ptr, val)         rt_soft_atomic_sub((ptr), (val))
+#define rt_atomic_exchange(ptr, val)    rt_soft_atomic_exchange((ptr), (val))
+#define rt_atomic_compare_exchange_strong(ptr, old, val) \
+    rt_soft_atomic_compare_exchange_strong((ptr), (old), (val))
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RT_ATOMIC_H__ */
@@ -31,6 +31,11 @@
  *                             add smp relevant macros
  * 2019-01-27     Bernard      change version number to v4.0.1
  * 2019-05-17     Bernard      change version number to v4.0.2
+ * 2026-10-19     Hehesheng    add rt_atomic_t and atomic semaphore value
+ * 2026-10-19     Hehesheng    add stack high water fields to rt_thread
+ * 2026-10-19     Hehesheng    add object cache structure
+ * 2026-10-19     Hehesheng    add softirq structure
+ * 2026-10-19     Hehesheng    add waiting buckets to event
  */
 
 #ifndef __RT_DEF_H__
@@ -87,6 +92,7 @@ typedef rt_base_t                       rt_flag_t;      /**< Type for flags */
 typedef rt_ubase_t                      rt_size_t;      /**< Type for size number */
 typedef rt_ubase_t                      rt_dev_t;       /**< Type for device */
 typedef rt_base_t                       rt_off_t;       /**< Type for offset */
+typedef rt_base_t                       rt_atomic_t;    /**< Type for atomic operations */
 
 /* boolean type definitions */
 #define RT_TRUE                         1               /**< boolean true  */
@@ -349,6 +355,11 @@ struct rt_object
     void      *module_id;                               /**< id of application module */
 #endif
     rt_list_t  list;                                    /**< list node of kernel object */
+
+#ifdef RT_USING_OBJECT_HASH
+    rt_uint32_t name_hash;                              /**< hash value of object name */
+    rt_slist_t  hash_node;                              /**< node in the name hash bucket */
+#endif
 };
 typedef struct rt_object *rt_object_t;                  /**< Type for kernel objects. */
 
@@ -395,6 +406,9 @@ struct rt_object_information
     enum rt_object_class_type type;                     /**< object class type */
     rt_list_t                 object_list;              /**< object list */
     rt_size_t                 object_size;              /**< object size */
+#ifdef RT_USING_OBJECT_HASH
+    rt_slist_t                hash_table[RT_OBJECT_HASH_BUCKETS]; /**< name hash buckets */
+#endif
 };
 
 /**
@@ -457,6 +471,31 @@ struct rt_timer
 };
 typedef struct rt_timer *rt_timer_t;
 
+#ifdef RT_USING_SOFTIRQ
+/**
+ * softirq structure, the bottom half of interrupt
+ */
+struct rt_softirq
+{
+    char        name[RT_NAME_MAX];                      /**< name of softirq */
+    rt_list_t   node;                                   /**< node in softirq list */
+    rt_list_t   list;                                   /**< node in pending queue */
+
+    void (*handler)(void *parameter);                   /**< bottom half handler */
+    void       *parameter;                              /**< parameter of handler */
+    rt_uint8_t  priority;                               /**< priority of softirq */
+    rt_uint8_t  pending;                                /**< raised and not run yet */
+
+    rt_uint32_t stamp;                                  /**< timestamp of interrupt entry */
+    rt_uint32_t count;                                  /**< numbers of run */
+    rt_uint32_t latency_max;                            /**< maximal latency from interrupt entry */
+    rt_uint32_t duration_max;                           /**< maximal run time of handler */
+    rt_uint64_t latency_sum;                            /**< total latency from interrupt entry */
+    rt_uint64_t duration_sum;                           /**< total run time of handler */
+};
+typedef struct rt_softirq *rt_softirq_t;
+#endif
+
 /**@}*/
 
 /**
@@ -542,6 +581,20 @@ struct rt_cpu
 
 #endif
 
+#ifdef RT_USING_SCHED_FASTPATH
+/**
+ * Scheduler statistics
+ */
+struct rt_schedule_stats
+{
+    rt_uint32_t calls;                                  /**< the invoked times of rt_schedule */
+    rt_uint32_t deferred;                               /**< the calls deferred by scheduler lock */
+    rt_uint32_t fast;                                   /**< the calls returned by the fast path */
+    rt_uint32_t switches;                               /**< the thread switches */
+    rt_uint32_t unlock_skipped;                         /**< the unlocks without schedule */
+};
+#endif
+
 /**
  * Thread structure
  */
@@ -557,6 +610,10 @@ struct rt_thread
 #endif
 
     rt_list_t   list;                                   /**< the object list */
+#ifdef RT_USING_OBJECT_HASH
+    rt_uint32_t name_hash;                              /**< hash value of thread name */
+    rt_slist_t  hash_node;                              /**< node in the name hash bucket */
+#endif
     rt_list_t   tlist;                                  /**< the thread list */
 
     /* stack point and entry */
@@ -565,6 +622,11 @@ struct rt_thread
     void       *parameter;                              /**< parameter */
     void       *stack_addr;                             /**< stack address */
     rt_uint32_t stack_size;                             /**< stack size */
+#ifdef RT_USING_STACKMON
+    rt_uint32_t stack_peak;                             /**< peak stack usage found by stackmon */
+    rt_uint32_t stack_scan;                             /**< stackmon scan position */
+    rt_uint8_t  stack_warn;                             /**< stackmon warning state */
+#endif
 
     /* error code */
     rt_err_t    error;                                  /**< error code */
@@ -659,8 +721,12 @@ struct rt_semaphore
 {
     struct rt_ipc_object parent;                        /**< inherit from ipc_object */
 
+#ifdef RT_USING_IPC_ATOMIC
+    rt_atomic_t          value;                         /**< value of semaphore, updated atomically */
+#else
     rt_uint16_t          value;                         /**< value of semaphore. */
     rt_uint16_t          reserved;                      /**< reserved field */
+#endif
 };
 typedef struct rt_semaphore *rt_sem_t;
 #endif
@@ -699,6 +765,13 @@ struct rt_event
     struct rt_ipc_object parent;                        /**< inherit from ipc_object */
 
     rt_uint32_t          set;                           /**< event set */
+
+#ifdef RT_USING_EVENT_BUCKETS
+    /* the waiting threads are bucketed by the lowest requested bit, and the
+     * first bucket is the suspend_thread of ipc object */
+    rt_list_t            wait_list[RT_EVENT_WAIT_BUCKETS - 1];  /**< waiting threads of bucket */
+    rt_uint32_t          wait_mask[RT_EVENT_WAIT_BUCKETS];      /**< bits requested by waiting threads of bucket */
+#endif
 };
 typedef struct rt_event *rt_event_t;
 #endif
@@ -820,6 +893,43 @@ struct rt_mempool
 typedef struct rt_mempool *rt_mp_t;
 #endif
 
+#ifdef RT_USING_OBJCACHE
+/**
+ * Magazine of object cache, the objects cached for one priority band
+ */
+struct rt_objcache_magazine
+{
+    rt_uint16_t      count;                             /**< numbers of cached object */
+    void            *objs[RT_OBJCACHE_MAGAZINE_SIZE];   /**< cached objects */
+};
+
+/**
+ * Base structure of object cache, the objects are allocated from memory pool
+ * pages and cached in magazines
+ */
+struct rt_objcache
+{
+    char             name[RT_NAME_MAX];                 /**< name of object cache */
+    rt_list_t        list;                              /**< node in object cache list */
+
+    rt_size_t        obj_size;                          /**< size of object */
+    rt_size_t        page_objs;                         /**< numbers of object in each page */
+    void (*ctor)(void *obj);                            /**< constructor of object */
+    void (*dtor)(void *obj);                            /**< destructor of object */
+
+    rt_list_t        pages;                             /**< memory pool pages */
+    rt_uint16_t      page_count;                        /**< numbers of page */
+    rt_uint16_t      page_peak;                         /**< maximal numbers of page */
+
+    rt_uint32_t      allocs;                            /**< numbers of allocation */
+    rt_uint32_t      frees;                             /**< numbers of release */
+    rt_uint32_t      misses;                            /**< numbers of empty magazine */
+
+    struct rt_objcache_magazine magazine[RT_OBJCACHE_MAGAZINES];
+};
+typedef struct rt_objcache *rt_objcache_t;
+#endif
+
 /**@}*/
 
 #ifdef RT_USING_DEVICE
@@ -51,6 +51,11 @@ void rt_object_delete(rt_object_t object);
 rt_bool_t rt_object_is_systemobject(rt_object_t object);
 rt_uint8_t rt_object_get_type(rt_object_t object);
 rt_object_t rt_object_find(const char *name, rt_uint8_t type);
+#ifdef RT_USING_OBJECT_HASH
+rt_object_t rt_object_hash_find(struct rt_object_information *information,
+                                const char                   *name);
+void rt_object_rehash(rt_object_t object);
+#endif
 
 #ifdef RT_USING_HOOK
 void rt_object_attach_sethook(void (*hook)(struct rt_object *object));
@@ -181,6 +186,11 @@ void rt_enter_critical(void);
 void rt_exit_critical(void);
 rt_uint16_t rt_critical_level(void);
 
+#ifdef RT_USING_SCHED_FASTPATH
+void rt_schedule_get_stats(struct rt_schedule_stats *stats);
+void rt_schedule_reset_stats(void);
+#endif
+
 #ifdef RT_USING_HOOK
 void rt_scheduler_sethook(void (*hook)(rt_thread_t from, rt_thread_t to));
 #endif
@@ -239,6 +249,23 @@ void rt_mp_free_sethook(void (*hook)(struct rt_mempool *mp, void *block));
 
 #endif
 
+#ifdef RT_USING_OBJCACHE
+/*
+ * object cache interface
+ */
+rt_objcache_t rt_objcache_create(const char *name,
+                                 rt_size_t   obj_size,
+                                 rt_size_t   page_objs,
+                                 void (*ctor)(void *obj),
+                                 void (*dtor)(void *obj));
+rt_err_t rt_objcache_delete(rt_objcache_t cache);
+
+void *rt_objcache_alloc(rt_objcache_t cache);
+void rt_objcache_free(rt_objcache_t cache, void *obj);
+rt_size_t rt_objcache_shrink(rt_objcache_t cache);
+rt_objcache_t rt_objcache_find(const char *name);
+#endif
+
 #ifdef RT_USING_HEAP
 /*
  * heap memory interface
@@ -264,6 +291,10 @@ void rt_page_free(void *addr, rt_size_t npages);
 #ifdef RT_USING_HOOK
 void rt_malloc_sethook(void (*hook)(void *ptr, rt_size_t size));
 void rt_free_sethook(void (*hook)(void *ptr));
+#ifdef RT_USING_MEMHEAP_AS_HEAP
+void rt_malloc_caller_sethook(void (*hook)(void *ptr, rt_size_t size, void *caller));
+void rt_free_caller_sethook(void (*hook)(void *ptr, void *caller));
+#endif
 #endif
 
 #endif
@@ -385,6 +416,12 @@ rt_err_t rt_mq_recv(rt_mq_t    mq,
                     rt_size_t  size,
                     rt_int32_t timeout);
 rt_err_t rt_mq_control(rt_mq_t mq, int cmd, void *arg);
+
+void *rt_mq_loan(rt_mq_t mq);
+rt_err_t rt_mq_commit(rt_mq_t mq, void *buffer, rt_bool_t urgent);
+rt_err_t rt_mq_cancel(rt_mq_t mq, void *buffer);
+rt_err_t rt_mq_peek(rt_mq_t mq, void **buffer, rt_int32_t timeout);
+rt_err_t rt_mq_release(rt_mq_t mq, void *buffer);
 #endif
 
 /**@}*/
@@ -463,6 +500,22 @@ struct rt_cpu *rt_cpu_index(int index);
  */
 rt_uint8_t rt_interrupt_get_nest(void);
 
+#ifdef RT_USING_SOFTIRQ
+/*
+ * softirq interface
+ */
+void rt_softirq_init(rt_softirq_t softirq,
+                     const char  *name,
+                     void (*handler)(void *parameter),
+                     void        *parameter,
+                     rt_uint8_t   priority);
+void rt_softirq_detach(rt_softirq_t softirq);
+void rt_softirq_raise(rt_softirq_t softirq);
+void rt_softirq_run(void);
+rt_uint32_t rt_softirq_timestamp(void);
+rt_uint32_t rt_softirq_timestamp_freq(void);
+#endif
+
 #ifdef RT_USING_HOOK
 void rt_interrupt_enter_sethook(void (*hook)(void));
 void rt_interrupt_leave_sethook(void (*hook)(void));
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rtthread.h>
+#include <rtatomic.h>
+
+#if defined(RT_USING_HW_ATOMIC) && !defined(RT_USING_STDC_ATOMIC)
+
+/*
+ * The atomic operations with the exclusive access instructions of ARMv7-M
+ * and later, ARMv6-M has no LDREX/STREX. The exclusive monitor is cleared on exception entry and return,
+ * so the store fails if the sequence is interrupted on a single core.
+ */
+
+#if defined(__CC_ARM)
+#define _ldrex(ptr)                     __ldrex(ptr)
+#define _strex(val, ptr)                __strex((val), (ptr))
+#define _dmb()                          __dmb(0xF)
+#elif defined(__IAR_SYSTEMS_ICC__)
+#include <intrinsics.h>
+#define _ldrex(ptr)                     __LDREX((unsigned long *)(ptr))
+#define _strex(val, ptr)                __STREX((val), (unsigned long *)(ptr))
+#define _dmb()                          __DMB()
+#elif defined(__GNUC__)
+rt_inline rt_atomic_t _ldrex(volatile rt_atomic_t *ptr)
+{
+    rt_atomic_t val;
+
+    __asm volatile ("ldrex %0, [%1]" : "=r" (val) : "r" (ptr) : "memory");
+    return val;
+}
+
+/* return 0 on success */
+rt_inline rt_uint32_t _strex(rt_atomic_t val, volatile rt_atomic_t *ptr)
+{
+    rt_uint32_t result;
+
+    __asm volatile ("strex %0, %2, [%1]" : "=&r" (result) : "r" (ptr), "r" (val) : "memory");
+    return result;
+}
+
+#define _dmb()                          __asm volatile ("dmb" ::: "memory")
+#else
+#error "atomic: not supported tool chain"
+#endif
+
+rt_atomic_t rt_hw_atomic_load(volatile rt_atomic_t *ptr)
+{
+    rt_atomic_t val;
+
+    _dmb();
+    val = *ptr;
+    _dmb();
+
+    return val;
+}
+
+void rt_hw_atomic_store(volatile rt_atomic_t *ptr, rt_atomic_t val)
+{
+    _dmb();
+    *ptr = val;
+    _dmb();
+}
+
+rt_atomic_t rt_hw_atomic_add(volatile rt_atomic_t *ptr, rt_atomic_t val)
+{
+    rt_atomic_t old;
+
+    _dmb();
+    do
+    {
+        old = _ldrex(ptr);
+    }
+    while (_strex(old + val, ptr) != 0);
+    _dmb();
+
+    return old;
+}
+
+rt_atomic_t rt_hw_atomic_sub(volatile rt_atomic_t *ptr, rt_atomic_t val)
+{
+    rt_atomic_t old;
+
+    _dmb();
+    do
+    {
+        old = _ldrex(ptr);
+    }
+    while (_strex(old - val, ptr) != 0);
+    _dmb();
+
+    return old;
+}
+
+rt_atomic_t rt_hw_atomic_exchange(volatile rt_atomic_t *ptr, rt_atomic_t val)
+{
+    rt_atomic_t old;
+
+    _dmb();
+    do
+    {
+        old = _ldrex(ptr);
+    }
+    while (_strex(val, ptr) != 0);
+    _dmb();
+
+    return old;
+}
+
+rt_bool_t rt_hw_atomic_compare_exchange_strong(volatile rt_atomic_t *ptr, rt_atomic_t *old, rt_atomic_t val)
+{
+    rt_atomic_t cur;
+
+    _dmb();
+    do
+    {
+        cur = _ldrex(ptr);
+        if (cur != *old)
+        {
+            /* clear the exclusive monitor by a dummy store */
+            _strex(cur, ptr);
+            _dmb();
+            *old = cur;
+
+            return RT_FALSE;
+        }
+    }
+    while (_strex(val, ptr) != 0);
+    _dmb();
+
+    return RT_TRUE;
+}
+
+#endif /* RT_USING_HW_ATOMIC */
@@ -15,6 +15,7 @@
  * 2013-06-23     aozima       support lazy stack optimized.
  * 2018-07-24     aozima       enhancement hard fault exception handler.
  * 2019-07-03     yangjie      add __rt_ffs() for armclang.
+ * 2026-10-19     Hehesheng    add DWT cycle counter as softirq timestamp.
  */
 
 #include <rtthread.h>
@@ -443,6 +444,38 @@ RT_WEAK void rt_hw_cpu_reset(void)
     SCB_AIRCR = SCB_RESET_VALUE;
 }
 
+#ifdef RT_USING_SOFTIRQ
+#define DEMCR                   (*(volatile rt_uint32_t *)0xE000EDFC)
+#define DWT_CTRL                (*(volatile rt_uint32_t *)0xE0001000)
+#define DWT_CYCCNT              (*(volatile rt_uint32_t *)0xE0001004)
+#define DEMCR_TRCENA            (1UL << 24)
+#define DWT_CTRL_CYCCNTENA      (1UL << 0)
+
+extern rt_uint32_t SystemCoreClock;
+
+/**
+ * This function returns the DWT cycle counter to measure the softirq latency.
+ */
+rt_uint32_t rt_softirq_timestamp(void)
+{
+    if (!(DWT_CTRL & DWT_CTRL_CYCCNTENA))
+    {
+        DEMCR |= DEMCR_TRCENA;
+        DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+    }
+
+    return DWT_CYCCNT;
+}
+
+/**
+ * This function returns the frequency of DWT cycle counter.
+ */
+rt_uint32_t rt_softirq_timestamp_freq(void)
+{
+    return SystemCoreClock;
+}
+#endif
+
 #ifdef RT_USING_CPU_FFS
 /**
  * This function finds the first bit set (beginning with the least significant bit)
@@ -111,6 +111,15 @@ rt_err_t rt_device_init_all(void)
  */
 rt_device_t rt_device_find(const char *name)
 {
+#ifdef RT_USING_OBJECT_HASH
+    struct rt_object_information *information;
+
+    /* find device object in the name hash index */
+    information = rt_object_get_information(RT_Object_Class_Device);
+    RT_ASSERT(information != RT_NULL);
+
+    return (rt_device_t)rt_object_hash_find(information, name);
+#else
     struct rt_object *object;
     struct rt_list_node *node;
     struct rt_object_information *information;
@@ -143,6 +152,7 @@ rt_device_t rt_device_find(const char *name)
 
     /* not found */
     return RT_NULL;
+#endif
 }
 RTM_EXPORT(rt_device_find);
 
@@ -33,10 +33,16 @@
  * 2011-12-18     Bernard      add more parameter checking in message queue
  * 2013-09-14     Grissiom     add an option check in rt_event_recv
  * 2018-10-02     Bernard      add 64bit support for mailbox
+ * 2026-10-19     Hehesheng    add zero-copy loan/commit and peek/release for message queue
+ * 2026-10-19     Hehesheng    add atomic fast path for uncontended semaphore and mutex
+ * 2026-10-19     Hehesheng    bucket the threads waiting on event by requested bits
  */
 
 #include <rtthread.h>
 #include <rthw.h>
+#ifdef RT_USING_IPC_ATOMIC
+#include <rtatomic.h>
+#endif
 
 #ifdef RT_USING_HOOK
 extern void (*rt_object_trytake_hook)(struct rt_object *object);
@@ -311,6 +317,23 @@ rt_err_t rt_sem_delete(rt_sem_t sem)
 RTM_EXPORT(rt_sem_delete);
 #endif
 
+#ifdef RT_USING_IPC_ATOMIC
+/* take a count of semaphore by compare-and-swap, it never blocks */
+rt_inline rt_err_t _rt_sem_trytake_atomic(rt_sem_t sem)
+{
+    rt_atomic_t value;
+
+    value = rt_atomic_load(&(sem->value));
+    while (value > 0)
+    {
+        if (rt_atomic_compare_exchange_strong(&(sem->value), &value, value - 1))
+            return RT_EOK;
+    }
+
+    return -RT_ETIMEOUT;
+}
+#endif
+
 /**
  * This function will take a semaphore, if the semaphore is unavailable, the
  * thread shall wait for a specified time.
@@ -331,6 +354,16 @@ rt_err_t rt_sem_take(rt_sem_t sem, rt_int32_t time)
 
     RT_OBJECT_HOOK_CALL(rt_object_trytake_hook, (&(sem->parent.parent)));
 
+#ifdef RT_USING_IPC_ATOMIC
+    /* fast path: take an available count without disabling interrupt */
+    if (_rt_sem_trytake_atomic(sem) == RT_EOK)
+    {
+        RT_OBJECT_HOOK_CALL(rt_object_take_hook, (&(sem->parent.parent)));
+
+        return RT_EOK;
+    }
+#endif
+
     /* disable interrupt */
     temp = rt_hw_interrupt_disable();
 
@@ -442,6 +475,33 @@ rt_err_t rt_sem_release(rt_sem_t sem)
 
     need_schedule = RT_FALSE;
 
+#ifdef RT_USING_IPC_ATOMIC
+    /* fast path: no thread is waiting, increase value without disabling interrupt */
+    if (rt_list_isempty(&sem->parent.suspend_thread))
+    {
+        rt_atomic_add(&(sem->value), 1);
+
+        /* a thread may be suspended before the value is increased */
+        if (rt_list_isempty(&sem->parent.suspend_thread))
+            return RT_EOK;
+
+        temp = rt_hw_interrupt_disable();
+        /* hand over the count if it is not taken by others */
+        if (!rt_list_isempty(&sem->parent.suspend_thread) && sem->value > 0)
+        {
+            sem->value --;
+            rt_ipc_list_resume(&(sem->parent.suspend_thread));
+            need_schedule = RT_TRUE;
+        }
+        rt_hw_interrupt_enable(temp);
+
+        if (need_schedule == RT_TRUE)
+            rt_schedule();
+
+        return RT_EOK;
+    }
+#endif
+
     /* disable interrupt */
     temp = rt_hw_interrupt_disable();
 
@@ -641,6 +701,163 @@ rt_err_t rt_mutex_delete(rt_mutex_t mutex)
 RTM_EXPORT(rt_mutex_delete);
 #endif
 
+#ifdef RT_USING_IPC_ATOMIC
+/* the highest priority of threads suspended on mutex, with interrupt disabled */
+static rt_uint8_t _rt_mutex_waiter_priority(rt_mutex_t mutex)
+{
+    struct rt_list_node *node;
+    struct rt_thread *thread;
+    rt_uint8_t priority = 0xff;
+
+    rt_list_for_each(node, &(mutex->parent.suspend_thread))
+    {
+        thread = rt_list_entry(node, struct rt_thread, tlist);
+        if (thread->current_priority < priority)
+            priority = thread->current_priority;
+    }
+
+    return priority;
+}
+
+/*
+ * The fast path reads the priority before owning the mutex. If the priority
+ * is changed in this window, it's raised by another mutex of this thread or
+ * inherited from the thread waiting on this mutex.
+ */
+static void _rt_mutex_take_fixup(rt_mutex_t mutex, struct rt_thread *thread, rt_uint8_t priority)
+{
+    register rt_base_t temp;
+    rt_uint8_t waiter_priority;
+
+    temp = rt_hw_interrupt_disable();
+
+    waiter_priority = _rt_mutex_waiter_priority(mutex);
+    if (thread->current_priority != priority && waiter_priority > thread->current_priority)
+    {
+        /* raised by another mutex, keep it after release */
+        mutex->original_priority = thread->current_priority;
+    }
+
+    /* the waiters may be suspended while the mutex has no owner */
+    if (waiter_priority < thread->current_priority)
+    {
+        rt_thread_control(thread,
+                          RT_THREAD_CTRL_CHANGE_PRIORITY,
+                          &waiter_priority);
+    }
+
+    rt_hw_interrupt_enable(temp);
+}
+
+/*
+ * A thread is suspended on the mutex before the fast path clears the owner,
+ * restore the priority and hand over the mutex to it.
+ */
+static void _rt_mutex_release_fixup(rt_mutex_t mutex, struct rt_thread *thread, rt_uint8_t priority)
+{
+    register rt_base_t temp;
+    rt_bool_t need_schedule = RT_FALSE;
+
+    temp = rt_hw_interrupt_disable();
+
+    if (thread->current_priority != priority)
+    {
+        rt_thread_control(thread,
+                          RT_THREAD_CTRL_CHANGE_PRIORITY,
+                          &priority);
+        need_schedule = RT_TRUE;
+    }
+
+    if (mutex->owner == RT_NULL && !rt_list_isempty(&mutex->parent.suspend_thread))
+    {
+        thread = rt_list_entry(mutex->parent.suspend_thread.next,
+                               struct rt_thread,
+                               tlist);
+
+        /* set new owner and priority */
+        mutex->value             = 0;
+        mutex->owner             = thread;
+        mutex->original_priority = thread->current_priority;
+        mutex->hold              = 1;
+
+        /* resume thread */
+        rt_ipc_list_resume(&(mutex->parent.suspend_thread));
+
+        need_schedule = RT_TRUE;
+    }
+
+    rt_hw_interrupt_enable(temp);
+
+    if (need_schedule == RT_TRUE)
+        rt_schedule();
+}
+
+/* own a free mutex by compare-and-swap on the owner, it never blocks */
+rt_inline rt_err_t _rt_mutex_trytake_atomic(rt_mutex_t mutex, struct rt_thread *thread)
+{
+    rt_atomic_t owner = 0;
+    rt_uint8_t priority;
+
+    /* only the owner itself changes the hold */
+    if (mutex->owner == thread)
+    {
+        mutex->hold ++;
+        thread->error = RT_EOK;
+
+        return RT_EOK;
+    }
+
+    priority = thread->current_priority;
+    if (!rt_atomic_compare_exchange_strong((rt_atomic_t *)&(mutex->owner), &owner, (rt_atomic_t)thread))
+        return -RT_EBUSY;
+
+    mutex->value             = 0;
+    mutex->original_priority = priority;
+    mutex->hold              = 1;
+    thread->error = RT_EOK;
+
+    if (thread->current_priority != priority ||
+            !rt_list_isempty(&mutex->parent.suspend_thread))
+    {
+        _rt_mutex_take_fixup(mutex, thread, priority);
+    }
+
+    return RT_EOK;
+}
+
+/* release an uncontended mutex by clearing the owner, -RT_EBUSY if contended */
+rt_inline rt_err_t _rt_mutex_release_atomic(rt_mutex_t mutex, struct rt_thread *thread)
+{
+    rt_uint8_t priority;
+
+    if (mutex->owner != thread)
+        return -RT_ERROR;
+
+    if (mutex->hold > 1)
+    {
+        mutex->hold --;
+
+        return RT_EOK;
+    }
+
+    priority = mutex->original_priority;
+    if (priority != thread->current_priority ||
+            !rt_list_isempty(&mutex->parent.suspend_thread))
+        return -RT_EBUSY;
+
+    mutex->hold              = 0;
+    mutex->value             = 1;
+    mutex->original_priority = 0xff;
+    rt_atomic_store((rt_atomic_t *)&(mutex->owner), 0);
+
+    /* a thread may be suspended before the owner is cleared */
+    if (!rt_list_isempty(&mutex->parent.suspend_thread))
+        _rt_mutex_release_fixup(mutex, thread, priority);
+
+    return RT_EOK;
+}
+#endif
+
 /**
  * This function will take a mutex, if the mutex is unavailable, the
  * thread shall wait for a specified time.
@@ -665,11 +882,21 @@ rt_err_t rt_mutex_take(rt_mutex_t mutex, rt_int32_t time)
     /* get current thread */
     thread = rt_thread_self();
 
+    RT_OBJECT_HOOK_CALL(rt_object_trytake_hook, (&(mutex->parent.parent)));
+
+#ifdef RT_USING_IPC_ATOMIC
+    /* fast path: the mutex is free or held by itself */
+    if (_rt_mutex_trytake_atomic(mutex, thread) == RT_EOK)
+    {
+        RT_OBJECT_HOOK_CALL(rt_object_take_hook, (&(mutex->parent.parent)));
+
+        return RT_EOK;
+    }
+#endif
+
     /* disable interrupt */
     temp = rt_hw_interrupt_disable();
 
-    RT_OBJECT_HOOK_CALL(rt_object_trytake_hook, (&(mutex->parent.parent)));
-
     RT_DEBUG_LOG(RT_DEBUG_IPC,
                  ("mutex_take: current thread %s, mutex value: %d, hold: %d\n",
                   thread->name, mutex->value, mutex->hold));
@@ -685,10 +912,11 @@ rt_err_t rt_mutex_take(rt_mutex_t mutex, rt_int32_t time)
     else
     {
 __again:
-        /* The value of mutex is 1 in initial status. Therefore, if the
-         * value is great than 0, it indicates the mutex is avaible.
+        /* The value of mutex is 1 in initial status and it's 0 when the
+         * mutex has owner. The owner is checked because it's the word
+         * changed firstly by the atomic fast path.
          */
-        if (mutex->value > 0)
+        if (mutex->owner == RT_NULL)
         {
             /* mutex is available */
             mutex->value --;
@@ -804,6 +1032,14 @@ rt_err_t rt_mutex_release(rt_mutex_t mutex)
     /* get current thread */
     thread = rt_thread_self();
 
+    RT_OBJECT_HOOK_CALL(rt_object_put_hook, (&(mutex->parent.parent)));
+
+#ifdef RT_USING_IPC_ATOMIC
+    /* fast path: no thread is waiting and no priority is inherited */
+    if (_rt_mutex_release_atomic(mutex, thread) == RT_EOK)
+        return RT_EOK;
+#endif
+
     /* disable interrupt */
     temp = rt_hw_interrupt_disable();
 
@@ -811,8 +1047,6 @@ rt_err_t rt_mutex_release(rt_mutex_t mutex)
                  ("mutex_release:current thread %s, mutex value: %d, hold: %d\n",
                   thread->name, mutex->value, mutex->hold));
 
-    RT_OBJECT_HOOK_CALL(rt_object_put_hook, (&(mutex->parent.parent)));
-
     /* mutex only can be released by owner */
     if (thread != mutex->owner)
     {
@@ -901,6 +1135,119 @@ RTM_EXPORT(rt_mutex_control);
 #endif /* end of RT_USING_MUTEX */
 
 #ifdef RT_USING_EVENT
+#ifdef RT_USING_EVENT_BUCKETS
+#if (RT_EVENT_WAIT_BUCKETS & (RT_EVENT_WAIT_BUCKETS - 1)) != 0
+#error "RT_EVENT_WAIT_BUCKETS must be a power of two"
+#endif
+
+/* get the bucket of waiting thread by the lowest requested bit */
+#define _EVENT_WAIT_BUCKET(set)         ((__rt_ffs(set) - 1) & (RT_EVENT_WAIT_BUCKETS - 1))
+
+/* get the waiting list of bucket, the first one is the list of ipc object */
+rt_inline rt_list_t *_rt_event_wait_list(rt_event_t event, rt_uint32_t index)
+{
+    if (index == 0)
+        return &(event->parent.suspend_thread);
+
+    return &(event->wait_list[index - 1]);
+}
+#endif
+
+/* initialize the event set and waiting buckets */
+static void _rt_event_init(rt_event_t event)
+{
+#ifdef RT_USING_EVENT_BUCKETS
+    rt_uint32_t index;
+
+    for (index = 1; index < RT_EVENT_WAIT_BUCKETS; index ++)
+        rt_list_init(_rt_event_wait_list(event, index));
+    rt_memset(event->wait_mask, 0, sizeof(event->wait_mask));
+#endif
+
+    event->set = 0;
+}
+
+/* resume all threads waiting on event */
+static void _rt_event_resume_all(rt_event_t event)
+{
+#ifdef RT_USING_EVENT_BUCKETS
+    rt_uint32_t index;
+
+    for (index = 0; index < RT_EVENT_WAIT_BUCKETS; index ++)
+    {
+        rt_ipc_list_resume_all(_rt_event_wait_list(event, index));
+        event->wait_mask[index] = 0;
+    }
+#else
+    rt_ipc_list_resume_all(&(event->parent.suspend_thread));
+#endif
+}
+
+/*
+ * resume the threads in the waiting list which are satisfied by the event set,
+ * and return the bits requested by the rest threads. The interrupt shall be
+ * disabled.
+ */
+static rt_uint32_t _rt_event_resume(rt_event_t event, rt_list_t *list, rt_bool_t *need_schedule)
+{
+    struct rt_list_node *n;
+    struct rt_thread *thread;
+    register rt_base_t status;
+    rt_uint32_t mask = 0;
+
+    /* search thread list to resume thread */
+    n = list->next;
+    while (n != list)
+    {
+        /* get thread */
+        thread = rt_list_entry(n, struct rt_thread, tlist);
+
+        status = -RT_ERROR;
+        if (thread->event_info & RT_EVENT_FLAG_AND)
+        {
+            if ((thread->event_set & event->set) == thread->event_set)
+            {
+                /* received an AND event */
+                status = RT_EOK;
+            }
+        }
+        else if (thread->event_info & RT_EVENT_FLAG_OR)
+        {
+            if (thread->event_set & event->set)
+            {
+                /* save recieved event set */
+                thread->event_set = thread->event_set & event->set;
+
+                /* received an OR event */
+                status = RT_EOK;
+            }
+        }
+
+        /* move node to the next */
+        n = n->next;
+
+        /* condition is satisfied, resume thread */
+        if (status == RT_EOK)
+        {
+            /* clear event */
+            if (thread->event_info & RT_EVENT_FLAG_CLEAR)
+                event->set &= ~thread->event_set;
+
+            /* resume thread, and thread list breaks out */
+            rt_thread_resume(thread);
+
+            /* need do a scheduling */
+            *need_schedule = RT_TRUE;
+        }
+        else
+        {
+            mask |= thread->event_set;
+        }
+    }
+
+    return mask;
+}
+
 /**
  * This function will initialize an event and put it under control of resource
  * management.
@@ -926,7 +1273,7 @@ rt_err_t rt_event_init(rt_event_t event, const char *name, rt_uint8_t flag)
     rt_ipc_object_init(&(event->parent));
 
     /* init event */
-    event->set = 0;
+    _rt_event_init(event);
 
     return RT_EOK;
 }
@@ -947,7 +1294,7 @@ rt_err_t rt_event_detach(rt_event_t event)
     RT_ASSERT(rt_object_is_systemobject(&event->parent.parent));
 
     /* resume all suspended thread */
-    rt_ipc_list_resume_all(&(event->parent.suspend_thread));
+    _rt_event_resume_all(event);
 
     /* detach event object */
     rt_object_detach(&(event->parent.parent));
@@ -983,7 +1330,7 @@ rt_event_t rt_event_create(const char *name, rt_uint8_t flag)
     rt_ipc_object_init(&(event->parent));
 
     /* init event */
-    event->set = 0;
+    _rt_event_init(event);
 
     return event;
 }
@@ -1006,7 +1353,7 @@ rt_err_t rt_event_delete(rt_event_t event)
     RT_DEBUG_NOT_IN_INTERRUPT;
 
     /* resume all suspended thread */
-    rt_ipc_list_resume_all(&(event->parent.suspend_thread));
+    _rt_event_resume_all(event);
 
     /* delete event object */
     rt_object_delete(&(event->parent.parent));
@@ -1027,11 +1374,11 @@ RTM_EXPORT(rt_event_delete);
  */
 rt_err_t rt_event_send(rt_event_t event, rt_uint32_t set)
 {
-    struct rt_list_node *n;
-    struct rt_thread *thread;
     register rt_ubase_t level;
-    register rt_base_t status;
     rt_bool_t need_schedule;
+#ifdef RT_USING_EVENT_BUCKETS
+    rt_uint32_t index;
+#endif
 
     /* parameter check */
     RT_ASSERT(event != RT_NULL);
@@ -1049,60 +1396,26 @@ rt_err_t rt_event_send(rt_event_t event, rt_uint32_t set)
     event->set |= set;
 
     RT_OBJECT_HOOK_CALL(rt_object_put_hook, (&(event->parent.parent)));
-    
-    if (!rt_list_isempty(&event->parent.suspend_thread))
+
+#ifdef RT_USING_EVENT_BUCKETS
+    /* only search the buckets which have threads waiting on the bits being set */
+    for (index = 0; index < RT_EVENT_WAIT_BUCKETS; index ++)
     {
-        /* search thread list to resume thread */
-        n = event->parent.suspend_thread.next;
-        while (n != &(event->parent.suspend_thread))
+        if (event->wait_mask[index] & event->set)
         {
-            /* get thread */
-            thread = rt_list_entry(n, struct rt_thread, tlist);
-
-            status = -RT_ERROR;
-            if (thread->event_info & RT_EVENT_FLAG_AND)
-            {
-                if ((thread->event_set & event->set) == thread->event_set)
-                {
-                    /* received an AND event */
-                    status = RT_EOK;
-                }
-            }
-            else if (thread->event_info & RT_EVENT_FLAG_OR)
-            {
-                if (thread->event_set & event->set)
-                {
-                    /* save recieved event set */
-                    thread->event_set = thread->event_set & event->set;
-
-                    /* received an OR event */
-                    status = RT_EOK;
-                }
-            }
-
-            /* move node to the next */
-            n = n->next;
-
-            /* condition is satisfied, resume thread */
-            if (status == RT_EOK)
-            {
-                /* clear event */
-                if (thread->event_info & RT_EVENT_FLAG_CLEAR)
-                    event->set &= ~thread->event_set;
-
-                /* resume thread, and thread list breaks out */
-                rt_thread_resume(thread);
-
-                /* need do a scheduling */
-                need_schedule = RT_TRUE;
-            }
+            event->wait_mask[index] = _rt_event_resume(event,
+                                                       _rt_event_wait_list(event, index),
+                                                       &need_schedule);
         }
     }
+#else
+    _rt_event_resume(event, &(event->parent.suspend_thread), &need_schedule);
+#endif
 
     /* enable interrupt */
     rt_hw_interrupt_enable(level);
 
-    /* do a schedule */
+    /* resume all satisfied threads by one scheduling */
     if (need_schedule == RT_TRUE)
         rt_schedule();
 
@@ -1192,10 +1505,18 @@ rt_err_t rt_event_recv(rt_event_t   event,
         thread->event_set  = set;
         thread->event_info = option;
 
+#ifdef RT_USING_EVENT_BUCKETS
+        /* put thread to the waiting bucket of its lowest requested bit */
+        rt_ipc_list_suspend(_rt_event_wait_list(event, _EVENT_WAIT_BUCKET(set)),
+                            thread,
+                            event->parent.parent.flag);
+        event->wait_mask[_EVENT_WAIT_BUCKET(set)] |= set;
+#else
         /* put thread to suspended thread list */
         rt_ipc_list_suspend(&(event->parent.suspend_thread),
                             thread,
                             event->parent.parent.flag);
+#endif
 
         /* if there is a waiting timeout, active thread timer */
         if (timeout > 0)
@@ -1259,7 +1580,7 @@ rt_err_t rt_event_control(rt_event_t event, int cmd, void *arg)
         level = rt_hw_interrupt_disable();
 
         /* resume all waiting thread */
-        rt_ipc_list_resume_all(&event->parent.suspend_thread);
+        _rt_event_resume_all(event);
 
         /* init event set */
         event->set = 0;
@@ -1950,155 +2271,85 @@ rt_err_t rt_mq_delete(rt_mq_t mq)
 RTM_EXPORT(rt_mq_delete);
 #endif
 
-/**
- * This function will send a message to message queue object, if there are
- * threads suspended on message queue object, it will be waked up.
- *
- * @param mq the message queue object
- * @param buffer the message
- * @param size the size of buffer
- *
- * @return the error code
+/*
+ * get a free message node from the message queue, RT_NULL is returned when
+ * the message queue is full.
  */
-rt_err_t rt_mq_send(rt_mq_t mq, void *buffer, rt_size_t size)
+rt_inline struct rt_mq_message *_rt_mq_alloc_msg(rt_mq_t mq)
 {
     register rt_ubase_t temp;
     struct rt_mq_message *msg;
 
-    /* parameter check */
-    RT_ASSERT(mq != RT_NULL);
-    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
-    RT_ASSERT(buffer != RT_NULL);
-    RT_ASSERT(size != 0);
-
-    /* greater than one message size */
-    if (size > mq->msg_size)
-        return -RT_ERROR;
-
-    RT_OBJECT_HOOK_CALL(rt_object_put_hook, (&(mq->parent.parent)));
-
     /* disable interrupt */
     temp = rt_hw_interrupt_disable();
 
     /* get a free list, there must be an empty item */
     msg = (struct rt_mq_message *)mq->msg_queue_free;
-    /* message queue is full */
-    if (msg == RT_NULL)
-    {
-        /* enable interrupt */
-        rt_hw_interrupt_enable(temp);
-
-        return -RT_EFULL;
-    }
     /* move free list pointer */
-    mq->msg_queue_free = msg->next;
+    if (msg != RT_NULL)
+        mq->msg_queue_free = msg->next;
 
     /* enable interrupt */
     rt_hw_interrupt_enable(temp);
 
-    /* the msg is the new tailer of list, the next shall be NULL */
-    msg->next = RT_NULL;
-    /* copy buffer */
-    rt_memcpy(msg + 1, buffer, size);
+    return msg;
+}
+
+/*
+ * put a message node back to the free list of message queue.
+ */
+rt_inline void _rt_mq_free_msg(rt_mq_t mq, struct rt_mq_message *msg)
+{
+    register rt_ubase_t temp;
 
     /* disable interrupt */
     temp = rt_hw_interrupt_disable();
-    /* link msg to message queue */
-    if (mq->msg_queue_tail != RT_NULL)
-    {
-        /* if the tail exists, */
-        ((struct rt_mq_message *)mq->msg_queue_tail)->next = msg;
-    }
-
-    /* set new tail */
-    mq->msg_queue_tail = msg;
-    /* if the head is empty, set head */
-    if (mq->msg_queue_head == RT_NULL)
-        mq->msg_queue_head = msg;
-
-    /* increase message entry */
-    mq->entry ++;
-
-    /* resume suspended thread */
-    if (!rt_list_isempty(&mq->parent.suspend_thread))
-    {
-        rt_ipc_list_resume(&(mq->parent.suspend_thread));
-
-        /* enable interrupt */
-        rt_hw_interrupt_enable(temp);
-
-        rt_schedule();
-
-        return RT_EOK;
-    }
-
+    /* put message to free list */
+    msg->next = (struct rt_mq_message *)mq->msg_queue_free;
+    mq->msg_queue_free = msg;
     /* enable interrupt */
     rt_hw_interrupt_enable(temp);
-
-    return RT_EOK;
 }
-RTM_EXPORT(rt_mq_send);
 
-/**
- * This function will send an urgent message to message queue object, which
- * means the message will be inserted to the head of message queue. If there
- * are threads suspended on message queue object, it will be waked up.
- *
- * @param mq the message queue object
- * @param buffer the message
- * @param size the size of buffer
- *
- * @return the error code
+/*
+ * link a filled message node to the tail (or the head for urgent message)
+ * of message queue, and wake up one suspended thread.
  */
-rt_err_t rt_mq_urgent(rt_mq_t mq, void *buffer, rt_size_t size)
+static void _rt_mq_put_msg(rt_mq_t mq, struct rt_mq_message *msg, rt_bool_t urgent)
 {
     register rt_ubase_t temp;
-    struct rt_mq_message *msg;
-
-    /* parameter check */
-    RT_ASSERT(mq != RT_NULL);
-    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
-    RT_ASSERT(buffer != RT_NULL);
-    RT_ASSERT(size != 0);
-
-    /* greater than one message size */
-    if (size > mq->msg_size)
-        return -RT_ERROR;
-
-    RT_OBJECT_HOOK_CALL(rt_object_put_hook, (&(mq->parent.parent)));
 
     /* disable interrupt */
     temp = rt_hw_interrupt_disable();
 
-    /* get a free list, there must be an empty item */
-    msg = (struct rt_mq_message *)mq->msg_queue_free;
-    /* message queue is full */
-    if (msg == RT_NULL)
+    if (urgent)
     {
-        /* enable interrupt */
-        rt_hw_interrupt_enable(temp);
+        /* link msg to the beginning of message queue */
+        msg->next = (struct rt_mq_message *)mq->msg_queue_head;
+        mq->msg_queue_head = msg;
 
-        return -RT_EFULL;
+        /* if there is no tail */
+        if (mq->msg_queue_tail == RT_NULL)
+            mq->msg_queue_tail = msg;
     }
-    /* move free list pointer */
-    mq->msg_queue_free = msg->next;
-
-    /* enable interrupt */
-    rt_hw_interrupt_enable(temp);
-
-    /* copy buffer */
-    rt_memcpy(msg + 1, buffer, size);
-
-    /* disable interrupt */
-    temp = rt_hw_interrupt_disable();
+    else
+    {
+        /* the msg is the new tailer of list, the next shall be NULL */
+        msg->next = RT_NULL;
 
-    /* link msg to the beginning of message queue */
-    msg->next = (struct rt_mq_message *)mq->msg_queue_head;
-    mq->msg_queue_head = msg;
+        /* link msg to message queue */
+        if (mq->msg_queue_tail != RT_NULL)
+        {
+            /* if the tail exists, */
+            ((struct rt_mq_message *)mq->msg_queue_tail)->next = msg;
+        }
 
-    /* if there is no tail */
-    if (mq->msg_queue_tail == RT_NULL)
+        /* set new tail */
         mq->msg_queue_tail = msg;
+        /* if the head is empty, set head */
+        if (mq->msg_queue_head == RT_NULL)
+            mq->msg_queue_head = msg;
+    }
 
     /* increase message entry */
     mq->entry ++;
@@ -2113,49 +2364,29 @@ rt_err_t rt_mq_urgent(rt_mq_t mq, void *buffer, rt_size_t size)
 
         rt_schedule();
 
-        return RT_EOK;
+        return;
     }
 
     /* enable interrupt */
     rt_hw_interrupt_enable(temp);
-
-    return RT_EOK;
 }
-RTM_EXPORT(rt_mq_urgent);
 
-/**
- * This function will receive a message from message queue object, if there is
- * no message in message queue object, the thread shall wait for a specified
- * time.
- *
- * @param mq the message queue object
- * @param buffer the received message will be saved in
- * @param size the size of buffer
- * @param timeout the waiting time
- *
- * @return the error code
+/*
+ * take the message node at the head of message queue, the thread shall wait
+ * for a specified time if the message queue is empty.
  */
-rt_err_t rt_mq_recv(rt_mq_t    mq,
-                    void      *buffer,
-                    rt_size_t  size,
-                    rt_int32_t timeout)
+static rt_err_t _rt_mq_get_msg(rt_mq_t                mq,
+                               struct rt_mq_message **msg,
+                               rt_int32_t             timeout)
 {
     struct rt_thread *thread;
     register rt_ubase_t temp;
-    struct rt_mq_message *msg;
     rt_uint32_t tick_delta;
 
-    /* parameter check */
-    RT_ASSERT(mq != RT_NULL);
-    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
-    RT_ASSERT(buffer != RT_NULL);
-    RT_ASSERT(size != 0);
-
     /* initialize delta tick */
     tick_delta = 0;
     /* get current thread */
     thread = rt_thread_self();
-    RT_OBJECT_HOOK_CALL(rt_object_trytake_hook, (&(mq->parent.parent)));
 
     /* disable interrupt */
     temp = rt_hw_interrupt_disable();
@@ -2235,12 +2466,12 @@ rt_err_t rt_mq_recv(rt_mq_t    mq,
     }
 
     /* get message from queue */
-    msg = (struct rt_mq_message *)mq->msg_queue_head;
+    *msg = (struct rt_mq_message *)mq->msg_queue_head;
 
     /* move message queue head */
-    mq->msg_queue_head = msg->next;
+    mq->msg_queue_head = (*msg)->next;
     /* reach queue tail, set to NULL */
-    if (mq->msg_queue_tail == msg)
+    if (mq->msg_queue_tail == *msg)
         mq->msg_queue_tail = RT_NULL;
 
     /* decrease message entry */
@@ -2249,16 +2480,146 @@ rt_err_t rt_mq_recv(rt_mq_t    mq,
     /* enable interrupt */
     rt_hw_interrupt_enable(temp);
 
+    return RT_EOK;
+}
+
+/*
+ * get the message node of a message buffer returned by rt_mq_loan or
+ * rt_mq_peek.
+ */
+rt_inline struct rt_mq_message *_rt_mq_buffer_to_msg(rt_mq_t mq, void *buffer)
+{
+    struct rt_mq_message *msg;
+
+    msg = (struct rt_mq_message *)buffer - 1;
+
+    /* the message must be inside the message pool of this queue */
+    RT_ASSERT((rt_uint8_t *)msg >= (rt_uint8_t *)mq->msg_pool);
+    RT_ASSERT((rt_uint8_t *)msg < (rt_uint8_t *)mq->msg_pool +
+              mq->max_msgs * (mq->msg_size + sizeof(struct rt_mq_message)));
+    RT_ASSERT(((rt_uint8_t *)msg - (rt_uint8_t *)mq->msg_pool) %
+              (mq->msg_size + sizeof(struct rt_mq_message)) == 0);
+
+    return msg;
+}
+
+/**
+ * This function will send a message to message queue object, if there are
+ * threads suspended on message queue object, it will be waked up.
+ *
+ * @param mq the message queue object
+ * @param buffer the message
+ * @param size the size of buffer
+ *
+ * @return the error code
+ */
+rt_err_t rt_mq_send(rt_mq_t mq, void *buffer, rt_size_t size)
+{
+    struct rt_mq_message *msg;
+
+    /* parameter check */
+    RT_ASSERT(mq != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+    RT_ASSERT(buffer != RT_NULL);
+    RT_ASSERT(size != 0);
+
+    /* greater than one message size */
+    if (size > mq->msg_size)
+        return -RT_ERROR;
+
+    RT_OBJECT_HOOK_CALL(rt_object_put_hook, (&(mq->parent.parent)));
+
+    msg = _rt_mq_alloc_msg(mq);
+    /* message queue is full */
+    if (msg == RT_NULL)
+        return -RT_EFULL;
+
+    /* copy buffer */
+    rt_memcpy(msg + 1, buffer, size);
+
+    _rt_mq_put_msg(mq, msg, RT_FALSE);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_mq_send);
+
+/**
+ * This function will send an urgent message to message queue object, which
+ * means the message will be inserted to the head of message queue. If there
+ * are threads suspended on message queue object, it will be waked up.
+ *
+ * @param mq the message queue object
+ * @param buffer the message
+ * @param size the size of buffer
+ *
+ * @return the error code
+ */
+rt_err_t rt_mq_urgent(rt_mq_t mq, void *buffer, rt_size_t size)
+{
+    struct rt_mq_message *msg;
+
+    /* parameter check */
+    RT_ASSERT(mq != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+    RT_ASSERT(buffer != RT_NULL);
+    RT_ASSERT(size != 0);
+
+    /* greater than one message size */
+    if (size > mq->msg_size)
+        return -RT_ERROR;
+
+    RT_OBJECT_HOOK_CALL(rt_object_put_hook, (&(mq->parent.parent)));
+
+    msg = _rt_mq_alloc_msg(mq);
+    /* message queue is full */
+    if (msg == RT_NULL)
+        return -RT_EFULL;
+
+    /* copy buffer */
+    rt_memcpy(msg + 1, buffer, size);
+
+    _rt_mq_put_msg(mq, msg, RT_TRUE);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_mq_urgent);
+
+/**
+ * This function will receive a message from message queue object, if there is
+ * no message in message queue object, the thread shall wait for a specified
+ * time.
+ *
+ * @param mq the message queue object
+ * @param buffer the received message will be saved in
+ * @param size the size of buffer
+ * @param timeout the waiting time
+ *
+ * @return the error code
+ */
+rt_err_t rt_mq_recv(rt_mq_t    mq,
+                    void      *buffer,
+                    rt_size_t  size,
+                    rt_int32_t timeout)
+{
+    struct rt_mq_message *msg;
+    rt_err_t result;
+
+    /* parameter check */
+    RT_ASSERT(mq != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+    RT_ASSERT(buffer != RT_NULL);
+    RT_ASSERT(size != 0);
+
+    RT_OBJECT_HOOK_CALL(rt_object_trytake_hook, (&(mq->parent.parent)));
+
+    result = _rt_mq_get_msg(mq, &msg, timeout);
+    if (result != RT_EOK)
+        return result;
+
     /* copy message */
     rt_memcpy(buffer, msg + 1, size > mq->msg_size ? mq->msg_size : size);
 
-    /* disable interrupt */
-    temp = rt_hw_interrupt_disable();
-    /* put message to free list */
-    msg->next = (struct rt_mq_message *)mq->msg_queue_free;
-    mq->msg_queue_free = msg;
-    /* enable interrupt */
-    rt_hw_interrupt_enable(temp);
+    _rt_mq_free_msg(mq, msg);
 
     RT_OBJECT_HOOK_CALL(rt_object_take_hook, (&(mq->parent.parent)));
 
@@ -2266,6 +2627,142 @@ rt_err_t rt_mq_recv(rt_mq_t    mq,
 }
 RTM_EXPORT(rt_mq_recv);
 
+/**
+ * This function will loan a free message buffer from message queue object,
+ * the sender can fill the message in place and then send it by rt_mq_commit,
+ * or give it back by rt_mq_cancel.
+ *
+ * @param mq the message queue object
+ *
+ * @return the message buffer with mq->msg_size bytes, RT_NULL if the
+ * message queue is full.
+ */
+void *rt_mq_loan(rt_mq_t mq)
+{
+    struct rt_mq_message *msg;
+
+    /* parameter check */
+    RT_ASSERT(mq != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+
+    msg = _rt_mq_alloc_msg(mq);
+    if (msg == RT_NULL)
+        return RT_NULL;
+
+    return (void *)(msg + 1);
+}
+RTM_EXPORT(rt_mq_loan);
+
+/**
+ * This function will send a message buffer loaned by rt_mq_loan to message
+ * queue object without copying. If there are threads suspended on message
+ * queue object, it will be waked up.
+ *
+ * @param mq the message queue object
+ * @param buffer the message buffer returned by rt_mq_loan
+ * @param urgent RT_TRUE to insert the message to the head of message queue
+ *
+ * @return the error code
+ */
+rt_err_t rt_mq_commit(rt_mq_t mq, void *buffer, rt_bool_t urgent)
+{
+    struct rt_mq_message *msg;
+
+    /* parameter check */
+    RT_ASSERT(mq != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+    RT_ASSERT(buffer != RT_NULL);
+
+    msg = _rt_mq_buffer_to_msg(mq, buffer);
+
+    RT_OBJECT_HOOK_CALL(rt_object_put_hook, (&(mq->parent.parent)));
+
+    _rt_mq_put_msg(mq, msg, urgent);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_mq_commit);
+
+/**
+ * This function will give back a message buffer loaned by rt_mq_loan
+ * without sending it.
+ *
+ * @param mq the message queue object
+ * @param buffer the message buffer returned by rt_mq_loan
+ *
+ * @return the error code
+ */
+rt_err_t rt_mq_cancel(rt_mq_t mq, void *buffer)
+{
+    /* parameter check */
+    RT_ASSERT(mq != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+    RT_ASSERT(buffer != RT_NULL);
+
+    _rt_mq_free_msg(mq, _rt_mq_buffer_to_msg(mq, buffer));
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_mq_cancel);
+
+/**
+ * This function will receive a message from message queue object without
+ * copying, the message buffer is returned in place and shall be given back
+ * by rt_mq_release after it has been consumed. If there is no message in
+ * message queue object, the thread shall wait for a specified time.
+ *
+ * @param mq the message queue object
+ * @param buffer the received message buffer with mq->msg_size bytes
+ * @param timeout the waiting time
+ *
+ * @return the error code
+ */
+rt_err_t rt_mq_peek(rt_mq_t mq, void **buffer, rt_int32_t timeout)
+{
+    struct rt_mq_message *msg;
+    rt_err_t result;
+
+    /* parameter check */
+    RT_ASSERT(mq != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+    RT_ASSERT(buffer != RT_NULL);
+
+    RT_OBJECT_HOOK_CALL(rt_object_trytake_hook, (&(mq->parent.parent)));
+
+    result = _rt_mq_get_msg(mq, &msg, timeout);
+    if (result != RT_EOK)
+        return result;
+
+    *buffer = (void *)(msg + 1);
+
+    RT_OBJECT_HOOK_CALL(rt_object_take_hook, (&(mq->parent.parent)));
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_mq_peek);
+
+/**
+ * This function will give back a message buffer received by rt_mq_peek to
+ * message queue object.
+ *
+ * @param mq the message queue object
+ * @param buffer the message buffer returned by rt_mq_peek
+ *
+ * @return the error code
+ */
+rt_err_t rt_mq_release(rt_mq_t mq, void *buffer)
+{
+    /* parameter check */
+    RT_ASSERT(mq != RT_NULL);
+    RT_ASSERT(rt_object_get_type(&mq->parent.parent) == RT_Object_Class_MessageQueue);
+    RT_ASSERT(buffer != RT_NULL);
+
+    _rt_mq_free_msg(mq, _rt_mq_buffer_to_msg(mq, buffer));
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_mq_release);
+
 /**
  * This function can get or set some extra attributions of a message queue
  * object.
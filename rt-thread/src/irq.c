@@ -9,6 +9,7 @@
  * 2006-05-03     Bernard      add IRQ_DEBUG
  * 2016-08-09     ArdaFu       add interrupt enter and leave hook.
  * 2018-11-22     Jesven       rt_interrupt_get_nest function add disable irq
+ * 2026-10-19     Hehesheng    run softirqs when leave the outermost interrupt
  */
 
 #include <rthw.h>
@@ -55,6 +56,10 @@ void rt_interrupt_leave_sethook(void (*hook)(void))
 volatile rt_uint8_t rt_interrupt_nest = 0;
 #endif
 
+#ifdef RT_USING_SOFTIRQ
+extern rt_uint32_t rt_softirq_irq_stamp;
+#endif
+
 /**
  * This function will be invoked by BSP, when enter interrupt service routine
  *
@@ -70,6 +75,10 @@ void rt_interrupt_enter(void)
                                 rt_interrupt_nest));
 
     level = rt_hw_interrupt_disable();
+#ifdef RT_USING_SOFTIRQ
+    if (rt_interrupt_nest == 0)
+        rt_softirq_irq_stamp = rt_softirq_timestamp();
+#endif
     rt_interrupt_nest ++;
     RT_OBJECT_HOOK_CALL(rt_interrupt_enter_hook,());
     rt_hw_interrupt_enable(level);
@@ -91,6 +100,15 @@ void rt_interrupt_leave(void)
                                 rt_interrupt_nest));
 
     level = rt_hw_interrupt_disable();
+#ifdef RT_USING_SOFTIRQ
+    if (rt_interrupt_nest == 1)
+    {
+        /* run the bottom halves before leave the outermost interrupt */
+        rt_hw_interrupt_enable(level);
+        rt_softirq_run();
+        level = rt_hw_interrupt_disable();
+    }
+#endif
     rt_interrupt_nest --;
     RT_OBJECT_HOOK_CALL(rt_interrupt_leave_hook,());
     rt_hw_interrupt_enable(level);
@@ -17,6 +17,8 @@
  * 2013-06-24     Bernard      remove rt_kprintf if RT_USING_CONSOLE is not defined.
  * 2013-09-24     aozima       make sure the device is in STREAM mode when used by rt_kprintf.
  * 2015-07-06     Bernard      Add rt_assert_handler routine.
+ * 2026-10-19     Hehesheng    optimize rt_memcpy/rt_memset/rt_memmove for unaligned buffers
+ * 2026-10-19     Hehesheng    add two digits conversion and float formats to rt_vsnprintf
  */
 
 #include <rtthread.h>
@@ -114,6 +116,84 @@ int *_rt_errno(void)
 }
 RTM_EXPORT(_rt_errno);
 
+#ifndef RT_USING_TINY_SIZE
+/*
+ * The word size helpers of memory functions. The shifted source copy merges
+ * two aligned source words into one destination word, it's only used on the
+ * little endian CPU.
+ */
+#define RT_MEM_WORD             (sizeof(rt_ubase_t))
+#define RT_MEM_UNALIGNED(x)     ((rt_ubase_t)(x) & (RT_MEM_WORD - 1))
+#define RT_MEM_SMALL            16
+
+#if defined(__ARMEB__) || (defined(__CC_ARM) && defined(__BIG_ENDIAN)) || \
+    (defined(__IAR_SYSTEMS_ICC__) && (__LITTLE_ENDIAN__ == 0)) || \
+    (defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__))
+#define RT_MEM_BIG_ENDIAN
+#endif
+
+/* copy 8 words, the compiler generates LDM/STM on ARM */
+#define RT_MEM_COPY_BLOCK(d, s)                 \
+    do {                                        \
+        rt_ubase_t w0, w1, w2, w3;              \
+        w0 = (s)[0]; w1 = (s)[1];               \
+        w2 = (s)[2]; w3 = (s)[3];               \
+        (d)[0] = w0; (d)[1] = w1;               \
+        (d)[2] = w2; (d)[3] = w3;               \
+        w0 = (s)[4]; w1 = (s)[5];               \
+        w2 = (s)[6]; w3 = (s)[7];               \
+        (d)[4] = w0; (d)[5] = w1;               \
+        (d)[6] = w2; (d)[7] = w3;               \
+    } while (0)
+
+#ifndef RT_MEM_BIG_ENDIAN
+/*
+ * Copy the source which is not aligned to the aligned destination, the
+ * length shall be no less than 2 words. It returns the copied length, the
+ * remaining is less than 2 words.
+ */
+static rt_ubase_t _rt_memcpy_shifted(rt_ubase_t *dst, const char *src, rt_ubase_t count)
+{
+    const rt_ubase_t *aligned_src;
+    rt_ubase_t offset, shift, prev, next, len, i;
+
+    offset = RT_MEM_UNALIGNED(src);
+    shift = offset * 8;
+    aligned_src = (const rt_ubase_t *)(src - offset);
+
+    /* the source bytes in the first aligned word */
+    prev = 0;
+    for (i = 0; i < RT_MEM_WORD - offset; i ++)
+        prev |= (rt_ubase_t)(rt_uint8_t)src[i] << (shift + i * 8);
+
+    /* the next source word must be in the range */
+    for (len = count; len >= RT_MEM_WORD * 5; len -= RT_MEM_WORD * 4)
+    {
+        next = aligned_src[1];
+        dst[0] = (prev >> shift) | (next << (RT_MEM_WORD * 8 - shift));
+        prev = aligned_src[2];
+        dst[1] = (next >> shift) | (prev << (RT_MEM_WORD * 8 - shift));
+        next = aligned_src[3];
+        dst[2] = (prev >> shift) | (next << (RT_MEM_WORD * 8 - shift));
+        prev = aligned_src[4];
+        dst[3] = (next >> shift) | (prev << (RT_MEM_WORD * 8 - shift));
+        aligned_src += 4;
+        dst += 4;
+    }
+
+    for (; len >= RT_MEM_WORD * 2; len -= RT_MEM_WORD)
+    {
+        next = aligned_src[1];
+        *dst++ = (prev >> shift) | (next << (RT_MEM_WORD * 8 - shift));
+        prev = next;
+        aligned_src ++;
+    }
+
+    return count - len;
+}
+#endif /* RT_MEM_BIG_ENDIAN */
+#endif /* RT_USING_TINY_SIZE */
+
 /**
  * This function will set the content of memory to specified value
  *
@@ -133,50 +213,44 @@ void *rt_memset(void *s, int c, rt_ubase_t count)
 
     return s;
 #else
-#define LBLOCKSIZE      (sizeof(long))
-#define UNALIGNED(X)    ((long)X & (LBLOCKSIZE - 1))
-#define TOO_SMALL(LEN)  ((LEN) < LBLOCKSIZE)
-
-    unsigned int i;
     char *m = (char *)s;
-    unsigned long buffer;
-    unsigned long *aligned_addr;
-    unsigned int d = c & 0xff;  /* To avoid sign extension, copy C to an
-                                unsigned variable.  */
+    rt_ubase_t buffer;
+    rt_ubase_t *aligned_addr;
+    rt_uint8_t d = (rt_uint8_t)c;
 
-    if (!TOO_SMALL(count) && !UNALIGNED(s))
+    if (count >= RT_MEM_SMALL)
     {
-        /* If we get this far, we know that n is large and m is word-aligned. */
-        aligned_addr = (unsigned long *)s;
+        /* align the address by bytes */
+        while (RT_MEM_UNALIGNED(m))
+        {
+            *m++ = (char)d;
+            count --;
+        }
 
         /* Store D into each char sized location in BUFFER so that
          * we can set large blocks quickly.
          */
-        if (LBLOCKSIZE == 4)
-        {
-            buffer = (d << 8) | d;
-            buffer |= (buffer << 16);
-        }
-        else
-        {
-            buffer = 0;
-            for (i = 0; i < LBLOCKSIZE; i ++)
-                buffer = (buffer << 8) | d;
-        }
+        buffer = ((rt_ubase_t)-1 / 0xff) * d;
+        aligned_addr = (rt_ubase_t *)m;
 
-        while (count >= LBLOCKSIZE * 4)
+        while (count >= RT_MEM_WORD * 8)
         {
-            *aligned_addr++ = buffer;
-            *aligned_addr++ = buffer;
-            *aligned_addr++ = buffer;
-            *aligned_addr++ = buffer;
-            count -= 4 * LBLOCKSIZE;
+            aligned_addr[0] = buffer;
+            aligned_addr[1] = buffer;
+            aligned_addr[2] = buffer;
+            aligned_addr[3] = buffer;
+            aligned_addr[4] = buffer;
+            aligned_addr[5] = buffer;
+            aligned_addr[6] = buffer;
+            aligned_addr[7] = buffer;
+            aligned_addr += 8;
+            count -= RT_MEM_WORD * 8;
         }
 
-        while (count >= LBLOCKSIZE)
+        while (count >= RT_MEM_WORD)
         {
             *aligned_addr++ = buffer;
-            count -= LBLOCKSIZE;
+            count -= RT_MEM_WORD;
         }
 
         /* Pick up the remainder with a bytewise loop. */
@@ -189,10 +263,6 @@ void *rt_memset(void *s, int c, rt_ubase_t count)
     }
 
     return s;
-
-#undef LBLOCKSIZE
-#undef UNALIGNED
-#undef TOO_SMALL
 #endif
 }
 RTM_EXPORT(rt_memset);
@@ -226,56 +296,65 @@ void *rt_memcpy(void *dst, const void *src, rt_ubase_t count)
 
     return dst;
 #else
-
-#define UNALIGNED(X, Y) \
-    (((long)X & (sizeof (long) - 1)) | ((long)Y & (sizeof (long) - 1)))
-#define BIGBLOCKSIZE    (sizeof (long) << 2)
-#define LITTLEBLOCKSIZE (sizeof (long))
-#define TOO_SMALL(LEN)  ((LEN) < BIGBLOCKSIZE)
-
     char *dst_ptr = (char *)dst;
-    char *src_ptr = (char *)src;
-    long *aligned_dst;
-    long *aligned_src;
-    int len = count;
+    const char *src_ptr = (const char *)src;
+    rt_ubase_t *aligned_dst;
+    const rt_ubase_t *aligned_src;
 
-    /* If the size is small, or either SRC or DST is unaligned,
-    then punt into the byte copy loop.  This should be rare. */
-    if (!TOO_SMALL(len) && !UNALIGNED(src_ptr, dst_ptr))
+    /* the small copy goes to the byte loop directly */
+    if (count >= RT_MEM_SMALL)
     {
-        aligned_dst = (long *)dst_ptr;
-        aligned_src = (long *)src_ptr;
-
-        /* Copy 4X long words at a time if possible. */
-        while (len >= BIGBLOCKSIZE)
+        /* align the destination by bytes */
+        while (RT_MEM_UNALIGNED(dst_ptr))
         {
-            *aligned_dst++ = *aligned_src++;
-            *aligned_dst++ = *aligned_src++;
-            *aligned_dst++ = *aligned_src++;
-            *aligned_dst++ = *aligned_src++;
-            len -= BIGBLOCKSIZE;
+            *dst_ptr++ = *src_ptr++;
+            count --;
         }
 
-        /* Copy one long word at a time if possible. */
-        while (len >= LITTLEBLOCKSIZE)
+        aligned_dst = (rt_ubase_t *)dst_ptr;
+        if (!RT_MEM_UNALIGNED(src_ptr))
         {
-            *aligned_dst++ = *aligned_src++;
-            len -= LITTLEBLOCKSIZE;
+            aligned_src = (const rt_ubase_t *)src_ptr;
+
+            /* Copy 8X words at a time if possible. */
+            while (count >= RT_MEM_WORD * 8)
+            {
+                RT_MEM_COPY_BLOCK(aligned_dst, aligned_src);
+                aligned_dst += 8;
+                aligned_src += 8;
+                count -= RT_MEM_WORD * 8;
+            }
+
+            /* Copy one word at a time if possible. */
+            while (count >= RT_MEM_WORD)
+            {
+                *aligned_dst++ = *aligned_src++;
+                count -= RT_MEM_WORD;
+            }
+
+            src_ptr = (const char *)aligned_src;
         }
+#ifndef RT_MEM_BIG_ENDIAN
+        else if (count >= RT_MEM_WORD * 2)
+        {
+            rt_ubase_t len;
+
+            /* merge the unaligned source into aligned words */
+            len = _rt_memcpy_shifted(aligned_dst, src_ptr, count);
+            aligned_dst += len / RT_MEM_WORD;
+            src_ptr += len;
+            count -= len;
+        }
+#endif
 
         /* Pick up any residual with a byte copier. */
         dst_ptr = (char *)aligned_dst;
-        src_ptr = (char *)aligned_src;
     }
 
-    while (len--)
+    while (count--)
         *dst_ptr++ = *src_ptr++;
 
     return dst;
-#undef UNALIGNED
-#undef BIGBLOCKSIZE
-#undef LITTLEBLOCKSIZE
-#undef TOO_SMALL
 #endif
 }
 RTM_EXPORT(rt_memcpy);
@@ -299,13 +378,55 @@ void *rt_memmove(void *dest, const void *src, rt_ubase_t n)
         tmp += n;
         s += n;
 
+#ifndef RT_USING_TINY_SIZE
+        /* copy words backward if both can be aligned */
+        if (n >= RT_MEM_SMALL && RT_MEM_UNALIGNED(tmp) == RT_MEM_UNALIGNED(s))
+        {
+            rt_ubase_t *aligned_dst;
+            const rt_ubase_t *aligned_src;
+
+            while (RT_MEM_UNALIGNED(tmp))
+            {
+                *(--tmp) = *(--s);
+                n --;
+            }
+
+            aligned_dst = (rt_ubase_t *)tmp;
+            aligned_src = (const rt_ubase_t *)s;
+            while (n >= RT_MEM_WORD * 4)
+            {
+                aligned_dst -= 4;
+                aligned_src -= 4;
+                aligned_dst[3] = aligned_src[3];
+                aligned_dst[2] = aligned_src[2];
+                aligned_dst[1] = aligned_src[1];
+                aligned_dst[0] = aligned_src[0];
+                n -= RT_MEM_WORD * 4;
+            }
+
+            while (n >= RT_MEM_WORD)
+            {
+                *(--aligned_dst) = *(--aligned_src);
+                n -= RT_MEM_WORD;
+            }
+
+            tmp = (char *)aligned_dst;
+            s = (char *)aligned_src;
+        }
+#endif
+
         while (n--)
             *(--tmp) = *(--s);
     }
     else
     {
+#ifndef RT_USING_TINY_SIZE
+        /* the forward copy of rt_memcpy is safe if the destination is lower */
+        return rt_memcpy(dest, src, n);
+#else
         while (n--)
             *tmp++ = *s++;
+#endif
     }
 
     return dest;
@@ -545,6 +666,7 @@ RTM_EXPORT(rt_show_version);
 /* private function */
 #define isdigit(c)  ((unsigned)((c) - '0') < 10)
 
+#ifdef RT_USING_TINY_SIZE
 #ifdef RT_PRINTF_LONGLONG
 rt_inline int divide(long long *n, int base)
 {
@@ -556,6 +678,11 @@ rt_inline int divide(long long *n, int base)
         res = (int)(((unsigned long long)*n) % 10U);
         *n = (long long)(((unsigned long long)*n) / 10U);
     }
+    else if (base == 8)
+    {
+        res = (int)(((unsigned long long)*n) % 8U);
+        *n = (long long)(((unsigned long long)*n) / 8U);
+    }
     else
     {
         res = (int)(((unsigned long long)*n) % 16U);
@@ -575,6 +702,11 @@ rt_inline int divide(long *n, int base)
         res = (int)(((unsigned long)*n) % 10U);
         *n = (long)(((unsigned long)*n) / 10U);
     }
+    else if (base == 8)
+    {
+        res = (int)(((unsigned long)*n) % 8U);
+        *n = (long)(((unsigned long)*n) / 8U);
+    }
     else
     {
         res = (int)(((unsigned long)*n) % 16U);
@@ -584,6 +716,105 @@ rt_inline int divide(long *n, int base)
     return res;
 }
 #endif
+#endif /* RT_USING_TINY_SIZE */
+
+#if !defined(RT_USING_TINY_SIZE) || defined(RT_PRINTF_FLOAT)
+/* "00" ~ "99", two decimal digits are converted by one division */
+static const char _rt_digit_pairs[200] =
+{
+    '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+    '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+    '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+    '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+    '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+    '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+    '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+    '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+    '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+    '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9',
+};
+#endif
+
+#ifndef RT_USING_TINY_SIZE
+/* put the decimal digits of value to tmp in reverse order, return the count */
+static int _rt_utoa_reverse(char *tmp, rt_uint32_t value)
+{
+    int i = 0;
+    rt_uint32_t index;
+
+    while (value >= 100)
+    {
+        index = (value % 100) << 1;
+        value /= 100;
+        tmp[i++] = _rt_digit_pairs[index + 1];
+        tmp[i++] = _rt_digit_pairs[index];
+    }
+
+    if (value >= 10)
+    {
+        index = value << 1;
+        tmp[i++] = _rt_digit_pairs[index + 1];
+        tmp[i++] = _rt_digit_pairs[index];
+    }
+    else
+    {
+        tmp[i++] = '0' + value;
+    }
+
+    return i;
+}
+
+/* put the digits of num to tmp in reverse order, return the count */
+static int _rt_number_reverse(char *tmp,
+#ifdef RT_PRINTF_LONGLONG
+                              unsigned long long num,
+#else
+                              unsigned long num,
+#endif
+                              int base,
+                              const char *digits)
+{
+    int i = 0;
+
+    if (base == 16)
+    {
+        do
+        {
+            tmp[i++] = digits[num & 0xf];
+            num >>= 4;
+        } while (num != 0);
+
+        return i;
+    }
+
+    if (base == 8)
+    {
+        do
+        {
+            tmp[i++] = digits[num & 0x7];
+            num >>= 3;
+        } while (num != 0);
+
+        return i;
+    }
+
+#ifdef RT_PRINTF_LONGLONG
+    /* one 64 bits division for every 9 digits */
+    while (num > 0xFFFFFFFFUL)
+    {
+        unsigned long long quot = num / 1000000000U;
+        int n = _rt_utoa_reverse(tmp + i, (rt_uint32_t)(num - quot * 1000000000U));
+
+        /* the leading zeros of the 9 digits */
+        for (i += n; n < 9; n++)
+            tmp[i++] = '0';
+        num = quot;
+    }
+#endif
+
+    return i + _rt_utoa_reverse(tmp + i, (rt_uint32_t)num);
+}
+#endif /* RT_USING_TINY_SIZE */
 
 rt_inline int skip_atoi(const char **s)
 {
@@ -602,6 +833,472 @@ rt_inline int skip_atoi(const char **s)
 #define SPECIAL     (1 << 5)    /* 0x */
 #define LARGE       (1 << 6)    /* use 'ABCDEF' instead of 'abcdef' */
 
+#ifdef RT_PRINTF_FLOAT
+/*
+ * The double is converted to the exact decimal in base 1e9 limbs without any
+ * libc support: the integer part by shifting the limbs, the fraction part by
+ * multiplying the binary fraction with 1e9, one limb for each step. Only the
+ * limbs for the precision are generated, so the common values take a few
+ * integer multiplications and the stack usage is bounded by the limb arrays.
+ * The result is rounded half to even, the same as glibc.
+ */
+#define FLOAT_LIMB              1000000000U
+#define FLOAT_INT_LIMBS         35      /* 2^1024 < 10^315 */
+#define FLOAT_FRAC_LIMBS        8
+#define FLOAT_FRAC_WORDS        34      /* 1074 bits of binary fraction */
+#define FLOAT_PRECISION_MAX     60
+
+struct float_digits
+{
+    /* limb[start, start + count), the integer part is the first point limbs */
+    rt_uint32_t limb[1 + FLOAT_INT_LIMBS + FLOAT_FRAC_LIMBS];
+    int start;
+    int count;
+    int point;
+    int skip;                           /* zero fraction limbs not stored */
+
+    /* the binary fraction, frac[words - 1] is the most significant word */
+    rt_uint32_t frac[FLOAT_FRAC_WORDS];
+    int low;
+    int words;
+};
+
+static const rt_uint32_t _rt_pow10[10] =
+{
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+static rt_uint32_t float_next_limb(struct float_digits *fd)
+{
+    rt_uint64_t value;
+    rt_uint32_t carry = 0;
+    int i;
+
+    for (i = fd->low; i < fd->words; i++)
+    {
+        value = (rt_uint64_t)fd->frac[i] * FLOAT_LIMB + carry;
+        fd->frac[i] = (rt_uint32_t)value;
+        carry = (rt_uint32_t)(value >> 32);
+    }
+
+    /* 1e9 = 2^9 * 5^9, the low words become zero quickly */
+    while (fd->low < fd->words && fd->frac[fd->low] == 0)
+        fd->low++;
+
+    return carry;
+}
+
+/* generate the fraction limbs */
+static void float_fill(struct float_digits *fd, int limbs)
+{
+    if (limbs > FLOAT_FRAC_LIMBS)
+        limbs = FLOAT_FRAC_LIMBS;
+
+    while (fd->count - fd->point < limbs)
+    {
+        fd->limb[fd->start + fd->count] = float_next_limb(fd);
+        fd->count++;
+    }
+}
+
+static void float_load(struct float_digits *fd, rt_uint64_t bits)
+{
+    const int end = 1 + FLOAT_INT_LIMBS;
+    rt_uint64_t mant, value;
+    rt_uint32_t carry;
+    int exp, shift, i;
+
+    mant = bits & ((1ULL << 52) - 1);
+    exp = (int)(bits >> 52) & 0x7FF;
+    if (exp == 0)
+        exp = 1;
+    else
+        mant |= 1ULL << 52;
+    exp -= 1075;
+
+    fd->skip = 0;
+    fd->low = 0;
+    fd->words = 0;
+
+    value = mant;
+    if (exp < 0)
+    {
+        shift = -exp;
+        value = shift < 64 ? mant >> shift : 0;
+        if (shift < 64)
+            mant &= (1ULL << shift) - 1;
+
+        if (mant != 0)
+        {
+            /* move the binary point to the word boundary */
+            fd->words = (shift + 31) >> 5;
+            shift = (fd->words << 5) - shift;
+            for (i = 0; i < fd->words; i++)
+                fd->frac[i] = 0;
+            fd->frac[0] = (rt_uint32_t)(mant << shift);
+            if (fd->words > 1)
+                fd->frac[1] = (rt_uint32_t)((mant << shift) >> 32);
+            if (fd->words > 2 && shift != 0)
+                fd->frac[2] = (rt_uint32_t)(mant >> (64 - shift));
+            while (fd->frac[fd->low] == 0)
+                fd->low++;
+        }
+        exp = 0;
+    }
+
+    /* the integer part, at most 3 limbs for 64 bits */
+    fd->start = end;
+    do
+    {
+        fd->limb[--fd->start] = (rt_uint32_t)(value % FLOAT_LIMB);
+        value /= FLOAT_LIMB;
+    } while (value != 0);
+
+    /* multiply by 2^exp */
+    while (exp > 0)
+    {
+        shift = exp > 29 ? 29 : exp;
+        exp -= shift;
+
+        carry = 0;
+        for (i = end - 1; i >= fd->start; i--)
+        {
+            value = ((rt_uint64_t)fd->limb[i] << shift) + carry;
+            carry = (rt_uint32_t)(value / FLOAT_LIMB);
+            fd->limb[i] = (rt_uint32_t)(value - (rt_uint64_t)carry * FLOAT_LIMB);
+        }
+        if (carry != 0)
+            fd->limb[--fd->start] = carry;
+    }
+
+    fd->point = end - fd->start;
+    fd->count = fd->point;
+}
+
+/* the digit at index, 9 digits for each limb */
+static int float_digit(struct float_digits *fd, int index)
+{
+    int limb = index / 9;
+
+    if (limb >= fd->count)
+        return 0;
+
+    return (fd->limb[fd->start + limb] / _rt_pow10[8 - index % 9]) % 10;
+}
+
+/* the index of the first non-zero digit */
+static int float_first(struct float_digits *fd)
+{
+    rt_uint32_t limb;
+    int i, n;
+
+    for (i = 0; i < fd->count; i++)
+    {
+        limb = fd->limb[fd->start + i];
+        if (limb != 0)
+        {
+            for (n = 1; n < 9 && limb >= _rt_pow10[n]; n++);
+            return i * 9 + 9 - n;
+        }
+    }
+
+    /* zero */
+    return fd->point * 9 - 1;
+}
+
+/* skip the zero limbs of a small fraction for the exponent format */
+static void float_skip(struct float_digits *fd)
+{
+    rt_uint32_t limb;
+
+    if (fd->point != 1 || fd->limb[fd->start] != 0)
+        return;
+
+    while (fd->low < fd->words)
+    {
+        limb = float_next_limb(fd);
+        if (limb != 0)
+        {
+            fd->limb[fd->start + fd->count] = limb;
+            fd->count++;
+            break;
+        }
+        fd->skip++;
+    }
+}
+
+/* keep the digits before cut, round half to even */
+static void float_round(struct float_digits *fd, int cut)
+{
+    int limb = cut / 9, i;
+    rt_uint32_t unit, digit, rest;
+
+    float_fill(fd, limb + 1 - fd->point);
+
+    rest = (fd->low < fd->words);
+    digit = 0;
+    if (limb < fd->count)
+    {
+        unit = _rt_pow10[8 - cut % 9];
+        digit = fd->limb[fd->start + limb] / unit % 10;
+        rest |= fd->limb[fd->start + limb] % unit;
+        for (i = limb + 1; i < fd->count; i++)
+            rest |= fd->limb[fd->start + i];
+
+        /* drop the digits from cut */
+        unit *= 10;
+        fd->limb[fd->start + limb] -= fd->limb[fd->start + limb] % unit;
+        fd->count = limb + 1;
+    }
+
+    if (digit < 5 || (digit == 5 && rest == 0 && (float_digit(fd, cut - 1) & 1) == 0))
+        return;
+
+    limb = (cut - 1) / 9;
+    fd->limb[fd->start + limb] += _rt_pow10[8 - (cut - 1) % 9];
+    while (fd->limb[fd->start + limb] >= FLOAT_LIMB)
+    {
+        fd->limb[fd->start + limb] -= FLOAT_LIMB;
+        if (limb == 0)
+        {
+            /* a new integer limb */
+            fd->limb[--fd->start] = 1;
+            fd->count++;
+            fd->point++;
+            break;
+        }
+        fd->limb[fd->start + --limb] += 1;
+    }
+}
+
+static char *float_put(char *buf, char *end, struct float_digits *fd, int from, int to)
+{
+    char digits[9];
+    rt_uint32_t value, index;
+    int limb, i, n;
+
+    while (from < to)
+    {
+        limb = from / 9;
+        i = from % 9;
+        n = 9 - i;
+        if (n > to - from)
+            n = to - from;
+        from += n;
+
+        if (limb < fd->count)
+        {
+            value = fd->limb[fd->start + limb];
+            for (index = 9; index > 1; index -= 2)
+            {
+                digits[index - 1] = _rt_digit_pairs[(value % 100) * 2 + 1];
+                digits[index - 2] = _rt_digit_pairs[(value % 100) * 2];
+                value /= 100;
+            }
+            digits[0] = '0' + value;
+        }
+        else
+        {
+            rt_memset(digits, '0', sizeof(digits));
+        }
+
+        for (n += i; i < n; i++)
+        {
+            if (buf < end)
+                *buf = digits[i];
+            ++ buf;
+        }
+    }
+
+    return buf;
+}
+
+static char *print_float(char *buf,
+                         char *end,
+                         double num,
+                         char  fmt,
+                         int   size,
+                         int   precision,
+                         int   type)
+{
+    struct float_digits fd;
+    union
+    {
+        double value;
+        rt_uint64_t bits;
+    } conv;
+    char sign, upper, exp_sign = '+';
+    int first = 0, exponent = 0, digits, exp_len = 0;
+    int exp_style = 0, dot = 0, len, i;
+    const char *text = RT_NULL;
+
+    conv.value = num;
+    upper = (fmt == 'F' || fmt == 'E' || fmt == 'G');
+    fmt |= 0x20;
+
+    if (type & LEFT)
+        type &= ~ZEROPAD;
+
+    sign = 0;
+    if (conv.bits >> 63)
+        sign = '-';
+    else if (type & PLUS)
+        sign = '+';
+    else if (type & SPACE)
+        sign = ' ';
+
+    if (((conv.bits >> 52) & 0x7FF) == 0x7FF)
+    {
+        if (conv.bits & ((1ULL << 52) - 1))
+            text = upper ? "NAN" : "nan";
+        else
+            text = upper ? "INF" : "inf";
+        type &= ~ZEROPAD;
+        len = 3;
+    }
+    else
+    {
+        if (precision < 0)
+            precision = 6;
+        if (precision > FLOAT_PRECISION_MAX)
+            precision = FLOAT_PRECISION_MAX;
+
+        float_load(&fd, conv.bits);
+        if (fmt == 'f')
+        {
+            float_round(&fd, fd.point * 9 + precision);
+            exp_style = 0;
+        }
+        else
+        {
+            /* the significant digits */
+            digits = precision + 1;
+            if (fmt == 'g')
+                digits = precision ? precision : 1;
+
+            float_skip(&fd);
+            float_round(&fd, float_first(&fd) + digits);
+            first = float_first(&fd);
+            exponent = fd.point * 9 - 1 - first - fd.skip * 9;
+
+            exp_style = 1;
+            precision = digits - 1;
+            if (fmt == 'g' && exponent >= -4 && exponent < digits)
+            {
+                exp_style = 0;
+                precision = digits - 1 - exponent;
+            }
+
+            /* remove the trailing zeros */
+            if (fmt == 'g' && !(type & SPECIAL))
+            {
+                i = exp_style ? first : fd.point * 9 - 1;
+                while (precision > 0 && float_digit(&fd, i + precision) == 0)
+                    precision--;
+            }
+        }
+
+        dot = (precision > 0 || (type & SPECIAL)) ? 1 : 0;
+        if (exp_style)
+        {
+            exp_sign = exponent < 0 ? '-' : '+';
+            if (exponent < 0)
+                exponent = -exponent;
+            for (exp_len = 2; exp_len < 3 && exponent >= (int)_rt_pow10[exp_len]; exp_len++);
+            len = 1 + dot + precision + 2 + exp_len;
+        }
+        else
+        {
+            first = float_first(&fd);
+            if (first >= fd.point * 9)
+                first = fd.point * 9 - 1;
+            len = fd.point * 9 - first + dot + precision;
+        }
+    }
+
+    size -= len;
+    if (sign)
+        size--;
+
+    if (!(type & (ZEROPAD | LEFT)))
+    {
+        while (size-- > 0)
+        {
+            if (buf < end)
+                *buf = ' ';
+            ++ buf;
+        }
+    }
+
+    if (sign)
+    {
+        if (buf < end)
+            *buf = sign;
+        ++ buf;
+    }
+
+    if (type & ZEROPAD)
+    {
+        while (size-- > 0)
+        {
+            if (buf < end)
+                *buf = '0';
+            ++ buf;
+        }
+    }
+
+    if (text)
+    {
+        for (i = 0; i < len; i++)
+        {
+            if (buf < end)
+                *buf = text[i];
+            ++ buf;
+        }
+    }
+    else
+    {
+        /* the integer part or the first significant digit */
+        buf = float_put(buf, end, &fd, first, exp_style ? first + 1 : fd.point * 9);
+        if (dot)
+        {
+            if (buf < end)
+                *buf = '.';
+            ++ buf;
+        }
+        if (exp_style)
+        {
+            buf = float_put(buf, end, &fd, first + 1, first + 1 + precision);
+            if (buf < end)
+                *buf = upper ? 'E' : 'e';
+            ++ buf;
+            if (buf < end)
+                *buf = exp_sign;
+            ++ buf;
+            while (exp_len-- > 0)
+            {
+                if (buf < end)
+                    *buf = '0' + exponent / _rt_pow10[exp_len] % 10;
+                ++ buf;
+            }
+        }
+        else
+        {
+            buf = float_put(buf, end, &fd, fd.point * 9, fd.point * 9 + precision);
+        }
+    }
+
+    while (size-- > 0)
+    {
+        if (buf < end)
+            *buf = ' ';
+        ++ buf;
+    }
+
+    return buf;
+}
+#endif /* RT_PRINTF_FLOAT */
+
 #ifdef RT_PRINTF_PRECISION
 static char *print_number(char *buf,
                           char *end,
@@ -633,7 +1330,6 @@ static char *print_number(char *buf,
 #else
     char tmp[16];
 #endif
-    int precision_bak = precision;
     const char *digits;
     static const char small_digits[] = "0123456789abcdef";
     static const char large_digits[] = "0123456789ABCDEF";
@@ -645,6 +1341,11 @@ static char *print_number(char *buf,
     digits = (type & LARGE) ? large_digits : small_digits;
     if (type & LEFT)
         type &= ~ZEROPAD;
+#ifdef RT_PRINTF_PRECISION
+    /* the zero padding is ignored with precision */
+    if (precision >= 0)
+        type &= ~ZEROPAD;
+#endif
 
     c = (type & ZEROPAD) ? '0' : ' ';
 
@@ -673,6 +1374,7 @@ static char *print_number(char *buf,
     }
 #endif
 
+#ifdef RT_USING_TINY_SIZE
     i = 0;
     if (num == 0)
         tmp[i++] = '0';
@@ -681,8 +1383,15 @@ static char *print_number(char *buf,
         while (num != 0)
             tmp[i++] = digits[divide(&num, base)];
     }
+#else
+    i = _rt_number_reverse(tmp, num, base, digits);
+#endif
 
 #ifdef RT_PRINTF_PRECISION
+    /* no digit for zero with zero precision */
+    if (precision == 0 && i == 1 && tmp[0] == '0')
+        i = 0;
+
     if (i > precision)
         precision = i;
     size -= precision;
@@ -757,7 +1466,7 @@ static char *print_number(char *buf,
 #endif
 
     /* put number in the temporary buffer */
-    while (i-- > 0 && (precision_bak != 0))
+    while (i-- > 0)
     {
         if (buf < end)
             *buf = tmp[i];
@@ -964,6 +1673,21 @@ rt_int32_t rt_vsnprintf(char       *buf,
             ++ str;
             continue;
 
+#ifdef RT_PRINTF_FLOAT
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+#ifdef RT_PRINTF_PRECISION
+            str = print_float(str, end, va_arg(args, double), *fmt, field_width, precision, flags);
+#else
+            str = print_float(str, end, va_arg(args, double), *fmt, field_width, -1, flags);
+#endif
+            continue;
+#endif
+
         /* integer number formats - set up the flags and "break" */
         case 'o':
             base = 8;
@@ -17,6 +17,7 @@
  * 2013-05-24     Bernard      fix the rt_memheap_realloc issue.
  * 2013-07-11     Grissiom     fix the memory block splitting issue.
  * 2013-07-15     Grissiom     optimize rt_memheap_realloc
+ * 2026-10-19     Hehesheng    add the heap hooks with caller address
  */
 
 #include <rthw.h>
@@ -598,6 +599,82 @@ RTM_EXPORT(rt_memheap_free);
 #ifdef RT_USING_MEMHEAP_AS_HEAP
 static struct rt_memheap _heap;
 
+#ifdef RT_USING_HOOK
+static void (*rt_malloc_hook)(void *ptr, rt_size_t size);
+static void (*rt_free_hook)(void *ptr);
+static void (*rt_malloc_caller_hook)(void *ptr, rt_size_t size, void *caller);
+static void (*rt_free_caller_hook)(void *ptr, void *caller);
+
+/**
+ * @addtogroup Hook
+ */
+
+/**@{*/
+
+/**
+ * This function will set a hook function, which will be invoked when a memory
+ * block is allocated from heap memory.
+ *
+ * @param hook the hook function
+ */
+void rt_malloc_sethook(void (*hook)(void *ptr, rt_size_t size))
+{
+    rt_malloc_hook = hook;
+}
+RTM_EXPORT(rt_malloc_sethook);
+
+/**
+ * This function will set a hook function, which will be invoked when a memory
+ * block is released to heap memory.
+ *
+ * @param hook the hook function
+ */
+void rt_free_sethook(void (*hook)(void *ptr))
+{
+    rt_free_hook = hook;
+}
+RTM_EXPORT(rt_free_sethook);
+
+/**
+ * This function will set a hook function, which will be invoked when a memory
+ * block is allocated from heap memory. The caller is the return address of
+ * heap interface, and the resized block of rt_realloc is reported as a new
+ * block.
+ *
+ * @param hook the hook function
+ */
+void rt_malloc_caller_sethook(void (*hook)(void *ptr, rt_size_t size, void *caller))
+{
+    rt_malloc_caller_hook = hook;
+}
+RTM_EXPORT(rt_malloc_caller_sethook);
+
+/**
+ * This function will set a hook function, which will be invoked when a memory
+ * block is released to heap memory. The caller is the return address of
+ * heap interface.
+ *
+ * @param hook the hook function
+ */
+void rt_free_caller_sethook(void (*hook)(void *ptr, void *caller))
+{
+    rt_free_caller_hook = hook;
+}
+RTM_EXPORT(rt_free_caller_sethook);
+
+/**@}*/
+
+#endif
+
+/* the return address of heap interface */
+#if defined(__CC_ARM)
+#define HEAP_CALLER()           ((void *)__return_address())
+#elif defined(__GNUC__) || defined(__CLANG_ARM)
+#define HEAP_CALLER()           __builtin_return_address(0)
+#else
+#define HEAP_CALLER()           RT_NULL
+#endif
+
 void rt_system_heap_init(void *begin_addr, void *end_addr)
 {
     /* initialize a default heap in the system */
@@ -607,7 +684,7 @@ void rt_system_heap_init(void *begin_addr, void *end_addr)
                     (rt_uint32_t)end_addr - (rt_uint32_t)begin_addr);
 }
 
-void *rt_malloc(rt_size_t size)
+static void *_rt_heap_malloc(rt_size_t size, void *caller)
 {
     void *ptr;
 
@@ -643,27 +720,47 @@ void *rt_malloc(rt_size_t size)
         }
     }
 
+    if (ptr != RT_NULL)
+    {
+        RT_OBJECT_HOOK_CALL(rt_malloc_hook, (ptr, size));
+        RT_OBJECT_HOOK_CALL(rt_malloc_caller_hook, (ptr, size, caller));
+    }
+
     return ptr;
 }
+
+static void _rt_heap_free(void *rmem, void *caller)
+{
+    RT_OBJECT_HOOK_CALL(rt_free_hook, (rmem));
+    RT_OBJECT_HOOK_CALL(rt_free_caller_hook, (rmem, caller));
+
+    rt_memheap_free(rmem);
+}
+
+void *rt_malloc(rt_size_t size)
+{
+    return _rt_heap_malloc(size, HEAP_CALLER());
+}
 RTM_EXPORT(rt_malloc);
 
 void rt_free(void *rmem)
 {
-    rt_memheap_free(rmem);
+    _rt_heap_free(rmem, HEAP_CALLER());
 }
 RTM_EXPORT(rt_free);
 
 void *rt_realloc(void *rmem, rt_size_t newsize)
 {
     void *new_ptr;
+    void *caller = HEAP_CALLER();
     struct rt_memheap_item *header_ptr;
 
     if (rmem == RT_NULL)
-        return rt_malloc(newsize);
+        return _rt_heap_malloc(newsize, caller);
 
     if (newsize == 0)
     {
-        rt_free(rmem);
+        _rt_heap_free(rmem, caller);
         return RT_NULL;
     }
 
@@ -672,10 +769,15 @@ void *rt_realloc(void *rmem, rt_size_t newsize)
                  ((rt_uint8_t *)rmem - RT_MEMHEAP_SIZE);
 
     new_ptr = rt_memheap_realloc(header_ptr->pool_ptr, rmem, newsize);
-    if (new_ptr == RT_NULL && newsize != 0)
+    if (new_ptr != RT_NULL)
+    {
+        RT_OBJECT_HOOK_CALL(rt_free_caller_hook, (rmem, caller));
+        RT_OBJECT_HOOK_CALL(rt_malloc_caller_hook, (new_ptr, newsize, caller));
+    }
+    else if (newsize != 0)
     {
         /* allocate memory block from other memheap */
-        new_ptr = rt_malloc(newsize);
+        new_ptr = _rt_heap_malloc(newsize, caller);
         if (new_ptr != RT_NULL && rmem != RT_NULL)
         {
             rt_size_t oldsize;
@@ -687,7 +789,7 @@ void *rt_realloc(void *rmem, rt_size_t newsize)
             else
                 rt_memcpy(new_ptr, rmem, newsize);
 
-            rt_free(rmem);
+            _rt_heap_free(rmem, caller);
         }
     }
 
@@ -701,7 +803,7 @@ void *rt_calloc(rt_size_t count, rt_size_t size)
     rt_size_t total_size;
 
     total_size = count * size;
-    ptr = rt_malloc(total_size);
+    ptr = _rt_heap_malloc(total_size, HEAP_CALLER());
     if (ptr != RT_NULL)
     {
         /* clean memory */
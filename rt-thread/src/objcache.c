@@ -0,0 +1,440 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#ifdef RT_USING_OBJCACHE
+
+/*
+ * The object cache keeps constructed objects of the same size. The objects
+ * live in pages, each page is a memory pool allocated from the heap. The
+ * freed objects are kept in the magazine of the priority band of current
+ * thread first, and the magazine exchanges half of its objects with the
+ * pages when it becomes empty or full. So most of allocation and release
+ * are a push or pop of magazine, and the pages are only touched in batch.
+ *
+ * The constructor is invoked when a page is added to cache, and the
+ * destructor is invoked when the page is released. The object shall be
+ * back to its constructed state when it's released to cache.
+ */
+
+struct rt_objcache_page
+{
+    struct rt_mempool mp;                               /**< memory pool of page */
+    rt_list_t list;                                     /**< node in page list of cache */
+    rt_objcache_t cache;                                /**< the owner cache */
+};
+
+#define OBJCACHE_BATCH                  (RT_OBJCACHE_MAGAZINE_SIZE / 2)
+#define OBJCACHE_BLOCK_SIZE(cache)      ((cache)->obj_size + sizeof(rt_uint8_t *))
+
+static rt_list_t _objcache_list = RT_LIST_OBJECT_INIT(_objcache_list);
+
+/* get the page which the object belongs to */
+rt_inline struct rt_objcache_page *_objcache_page(void *obj)
+{
+    return (struct rt_objcache_page *)*(rt_uint8_t **)((rt_uint8_t *)obj - sizeof(rt_uint8_t *));
+}
+
+/* get the magazine of current thread, the interrupt shall be disabled */
+rt_inline struct rt_objcache_magazine *_objcache_magazine(rt_objcache_t cache)
+{
+    rt_thread_t thread;
+
+    thread = rt_thread_self();
+    if (thread == RT_NULL)
+        return &(cache->magazine[0]);
+
+    return &(cache->magazine[thread->current_priority * RT_OBJCACHE_MAGAZINES / RT_THREAD_PRIORITY_MAX]);
+}
+
+/* move a batch of objects from pages to magazine, the interrupt shall be disabled */
+static void _objcache_refill(rt_objcache_t cache, struct rt_objcache_magazine *magazine)
+{
+    struct rt_objcache_page *page;
+    void *obj;
+
+    rt_list_for_each_entry(page, &(cache->pages), list)
+    {
+        while (page->mp.block_free_count > 0)
+        {
+            obj = rt_mp_alloc(&(page->mp), 0);
+            magazine->objs[magazine->count ++] = obj;
+            if (magazine->count == OBJCACHE_BATCH)
+                return;
+        }
+    }
+}
+
+/* move the objects of magazine back to pages, the interrupt shall be disabled */
+static void _objcache_flush(struct rt_objcache_magazine *magazine, rt_uint16_t count)
+{
+    while (count-- > 0)
+        rt_mp_free(magazine->objs[-- magazine->count]);
+}
+
+/* release the pages that all objects are free, the first keep pages are kept */
+static rt_size_t _objcache_reap(rt_objcache_t cache, rt_size_t keep)
+{
+    struct rt_objcache_page *page, *victim;
+    rt_uint8_t *block_ptr;
+    register rt_base_t level;
+    rt_size_t count = 0, empty, index;
+
+    do
+    {
+        victim = RT_NULL;
+        empty = 0;
+
+        level = rt_hw_interrupt_disable();
+        rt_list_for_each_entry(page, &(cache->pages), list)
+        {
+            if (page->mp.block_free_count == page->mp.block_total_count && empty ++ >= keep)
+            {
+                /* no one can allocate from the page after it's removed */
+                victim = page;
+                rt_list_remove(&(victim->list));
+                cache->page_count --;
+                break;
+            }
+        }
+        rt_hw_interrupt_enable(level);
+
+        if (victim != RT_NULL)
+        {
+            if (cache->dtor != RT_NULL)
+            {
+                block_ptr = (rt_uint8_t *)victim->mp.start_address + sizeof(rt_uint8_t *);
+                for (index = 0; index < victim->mp.block_total_count; index ++)
+                    cache->dtor(block_ptr + index * OBJCACHE_BLOCK_SIZE(cache));
+            }
+
+            rt_mp_detach(&(victim->mp));
+            rt_free(victim);
+            count ++;
+        }
+    }
+    while (victim != RT_NULL);
+
+    return count;
+}
+
+/* add a page to cache */
+static rt_err_t _objcache_grow(rt_objcache_t cache)
+{
+    struct rt_objcache_page *page;
+    rt_uint8_t *block_ptr;
+    register rt_base_t level;
+    rt_size_t index;
+
+    page = (struct rt_objcache_page *)rt_malloc(sizeof(struct rt_objcache_page) +
+                                                cache->page_objs * OBJCACHE_BLOCK_SIZE(cache));
+    if (page == RT_NULL)
+        return -RT_ENOMEM;
+
+    rt_mp_init(&(page->mp), cache->name, page + 1,
+               cache->page_objs * OBJCACHE_BLOCK_SIZE(cache), cache->obj_size);
+    page->cache = cache;
+
+    if (cache->ctor != RT_NULL)
+    {
+        block_ptr = (rt_uint8_t *)page->mp.start_address + sizeof(rt_uint8_t *);
+        for (index = 0; index < page->mp.block_total_count; index ++)
+            cache->ctor(block_ptr + index * OBJCACHE_BLOCK_SIZE(cache));
+    }
+
+    level = rt_hw_interrupt_disable();
+    rt_list_insert_after(&(cache->pages), &(page->list));
+    cache->page_count ++;
+    if (cache->page_count > cache->page_peak)
+        cache->page_peak = cache->page_count;
+    rt_hw_interrupt_enable(level);
+
+    return RT_EOK;
+}
+
+/**
+ * @addtogroup MM
+ */
+
+/**@{*/
+
+/**
+ * This function will create an object cache. No page is allocated until the
+ * first object is allocated.
+ *
+ * @param name the name of object cache
+ * @param obj_size the size of each object
+ * @param page_objs the number of objects in each page
+ * @param ctor the constructor of object, it can be RT_NULL
+ * @param dtor the destructor of object, it can be RT_NULL
+ *
+ * @return the created object cache, RT_NULL on error happen
+ */
+rt_objcache_t rt_objcache_create(const char *name,
+                                 rt_size_t   obj_size,
+                                 rt_size_t   page_objs,
+                                 void (*ctor)(void *obj),
+                                 void (*dtor)(void *obj))
+{
+    rt_objcache_t cache;
+
+    RT_DEBUG_NOT_IN_INTERRUPT;
+
+    /* parameter check */
+    RT_ASSERT(name != RT_NULL);
+    RT_ASSERT(obj_size > 0 && page_objs > 0);
+
+    cache = (rt_objcache_t)rt_malloc(sizeof(struct rt_objcache));
+    if (cache == RT_NULL)
+        return RT_NULL;
+
+    rt_memset(cache, 0, sizeof(struct rt_objcache));
+    rt_strncpy(cache->name, name, RT_NAME_MAX);
+    cache->obj_size  = RT_ALIGN(obj_size, RT_ALIGN_SIZE);
+    cache->page_objs = page_objs;
+    cache->ctor      = ctor;
+    cache->dtor      = dtor;
+    rt_list_init(&(cache->pages));
+
+    rt_enter_critical();
+    rt_list_insert_after(&_objcache_list, &(cache->list));
+    rt_exit_critical();
+
+    return cache;
+}
+RTM_EXPORT(rt_objcache_create);
+
+/**
+ * This function will delete an object cache. All objects shall be released
+ * to the cache before it's deleted.
+ *
+ * @param cache the object cache
+ *
+ * @return RT_EOK on successful, -RT_EBUSY if some objects are still in use
+ */
+rt_err_t rt_objcache_delete(rt_objcache_t cache)
+{
+    RT_DEBUG_NOT_IN_INTERRUPT;
+
+    /* parameter check */
+    RT_ASSERT(cache != RT_NULL);
+
+    rt_objcache_shrink(cache);
+    if (cache->page_count > 0)
+        return -RT_EBUSY;
+
+    rt_enter_critical();
+    rt_list_remove(&(cache->list));
+    rt_exit_critical();
+
+    rt_free(cache);
+
+    return RT_EOK;
+}
+RTM_EXPORT(rt_objcache_delete);
+
+/**
+ * This function will allocate an object from object cache. The cache grows
+ * by one page when there is no free object, except in interrupt context.
+ *
+ * @param cache the object cache
+ *
+ * @return the allocated object or RT_NULL on allocated failed
+ */
+void *rt_objcache_alloc(rt_objcache_t cache)
+{
+    struct rt_objcache_magazine *magazine;
+    register rt_base_t level;
+    rt_bool_t grown = RT_FALSE;
+    void *obj;
+
+    /* parameter check */
+    RT_ASSERT(cache != RT_NULL);
+
+    while (1)
+    {
+        level = rt_hw_interrupt_disable();
+
+        magazine = _objcache_magazine(cache);
+        if (magazine->count == 0)
+        {
+            if (!grown)
+                cache->misses ++;
+            _objcache_refill(cache, magazine);
+        }
+
+        if (magazine->count > 0)
+        {
+            obj = magazine->objs[-- magazine->count];
+            cache->allocs ++;
+            rt_hw_interrupt_enable(level);
+
+            return obj;
+        }
+
+        rt_hw_interrupt_enable(level);
+
+        /* the heap can't be used in interrupt context */
+        if (grown || rt_interrupt_get_nest() > 0 || _objcache_grow(cache) != RT_EOK)
+            return RT_NULL;
+        grown = RT_TRUE;
+    }
+}
+RTM_EXPORT(rt_objcache_alloc);
+
+/**
+ * This function will release an object to object cache.
+ *
+ * @param cache the object cache
+ * @param obj the object allocated from this cache
+ */
+void rt_objcache_free(rt_objcache_t cache, void *obj)
+{
+    struct rt_objcache_magazine *magazine;
+    register rt_base_t level;
+    rt_bool_t flushed = RT_FALSE;
+
+    /* parameter check */
+    RT_ASSERT(cache != RT_NULL);
+    if (obj == RT_NULL) return;
+    RT_ASSERT(_objcache_page(obj)->cache == cache);
+
+    level = rt_hw_interrupt_disable();
+
+    magazine = _objcache_magazine(cache);
+    if (magazine->count == RT_OBJCACHE_MAGAZINE_SIZE)
+    {
+        _objcache_flush(magazine, OBJCACHE_BATCH);
+        flushed = RT_TRUE;
+    }
+    magazine->objs[magazine->count ++] = obj;
+    cache->frees ++;
+
+    rt_hw_interrupt_enable(level);
+
+    /* keep one free page to avoid the page is released and allocated repeatedly */
+    if (flushed && rt_interrupt_get_nest() == 0)
+        _objcache_reap(cache, 1);
+}
+RTM_EXPORT(rt_objcache_free);
+
+/**
+ * This function will move all cached objects in magazines back to pages,
+ * and release the pages that all objects are free to heap.
+ *
+ * @param cache the object cache
+ *
+ * @return the number of released pages
+ */
+rt_size_t rt_objcache_shrink(rt_objcache_t cache)
+{
+    register rt_base_t level;
+    rt_size_t index;
+
+    RT_DEBUG_NOT_IN_INTERRUPT;
+
+    /* parameter check */
+    RT_ASSERT(cache != RT_NULL);
+
+    for (index = 0; index < RT_OBJCACHE_MAGAZINES; index ++)
+    {
+        level = rt_hw_interrupt_disable();
+        _objcache_flush(&(cache->magazine[index]), cache->magazine[index].count);
+        rt_hw_interrupt_enable(level);
+    }
+
+    return _objcache_reap(cache, 0);
+}
+RTM_EXPORT(rt_objcache_shrink);
+
+/**
+ * This function will find the specified object cache.
+ *
+ * @param name the name of object cache
+ *
+ * @return the found object cache or RT_NULL if there is no this object cache
+ */
+rt_objcache_t rt_objcache_find(const char *name)
+{
+    rt_objcache_t cache;
+
+    RT_ASSERT(name != RT_NULL);
+
+    rt_enter_critical();
+    rt_list_for_each_entry(cache, &_objcache_list, list)
+    {
+        if (rt_strncmp(cache->name, name, RT_NAME_MAX) == 0)
+        {
+            rt_exit_critical();
+
+            return cache;
+        }
+    }
+    rt_exit_critical();
+
+    return RT_NULL;
+}
+RTM_EXPORT(rt_objcache_find);
+
+/**@}*/
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+void list_cache(void)
+{
+    struct rt_objcache info;
+    rt_objcache_t cache;
+    rt_uint32_t cached, hit;
+    rt_size_t index, count;
+
+    rt_kprintf("%-*.*s  size page pages  peak in use cached    allocs hit\n",
+               RT_NAME_MAX, RT_NAME_MAX, "cache");
+    rt_kprintf("%-*.*s ----- ---- ----- ----- ------ ------ --------- ----\n",
+               RT_NAME_MAX, RT_NAME_MAX, "--------------------------------");
+
+    for (count = 0; ; count ++)
+    {
+        /* take a snapshot of the count-th cache, and print it out of the lock */
+        index = 0;
+        rt_enter_critical();
+        rt_list_for_each_entry(cache, &_objcache_list, list)
+        {
+            if (index ++ == count)
+            {
+                rt_memcpy(&info, cache, sizeof(struct rt_objcache));
+                break;
+            }
+        }
+        rt_exit_critical();
+
+        if (index <= count)
+            break;
+
+        cached = 0;
+        for (index = 0; index < RT_OBJCACHE_MAGAZINES; index ++)
+            cached += info.magazine[index].count;
+        hit = 0;
+        if (info.allocs > 0 && info.misses < info.allocs)
+            hit = (info.allocs - info.misses) * 100 / info.allocs;
+
+        rt_kprintf("%-*.*s %5d %4d %5d %5d %6d %6d %9d %3d%%\n",
+                   RT_NAME_MAX, RT_NAME_MAX, info.name,
+                   info.obj_size, info.page_objs, info.page_count, info.page_peak,
+                   info.allocs - info.frees, cached, info.allocs, hit);
+    }
+}
+FINSH_FUNCTION_EXPORT(list_cache, list object cache in system)
+MSH_CMD_EXPORT(list_cache, list object cache in system);
+#endif /* RT_USING_FINSH */
+
+#endif /* RT_USING_OBJCACHE */
@@ -13,6 +13,7 @@
  * 2010-10-26     yi.qiu       add module support in rt_object_allocate and rt_object_free
  * 2017-12-10     Bernard      Add object_info enum.
  * 2018-01-25     Bernard      Fix the object find issue when enable MODULE.
+ * 2026-10-19     Hehesheng    add name hash index for object find.
  */
 
 #include <rtthread.h>
@@ -105,6 +106,33 @@ static struct rt_object_information rt_object_container[RT_Object_Info_Unknown]
 #endif
 };
 
+#ifdef RT_USING_OBJECT_HASH
+#if (RT_OBJECT_HASH_BUCKETS & (RT_OBJECT_HASH_BUCKETS - 1)) != 0
+#error "RT_OBJECT_HASH_BUCKETS must be a power of two"
+#endif
+
+#define _OBJ_HASH_BUCKET(info, hash)    \
+    (&((info)->hash_table[(hash) & (RT_OBJECT_HASH_BUCKETS - 1)]))
+
+/*
+ * FNV-1a hash of an object name. At most RT_NAME_MAX characters are used,
+ * which matches the rt_strncmp() comparison of object names.
+ */
+static rt_uint32_t _object_name_hash(const char *name)
+{
+    rt_uint32_t hash = 2166136261UL;
+    rt_ubase_t index;
+
+    for (index = 0; index < RT_NAME_MAX && name[index] != '\0'; index ++)
+    {
+        hash ^= (rt_uint8_t)name[index];
+        hash *= 16777619UL;
+    }
+
+    return hash;
+}
+#endif
+
 #ifdef RT_USING_HOOK
 static void (*rt_object_attach_hook)(struct rt_object *object);
 static void (*rt_object_detach_hook)(struct rt_object *object);
@@ -275,6 +303,10 @@ void rt_object_init(struct rt_object         *object,
     object->type = type | RT_Object_Class_Static;
     /* copy name */
     rt_strncpy(object->name, name, RT_NAME_MAX);
+#ifdef RT_USING_OBJECT_HASH
+    object->name_hash = _object_name_hash(object->name);
+    object->hash_node.next = RT_NULL;
+#endif
 
     RT_OBJECT_HOOK_CALL(rt_object_attach_hook, (object));
 
@@ -292,6 +324,11 @@ void rt_object_init(struct rt_object         *object,
     {
         /* insert object into information object list */
         rt_list_insert_after(&(information->object_list), &(object->list));
+#ifdef RT_USING_OBJECT_HASH
+        /* insert object into name hash bucket */
+        rt_slist_insert(_OBJ_HASH_BUCKET(information, object->name_hash),
+                        &(object->hash_node));
+#endif
     }
 
     /* unlock interrupt */
@@ -307,12 +344,20 @@ void rt_object_init(struct rt_object         *object,
 void rt_object_detach(rt_object_t object)
 {
     register rt_base_t temp;
+#ifdef RT_USING_OBJECT_HASH
+    struct rt_object_information *information;
+#endif
 
     /* object check */
     RT_ASSERT(object != RT_NULL);
 
     RT_OBJECT_HOOK_CALL(rt_object_detach_hook, (object));
 
+#ifdef RT_USING_OBJECT_HASH
+    information = rt_object_get_information((enum rt_object_class_type)
+                                            rt_object_get_type(object));
+#endif
+
     /* reset object type */
     object->type = 0;
 
@@ -321,6 +366,14 @@ void rt_object_detach(rt_object_t object)
 
     /* remove from old list */
     rt_list_remove(&(object->list));
+#ifdef RT_USING_OBJECT_HASH
+    /* remove from name hash bucket, module objects are not in any bucket */
+    if (information != RT_NULL)
+    {
+        rt_slist_remove(_OBJ_HASH_BUCKET(information, object->name_hash),
+                        &(object->hash_node));
+    }
+#endif
 
     /* unlock interrupt */
     rt_hw_interrupt_enable(temp);
@@ -370,6 +423,10 @@ rt_object_t rt_object_allocate(enum rt_object_class_type type, const char *name)
 
     /* copy name */
     rt_strncpy(object->name, name, RT_NAME_MAX);
+#ifdef RT_USING_OBJECT_HASH
+    object->name_hash = _object_name_hash(object->name);
+    object->hash_node.next = RT_NULL;
+#endif
 
     RT_OBJECT_HOOK_CALL(rt_object_attach_hook, (object));
 
@@ -387,6 +444,11 @@ rt_object_t rt_object_allocate(enum rt_object_class_type type, const char *name)
     {
         /* insert object into information object list */
         rt_list_insert_after(&(information->object_list), &(object->list));
+#ifdef RT_USING_OBJECT_HASH
+        /* insert object into name hash bucket */
+        rt_slist_insert(_OBJ_HASH_BUCKET(information, object->name_hash),
+                        &(object->hash_node));
+#endif
     }
 
     /* unlock interrupt */
@@ -404,6 +466,9 @@ rt_object_t rt_object_allocate(enum rt_object_class_type type, const char *name)
 void rt_object_delete(rt_object_t object)
 {
     register rt_base_t temp;
+#ifdef RT_USING_OBJECT_HASH
+    struct rt_object_information *information;
+#endif
 
     /* object check */
     RT_ASSERT(object != RT_NULL);
@@ -411,6 +476,11 @@ void rt_object_delete(rt_object_t object)
 
     RT_OBJECT_HOOK_CALL(rt_object_detach_hook, (object));
 
+#ifdef RT_USING_OBJECT_HASH
+    information = rt_object_get_information((enum rt_object_class_type)
+                                            rt_object_get_type(object));
+#endif
+
     /* reset object type */
     object->type = 0;
 
@@ -419,6 +489,14 @@ void rt_object_delete(rt_object_t object)
 
     /* remove from old list */
     rt_list_remove(&(object->list));
+#ifdef RT_USING_OBJECT_HASH
+    /* remove from name hash bucket, module objects are not in any bucket */
+    if (information != RT_NULL)
+    {
+        rt_slist_remove(_OBJ_HASH_BUCKET(information, object->name_hash),
+                        &(object->hash_node));
+    }
+#endif
 
     /* unlock interrupt */
     rt_hw_interrupt_enable(temp);
@@ -478,8 +556,10 @@ rt_uint8_t rt_object_get_type(rt_object_t object)
  */
 rt_object_t rt_object_find(const char *name, rt_uint8_t type)
 {
+#ifndef RT_USING_OBJECT_HASH
     struct rt_object *object = RT_NULL;
     struct rt_list_node *node = RT_NULL;
+#endif
     struct rt_object_information *information = RT_NULL;
 
     /* parameter check */
@@ -489,6 +569,12 @@ rt_object_t rt_object_find(const char *name, rt_uint8_t type)
     /* which is invoke in interrupt status */
     RT_DEBUG_NOT_IN_INTERRUPT;
 
+#ifdef RT_USING_OBJECT_HASH
+    information = rt_object_get_information((enum rt_object_class_type)type);
+    RT_ASSERT(information != RT_NULL);
+
+    return rt_object_hash_find(information, name);
+#else
     /* enter critical */
     rt_enter_critical();
 
@@ -516,6 +602,112 @@ rt_object_t rt_object_find(const char *name, rt_uint8_t type)
     rt_exit_critical();
 
     return RT_NULL;
+#endif
+}
+
+#ifdef RT_USING_OBJECT_HASH
+/**
+ * This function will find specified name object in the name hash index
+ * of an object container.
+ *
+ * Only the objects in the same hash bucket are compared, and the bucket is
+ * walked with interrupt disabled, so it can be used before the scheduler
+ * is started.
+ *
+ * @param information the object container to be searched.
+ * @param name the specified name of object.
+ *
+ * @return the found object or RT_NULL if there is no this object
+ * in object container.
+ */
+rt_object_t rt_object_hash_find(struct rt_object_information *information,
+                                const char                   *name)
+{
+    register rt_base_t temp;
+    struct rt_object *object;
+    rt_slist_t *node;
+    rt_uint32_t hash;
+
+    RT_ASSERT(information != RT_NULL);
+
+    if (name == RT_NULL)
+        return RT_NULL;
+
+    hash = _object_name_hash(name);
+
+    /* lock interrupt */
+    temp = rt_hw_interrupt_disable();
+
+    for (node  = rt_slist_first(_OBJ_HASH_BUCKET(information, hash));
+         node != RT_NULL;
+         node  = rt_slist_next(node))
+    {
+        object = rt_slist_entry(node, struct rt_object, hash_node);
+        if (object->name_hash == hash &&
+            rt_strncmp(object->name, name, RT_NAME_MAX) == 0)
+        {
+            /* unlock interrupt */
+            rt_hw_interrupt_enable(temp);
+
+            return object;
+        }
+    }
+
+    /* unlock interrupt */
+    rt_hw_interrupt_enable(temp);
+
+    return RT_NULL;
+}
+RTM_EXPORT(rt_object_hash_find);
+
+/**
+ * This function will move an object to the right hash bucket after its
+ * name has been changed in place.
+ *
+ * @param object the specified object which name has been changed.
+ */
+void rt_object_rehash(rt_object_t object)
+{
+    register rt_base_t temp;
+    struct rt_object_information *information;
+    rt_slist_t *node;
+    rt_bool_t indexed = RT_FALSE;
+
+    /* object check */
+    RT_ASSERT(object != RT_NULL);
+
+    information = rt_object_get_information((enum rt_object_class_type)
+                                            rt_object_get_type(object));
+    RT_ASSERT(information != RT_NULL);
+
+    /* lock interrupt */
+    temp = rt_hw_interrupt_disable();
+
+    /* remove from old hash bucket, module objects are not in any bucket */
+    for (node  = _OBJ_HASH_BUCKET(information, object->name_hash);
+         node->next != RT_NULL;
+         node  = node->next)
+    {
+        if (node->next == &(object->hash_node))
+        {
+            node->next = object->hash_node.next;
+            indexed = RT_TRUE;
+            break;
+        }
+    }
+
+    object->name_hash = _object_name_hash(object->name);
+    if (indexed)
+    {
+        /* insert object into new name hash bucket */
+        rt_slist_insert(_OBJ_HASH_BUCKET(information, object->name_hash),
+                        &(object->hash_node));
+    }
+
+    /* unlock interrupt */
+    rt_hw_interrupt_enable(temp);
 }
+RTM_EXPORT(rt_object_rehash);
+#endif
 
 /**@}*/
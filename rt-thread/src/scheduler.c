@@ -27,6 +27,7 @@
  *                             rt_schedule_insert_thread won't insert current task to ready queue
  *                             in smp version, rt_hw_context_switch_interrupt maybe switch to
  *                               new task directly
+ * 2026-10-19     Hehesheng    add the fast path with cached next thread
  *
  */
 
@@ -49,6 +50,20 @@ extern volatile rt_uint8_t rt_interrupt_nest;
 static rt_int16_t rt_scheduler_lock_nest;
 struct rt_thread *rt_current_thread;
 rt_uint8_t rt_current_priority;
+
+#ifdef RT_USING_SCHED_FASTPATH
+/*
+ * The highest priority ready thread is cached until the ready queue changes.
+ * A thread inserted with higher priority replaces the cached one, and the
+ * cache is invalidated only when the cached thread is removed, so most of
+ * the wake-ups keep it valid.
+ */
+static struct rt_thread *_rt_next_thread;
+static rt_ubase_t _rt_next_priority;
+/* the ready queue is changed or rt_schedule is deferred by scheduler lock */
+static rt_bool_t _rt_schedule_pending;
+static struct rt_schedule_stats _rt_schedule_stats;
+#endif
 #endif /*RT_USING_SMP*/
 
 rt_list_t rt_thread_defunct;
@@ -228,6 +243,10 @@ void rt_system_scheduler_init(void)
 
     /* initialize ready priority group */
     rt_thread_ready_priority_group = 0;
+#ifdef RT_USING_SCHED_FASTPATH
+    _rt_next_thread = RT_NULL;
+    _rt_schedule_pending = RT_FALSE;
+#endif
 
 #if RT_THREAD_PRIORITY_MAX > 32
     /* initialize ready table */
@@ -417,17 +436,43 @@ void rt_schedule(void)
     /* disable interrupt */
     level = rt_hw_interrupt_disable();
 
+#ifdef RT_USING_SCHED_FASTPATH
+    _rt_schedule_stats.calls ++;
+#endif
+
     /* check the scheduler is enabled or not */
     if (rt_scheduler_lock_nest == 0)
     {
         rt_ubase_t highest_ready_priority;
 
+#ifdef RT_USING_SCHED_FASTPATH
+        _rt_schedule_pending = RT_FALSE;
+
+        if (rt_thread_ready_priority_group != 0 && _rt_next_thread == RT_NULL)
+            _rt_next_thread = _get_highest_priority_thread(&_rt_next_priority);
+
+        /* no ready thread, or the current thread is still the highest */
+        if (rt_thread_ready_priority_group == 0 ||
+            ((rt_current_thread->stat & RT_THREAD_STAT_MASK) == RT_THREAD_RUNNING &&
+             rt_current_thread->current_priority < _rt_next_priority))
+        {
+            _rt_schedule_stats.fast ++;
+            rt_hw_interrupt_enable(level);
+            return;
+        }
+#endif
+
         if (rt_thread_ready_priority_group != 0)
         {
             /* need_insert_from_thread: need to insert from_thread to ready queue */
             int need_insert_from_thread = 0;
 
+#ifdef RT_USING_SCHED_FASTPATH
+            to_thread = _rt_next_thread;
+            highest_ready_priority = _rt_next_priority;
+#else
             to_thread = _get_highest_priority_thread(&highest_ready_priority);
+#endif
 
             if ((rt_current_thread->stat & RT_THREAD_STAT_MASK) == RT_THREAD_RUNNING)
             {
@@ -471,6 +516,10 @@ void rt_schedule(void)
                 _rt_scheduler_stack_check(to_thread);
 #endif
 
+#ifdef RT_USING_SCHED_FASTPATH
+                _rt_schedule_stats.switches ++;
+#endif
+
                 if (rt_interrupt_nest == 0)
                 {
                     extern void rt_thread_handle_sig(rt_bool_t clean_state);
@@ -514,6 +563,14 @@ void rt_schedule(void)
             }
         }
     }
+#ifdef RT_USING_SCHED_FASTPATH
+    else
+    {
+        /* schedule it when the scheduler is unlocked */
+        _rt_schedule_pending = RT_TRUE;
+        _rt_schedule_stats.deferred ++;
+    }
+#endif
 
     /* enable interrupt */
     rt_hw_interrupt_enable(level);
@@ -716,6 +773,16 @@ void rt_schedule_insert_thread(struct rt_thread *thread)
 #endif
     rt_thread_ready_priority_group |= thread->number_mask;
 
+#ifdef RT_USING_SCHED_FASTPATH
+    /* the thread is inserted to tail, only a higher priority one replaces the next thread */
+    if (_rt_next_thread != RT_NULL && thread->current_priority < _rt_next_priority)
+    {
+        _rt_next_thread = thread;
+        _rt_next_priority = thread->current_priority;
+    }
+    _rt_schedule_pending = RT_TRUE;
+#endif
+
 __exit:
     /* enable interrupt */
     rt_hw_interrupt_enable(temp);
@@ -810,6 +877,12 @@ void rt_schedule_remove_thread(struct rt_thread *thread)
 #endif
     }
 
+#ifdef RT_USING_SCHED_FASTPATH
+    if (thread == _rt_next_thread)
+        _rt_next_thread = RT_NULL;
+    _rt_schedule_pending = RT_TRUE;
+#endif
+
     /* enable interrupt */
     rt_hw_interrupt_enable(level);
 }
@@ -923,6 +996,17 @@ void rt_exit_critical(void)
     if (rt_scheduler_lock_nest <= 0)
     {
         rt_scheduler_lock_nest = 0;
+
+#ifdef RT_USING_SCHED_FASTPATH
+        /* nothing is woken up or suspended in the critical section */
+        if (!_rt_schedule_pending)
+        {
+            _rt_schedule_stats.unlock_skipped ++;
+            rt_hw_interrupt_enable(level);
+            return;
+        }
+#endif
+
         /* enable interrupt */
         rt_hw_interrupt_enable(level);
 
@@ -958,4 +1042,55 @@ rt_uint16_t rt_critical_level(void)
 }
 RTM_EXPORT(rt_critical_level);
 
+#ifdef RT_USING_SCHED_FASTPATH
+/**
+ * This function will get the scheduler statistics.
+ *
+ * @param stats the buffer to save the statistics
+ */
+void rt_schedule_get_stats(struct rt_schedule_stats *stats)
+{
+    register rt_base_t level;
+
+    RT_ASSERT(stats != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    rt_memcpy(stats, &_rt_schedule_stats, sizeof(struct rt_schedule_stats));
+    rt_hw_interrupt_enable(level);
+}
+RTM_EXPORT(rt_schedule_get_stats);
+
+/**
+ * This function will reset the scheduler statistics.
+ */
+void rt_schedule_reset_stats(void)
+{
+    register rt_base_t level;
+
+    level = rt_hw_interrupt_disable();
+    rt_memset(&_rt_schedule_stats, 0, sizeof(struct rt_schedule_stats));
+    rt_hw_interrupt_enable(level);
+}
+RTM_EXPORT(rt_schedule_reset_stats);
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+void list_sched(void)
+{
+    struct rt_schedule_stats stats;
+
+    rt_schedule_get_stats(&stats);
+
+    rt_kprintf("schedule calls : %d\n", stats.calls);
+    rt_kprintf("  deferred     : %d\n", stats.deferred);
+    rt_kprintf("  fast path    : %d\n", stats.fast);
+    rt_kprintf("  switches     : %d\n", stats.switches);
+    rt_kprintf("unlock skipped : %d\n", stats.unlock_skipped);
+}
+FINSH_FUNCTION_EXPORT(list_sched, list scheduler statistics)
+MSH_CMD_EXPORT(list_sched, list scheduler statistics);
+#endif /* RT_USING_FINSH */
+#endif /* RT_USING_SCHED_FASTPATH */
+
 /**@}*/
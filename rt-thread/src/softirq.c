@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2006-2019, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Hehesheng    the first version
+ */
+
+#include <rthw.h>
+#include <rtthread.h>
+
+#ifdef RT_USING_SOFTIRQ
+
+/*
+ * The softirq is the bottom half of interrupt. The top half in ISR only
+ * acknowledges the hardware and raises the softirq, and the raised softirqs
+ * run by priority when the outermost interrupt is leaving, with interrupt
+ * enabled and the interrupt nest still counted. So the bottom half is still
+ * in interrupt context, it can't be blocked, and the thread switch caused by
+ * it is taken after the interrupt returns.
+ *
+ * On Cortex-M, the bottom half runs at the priority of the interrupt which
+ * is leaving, only the interrupts with higher priority can preempt it.
+ */
+
+/* the maximal number of softirqs run in one interrupt exit, the rest are left
+ * to the next interrupt exit, so a softirq raising itself can't hold the CPU */
+#define SOFTIRQ_RUN_MAX                 32
+
+static rt_list_t _softirq_queue[RT_SOFTIRQ_PRIORITIES];
+static rt_list_t _softirq_list = RT_LIST_OBJECT_INIT(_softirq_list);
+static rt_uint32_t _softirq_ready;
+static rt_uint8_t _softirq_running;
+
+/* the timestamp of outermost interrupt entry */
+rt_uint32_t rt_softirq_irq_stamp;
+
+/**
+ * This function will return the timestamp to measure the softirq latency.
+ * The BSP or libcpu shall provide a cycle counter, it's OS tick by default.
+ *
+ * @return the timestamp
+ */
+RT_WEAK rt_uint32_t rt_softirq_timestamp(void)
+{
+    return rt_tick_get();
+}
+
+/**
+ * This function will return the frequency of rt_softirq_timestamp.
+ *
+ * @return the frequency in Hz
+ */
+RT_WEAK rt_uint32_t rt_softirq_timestamp_freq(void)
+{
+    return RT_TICK_PER_SECOND;
+}
+
+/**
+ * @addtogroup Kernel
+ */
+
+/**@{*/
+
+/**
+ * This function will initialize a softirq.
+ *
+ * @param softirq the softirq to be initialized
+ * @param name the name of softirq
+ * @param handler the bottom half handler
+ * @param parameter the parameter of handler
+ * @param priority the priority of softirq, 0 is the highest
+ */
+void rt_softirq_init(rt_softirq_t softirq,
+                     const char  *name,
+                     void (*handler)(void *parameter),
+                     void        *parameter,
+                     rt_uint8_t   priority)
+{
+    register rt_base_t level;
+
+    /* parameter check */
+    RT_ASSERT(softirq != RT_NULL);
+    RT_ASSERT(handler != RT_NULL);
+    RT_ASSERT(priority < RT_SOFTIRQ_PRIORITIES);
+
+    rt_memset(softirq, 0, sizeof(struct rt_softirq));
+    rt_strncpy(softirq->name, name, RT_NAME_MAX);
+    rt_list_init(&(softirq->list));
+    softirq->handler   = handler;
+    softirq->parameter = parameter;
+    softirq->priority  = priority;
+
+    level = rt_hw_interrupt_disable();
+    if (_softirq_queue[0].next == RT_NULL)
+    {
+        rt_uint32_t index;
+
+        for (index = 0; index < RT_SOFTIRQ_PRIORITIES; index ++)
+            rt_list_init(&_softirq_queue[index]);
+    }
+    rt_list_insert_before(&_softirq_list, &(softirq->node));
+    rt_hw_interrupt_enable(level);
+}
+RTM_EXPORT(rt_softirq_init);
+
+/**
+ * This function will detach a softirq. The pending run is cancelled.
+ *
+ * @param softirq the softirq to be detached
+ */
+void rt_softirq_detach(rt_softirq_t softirq)
+{
+    register rt_base_t level;
+
+    /* parameter check */
+    RT_ASSERT(softirq != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    if (softirq->pending)
+    {
+        rt_list_remove(&(softirq->list));
+        if (rt_list_isempty(&_softirq_queue[softirq->priority]))
+            _softirq_ready &= ~(1UL << softirq->priority);
+        softirq->pending = RT_FALSE;
+    }
+    rt_list_remove(&(softirq->node));
+    rt_hw_interrupt_enable(level);
+}
+RTM_EXPORT(rt_softirq_detach);
+
+/**
+ * This function will raise a softirq. The softirq runs once even if it's
+ * raised several times before it runs.
+ *
+ * In ISR, the softirq runs when the outermost interrupt is leaving. In thread,
+ * it runs immediately.
+ *
+ * @param softirq the softirq to be raised
+ */
+void rt_softirq_raise(rt_softirq_t softirq)
+{
+    register rt_base_t level;
+    rt_uint8_t nest;
+
+    /* parameter check */
+    RT_ASSERT(softirq != RT_NULL);
+
+    level = rt_hw_interrupt_disable();
+    nest = rt_interrupt_get_nest();
+    if (!softirq->pending)
+    {
+        softirq->pending = RT_TRUE;
+        softirq->stamp = nest > 0 ? rt_softirq_irq_stamp : rt_softirq_timestamp();
+        rt_list_insert_before(&_softirq_queue[softirq->priority], &(softirq->list));
+        _softirq_ready |= 1UL << softirq->priority;
+    }
+    rt_hw_interrupt_enable(level);
+
+    if (nest == 0)
+    {
+        rt_enter_critical();
+        rt_softirq_run();
+        rt_exit_critical();
+    }
+}
+RTM_EXPORT(rt_softirq_raise);
+
+/**
+ * This function will run the raised softirqs. It's invoked by
+ * rt_interrupt_leave, please don't invoke it in application.
+ */
+void rt_softirq_run(void)
+{
+    rt_softirq_t softirq;
+    register rt_base_t level;
+    rt_uint32_t start, latency, duration, count;
+
+    level = rt_hw_interrupt_disable();
+
+    /* the softirqs are running in the interrupted context */
+    if (_softirq_running || _softirq_ready == 0)
+    {
+        rt_hw_interrupt_enable(level);
+        return;
+    }
+    _softirq_running = RT_TRUE;
+
+    for (count = 0; _softirq_ready != 0 && count < SOFTIRQ_RUN_MAX; count ++)
+    {
+        softirq = rt_list_entry(_softirq_queue[__rt_ffs(_softirq_ready) - 1].next,
+                                struct rt_softirq, list);
+        rt_list_remove(&(softirq->list));
+        if (rt_list_isempty(&_softirq_queue[softirq->priority]))
+            _softirq_ready &= ~(1UL << softirq->priority);
+        softirq->pending = RT_FALSE;
+        rt_hw_interrupt_enable(level);
+
+        start = rt_softirq_timestamp();
+        softirq->handler(softirq->parameter);
+        duration = rt_softirq_timestamp() - start;
+
+        level = rt_hw_interrupt_disable();
+        latency = start - softirq->stamp;
+        softirq->count ++;
+        softirq->latency_sum += latency;
+        if (latency > softirq->latency_max)
+            softirq->latency_max = latency;
+        softirq->duration_sum += duration;
+        if (duration > softirq->duration_max)
+            softirq->duration_max = duration;
+    }
+
+    _softirq_running = RT_FALSE;
+    rt_hw_interrupt_enable(level);
+}
+
+/**@}*/
+
+#ifdef RT_USING_FINSH
+#include <finsh.h>
+
+void list_softirq(void)
+{
+    struct rt_softirq info;
+    rt_softirq_t softirq;
+    register rt_base_t level;
+    rt_uint32_t index, count, freq;
+
+    freq = rt_softirq_timestamp_freq();
+
+    rt_kprintf("%-*.*s pri     count lat avg(us) lat max(us) run avg(us) run max(us)\n",
+               RT_NAME_MAX, RT_NAME_MAX, "softirq");
+    rt_kprintf("%-*.*s --- --------- ----------- ----------- ----------- -----------\n",
+               RT_NAME_MAX, RT_NAME_MAX, "--------------------------------");
+
+    for (count = 0; ; count ++)
+    {
+        /* take a snapshot of the count-th softirq, and print it out of the lock */
+        index = 0;
+        level = rt_hw_interrupt_disable();
+        rt_list_for_each_entry(softirq, &_softirq_list, node)
+        {
+            if (index ++ == count)
+            {
+                rt_memcpy(&info, softirq, sizeof(struct rt_softirq));
+                break;
+            }
+        }
+        rt_hw_interrupt_enable(level);
+
+        if (index <= count)
+            break;
+
+        rt_kprintf("%-*.*s %3d %9d %11d %11d %11d %11d\n",
+                   RT_NAME_MAX, RT_NAME_MAX, info.name, info.priority, info.count,
+                   info.count ? (rt_uint32_t)(info.latency_sum * 1000000 / freq / info.count) : 0,
+                   (rt_uint32_t)((rt_uint64_t)info.latency_max * 1000000 / freq),
+                   info.count ? (rt_uint32_t)(info.duration_sum * 1000000 / freq / info.count) : 0,
+                   (rt_uint32_t)((rt_uint64_t)info.duration_max * 1000000 / freq));
+    }
+}
+FINSH_FUNCTION_EXPORT(list_softirq, list softirq in system)
+MSH_CMD_EXPORT(list_softirq, list softirq in system);
+#endif /* RT_USING_FINSH */
+
+#endif /* RT_USING_SOFTIRQ */
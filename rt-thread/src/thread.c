@@ -26,6 +26,7 @@
  *                             bug when thread has not startup.
  * 2018-11-22     Jesven       yield is same to rt_schedule
  *                             add support for tasks bound to cpu
+ * 2026-10-19     Hehesheng    reset stack high water fields of stackmon
  */
 
 #include <rthw.h>
@@ -135,6 +136,11 @@ static rt_err_t _rt_thread_init(struct rt_thread *thread,
 
     /* init thread stack */
     rt_memset(thread->stack_addr, '#', thread->stack_size);
+#ifdef RT_USING_STACKMON
+    thread->stack_peak = 0;
+    thread->stack_scan = 0;
+    thread->stack_warn = 0;
+#endif
 #ifdef ARCH_CPU_STACK_GROWS_UPWARD
     thread->sp = (void *)rt_hw_stack_init(thread->entry, thread->parameter,
                                           (void *)((char *)thread->stack_addr),
@@ -782,6 +788,15 @@ RTM_EXPORT(rt_thread_timeout);
  */
 rt_thread_t rt_thread_find(char *name)
 {
+#ifdef RT_USING_OBJECT_HASH
+    struct rt_object_information *information;
+
+    /* find thread object in the name hash index */
+    information = rt_object_get_information(RT_Object_Class_Thread);
+    RT_ASSERT(information != RT_NULL);
+
+    return (rt_thread_t)rt_object_hash_find(information, name);
+#else
     struct rt_object_information *information;
     struct rt_object *object;
     struct rt_list_node *node;
@@ -814,6 +829,7 @@ rt_thread_t rt_thread_find(char *name)
 
     /* not found */
     return RT_NULL;
+#endif
 }
 RTM_EXPORT(rt_thread_find);
 
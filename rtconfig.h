@@ -20,14 +20,21 @@
 #define RT_USING_IDLE_HOOK
 #define RT_IDEL_HOOK_LIST_SIZE 4
 #define IDLE_THREAD_STACK_SIZE 1024
+#define RT_USING_SCHED_FASTPATH
+#define RT_USING_OBJECT_HASH
+#define RT_OBJECT_HASH_BUCKETS 16
 /* RT_USING_TIMER_SOFT is not set */
+/* RT_USING_SOFTIRQ is not set */
 /* RT_DEBUG is not set */
 
 /* Inter-Thread communication */
 
 #define RT_USING_SEMAPHORE
 #define RT_USING_MUTEX
+#define RT_USING_IPC_ATOMIC
 #define RT_USING_EVENT
+#define RT_USING_EVENT_BUCKETS
+#define RT_EVENT_WAIT_BUCKETS 4
 #define RT_USING_MAILBOX
 #define RT_USING_MESSAGEQUEUE
 /* RT_USING_SIGNALS is not set */
@@ -41,6 +48,7 @@
 /* RT_USING_SLAB is not set */
 #define RT_USING_MEMHEAP_AS_HEAP
 #define RT_USING_HEAP
+/* RT_USING_OBJCACHE is not set */
 
 /* Kernel Device Object */
 
@@ -50,9 +58,11 @@
 #define RT_USING_CONSOLE
 #define RT_CONSOLEBUF_SIZE 128
 #define RT_CONSOLE_DEVICE_NAME "uart1"
+#define RT_PRINTF_FLOAT
 #define RT_VER_NUM 0x40002
 #define ARCH_ARM
 #define RT_USING_CPU_FFS
+#define RT_USING_HW_ATOMIC
 #define ARCH_ARM_CORTEX_M
 #define ARCH_ARM_CORTEX_M4
 /* ARCH_CPU_STACK_GROWS_UPWARD is not set */
@@ -124,9 +134,11 @@
 #define RT_USING_SYSTEM_WORKQUEUE
 #define RT_SYSTEM_WORKQUEUE_STACKSIZE 2048
 #define RT_SYSTEM_WORKQUEUE_PRIORITY 23
+#define RT_SYSTEM_WORKQUEUE_WORKERS 1
 #define RT_USING_SERIAL
 #define RT_SERIAL_USING_DMA
 #define RT_SERIAL_RB_BUFSZ 64
+#define RT_SERIAL_TX_DMA_BUFSZ 256
 /* RT_USING_CAN is not set */
 /* RT_USING_HWTIMER is not set */
 /* RT_USING_CPUTIME is not set */
@@ -134,9 +146,14 @@
 #define RT_USING_I2C_BITOPS
 #define RT_USING_PIN
 /* RT_USING_ADC is not set */
+/* RT_USING_ADC_STREAM is not set */
 /* RT_USING_PWM is not set */
 /* RT_USING_MTD_NOR is not set */
 /* RT_USING_MTD_NAND is not set */
+#define RT_USING_BLK_CACHE
+#define RT_BLK_CACHE_SECTORS 4
+#define RT_BLK_CACHE_READ_AHEAD 2
+#define RT_BLK_CACHE_FLUSH_MS 1000
 /* RT_USING_PM is not set */
 #define RT_USING_RTC
 /* RT_USING_ALARM is not set */
@@ -147,9 +164,13 @@
 #define RT_MMCSD_STACK_SIZE 1024
 #define RT_MMCSD_THREAD_PREORITY 22
 #define RT_MMCSD_MAX_PARTITION 16
+#define RT_MMCSD_USING_BLK_QUEUE
+#define RT_MMCSD_BLK_QUEUE_STACK_SIZE 1024
+#define RT_MMCSD_BLK_MERGE_SECTORS 16
 /* RT_SDIO_DEBUG is not set */
 #define RT_USING_SPI
 /* RT_USING_QSPI is not set */
+#define RT_SPI_USING_ASYNC
 /* RT_USING_SPI_MSD is not set */
 #define RT_USING_SFUD
 #define RT_SFUD_USING_SFDP
@@ -161,6 +182,7 @@
 /* RT_USING_WDT is not set */
 /* RT_USING_AUDIO is not set */
 /* RT_USING_SENSOR is not set */
+/* RT_SENSOR_USING_FIFO_RING is not set */
 /* RT_USING_TOUCH is not set */
 
 /* Using Hardware Crypto drivers */
@@ -261,6 +283,7 @@
 #define RT_LWIP_TCPTHREAD_STACKSIZE 1024
 /* LWIP_NO_RX_THREAD is not set */
 /* LWIP_NO_TX_THREAD is not set */
+/* RT_LWIP_USING_ETH_TX_BATCH is not set */
 #define RT_LWIP_ETHTHREAD_PRIORITY 12
 #define RT_LWIP_ETHTHREAD_STACKSIZE 1024
 #define RT_LWIP_ETHTHREAD_MBOX_SIZE 8
@@ -275,6 +298,7 @@
 #define LWIP_NETIF_LOOPBACK 0
 /* RT_LWIP_STATS is not set */
 /* RT_LWIP_USING_HW_CHECKSUM is not set */
+/* RT_LWIP_USING_CUSTOM_PBUF is not set */
 #define RT_LWIP_USING_PING
 /* RT_LWIP_DEBUG is not set */
 
@@ -319,6 +343,12 @@
 /* ULOG_USING_FILTER is not set */
 /* ULOG_USING_SYSLOG is not set */
 /* RT_USING_UTEST is not set */
+/* RT_USING_KTRACE is not set */
+#define RT_USING_STACKMON
+#define RT_STACKMON_SCAN_STEP 64
+#define RT_STACKMON_WARN_PERCENT 80
+#define RT_STACKMON_MARGIN_PERCENT 25
+/* RT_USING_MEMPROF is not set */
 /* RT_USING_LWP is not set */
 
 /* RT-Thread online packages */
@@ -595,6 +625,7 @@
 /* BSP_USING_RS232 is not set */
 #define BSP_USING_SDRAM
 #define BSP_USING_SPI_FLASH
+/* BSP_USING_SPI_FLASH_FTL is not set */
 /* BSP_USING_LCD is not set */
 /* BSP_USING_MPU6050 is not set */
 /* BSP_USING_ETH is not set */
@@ -610,17 +641,18 @@
 /* BSP_UART1_RX_USING_DMA is not set */
 #define BSP_USING_UART2
 /* BSP_UART2_RX_USING_DMA is not set */
+#define BSP_UART2_TX_USING_DMA
 #define BSP_USING_UART3
 #define BSP_UART3_RX_USING_DMA
 /* BSP_USING_ON_CHIP_FLASH is not set */
 #define BSP_USING_SPI
 /* BSP_USING_SPI1 is not set */
 #define BSP_USING_SPI3
-/* BSP_SPI3_TX_USING_DMA is not set */
-/* BSP_SPI3_RX_USING_DMA is not set */
+#define BSP_SPI3_TX_USING_DMA
+#define BSP_SPI3_RX_USING_DMA
 #define BSP_USING_SPI5
-/* BSP_SPI5_TX_USING_DMA is not set */
-/* BSP_SPI5_RX_USING_DMA is not set */
+#define BSP_SPI5_TX_USING_DMA
+#define BSP_SPI5_RX_USING_DMA
 /* BSP_USING_TIM is not set */
 /* BSP_USING_PWM is not set */
 /* BSP_USING_ADC is not set */